@@ -96,14 +96,15 @@ module MLC
     
     # Type declarations
     class TypeDecl < Node
-      attr_reader :name, :type, :type_params, :exported
+      attr_reader :name, :type, :type_params, :exported, :derives
 
-      def initialize(name:, type:, type_params: [], exported: false, origin: nil)
+      def initialize(name:, type:, type_params: [], exported: false, derives: [], origin: nil)
         super(origin: origin)
         @name = name
         @type = type
         @type_params = type_params  # Array of TypeParam
         @exported = exported        # Boolean - is this exported?
+        @derives = derives          # Array of String - generated capabilities (e.g. "Json")
       end
     end
 
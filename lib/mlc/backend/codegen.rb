@@ -12,6 +12,7 @@ require_relative "codegen/function_lowerer"
 require_relative "codegen/rules/function_rule"
 require_relative "runtime_policy"
 require_relative "block_complexity_analyzer"
+require_relative "linear_use_analyzer"
 require_relative "../rules/codegen/cpp_expression_rule"
 require_relative "../rules/codegen/expression/literal_rule"
 require_relative "../rules/codegen/expression/var_ref_rule"
@@ -9,6 +9,10 @@ module MLC
       module FunctionLowerer
       def lower_module(module_node)
               @user_functions = module_node.items.grep(HighIR::Func).map(&:name)
+              @call_effects = PipelineFusionAnalyzer::CallEffects.new(
+                module_node.items.grep(HighIR::Func),
+                stdlib_scanner: @stdlib_scanner
+              )
               @identifier_map = {}
 
               include_stmt = CppAst::Nodes::IncludeDirective.new(
@@ -30,6 +34,14 @@ module MLC
               return_type = map_type(func.ret_type)
               name = sanitize_identifier(func.name)
               parameters = func.params.map { |param| "#{map_type(param.type)} #{sanitize_identifier(param.name)}" }
+              @lazy_json_decls = @runtime_policy.lazy_json_bindings(func.body, Array(@user_functions))
+              linear_uses = LinearUseAnalyzer.new(func.params, func.body, user_functions: Array(@user_functions))
+              @moved_uses = linear_uses.moved_uses
+              @moved_bindings = linear_uses.moved_bindings
+              @pipeline_plans = @runtime_policy.pipeline_plans(
+                func.body,
+                @call_effects || PipelineFusionAnalyzer::CallEffects.new(stdlib_scanner: @stdlib_scanner)
+              )
 
               block_body = if func.body.is_a?(HighIR::BlockExpr)
                              stmts = lower_block_expr_statements(func.body, emit_return: true)
@@ -85,6 +97,39 @@ module MLC
               end
             end
 
+      # let-binding of parse_json that is lowered to a mlc::json::LazyValue cursor
+      def lazy_json_binding?(stmt)
+              Array(@lazy_json_decls).any? { |decl| decl.equal?(stmt) }
+            end
+
+      # Variable reference that is its value's last use (lowered as std::move)
+      def moved_use?(expr)
+              Array(@moved_uses).any? { |use| use.equal?(expr) }
+            end
+
+      # Fusion plan for the array method call that ends a map/filter chain
+      def pipeline_plan(call)
+              @pipeline_plans&.[](call)
+            end
+
+      # Lower the iterable of a for loop, where a streaming call stays lazy
+      def lower_iterable(expr)
+              previous = @streamed_iterable
+              @streamed_iterable = expr
+              lower_expression(expr)
+            ensure
+              @streamed_iterable = previous
+            end
+
+      def streamed_iterable?(expr)
+              @streamed_iterable.equal?(expr)
+            end
+
+      # let-binding that is moved from, so it cannot be declared const
+      def moved_binding?(name)
+              Array(@moved_bindings).include?(name)
+            end
+
       def generate_template_function(type_params, func_decl)
               template_params_str, params_suffix = build_template_signature(type_params)
       
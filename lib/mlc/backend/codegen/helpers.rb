@@ -17,8 +17,21 @@ module MLC
           virtual void volatile wchar_t while xor xor_eq
         ].freeze
 
+        # Stdlib functions declared `-> str[]` that return a lazy C++ range of
+        # string views instead of a vector. A for loop iterates them as they
+        # are (ForRule); anywhere else CallRule collects them into a vector.
+        STREAMING_FUNCTIONS = %w[
+          mlc::io::stdin_lines mlc::file::lines mlc::file::chunks mlc::file::records
+        ].freeze
+
         module_function
 
+        def streaming_call?(cpp_expr)
+          cpp_expr.is_a?(CppAst::Nodes::FunctionCallExpression) &&
+            cpp_expr.callee.is_a?(CppAst::Nodes::Identifier) &&
+            STREAMING_FUNCTIONS.include?(cpp_expr.callee.name)
+        end
+
         # Check if name is a C++ keyword
         def cpp_keyword?(name)
           CPP_KEYWORDS.include?(name)
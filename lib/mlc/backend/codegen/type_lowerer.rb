@@ -17,6 +17,8 @@ module MLC
                         # For primitive types, generate empty program (no direct C++ emission)
                         CppAst::Nodes::Program.new(statements: [], statement_trailings: [])
                       end
+
+              result = append_json_codec(result, type_decl) if type_decl.derives.include?("Json")
       
               if type_decl.type_params.any?
                 if result.is_a?(CppAst::Nodes::Program)
@@ -127,6 +129,55 @@ module MLC
               )
             end
 
+      # `derive Json`: the codec hook runtime/mlc_json_codec.hpp finds by ADL
+      # (one per variant struct for sum types) and the <t>_to_json /
+      # <t>_from_json functions registered during IR generation
+      def append_json_codec(result, type_decl)
+              name = type_decl.name
+              hooks = case type_decl.type
+                      when HighIR::RecordType
+                        [json_codec_hook(name, json_record_codec(name, type_decl.type.fields))]
+                      when HighIR::SumType
+                        variants = type_decl.type.variants
+                        variant_hooks = variants.map { |variant| json_codec_hook(variant[:name], json_variant_codec(variant)) }
+                        alternatives = variants.map { |variant| "mlc::json::Alternative<\"#{variant[:name]}\", #{variant[:name]}>" }
+                        variant_hooks + [json_codec_hook(name, "mlc::json::VariantCodec<#{name}, #{alternatives.join(', ')}>")]
+                      end
+
+              prefix = HighIR::TypeDecl.json_function_prefix(name)
+              functions = [
+                "inline mlc::String #{prefix}_to_json(const #{name}& value) { return mlc::json::encode(value); }",
+                "inline #{name} #{prefix}_from_json(const mlc::String& text, const #{name}& fallback) " \
+                "{ return mlc::json::decode_or(text, fallback); }"
+              ]
+
+              statements = result.is_a?(CppAst::Nodes::Program) ? result.statements.dup : [result]
+              statements.concat((hooks + functions).map { |code| CppAst::Nodes::RawStatement.new(code: code) })
+              CppAst::Nodes::Program.new(statements: statements, statement_trailings: Array.new(statements.size, ""))
+            end
+
+      def json_codec_hook(type_name, codec)
+              "#{codec} mlc_json_codec(const #{type_name}*);"
+            end
+
+      def json_record_codec(struct_name, fields)
+              members = fields.map do |field|
+                ", mlc::json::Field<\"#{field[:name]}\", &#{struct_name}::#{sanitize_identifier(field[:name])}>"
+              end
+              "mlc::json::RecordCodec<#{struct_name}#{members.join}>"
+            end
+
+      # Positional variants (Circle(f32) has field0) encode as their payload
+      def json_variant_codec(variant)
+              fields = variant[:fields]
+              if fields.any? && fields.each_with_index.all? { |field, i| field[:name] == "field#{i}" }
+                members = fields.map { |field| ", &#{variant[:name]}::#{field[:name]}" }
+                "mlc::json::TupleCodec<#{variant[:name]}#{members.join}>"
+              else
+                json_record_codec(variant[:name], fields)
+              end
+            end
+
       end
     end
   end
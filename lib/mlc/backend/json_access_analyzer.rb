@@ -0,0 +1,74 @@
+# frozen_string_literal: true
+
+module MLC
+  module Backend
+    # JsonAccessAnalyzer - finds `let x = parse_json(...)` bindings that are
+    # only ever read through the JSON accessors (json_get, json_has_key,
+    # json_array_get, json_array_length) as their first argument.
+    #
+    # Such a document never needs a DOM: it is lowered to a
+    # mlc::json::LazyValue cursor (runtime/mlc_json_lazy.hpp) that scans the
+    # text on demand. Names are tracked per function, so any other use of the
+    # name anywhere in the body (passing it on, returning it, shadowing it
+    # with a value used differently) keeps every binding of it on the DOM.
+    # Only used with RuntimePolicy#json_strategy = :lazy (mlc --lazy-json):
+    # a cursor does not check scalars in values no lookup reads.
+    class JsonAccessAnalyzer
+      ACCESSORS = %w[json_get json_has_key json_array_get json_array_length].freeze
+
+      def initialize(body, user_functions: [])
+        @user_functions = user_functions
+        @candidates = []
+        @accessor_args = {}.compare_by_identity
+        @var_refs = []
+        walk(body)
+      end
+
+      # VariableDeclStmt nodes to lower as lazy cursors
+      def lazy_bindings
+        lazy_names = @candidates.map(&:name).uniq.select do |name|
+          @var_refs.all? { |ref| ref.name != name || @accessor_args.key?(ref) }
+        end
+        @candidates.select { |decl| lazy_names.include?(decl.name) }
+      end
+
+      private
+
+      def walk(node)
+        case node
+        when Array
+          node.each { |item| walk(item) }
+        when Hash
+          node.each_value { |value| walk(value) }
+        when HighIR::Type
+          nil
+        when HighIR::VarExpr
+          @var_refs << node
+        when HighIR::Node
+          record(node)
+          node.instance_variables.each do |ivar|
+            walk(node.instance_variable_get(ivar)) unless ivar == :@origin
+          end
+        end
+      end
+
+      def record(node)
+        case node
+        when HighIR::VariableDeclStmt
+          @candidates << node if stdlib_call?(node.value, "parse_json")
+        when HighIR::CallExpr
+          if ACCESSORS.any? { |name| stdlib_call?(node, name) } && node.args.first.is_a?(HighIR::VarExpr)
+            @accessor_args[node.args.first] = true
+          end
+        end
+      end
+
+      def stdlib_call?(expr, name)
+        expr.is_a?(HighIR::CallExpr) &&
+          expr.callee.is_a?(HighIR::VarExpr) &&
+          expr.callee.name == name &&
+          !@user_functions.include?(name)
+      end
+    end
+  end
+end
@@ -0,0 +1,137 @@
+# frozen_string_literal: true
+
+module MLC
+  module Backend
+    # LinearUseAnalyzer - finds JsonValue arguments of json_array_push/json_set
+    # that are the value's last use, so codegen can pass them with std::move.
+    # A moved handle is the only one on its document, and the runtime then
+    # updates that document in place instead of copying it.
+    #
+    # A variable reference is moved when either
+    # - it is the only reference to a let binding or parameter of the same
+    #   function/lambda, with no loop between the binding and the use; or
+    # - it is a self-update `x = json_array_push(x, ...)` whose other
+    #   arguments do not mention x (safe anywhere, since x is reassigned).
+    class LinearUseAnalyzer
+      CONSUMERS = %w[json_array_push json_set].freeze
+
+      Frame = Struct.new(:bindings, :loop_depth)
+
+      def initialize(params, body, user_functions: [])
+        @user_functions = user_functions
+        @refs = {}.compare_by_identity
+        @ref_counts = Hash.new(0)
+        @candidates = {}.compare_by_identity
+        @self_updates = {}.compare_by_identity
+        @frames = [Frame.new(params.to_h { |param| [param.name, 0] }, 0)]
+        walk(body)
+      end
+
+      # VarExpr nodes to lower as std::move(...)
+      def moved_uses
+        moved = @candidates.select { |ref, ok| ok && @ref_counts[ref.name] == 1 }.keys
+        moved + @self_updates.keys
+      end
+
+      # Names of let bindings that are moved from (and so cannot be const)
+      def moved_bindings
+        moved_uses.map(&:name).uniq
+      end
+
+      private
+
+      def frame
+        @frames.last
+      end
+
+      def walk(node)
+        case node
+        when Array
+          node.each { |item| walk(item) }
+        when Hash
+          node.each_value { |value| walk(value) }
+        when HighIR::Type
+          nil
+        when HighIR::VarExpr
+          @ref_counts[node.name] += 1 unless @refs.key?(node)
+          @refs[node] = true
+        when HighIR::VariableDeclStmt
+          walk(node.value)
+          frame.bindings[node.name] = frame.loop_depth
+        when HighIR::ForStmt
+          walk(node.iterable)
+          in_loop { walk(node.body) }
+        when HighIR::WhileStmt, HighIR::ListCompExpr
+          in_loop { walk_children(node) }
+        when HighIR::LambdaExpr
+          @frames.push(Frame.new(node.params.to_h { |param| [param.name, 0] }, 0))
+          walk(node.body)
+          @frames.pop
+        when HighIR::AssignmentStmt
+          record_self_update(node)
+          walk_children(node)
+        when HighIR::CallExpr
+          record_consumer(node)
+          walk_children(node)
+        when HighIR::Node
+          walk_children(node)
+        end
+      end
+
+      def walk_children(node)
+        node.instance_variables.each do |ivar|
+          walk(node.instance_variable_get(ivar)) unless ivar == :@origin
+        end
+      end
+
+      def in_loop
+        frame.loop_depth += 1
+        yield
+      ensure
+        frame.loop_depth -= 1
+      end
+
+      def record_consumer(call)
+        return unless consumer?(call)
+
+        ref = call.args.first
+        @candidates[ref] = frame.bindings[ref.name] == frame.loop_depth unless @candidates.key?(ref)
+      end
+
+      def record_self_update(stmt)
+        target = stmt.target
+        call = stmt.value
+        return unless target.is_a?(HighIR::VarExpr) && consumer?(call)
+        return unless call.args.first.name == target.name
+        return if mentions?(call.args.drop(1), target.name)
+
+        @self_updates[call.args.first] = true
+      end
+
+      def consumer?(expr)
+        expr.is_a?(HighIR::CallExpr) &&
+          expr.callee.is_a?(HighIR::VarExpr) &&
+          CONSUMERS.include?(expr.callee.name) &&
+          !@user_functions.include?(expr.callee.name) &&
+          expr.args.first.is_a?(HighIR::VarExpr)
+      end
+
+      def mentions?(node, name)
+        case node
+        when Array
+          node.any? { |item| mentions?(item, name) }
+        when Hash
+          node.each_value.any? { |value| mentions?(value, name) }
+        when HighIR::Type
+          false
+        when HighIR::VarExpr
+          node.name == name
+        when HighIR::Node
+          node.instance_variables.any? { |ivar| ivar != :@origin && mentions?(node.instance_variable_get(ivar), name) }
+        else
+          false
+        end
+      end
+    end
+  end
+end
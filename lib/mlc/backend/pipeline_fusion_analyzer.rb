@@ -0,0 +1,169 @@
+# frozen_string_literal: true
+
+module MLC
+  module Backend
+    # PipelineFusionAnalyzer - finds chains of array methods such as
+    # `xs.map(f).filter(g).fold(init, h)` that can run as one loop.
+    #
+    # Lowered one call at a time, every map/filter builds a full std::vector
+    # that the next call reads once and drops. A fused chain is lowered to a
+    # mlc::collections::lazy pipeline (runtime/mlc_collections.hpp) instead,
+    # and a vector is only built where the chain ends:
+    # - at a terminal (fold, sum, length/size), which consumes the elements;
+    # - as the iterable of a for loop, which pulls them one at a time;
+    # - otherwise, where the value escapes (bound, returned, passed on), by
+    #   collecting the last stage into a single vector.
+    # A lone map or filter outside a for loop gains nothing and is left alone.
+    #
+    # Fusing runs the stages element by element instead of one whole stage
+    # after another, so a chain is only fused when its map/filter arguments
+    # have no effects (CallEffects). The terminal's function may have effects:
+    # it runs after the stages in both orders.
+    class PipelineFusionAnalyzer
+      STAGES = %w[map filter].freeze
+      TERMINALS = { "fold" => :fold, "sum" => :sum, "length" => :count, "size" => :count }.freeze
+
+      # stages: the map/filter calls from the source outwards; terminal: one
+      # of :fold, :sum, :count, :iterate or :collect, with terminal_call the
+      # call that ends the chain for the first three
+      Plan = Struct.new(:source, :stages, :terminal, :terminal_call)
+
+      # Which calls can only compute a value. User functions are judged by
+      # their bodies, transitively; stdlib functions by their module (IO,
+      # File and Graphics touch the outside world); anything else that is
+      # called (extern functions, function-typed values) counts as an effect.
+      class CallEffects
+        PURE_BUILTINS = %w[to_string format to_f32 args].freeze
+        EFFECTFUL_NAMESPACES = %w[mlc::io:: mlc::file:: mlc::graphics::].freeze
+
+        def initialize(functions = [], stdlib_scanner: nil)
+          @bodies = functions.to_h { |func| [func.name, func.body] }
+          @stdlib_scanner = stdlib_scanner
+          @effectful = {}
+          # Least fixed point: recursion alone is not an effect
+          loop do
+            found = @bodies.reject { |name, body| @effectful.key?(name) || (body && pure?(body)) }.keys
+            break if found.empty?
+
+            found.each { |name| @effectful[name] = true }
+          end
+        end
+
+        def pure?(node)
+          case node
+          when Array
+            node.all? { |item| pure?(item) }
+          when Hash
+            node.each_value.all? { |value| pure?(value) }
+          when HighIR::Type
+            true
+          when HighIR::VarExpr
+            !@effectful.key?(node.name)
+          when HighIR::CallExpr
+            pure_callee?(node.callee) && pure?(node.args)
+          when HighIR::Node
+            node.instance_variables.all? { |ivar| ivar == :@origin || pure?(node.instance_variable_get(ivar)) }
+          else
+            true
+          end
+        end
+
+        private
+
+        def pure_callee?(callee)
+          case callee
+          when HighIR::VarExpr
+            pure_function?(callee.name)
+          when HighIR::MemberExpr
+            # Built-in methods of arrays, strings and numbers
+            type = callee.object.type
+            (type.is_a?(HighIR::ArrayType) || type&.primitive?) && pure?(callee.object)
+          else
+            false
+          end
+        end
+
+        def pure_function?(name)
+          return !@effectful.key?(name) if @bodies.key?(name)
+          return true if PURE_BUILTINS.include?(name)
+
+          qualified = @stdlib_scanner&.cpp_function_name(name)
+          !qualified.nil? && EFFECTFUL_NAMESPACES.none? { |prefix| qualified.start_with?(prefix) }
+        end
+      end
+
+      def initialize(body, call_effects: CallEffects.new)
+        @call_effects = call_effects
+        @plans = {}.compare_by_identity
+        walk(body)
+      end
+
+      # Outermost call of each fused chain => Plan
+      attr_reader :plans
+
+      private
+
+      def walk(node, iterable: false)
+        case node
+        when Array
+          node.each { |item| walk(item) }
+        when Hash
+          node.each_value { |value| walk(value) }
+        when HighIR::Type
+          nil
+        when HighIR::ForStmt
+          walk(node.iterable, iterable: true)
+          walk(node.body)
+        when HighIR::CallExpr
+          return if record_chain(node, iterable)
+
+          walk_children(node)
+        when HighIR::Node
+          walk_children(node)
+        end
+      end
+
+      def walk_children(node)
+        node.instance_variables.each do |ivar|
+          walk(node.instance_variable_get(ivar)) unless ivar == :@origin
+        end
+      end
+
+      # Records the chain ending at call, then walks what is left of it: the
+      # source and the arguments of every link. Returns false when call does
+      # not end a chain worth fusing.
+      def record_chain(call, iterable)
+        method = array_method(call)
+        return false unless method && (STAGES.include?(method) || TERMINALS.key?(method))
+
+        links = [call]
+        links.unshift(links.first.callee.object) while STAGES.include?(array_method(links.first.callee.object))
+        terminal_call = TERMINALS.key?(method) ? call : nil
+        stages = terminal_call ? links[0...-1] : links
+        terminal = if terminal_call
+                     TERMINALS[method]
+                   elsif iterable
+                     :iterate
+                   else
+                     :collect
+                   end
+        return false if stages.empty?
+        return false if terminal == :collect && stages.size < 2
+        return false unless stages.all? { |stage| @call_effects.pure?(stage.args) }
+
+        source = links.first.callee.object
+        @plans[call] = Plan.new(source, stages, terminal, terminal_call)
+        walk(source)
+        links.each { |link| walk(link.args) }
+        true
+      end
+
+      def array_method(expr)
+        return nil unless expr.is_a?(HighIR::CallExpr) && expr.callee.is_a?(HighIR::MemberExpr)
+        return nil unless expr.callee.object.type.is_a?(HighIR::ArrayType)
+
+        expr.callee.member
+      end
+    end
+  end
+end
@@ -1,5 +1,9 @@
 # frozen_string_literal: true
 
+require_relative "static_regex_compiler"
+require_relative "json_access_analyzer"
+require_relative "pipeline_fusion_analyzer"
+
 module MLC
   module Backend
     # RuntimePolicy - конфигурация стратегий lowering
@@ -22,6 +26,9 @@ module MLC
       attr_accessor :use_gcc_extensions            # Использовать ли ({ }) expressions
       attr_accessor :error_model                   # :expected или :exceptions
       attr_accessor :always_use_runtime            # Всегда использовать runtime для collections
+      attr_accessor :regex_strategy                # :runtime (mlc::Regex) или :static (mlc::ct, compile-time)
+      attr_accessor :json_strategy                 # :dom (всегда parse_json) или :lazy (курсоры для json_get-цепочек)
+      attr_accessor :pipeline_strategy             # :fused (цепочки map/filter/fold в один цикл) или :eager (вектор на каждом шаге)
 
       def initialize
         # По умолчанию: консервативная стратегия (используем IIFE везде)
@@ -33,6 +40,9 @@ module MLC
         @use_gcc_extensions = false              # ({ }) работает только в GCC
         @error_model = :expected                 # Когда добавим Expected<T,E>
         @always_use_runtime = true               # map/filter/fold всегда через runtime
+        @regex_strategy = :runtime               # :static - regex-ветки match через шаблоны mlc::ct
+        @json_strategy = :dom                    # :lazy - mlc::json::LazyValue; не проверяет скаляры в пропущенных значениях
+        @pipeline_strategy = :fused              # :eager - отключить mlc::collections::lazy
       end
 
       # Выбрать стратегию для block expression
@@ -69,6 +79,27 @@ module MLC
         end
       end
 
+      # Выбрать реализацию для regex-литерала: шаблон mlc::ct или nil (runtime mlc::Regex)
+      def static_regex_for(pattern, flags)
+        return nil unless @regex_strategy == :static
+
+        StaticRegexCompiler.compile(pattern, flags)
+      end
+
+      # Выбрать let-привязки parse_json, которые можно читать лениво (mlc::json::LazyValue)
+      def lazy_json_bindings(body, user_functions = [])
+        return [] unless @json_strategy == :lazy
+
+        JsonAccessAnalyzer.new(body, user_functions: user_functions).lazy_bindings
+      end
+
+      # Выбрать цепочки map/filter/fold, которые lowering сливает в один проход (mlc::collections::lazy)
+      def pipeline_plans(body, call_effects = PipelineFusionAnalyzer::CallEffects.new)
+        return {} unless @pipeline_strategy == :fused
+
+        PipelineFusionAnalyzer.new(body, call_effects: call_effects).plans
+      end
+
       # Клонировать с изменениями
       def with(**overrides)
         copy = self.dup
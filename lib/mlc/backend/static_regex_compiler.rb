@@ -0,0 +1,436 @@
+# frozen_string_literal: true
+
+module MLC
+  module Backend
+    # StaticRegexCompiler - translates a regex literal into a compile-time
+    # matcher type from runtime/mlc_regex_static.hpp (mlc::ct::*).
+    #
+    # Static matchers repeat possessively, so only patterns where that equals
+    # ordinary backtracking are accepted: every repeated item must be
+    # non-empty, free of alternation/nested repeats, and unable to start what
+    # follows it. Anything else (including constructs the runtime engine
+    # handles through std::regex) returns nil and stays on mlc::Regex.
+    class StaticRegexCompiler
+      class Unsupported < StandardError; end
+
+      Result = Struct.new(:type, :groups, keyword_init: true)
+
+      ALL_BYTES = (1 << 256) - 1
+      MAX_NODES = 96
+
+      # Follow context of a node: bytes that can come next, whether the rest of
+      # the pattern can match without consuming, and the assertions on that path
+      Follow = Struct.new(:bytes, :nullable, :asserts)
+
+      def self.compile(pattern, flags = "")
+        new(pattern, flags.to_s.include?("i")).compile
+      end
+
+      def initialize(pattern, icase)
+        @src = pattern.to_s.b
+        @icase = icase
+        @pos = 0
+        @groups = 0
+        @nodes = 0
+      end
+
+      def compile
+        root = parse_alternation
+        raise Unsupported, "unmatched )" unless at_end?
+        raise Unsupported, "pattern too large" if @nodes > MAX_NODES
+
+        check(root, Follow.new(0, true, []))
+        Result.new(type: "mlc::ct::Regex<#{emit(root)}, #{@groups}>", groups: @groups)
+      rescue Unsupported
+        nil
+      end
+
+      private
+
+      # ----------------------------------------------------------------------
+      # Parser (same ECMAScript subset as runtime/mlc_regex_engine.hpp)
+      # ----------------------------------------------------------------------
+
+      def at_end?
+        @pos >= @src.bytesize
+      end
+
+      def peek
+        @src.getbyte(@pos)
+      end
+
+      def consume(char)
+        return false if at_end? || peek != char.ord
+
+        @pos += 1
+        true
+      end
+
+      def node(*parts)
+        @nodes += 1
+        parts
+      end
+
+      def parse_alternation
+        branches = [parse_concat]
+        branches << parse_concat while consume("|")
+        branches.size == 1 ? branches.first : node(:alt, branches)
+      end
+
+      def parse_concat
+        items = []
+        items << parse_repeat until at_end? || peek == "|".ord || peek == ")".ord
+        items.size == 1 ? items.first : node(:seq, items)
+      end
+
+      def parse_repeat
+        atom = parse_atom
+        loop do
+          break if at_end?
+
+          min, max =
+            case peek.chr
+            when "*" then @pos += 1; [0, nil]
+            when "+" then @pos += 1; [1, nil]
+            when "?" then @pos += 1; [0, 1]
+            when "{" then parse_braces || break
+            else break
+            end
+          raise Unsupported, "lazy quantifier" if consume("?")
+          raise Unsupported, "nothing to repeat" if atom.first == :assert
+
+          atom = node(:repeat, min, max, atom)
+        end
+        atom
+      end
+
+      def parse_braces
+        match = @src.byteslice(@pos..).match(/\A\{(\d+)(,(\d*))?\}/n)
+        return nil unless match
+
+        @pos += match[0].bytesize
+        min = match[1].to_i
+        max = match[2].nil? ? min : (match[3].empty? ? nil : match[3].to_i)
+        raise Unsupported, "bad range" if max && max < min
+
+        [min, max]
+      end
+
+      def parse_atom
+        char = peek.chr
+        @pos += 1
+        case char
+        when "("
+          index = nil
+          if consume("?")
+            raise Unsupported, "group syntax" unless consume(":")
+          else
+            index = (@groups += 1)
+          end
+          inner = parse_alternation
+          raise Unsupported, "missing )" unless consume(")")
+          node(:group, index, inner)
+        when ")", "*", "+", "?"
+          raise Unsupported, "unexpected #{char}"
+        when "["
+          node(:set, parse_class)
+        when "."
+          node(:set, ALL_BYTES & ~(byte_bit("\n".ord) | byte_bit("\r".ord)))
+        when "^"
+          node(:assert, :line_start)
+        when "$"
+          node(:assert, :line_end)
+        when "\\"
+          parse_escape
+        else
+          node(:set, literal_bits(char.ord))
+        end
+      end
+
+      def parse_escape
+        raise Unsupported, "trailing backslash" if at_end?
+
+        char = peek.chr
+        @pos += 1
+        return node(:assert, :word_boundary) if char == "b"
+        return node(:assert, :not_word_boundary) if char == "B"
+
+        node(:set, escape_bits(char))
+      end
+
+      def escape_bits(char)
+        case char
+        when "d" then digit_bits
+        when "D" then ALL_BYTES & ~digit_bits
+        when "w" then word_bits
+        when "W" then ALL_BYTES & ~word_bits
+        when "s" then space_bits
+        when "S" then ALL_BYTES & ~space_bits
+        when "n" then literal_bits(10)
+        when "r" then literal_bits(13)
+        when "t" then literal_bits(9)
+        when "f" then literal_bits(12)
+        when "v" then literal_bits(11)
+        when "0" then literal_bits(0)
+        when "x" then literal_bits(parse_hex(2))
+        when "u"
+          code = parse_hex(4)
+          raise Unsupported, "non-ASCII escape" if code >= 0x80
+
+          literal_bits(code)
+        when "c"
+          raise Unsupported, "control escape" if at_end? || !peek.chr.match?(/[A-Za-z]/)
+
+          @pos += 1
+          literal_bits(@src.getbyte(@pos - 1) % 32)
+        else
+          raise Unsupported, "escape \\#{char}" if char.match?(/[A-Za-z0-9]/)
+
+          literal_bits(char.ord)
+        end
+      end
+
+      def parse_hex(digits)
+        text = @src.byteslice(@pos, digits)
+        raise Unsupported, "hex escape" unless text&.match?(/\A[0-9A-Fa-f]{#{digits}}\z/)
+
+        @pos += digits
+        text.to_i(16)
+      end
+
+      def parse_class
+        negated = consume("^")
+        bits = 0
+        loop do
+          raise Unsupported, "missing ]" if at_end?
+          break if consume("]")
+
+          item, single = parse_class_atom
+          if single && !at_end? && peek == "-".ord && @src.getbyte(@pos + 1) && @src.getbyte(@pos + 1) != "]".ord
+            @pos += 1
+            _hi_item, hi = parse_class_atom
+            raise Unsupported, "bad class range" if hi.nil? || hi < single
+
+            (single..hi).each { |b| bits |= byte_bit(b) }
+          else
+            bits |= item
+          end
+        end
+        bits = fold_case(bits) if @icase
+        negated ? ALL_BYTES & ~bits : bits
+      end
+
+      # Returns [bits, single_byte_or_nil]
+      def parse_class_atom
+        byte = peek
+        @pos += 1
+        return [byte_bit(byte), byte] unless byte == "\\".ord
+
+        raise Unsupported, "trailing backslash" if at_end?
+
+        char = peek.chr
+        @pos += 1
+        return [byte_bit(8), 8] if char == "b"
+        return [byte_bit("-".ord), "-".ord] if char == "-"
+
+        saved = @icase
+        @icase = false
+        bits = escape_bits(char)
+        @icase = saved
+        single = "dDwWsS".include?(char) ? nil : bits.bit_length - 1
+        [bits, single]
+      end
+
+      def byte_bit(byte)
+        1 << byte
+      end
+
+      def literal_bits(byte)
+        bits = byte_bit(byte)
+        @icase ? fold_case(bits) : bits
+      end
+
+      def range_bits(low, high)
+        (low.ord..high.ord).sum { |b| byte_bit(b) }
+      end
+
+      def digit_bits
+        range_bits("0", "9")
+      end
+
+      def word_bits
+        range_bits("a", "z") | range_bits("A", "Z") | digit_bits | byte_bit("_".ord)
+      end
+
+      def space_bits
+        [" ", "\t", "\n", "\v", "\f", "\r"].sum { |c| byte_bit(c.ord) }
+      end
+
+      def fold_case(bits)
+        ("a".ord.."z".ord).each do |lower|
+          upper = lower - 32
+          bits |= byte_bit(lower) | byte_bit(upper) if bits[lower] == 1 || bits[upper] == 1
+        end
+        bits
+      end
+
+      # ----------------------------------------------------------------------
+      # Possessive-safety analysis
+      # ----------------------------------------------------------------------
+
+      def first(ast)
+        case ast.first
+        when :set then ast[1]
+        when :assert then 0
+        when :group then first(ast[2])
+        when :repeat then ast[1].zero? && ast[2] == 0 ? 0 : first(ast[3])
+        when :alt then ast[1].sum(0) { |branch| first(branch) }
+        when :seq
+          bits = 0
+          ast[1].each do |item|
+            bits |= first(item)
+            break unless nullable?(item)
+          end
+          bits
+        end
+      end
+
+      def nullable?(ast)
+        case ast.first
+        when :set then false
+        when :assert then true
+        when :group then nullable?(ast[2])
+        when :repeat then ast[1].zero? || nullable?(ast[3])
+        when :alt then ast[1].any? { |branch| nullable?(branch) }
+        when :seq then ast[1].all? { |item| nullable?(item) }
+        end
+      end
+
+      def assertions(ast)
+        case ast.first
+        when :set then []
+        when :assert then [ast[1]]
+        when :group then assertions(ast[2])
+        when :repeat then assertions(ast[3])
+        when :alt, :seq then ast[1].flat_map { |item| assertions(item) }
+        end
+      end
+
+      # Deterministic body: a fixed sequence of bytes, classes and captures
+      def deterministic?(ast)
+        case ast.first
+        when :set then true
+        when :group then deterministic?(ast[2])
+        when :seq then ast[1].all? { |item| deterministic?(item) }
+        else false
+        end
+      end
+
+      def check(ast, follow)
+        case ast.first
+        when :group
+          check(ast[2], follow)
+        when :alt
+          ast[1].each { |branch| check(branch, follow) }
+        when :seq
+          ast[1].reverse_each do |item|
+            check(item, follow)
+            follow = if nullable?(item)
+                       Follow.new(first(item) | follow.bytes, follow.nullable, follow.asserts + assertions(item))
+                     else
+                       Follow.new(first(item), false, [])
+                     end
+          end
+        when :repeat
+          body = ast[3]
+          raise Unsupported, "repeated item must be a fixed sequence" unless deterministic?(body)
+          raise Unsupported, "repeated item can be empty" if nullable?(body)
+          raise Unsupported, "repeated item overlaps what follows" unless (first(body) & follow.bytes).zero?
+          raise Unsupported, "assertion after repetition" if follow.nullable && !(follow.asserts - [:line_end]).empty?
+        end
+      end
+
+      # ----------------------------------------------------------------------
+      # Emission
+      # ----------------------------------------------------------------------
+
+      def emit(ast)
+        case ast.first
+        when :set then "mlc::ct::Class<#{emit_set(ast[1])}>"
+        when :assert then emit_assert(ast[1])
+        when :group
+          inner = emit(ast[2])
+          ast[1] ? "mlc::ct::Group<#{ast[1]}, #{inner}>" : inner
+        when :repeat
+          max = ast[2].nil? ? "mlc::ct::kInf" : ast[2].to_s
+          "mlc::ct::Repeat<#{ast[1]}, #{max}, #{emit(ast[3])}>"
+        when :alt then "mlc::ct::Alt<#{ast[1].map { |b| emit(b) }.join(', ')}>"
+        when :seq then emit_seq(ast[1])
+        end
+      end
+
+      # Runs of single bytes become one Lit<...>
+      def emit_seq(items)
+        parts = []
+        literal = []
+        flush = lambda do
+          if literal.size == 1
+            parts << "mlc::ct::Class<mlc::ct::Ch<#{literal.first}>>"
+          elsif literal.size > 1
+            parts << "mlc::ct::Lit<#{literal.join(',')}>"
+          end
+          literal = []
+        end
+
+        items.each do |item|
+          if item.first == :set && single_byte(item[1])
+            literal << single_byte(item[1])
+          else
+            flush.call
+            parts << emit(item)
+          end
+        end
+        flush.call
+
+        parts.size == 1 ? parts.first : "mlc::ct::Seq<#{parts.join(', ')}>"
+      end
+
+      def single_byte(bits)
+        bits.positive? && (bits & (bits - 1)).zero? ? bits.bit_length - 1 : nil
+      end
+
+      def emit_set(bits)
+        byte = single_byte(bits)
+        return "mlc::ct::Ch<#{byte}>" if byte
+
+        members = (0..255).count { |b| bits[b] == 1 }
+        return "mlc::ct::NotSet<#{emit_ranges(ALL_BYTES & ~bits)}>" if members > 128
+
+        "mlc::ct::Set<#{emit_ranges(bits)}>"
+      end
+
+      def emit_ranges(bits)
+        ranges = []
+        byte = 0
+        while byte < 256
+          if bits[byte] == 1
+            start = byte
+            byte += 1 while byte + 1 < 256 && bits[byte + 1] == 1
+            ranges << (start == byte ? "mlc::ct::Ch<#{start}>" : "mlc::ct::Range<#{start},#{byte}>")
+          end
+          byte += 1
+        end
+        ranges.join(", ")
+      end
+
+      def emit_assert(kind)
+        {
+          line_start: "mlc::ct::LineStart",
+          line_end: "mlc::ct::LineEnd",
+          word_boundary: "mlc::ct::WordBoundary",
+          not_word_boundary: "mlc::ct::NotWordBoundary"
+        }.fetch(kind)
+      end
+    end
+  end
+end
@@ -389,13 +389,20 @@ module MLC
     
     # Type declaration
     class TypeDecl < Node
-      attr_reader :name, :type, :type_params
+      attr_reader :name, :type, :type_params, :derives
 
-      def initialize(name:, type:, type_params: [], origin: nil)
+      def initialize(name:, type:, type_params: [], derives: [], origin: nil)
         super(origin: origin)
         @name = name
         @type = type
         @type_params = type_params  # Array of TypeParam
+        @derives = derives          # Array of String (e.g. "Json")
+      end
+
+      # Prefix of the functions `derive Json` generates: HttpRequest -> http_request
+      # (http_request_to_json / http_request_from_json)
+      def self.json_function_prefix(type_name)
+        type_name.gsub(/([A-Z]+)([A-Z][a-z])/, '\1_\2').gsub(/([a-z\d])([A-Z])/, '\1_\2').downcase
       end
     end
 
@@ -155,7 +155,7 @@ module MLC
         # String and collection types are not literal types in C++20
         type.name == "string" ||
           type.name == "String" ||
-          type.name =~ /^(Array|Vec|HashMap|HashSet)$/
+          type.name =~ /^(Array|Vec|HashMap|HashSet|JsonValue)$/
       end
 
       def pure_block_expr?(block_expr)
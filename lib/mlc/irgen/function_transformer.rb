@@ -469,7 +469,44 @@ module MLC
         program = context[:program]
 
         program.declarations.each do |decl|
-          register_function_signature(decl) if decl.is_a?(AST::FuncDecl)
+          case decl
+          when AST::FuncDecl
+            register_function_signature(decl)
+          when AST::TypeDecl
+            register_derived_functions(decl)
+          end
+        end
+      end
+
+      # `derive Json` gives a record or sum type T a pair of functions whose
+      # bodies come with the type's C++ lowering (TypeLowerer):
+      #   <t>_to_json(value: T) -> str
+      #   <t>_from_json(text: str, fallback: T) -> T   (fallback when text does not decode)
+      def register_derived_functions(decl)
+        decl.derives.each do |capability|
+          with_current_node(decl) do
+            type_error("Unknown derive '#{capability}' on type '#{decl.name}'") unless capability == "Json"
+            type_error("derive Json is not supported on generic type '#{decl.name}'") if decl.type_params.any?
+            unless decl.type.is_a?(AST::RecordType) || decl.type.is_a?(AST::SumType)
+              type_error("derive Json needs a record or sum type, '#{decl.name}' is neither")
+            end
+          end
+
+          prefix = HighIR::TypeDecl.json_function_prefix(decl.name)
+          self_type = AST::PrimType.new(name: decl.name, origin: decl.origin)
+          str_type = AST::PrimType.new(name: "str", origin: decl.origin)
+          signatures = {
+            "#{prefix}_to_json" => [[AST::Param.new(name: "value", type: self_type)], str_type],
+            "#{prefix}_from_json" => [
+              [AST::Param.new(name: "text", type: str_type), AST::Param.new(name: "fallback", type: self_type)],
+              self_type
+            ]
+          }
+          signatures.each do |name, (params, ret_type)|
+            register_function_signature(
+              AST::FuncDecl.new(name: name, params: params, ret_type: ret_type, exported: decl.exported, origin: decl.origin)
+            )
+          end
         end
       end
       def pass_lower_declarations(context)
@@ -570,7 +607,7 @@ module MLC
           end
 
           # Create TypeDecl
-          type_decl = HighIR::TypeDecl.new(name: decl.name, type: type, type_params: type_params)
+          type_decl = HighIR::TypeDecl.new(name: decl.name, type: type, type_params: type_params, derives: decl.derives)
 
           @rule_engine.apply(
             :core_ir_type_decl,
@@ -177,8 +177,12 @@ module MLC
               accumulator_type = args.first&.type
               ensure_type!(accumulator_type, "Unable to determine accumulator type for fold")
               accumulator_type
+            when "sum"
+              ensure_argument_count(member, args, 0)
+              ensure_numeric_type(object_type.element_type, "Array element for sum")
+              object_type.element_type
             else
-              type_error("Unknown array method '#{member}'. Supported methods: length, size, is_empty, map, filter, fold")
+              type_error("Unknown array method '#{member}'. Supported methods: length, size, is_empty, map, filter, fold, sum")
             end
           elsif string_type?(object_type)
             case member
@@ -255,10 +259,10 @@ module MLC
             HighIR::Builder.primitive_type("i32")
           when "is_empty"
             HighIR::Builder.primitive_type("bool")
-          when "map", "filter", "fold"
+          when "map", "filter", "fold", "sum"
             HighIR::Builder.function_type([], HighIR::Builder.primitive_type("auto"))
           else
-            type_error("Unknown array member '#{member}'. Known members: length, size, is_empty, map, filter, fold", node: node)
+            type_error("Unknown array member '#{member}'. Known members: length, size, is_empty, map, filter, fold, sum", node: node)
           end
         elsif string_type?(object_type)
           case member
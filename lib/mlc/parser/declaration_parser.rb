@@ -297,7 +297,24 @@ module MLC
                AST::OpaqueType.new(name: name)
              end
 
-      with_origin(name_token) { AST::TypeDecl.new(name: name, type: type, type_params: type_params, exported: exported) }
+      derives = parse_derive_clause
+
+      with_origin(name_token) do
+        AST::TypeDecl.new(name: name, type: type, type_params: type_params, exported: exported, derives: derives)
+      end
+    end
+
+    # Optional trailing `derive Json, ...` after a type definition
+    def parse_derive_clause
+      return [] unless current.type == :IDENTIFIER && current.value == "derive"
+
+      consume(:IDENTIFIER)
+      derives = [consume(:IDENTIFIER).value]
+      while current.type == :COMMA
+        consume(:COMMA)
+        derives << consume(:IDENTIFIER).value
+      end
+      derives
     end
 
     end
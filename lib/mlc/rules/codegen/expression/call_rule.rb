@@ -12,7 +12,8 @@ module MLC
         # 1. IO functions (print, println, etc.)
         # 2. Stdlib function overrides (to_f32, etc.)
         # 3. Qualified functions (via function_registry or stdlib_scanner)
-        # 4. Array method calls (length, push, map, filter, fold, etc.)
+        # 4. Array method calls (length, push, map, filter, fold, etc.),
+        #    with map/filter chains fused into one mlc::collections::lazy pass
         # 5. Regular function calls
         class CallRule < BaseRule
           include MLC::Backend::CodeGenHelpers
@@ -66,17 +67,29 @@ module MLC
                 if qualified_name
                   args = node.args.map { |arg| lowerer.send(:lower_expression, arg) }
                   num_separators = [args.size - 1, 0].max
-                  return CppAst::Nodes::FunctionCallExpression.new(
+                  call = CppAst::Nodes::FunctionCallExpression.new(
                     callee: CppAst::Nodes::Identifier.new(name: qualified_name),
                     arguments: args,
                     argument_separators: Array.new(num_separators, ", ")
                   )
+                  return call unless streaming_call?(call)
+                  return call if lowerer.respond_to?(:streamed_iterable?, true) && lowerer.send(:streamed_iterable?, node)
+
+                  # Used as a value: collect the stream into the str[] it is typed as
+                  return CppAst::Nodes::FunctionCallExpression.new(
+                    callee: CppAst::Nodes::Identifier.new(name: "std::vector<mlc::String>"),
+                    arguments: [call],
+                    argument_separators: []
+                  )
                 end
               end
             end
 
             # Check for array method calls
             if node.callee.is_a?(MLC::HighIR::MemberExpr) && node.callee.object.type.is_a?(MLC::HighIR::ArrayType)
+              plan = lowerer.respond_to?(:pipeline_plan, true) && lowerer.send(:pipeline_plan, node)
+              return lower_pipeline(plan, lowerer) if plan
+
               return lower_array_method_call(node, lowerer)
             end
 
@@ -126,6 +139,44 @@ module MLC
             end
           end
 
+          # Lower a fused chain (see PipelineFusionAnalyzer):
+          # xs.map(f).filter(g).fold(init, h) -> mlc::collections::lazy(xs).map(f).filter(g).fold(init, h)
+          # As a for-loop iterable the chain is left unterminated and pulled by the loop.
+          def lower_pipeline(plan, lowerer)
+            pipeline = CppAst::Nodes::FunctionCallExpression.new(
+              callee: CppAst::Nodes::Identifier.new(name: "mlc::collections::lazy"),
+              arguments: [lowerer.send(:lower_expression, plan.source)],
+              argument_separators: []
+            )
+            plan.stages.each do |stage|
+              pipeline = member_call(pipeline, stage.callee.member, stage.args, lowerer)
+            end
+
+            case plan.terminal
+            when :fold, :sum
+              member_call(pipeline, plan.terminal.to_s, plan.terminal_call.args, lowerer)
+            when :count
+              member_call(pipeline, "count", [], lowerer)
+            when :collect
+              member_call(pipeline, "collect", [], lowerer)
+            else
+              pipeline
+            end
+          end
+
+          def member_call(object, member, args, lowerer)
+            arguments = args.map { |arg| lowerer.send(:lower_expression, arg) }
+            CppAst::Nodes::FunctionCallExpression.new(
+              callee: CppAst::Nodes::MemberAccessExpression.new(
+                object: object,
+                operator: ".",
+                member: CppAst::Nodes::Identifier.new(name: member)
+              ),
+              arguments: arguments,
+              argument_separators: Array.new([arguments.size - 1, 0].max, ", ")
+            )
+          end
+
           # Lower array method calls (length, push, map, filter, fold, etc.)
           def lower_array_method_call(call, lowerer)
             method_name = call.callee.member
@@ -223,6 +274,14 @@ module MLC
                 argument_separators: separators
               )
 
+            when "sum"
+              # arr.sum() -> mlc::collections::sum(arr)
+              CppAst::Nodes::FunctionCallExpression.new(
+                callee: CppAst::Nodes::Identifier.new(name: "mlc::collections::sum"),
+                arguments: [array_obj],
+                argument_separators: []
+              )
+
             else
               # Fallback: call method directly
               member_access = CppAst::Nodes::MemberAccessExpression.new(
@@ -29,7 +29,7 @@ module MLC
 
             if has_regex
               # Generate if-else chain for regex matching
-              lower_match_with_regex(node, scrutinee, lowerer)
+              lower_match_with_regex(node, scrutinee, lowerer, context[:runtime_policy])
             else
               # Generate MatchExpression with std::visit
               arms = node.arms.map { |arm| lower_match_arm(arm, lowerer) }
@@ -45,24 +45,58 @@ module MLC
           private
 
           # Lower match with regex patterns to IIFE with if-else chain
-          def lower_match_with_regex(match_expr, scrutinee, lowerer)
+          def lower_match_with_regex(match_expr, scrutinee, lowerer, runtime_policy = nil)
             # Generate an IIFE (Immediately Invoked Function Expression) lambda
             # that contains if-else chain for regex matching:
             # [&]() {
-            #   if (regex1.test(scrutinee)) return value1;
-            #   if (regex2.test(scrutinee)) return value2;
+            #   static const mlc::Regex mlc_re_0 = mlc::regex(...);
+            #   static const mlc::Regex mlc_re_1 = mlc::regex(...);
+            #   if (mlc_re_0.test(scrutinee)) return value1;
+            #   if (mlc_re_1.test(scrutinee)) return value2;
             #   return default_value;
             # }()
+            #
+            # Regexes are function-local statics: compiled once on first
+            # evaluation (thread-safe initialization), not on every match.
+            #
+            # Two or more leading regex arms are combined into an mlc::RegexSet
+            # so the scrutinee is scanned once; captures are extracted only for
+            # the arm that won:
+            #   static const mlc::RegexSet mlc_re_set{mlc_re_0, mlc_re_1};
+            #   switch (mlc_re_set.first_match(scrutinee)) { case 0: return value1; ... }
+            #
+            # With RuntimePolicy#regex_strategy = :static, eligible patterns become
+            # compile-time matchers instead (static constexpr mlc::ct::Regex<...>)
+            # and are tested in order; the set is only used for runtime regexes.
 
             statements = []
+            regex_decls = []
+            set_cases = []
 
-            match_expr.arms.each do |arm|
+            static_regexes = match_expr.arms.map do |arm|
+              pattern = arm[:pattern]
+              next nil unless pattern[:kind] == :regex && runtime_policy
+
+              runtime_policy.static_regex_for(pattern[:pattern], pattern[:flags])
+            end
+
+            leading_regex_arms = match_expr.arms.take_while { |arm| arm[:pattern][:kind] == :regex }.size
+            use_regex_set = leading_regex_arms >= 2 && static_regexes.none?
+
+            match_expr.arms.each_with_index do |arm, index|
               pattern = arm[:pattern]
               body = lowerer.send(:lower_expression, arm[:body])
 
               case pattern[:kind]
               when :regex
-                statements.concat(build_regex_arm_statements(pattern, body, scrutinee))
+                regex_name = "mlc_re_#{regex_decls.size}"
+                regex_decls << build_static_regex_decl(regex_name, pattern, static_regexes[index])
+
+                if use_regex_set && index < leading_regex_arms
+                  set_cases << build_regex_set_case(index, pattern, body, scrutinee, regex_name)
+                else
+                  statements.concat(build_regex_arm_statements(pattern, body, scrutinee, regex_name))
+                end
 
               when :wildcard, :var
                 # Default case - just return
@@ -75,8 +109,41 @@ module MLC
               end
             end
 
+            if use_regex_set
+              set_names = (0...leading_regex_arms).map { |i| "mlc_re_#{i}" }
+              regex_decls << CppAst::Nodes::VariableDeclaration.new(
+                type: "mlc::RegexSet",
+                declarators: ["mlc_re_set{#{set_names.join(', ')}}"],
+                declarator_separators: [],
+                type_suffix: " ",
+                prefix_modifiers: "static const "
+              )
+
+              first_match = CppAst::Nodes::FunctionCallExpression.new(
+                callee: CppAst::Nodes::MemberAccessExpression.new(
+                  object: CppAst::Nodes::Identifier.new(name: "mlc_re_set"),
+                  member: CppAst::Nodes::Identifier.new(name: "first_match"),
+                  operator: "."
+                ),
+                arguments: [scrutinee],
+                argument_separators: []
+              )
+
+              statements.unshift(
+                CppAst::Nodes::SwitchStatement.new(
+                  expression: first_match,
+                  cases: set_cases,
+                  switch_suffix: " ",
+                  rparen_suffix: "",
+                  lbrace_prefix: " ",
+                  lbrace_suffix: " ",
+                  rbrace_prefix: ""
+                )
+              )
+            end
+
             # Build body string from statements
-            body_str = statements.map { |stmt| stmt.to_source }.join(" ")
+            body_str = (regex_decls + statements).map { |stmt| stmt.to_source }.join(" ")
 
             # Create IIFE lambda: [&]() { ... }()
             CppAst::Nodes::FunctionCallExpression.new(
@@ -93,21 +160,62 @@ module MLC
             )
           end
 
-          # Build if statements for regex arm
-          def build_regex_arm_statements(pattern, body, scrutinee)
-            regex_pattern = pattern[:pattern]
-            regex_flags = pattern[:flags] || ""
-            bindings = pattern[:bindings] || []
+          # Build `case <index>:` for a regex arm dispatched through mlc::RegexSet.
+          # The set already decided this arm matches, so a plain arm just returns;
+          # a capture arm runs match() on its own regex and breaks out if that
+          # (unexpectedly) fails.
+          def build_regex_set_case(index, pattern, body, scrutinee, regex_name)
+            statements =
+              if (pattern[:bindings] || []).empty?
+                [CppAst::Nodes::ReturnStatement.new(expression: body)]
+              else
+                build_regex_arm_statements(pattern, body, scrutinee, regex_name) + [CppAst::Nodes::BreakStatement.new]
+              end
+
+            CppAst::Nodes::CaseClause.new(
+              value: CppAst::Nodes::NumberLiteral.new(value: index.to_s),
+              statements: statements,
+              statement_trailings: Array.new(statements.size, " "),
+              case_suffix: " ",
+              colon_suffix: " "
+            )
+          end
+
+          # Build `static const mlc::Regex name = mlc::regex(...);` for a regex arm,
+          # or `static constexpr mlc::ct::Regex<...> name{};` for a compile-time matcher
+          def build_static_regex_decl(name, pattern, static_regex = nil)
+            if static_regex
+              return CppAst::Nodes::VariableDeclaration.new(
+                type: static_regex.type,
+                declarators: ["#{name}{}"],
+                declarator_separators: [],
+                type_suffix: " ",
+                prefix_modifiers: "static constexpr "
+              )
+            end
 
-            # Create regex object
-            pattern_string = build_aurora_string(regex_pattern)
+            regex_flags = pattern[:flags] || ""
             func_name = regex_flags.include?("i") ? "mlc::regex_i" : "mlc::regex"
             regex_obj = CppAst::Nodes::FunctionCallExpression.new(
               callee: CppAst::Nodes::Identifier.new(name: func_name),
-              arguments: [pattern_string],
+              arguments: [build_aurora_string(pattern[:pattern])],
               argument_separators: []
             )
 
+            CppAst::Nodes::VariableDeclaration.new(
+              type: "mlc::Regex",
+              declarators: ["#{name} = #{regex_obj.to_source}"],
+              declarator_separators: [],
+              type_suffix: " ",
+              prefix_modifiers: "static const "
+            )
+          end
+
+          # Build if statements for regex arm
+          def build_regex_arm_statements(pattern, body, scrutinee, regex_name)
+            bindings = pattern[:bindings] || []
+            regex_obj = CppAst::Nodes::Identifier.new(name: regex_name)
+
             if bindings.empty?
               # No capture groups - use test()
               test_call = CppAst::Nodes::MemberAccessExpression.new(
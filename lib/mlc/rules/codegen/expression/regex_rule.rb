@@ -27,11 +27,26 @@ module MLC
                           "mlc::regex"
                         end
 
-            CppAst::Nodes::FunctionCallExpression.new(
+            regex_obj = CppAst::Nodes::FunctionCallExpression.new(
               callee: CppAst::Nodes::Identifier.new(name: func_name),
               arguments: [pattern_string],
               argument_separators: []
             )
+
+            # Hoist the literal into a function-local static so it is compiled once:
+            # []() -> const mlc::Regex& { static const mlc::Regex re = ...; return re; }()
+            CppAst::Nodes::FunctionCallExpression.new(
+              callee: CppAst::Nodes::LambdaExpression.new(
+                capture: "",
+                parameters: "",
+                specifiers: " -> const mlc::Regex&",
+                body: "static const mlc::Regex re = #{regex_obj.to_source}; return re;",
+                capture_suffix: "",
+                params_suffix: ""
+              ),
+              arguments: [],
+              argument_separators: []
+            )
           end
         end
       end
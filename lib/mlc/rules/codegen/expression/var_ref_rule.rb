@@ -8,7 +8,7 @@ module MLC
     module CodeGen
       module Expression
         # Rule for lowering HighIR variable references to C++ identifiers
-        # Pure function - all logic contained, no delegation
+        # Last uses found by LinearUseAnalyzer are wrapped in std::move
         class VarRefRule < BaseRule
           include MLC::Backend::CodeGenHelpers
 
@@ -16,14 +16,23 @@ module MLC
             node.is_a?(MLC::HighIR::VarExpr)
           end
 
-          def apply(node, _context = {})
+          def apply(node, context = {})
             case node.name
             when "true"
               CppAst::Nodes::BooleanLiteral.new(value: true)
             when "false"
               CppAst::Nodes::BooleanLiteral.new(value: false)
             else
-              CppAst::Nodes::Identifier.new(name: sanitize_identifier(node.name))
+              identifier = CppAst::Nodes::Identifier.new(name: sanitize_identifier(node.name))
+              lowerer = context[:lowerer]
+              return identifier unless lowerer.respond_to?(:moved_use?, true) && lowerer.send(:moved_use?, node)
+
+              # Last use of a value the callee may update in place
+              CppAst::Nodes::FunctionCallExpression.new(
+                callee: CppAst::Nodes::Identifier.new(name: "std::move"),
+                arguments: [identifier],
+                argument_separators: []
+              )
             end
           end
         end
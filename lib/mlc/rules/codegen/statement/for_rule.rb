@@ -25,15 +25,36 @@ module MLC
             lowerer = context[:lowerer]
 
             # Lower container expression
-            container = lowerer.send(:lower_expression, for_stmt.iterable)
+            container = if lowerer.respond_to?(:lower_iterable, true)
+                          lowerer.send(:lower_iterable, for_stmt.iterable)
+                        else
+                          lowerer.send(:lower_expression, for_stmt.iterable)
+                        end
 
             # Map variable type to C++ (using lowerer's map_type)
             var_type_str = lowerer.send(:map_type, for_stmt.var_type)
-            variable = MLC::Backend::ForLoopVariable.new(var_type_str, sanitize_identifier(for_stmt.var_name))
+            var_name = sanitize_identifier(for_stmt.var_name)
 
             # Lower body
             body_block = lower_for_body(for_stmt.body, lowerer)
 
+            if streaming_call?(container)
+              # A stream yields views that the next step invalidates; the body
+              # gets its own copy
+              view_name = "#{var_name}_view"
+              variable = MLC::Backend::ForLoopVariable.new("std::string_view", view_name)
+              copy = CppAst::Nodes::VariableDeclaration.new(
+                type: var_type_str,
+                declarators: ["#{var_name}(#{view_name})"],
+                prefix_modifiers: "const ",
+                type_suffix: " "
+              )
+              body_block.statements.unshift(copy)
+              body_block.statement_trailings.unshift("\n")
+            else
+              variable = MLC::Backend::ForLoopVariable.new(var_type_str, var_name)
+            end
+
             CppAst::Nodes::RangeForStatement.new(
               variable: variable,
               container: container,
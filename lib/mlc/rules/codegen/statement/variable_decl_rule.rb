@@ -25,14 +25,26 @@ module MLC
             # Lower initializer expression
             init_expr = lowerer.send(:lower_expression, node.value)
 
+            # A parsed document only read through json_get chains stays unparsed
+            if lowerer.send(:lazy_json_binding?, node)
+              type_str = "mlc::json::LazyValue"
+              use_auto = false
+              init_expr = CppAst::Nodes::FunctionCallExpression.new(
+                callee: CppAst::Nodes::Identifier.new(name: "mlc::json::json_lazy"),
+                arguments: init_expr.arguments,
+                argument_separators: init_expr.argument_separators
+              )
+            end
+
             # Build declarator
             decl_type = use_auto ? "auto" : type_str
             identifier = sanitize_identifier(node.name)
             declarator = "#{identifier} = #{init_expr.to_source}"
 
-            # Don't add const for pointer types (they end with *)
+            # Don't add const for pointer types (they end with *) or bindings that are moved from
             is_pointer = type_str.end_with?("*")
-            prefix = (node.mutable || is_pointer) ? "" : "const "
+            moved = lowerer.send(:moved_binding?, node.name)
+            prefix = (node.mutable || is_pointer || moved) ? "" : "const "
 
             CppAst::Nodes::VariableDeclaration.new(
               type: decl_type,
@@ -1,6 +1,8 @@
 #ifndef AURORA_COLLECTIONS_HPP
 #define AURORA_COLLECTIONS_HPP
 
+#include <memory>
+#include <optional>
 #include <vector>
 #include <type_traits>
 #include <utility>
@@ -33,11 +35,212 @@ auto filter(const std::vector<T>& items, Func&& predicate) {
 template <typename T, typename Acc, typename Func>
 Acc fold(const std::vector<T>& items, Acc acc, Func&& reducer) {
     for (const auto& item : items) {
-        acc = reducer(acc, item);
+        acc = reducer(std::move(acc), item);
     }
     return acc;
 }
 
+// Lazy pipelines. The compiler lowers chains such as
+// xs.map(f).filter(g).fold(init, h) to lazy(xs).map(f).filter(g).fold(init, h):
+// each stage wraps the one before it, and a terminal (fold, sum, count,
+// collect) or a range-for pulls the elements through all stages in one loop,
+// so no vector is built between stages. A pipeline over a temporary vector
+// keeps it alive; over a named one it only refers to it.
+
+template <typename T>
+class VectorSource {
+public:
+    using value_type = T;
+
+    explicit VectorSource(const std::vector<T>& items) : items_(&items) {}
+    explicit VectorSource(std::vector<T>&& items)
+        : owned_(std::make_shared<const std::vector<T>>(std::move(items))), items_(owned_.get()) {}
+
+    template <typename Sink>
+    void each(Sink&& sink) const {
+        for (const T& item : *items_) sink(item);
+    }
+
+    size_t size_bound() const { return items_->size(); }
+    static constexpr bool exact_size = true;
+
+    auto begin() const { return items_->begin(); }
+    auto end() const { return items_->end(); }
+
+private:
+    std::shared_ptr<const std::vector<T>> owned_;
+    const std::vector<T>* items_;
+};
+
+template <typename Base, typename Func>
+class MapStage;
+template <typename Base, typename Pred>
+class FilterStage;
+
+// Stages and terminals shared by every pipeline
+template <typename Self>
+class PipelineOps {
+public:
+    template <typename Func>
+    auto map(Func&& func) && {
+        return MapStage<Self, std::decay_t<Func>>(std::move(self()), std::forward<Func>(func));
+    }
+
+    template <typename Pred>
+    auto filter(Pred&& pred) && {
+        return FilterStage<Self, std::decay_t<Pred>>(std::move(self()), std::forward<Pred>(pred));
+    }
+
+    template <typename Acc, typename Func>
+    Acc fold(Acc acc, Func&& reducer) const {
+        self().each([&](auto&& item) { acc = reducer(std::move(acc), std::forward<decltype(item)>(item)); });
+        return acc;
+    }
+
+    auto sum() const {
+        using Value = typename Self::value_type;
+        Value total{};
+        self().each([&](auto&& item) { total += item; });
+        return total;
+    }
+
+    // Runs every stage, as the eager calls would, even when no filter
+    // could change the count
+    size_t count() const {
+        size_t total = 0;
+        self().each([&](auto&&) { ++total; });
+        return total;
+    }
+
+    auto collect() const {
+        std::vector<typename Self::value_type> result;
+        if constexpr (Self::exact_size) result.reserve(self().size_bound());
+        self().each([&](auto&& item) { result.push_back(std::forward<decltype(item)>(item)); });
+        return result;
+    }
+
+private:
+    Self& self() { return static_cast<Self&>(*this); }
+    const Self& self() const { return static_cast<const Self&>(*this); }
+};
+
+template <typename Base, typename Func>
+class MapStage : public PipelineOps<MapStage<Base, Func>> {
+public:
+    using value_type = std::decay_t<std::invoke_result_t<const Func&, const typename Base::value_type&>>;
+
+    MapStage(Base base, Func func) : base_(std::move(base)), func_(std::move(func)) {}
+
+    template <typename Sink>
+    void each(Sink&& sink) const {
+        base_.each([&](auto&& item) { sink(func_(std::forward<decltype(item)>(item))); });
+    }
+
+    size_t size_bound() const { return base_.size_bound(); }
+    static constexpr bool exact_size = Base::exact_size;
+
+    class iterator {
+    public:
+        using BaseIterator = decltype(std::declval<const Base&>().begin());
+
+        iterator(BaseIterator it, const Func* func) : it_(it), func_(func) {}
+        value_type operator*() const { return (*func_)(*it_); }
+        iterator& operator++() {
+            ++it_;
+            return *this;
+        }
+        bool operator!=(const iterator& other) const { return it_ != other.it_; }
+
+    private:
+        BaseIterator it_;
+        const Func* func_;
+    };
+
+    iterator begin() const { return iterator(base_.begin(), &func_); }
+    iterator end() const { return iterator(base_.end(), &func_); }
+
+private:
+    Base base_;
+    Func func_;
+};
+
+template <typename Base, typename Pred>
+class FilterStage : public PipelineOps<FilterStage<Base, Pred>> {
+public:
+    using value_type = typename Base::value_type;
+
+    FilterStage(Base base, Pred pred) : base_(std::move(base)), pred_(std::move(pred)) {}
+
+    template <typename Sink>
+    void each(Sink&& sink) const {
+        base_.each([&](auto&& item) {
+            if (pred_(item)) sink(std::forward<decltype(item)>(item));
+        });
+    }
+
+    size_t size_bound() const { return base_.size_bound(); }
+    static constexpr bool exact_size = false;
+
+    // Dereferencing the base iterator again would run earlier map stages
+    // twice, so the element that passed is kept
+    class iterator {
+    public:
+        using BaseIterator = decltype(std::declval<const Base&>().begin());
+
+        iterator(BaseIterator it, BaseIterator end, const Pred* pred) : it_(it), end_(end), pred_(pred) { advance(); }
+        const value_type& operator*() const { return *current_; }
+        iterator& operator++() {
+            ++it_;
+            advance();
+            return *this;
+        }
+        bool operator!=(const iterator& other) const { return it_ != other.it_; }
+
+    private:
+        BaseIterator it_;
+        BaseIterator end_;
+        const Pred* pred_;
+        std::optional<value_type> current_;
+
+        void advance() {
+            for (; it_ != end_; ++it_) {
+                current_.emplace(*it_);
+                if ((*pred_)(*current_)) return;
+            }
+        }
+    };
+
+    iterator begin() const { return iterator(base_.begin(), base_.end(), &pred_); }
+    iterator end() const { return iterator(base_.end(), base_.end(), &pred_); }
+
+private:
+    Base base_;
+    Pred pred_;
+};
+
+template <typename T>
+class Pipeline : public VectorSource<T>, public PipelineOps<Pipeline<T>> {
+public:
+    using VectorSource<T>::VectorSource;
+};
+
+template <typename T>
+Pipeline<T> lazy(const std::vector<T>& items) {
+    return Pipeline<T>(items);
+}
+
+template <typename T>
+Pipeline<T> lazy(std::vector<T>&& items) {
+    return Pipeline<T>(std::move(items));
+}
+
+template <typename T>
+T sum(const std::vector<T>& items) {
+    T total{};
+    for (const auto& item : items) total += item;
+    return total;
+}
+
 template <typename T>
 bool is_empty(const std::vector<T>& items) {
     return items.empty();
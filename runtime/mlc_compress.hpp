@@ -0,0 +1,926 @@
+#ifndef MLC_COMPRESS_HPP
+#define MLC_COMPRESS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "mlc_string.hpp"
+#include "mlc_buffer.hpp"
+
+// Dependency-free LZ4 compression.
+//
+// Two layers are provided:
+//   * the LZ4 block format (compress_block / decompress_block), plus a
+//     size-prefixed wrapper for Bytes, Buffer and String payloads;
+//   * the LZ4 frame format (FrameWriter / FrameReader) for streaming files.
+//     Frames are interoperable with the reference `lz4` tool.
+
+namespace mlc::compress {
+
+// ============================================================================
+// xxHash32 - checksum used by the LZ4 frame format
+// ============================================================================
+
+class XXH32 {
+private:
+    static constexpr uint32_t P1 = 2654435761U;
+    static constexpr uint32_t P2 = 2246822519U;
+    static constexpr uint32_t P3 = 3266489917U;
+    static constexpr uint32_t P4 = 668265263U;
+    static constexpr uint32_t P5 = 374761393U;
+
+    uint32_t seed_;
+    uint32_t v1_, v2_, v3_, v4_;
+    uint64_t total_;
+    uint8_t mem_[16];
+    size_t mem_size_;
+
+    static uint32_t rotl(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+
+    static uint32_t read32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) |
+               (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) |
+               (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    static uint32_t round(uint32_t acc, uint32_t input) {
+        acc += input * P2;
+        acc = rotl(acc, 13);
+        return acc * P1;
+    }
+
+    void consume_stripe(const uint8_t* p) {
+        v1_ = round(v1_, read32(p));
+        v2_ = round(v2_, read32(p + 4));
+        v3_ = round(v3_, read32(p + 8));
+        v4_ = round(v4_, read32(p + 12));
+    }
+
+public:
+    explicit XXH32(uint32_t seed = 0) { reset(seed); }
+
+    void reset(uint32_t seed = 0) {
+        seed_ = seed;
+        v1_ = seed + P1 + P2;
+        v2_ = seed + P2;
+        v3_ = seed;
+        v4_ = seed - P1;
+        total_ = 0;
+        mem_size_ = 0;
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        if (len == 0) return;
+        total_ += len;
+
+        if (mem_size_ + len < 16) {
+            std::memcpy(mem_ + mem_size_, data, len);
+            mem_size_ += len;
+            return;
+        }
+
+        if (mem_size_ > 0) {
+            size_t fill = 16 - mem_size_;
+            std::memcpy(mem_ + mem_size_, data, fill);
+            consume_stripe(mem_);
+            data += fill;
+            len -= fill;
+            mem_size_ = 0;
+        }
+
+        while (len >= 16) {
+            consume_stripe(data);
+            data += 16;
+            len -= 16;
+        }
+
+        std::memcpy(mem_, data, len);
+        mem_size_ = len;
+    }
+
+    uint32_t digest() const {
+        uint32_t h;
+        if (total_ >= 16) {
+            h = rotl(v1_, 1) + rotl(v2_, 7) + rotl(v3_, 12) + rotl(v4_, 18);
+        } else {
+            h = seed_ + P5;
+        }
+        h += static_cast<uint32_t>(total_);
+
+        size_t i = 0;
+        for (; i + 4 <= mem_size_; i += 4) {
+            h += read32(mem_ + i) * P3;
+            h = rotl(h, 17) * P4;
+        }
+        for (; i < mem_size_; i++) {
+            h += mem_[i] * P5;
+            h = rotl(h, 11) * P1;
+        }
+
+        h ^= h >> 15;
+        h *= P2;
+        h ^= h >> 13;
+        h *= P3;
+        h ^= h >> 16;
+        return h;
+    }
+
+    static uint32_t hash(const uint8_t* data, size_t len, uint32_t seed = 0) {
+        XXH32 state(seed);
+        state.update(data, len);
+        return state.digest();
+    }
+};
+
+// ============================================================================
+// LZ4 block format
+// ============================================================================
+
+namespace detail {
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t LAST_LITERALS = 5;   // Last 5 bytes are always literals
+    constexpr size_t MF_LIMIT = 12;       // Last match must start 12 bytes before end
+    constexpr size_t MAX_DISTANCE = 65535;
+    constexpr int HASH_LOG = 12;
+    constexpr int SKIP_TRIGGER = 6;       // Search step grows every 2^6 failed probes
+
+    inline uint32_t read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t read64(const uint8_t* p) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void write_le32(uint8_t* p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+        p[2] = static_cast<uint8_t>(v >> 16);
+        p[3] = static_cast<uint8_t>(v >> 24);
+    }
+
+    inline uint32_t read_le32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) |
+               (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) |
+               (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline uint32_t hash_sequence(uint32_t sequence) {
+        return (sequence * 2654435761U) >> (32 - HASH_LOG);
+    }
+
+    // Count matching bytes between p and ref, stopping at limit
+    inline size_t count_match(const uint8_t* p, const uint8_t* ref, const uint8_t* limit) {
+        const uint8_t* start = p;
+        while (p + 8 <= limit) {
+            uint64_t diff = read64(p) ^ read64(ref);
+            if (diff != 0) {
+                if (endian::native() == Endian::Little) {
+                    return (p - start) + (__builtin_ctzll(diff) >> 3);
+                }
+                return (p - start) + (__builtin_clzll(diff) >> 3);
+            }
+            p += 8;
+            ref += 8;
+        }
+        while (p < limit && *p == *ref) {
+            p++;
+            ref++;
+        }
+        return p - start;
+    }
+
+    // Write the 255-run extension of a literal or match length
+    inline void write_length(uint8_t*& op, size_t len) {
+        while (len >= 255) {
+            *op++ = 255;
+            len -= 255;
+        }
+        *op++ = static_cast<uint8_t>(len);
+    }
+
+    inline size_t read_length(const uint8_t*& ip, const uint8_t* iend) {
+        size_t len = 0;
+        uint8_t byte;
+        do {
+            if (ip >= iend) {
+                throw std::runtime_error("LZ4: truncated length");
+            }
+            byte = *ip++;
+            len += byte;
+        } while (byte == 255);
+        return len;
+    }
+}
+
+// Worst-case compressed size for n input bytes
+inline size_t compress_bound(size_t n) {
+    return n + n / 255 + 16;
+}
+
+// Compress src into dst using the LZ4 block format.
+// Returns the compressed size, or 0 if dst_capacity is too small.
+inline size_t compress_block(const uint8_t* src, size_t src_size,
+                             uint8_t* dst, size_t dst_capacity) {
+    using namespace detail;
+
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* const iend = src + src_size;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dst_capacity;
+
+    if (src_size > MF_LIMIT) {
+        const uint8_t* const mflimit = iend - MF_LIMIT;
+        const uint8_t* const match_limit = iend - LAST_LITERALS;
+        std::vector<uint32_t> table(size_t(1) << HASH_LOG, 0);
+
+        table[hash_sequence(read32(ip))] = 0;
+        ip++;
+
+        while (true) {
+            // Find a match, accelerating through incompressible data
+            const uint8_t* ref;
+            size_t probes = size_t(1) << SKIP_TRIGGER;
+            while (true) {
+                if (ip > mflimit) goto last_literals;
+                uint32_t seq = read32(ip);
+                uint32_t h = hash_sequence(seq);
+                ref = src + table[h];
+                table[h] = static_cast<uint32_t>(ip - src);
+                if (ref < ip && static_cast<size_t>(ip - ref) <= MAX_DISTANCE && read32(ref) == seq) {
+                    break;
+                }
+                ip += probes++ >> SKIP_TRIGGER;
+            }
+
+            // Extend the match backwards over pending literals
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            size_t literal_len = ip - anchor;
+            size_t match_len = count_match(ip + MIN_MATCH, ref + MIN_MATCH, match_limit);
+
+            // token + literal length + literals + offset + match length
+            size_t needed = 1 + literal_len / 255 + 1 + literal_len + 2 + match_len / 255 + 1;
+            if (static_cast<size_t>(oend - op) < needed) return 0;
+
+            uint8_t* token = op++;
+            if (literal_len >= 15) {
+                *token = 15 << 4;
+                write_length(op, literal_len - 15);
+            } else {
+                *token = static_cast<uint8_t>(literal_len << 4);
+            }
+            std::memcpy(op, anchor, literal_len);
+            op += literal_len;
+
+            uint16_t offset = static_cast<uint16_t>(ip - ref);
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+
+            if (match_len >= 15) {
+                *token |= 15;
+                write_length(op, match_len - 15);
+            } else {
+                *token |= static_cast<uint8_t>(match_len);
+            }
+
+            ip += MIN_MATCH + match_len;
+            anchor = ip;
+
+            if (ip > mflimit) break;
+            table[hash_sequence(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+        }
+    }
+
+last_literals:
+    size_t literal_len = iend - anchor;
+    if (static_cast<size_t>(oend - op) < 1 + literal_len / 255 + 1 + literal_len) return 0;
+
+    uint8_t* token = op++;
+    if (literal_len >= 15) {
+        *token = 15 << 4;
+        detail::write_length(op, literal_len - 15);
+    } else {
+        *token = static_cast<uint8_t>(literal_len << 4);
+    }
+    if (literal_len > 0) std::memcpy(op, anchor, literal_len);
+    op += literal_len;
+
+    return op - dst;
+}
+
+// Decompress an LZ4 block into dst. Returns the decompressed size.
+// Throws std::runtime_error on malformed input or if dst is too small.
+inline size_t decompress_block(const uint8_t* src, size_t src_size,
+                               uint8_t* dst, size_t dst_capacity) {
+    using namespace detail;
+
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + src_size;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dst_capacity;
+
+    while (true) {
+        if (ip >= iend) {
+            throw std::runtime_error("LZ4: truncated block");
+        }
+        uint8_t token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15) literal_len += read_length(ip, iend);
+        if (literal_len > static_cast<size_t>(iend - ip) ||
+            literal_len > static_cast<size_t>(oend - op)) {
+            throw std::runtime_error("LZ4: literal run out of range");
+        }
+        if (literal_len <= 16 && iend - ip >= 16 && oend - op >= 16) {
+            std::memcpy(op, ip, 16);  // Fixed-size copy; the excess is overwritten
+        } else if (literal_len > 0) {
+            std::memcpy(op, ip, literal_len);
+        }
+        ip += literal_len;
+        op += literal_len;
+
+        // The last sequence carries literals only
+        if (ip == iend) break;
+
+        if (iend - ip < 2) {
+            throw std::runtime_error("LZ4: truncated offset");
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            throw std::runtime_error("LZ4: invalid match offset");
+        }
+
+        size_t match_len = token & 15;
+        if (match_len == 15) match_len += read_length(ip, iend);
+        match_len += MIN_MATCH;
+        if (match_len > static_cast<size_t>(oend - op)) {
+            throw std::runtime_error("LZ4: match out of range");
+        }
+
+        const uint8_t* ref = op - offset;
+        if (offset >= 8 && static_cast<size_t>(oend - op) >= match_len + 8) {
+            // 8-byte chunks may run past the match end but never past oend
+            uint8_t* const match_end = op + match_len;
+            do {
+                std::memcpy(op, ref, 8);
+                op += 8;
+                ref += 8;
+            } while (op < match_end);
+            op = match_end;
+        } else if (offset >= match_len) {
+            std::memcpy(op, ref, match_len);
+            op += match_len;
+        } else {
+            // Overlapping copy replicates the trailing pattern
+            for (size_t i = 0; i < match_len; i++) {
+                *op++ = *ref++;
+            }
+        }
+    }
+
+    return op - dst;
+}
+
+// ============================================================================
+// Size-prefixed blocks for Bytes / Buffer / String
+// Layout: [u32 little-endian original size][LZ4 block]
+// ============================================================================
+
+namespace detail {
+    inline std::vector<uint8_t> compress_prefixed(const uint8_t* src, size_t size) {
+        if (size > 0xFFFFFFFFu) {
+            throw std::length_error("LZ4: block larger than 4 GiB, use FrameWriter");
+        }
+        std::vector<uint8_t> out(4 + compress_bound(size));
+        write_le32(out.data(), static_cast<uint32_t>(size));
+        size_t n = compress_block(src, size, out.data() + 4, out.size() - 4);
+        out.resize(4 + n);
+        return out;
+    }
+
+    // Each LZ4 length byte adds at most 255 output bytes, so a block never
+    // expands by more than this; a larger size prefix is corrupt
+    constexpr size_t MAX_EXPANSION = 255;
+
+    inline std::vector<uint8_t> decompress_prefixed(const uint8_t* src, size_t size) {
+        if (size < 4) {
+            throw std::runtime_error("LZ4: missing size prefix");
+        }
+        const size_t original_size = read_le32(src);
+        if (original_size > (size - 4) * MAX_EXPANSION) {
+            throw std::runtime_error("LZ4: size prefix larger than the block can hold");
+        }
+        std::vector<uint8_t> out(original_size);
+        size_t n = decompress_block(src + 4, size - 4, out.data(), out.size());
+        if (n != out.size()) {
+            throw std::runtime_error("LZ4: size prefix mismatch");
+        }
+        return out;
+    }
+}
+
+inline Bytes compress(const Bytes& input) {
+    return Bytes(detail::compress_prefixed(input.as_ptr(), input.size()));
+}
+
+inline Bytes decompress(const Bytes& input) {
+    return Bytes(detail::decompress_prefixed(input.as_ptr(), input.size()));
+}
+
+inline Buffer compress(const Buffer& input) {
+    auto out = detail::compress_prefixed(input.data(), input.size());
+    return Buffer(out.data(), out.size());
+}
+
+inline Buffer decompress(const Buffer& input) {
+    auto out = detail::decompress_prefixed(input.data(), input.size());
+    return Buffer(out.data(), out.size());
+}
+
+inline String compress(const String& input) {
+    const std::string& s = input.as_std_string();
+    auto out = detail::compress_prefixed(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    return String(std::string(out.begin(), out.end()));
+}
+
+// Returns an empty string if the input is not a valid compressed block
+inline String decompress(const String& input) {
+    const std::string& s = input.as_std_string();
+    try {
+        auto out = detail::decompress_prefixed(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+        return String(std::string(out.begin(), out.end()));
+    } catch (const std::exception&) {
+        return String("");
+    }
+}
+
+// ============================================================================
+// LZ4 frame format (streaming)
+// ============================================================================
+
+enum class BlockSize : uint8_t {
+    Max64KB = 4,
+    Max256KB = 5,
+    Max1MB = 6,
+    Max4MB = 7
+};
+
+inline size_t block_size_bytes(BlockSize bs) {
+    return size_t(1) << (8 + 2 * static_cast<uint8_t>(bs));
+}
+
+namespace detail {
+    constexpr uint32_t FRAME_MAGIC = 0x184D2204;
+    constexpr uint32_t SKIPPABLE_MAGIC_MASK = 0xFFFFFFF0;
+    constexpr uint32_t SKIPPABLE_MAGIC = 0x184D2A50;
+    constexpr uint32_t UNCOMPRESSED_BIT = 0x80000000;
+
+    constexpr uint8_t FLG_VERSION = 0x40;
+    constexpr uint8_t FLG_BLOCK_INDEPENDENT = 0x20;
+    constexpr uint8_t FLG_BLOCK_CHECKSUM = 0x10;
+    constexpr uint8_t FLG_CONTENT_SIZE = 0x08;
+    constexpr uint8_t FLG_CONTENT_CHECKSUM = 0x04;
+    constexpr uint8_t FLG_DICT_ID = 0x01;
+}
+
+// Writes one LZ4 frame to an output stream. Input is buffered into
+// independent blocks; the frame is terminated by finish() or the destructor.
+class FrameWriter {
+private:
+    std::ostream& out_;
+    BlockSize block_size_;
+    std::vector<uint8_t> block_;
+    std::vector<uint8_t> compressed_;
+    XXH32 content_hash_;
+    bool header_written_;
+    bool finished_;
+    uint64_t bytes_in_;
+    uint64_t bytes_out_;
+
+    void put(const uint8_t* data, size_t len) {
+        out_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(len));
+        if (!out_) {
+            throw std::runtime_error("LZ4: write failed");
+        }
+        bytes_out_ += len;
+    }
+
+    void write_header() {
+        uint8_t header[7];
+        detail::write_le32(header, detail::FRAME_MAGIC);
+        header[4] = detail::FLG_VERSION | detail::FLG_BLOCK_INDEPENDENT | detail::FLG_CONTENT_CHECKSUM;
+        header[5] = static_cast<uint8_t>(static_cast<uint8_t>(block_size_) << 4);
+        header[6] = static_cast<uint8_t>((XXH32::hash(header + 4, 2) >> 8) & 0xFF);
+        put(header, sizeof(header));
+        header_written_ = true;
+    }
+
+    void flush_block() {
+        if (block_.empty()) return;
+        if (!header_written_) write_header();
+
+        size_t n = compress_block(block_.data(), block_.size(), compressed_.data(), compressed_.size());
+        uint8_t size_field[4];
+        if (n == 0 || n >= block_.size()) {
+            // Incompressible: store raw
+            detail::write_le32(size_field, static_cast<uint32_t>(block_.size()) | detail::UNCOMPRESSED_BIT);
+            put(size_field, 4);
+            put(block_.data(), block_.size());
+        } else {
+            detail::write_le32(size_field, static_cast<uint32_t>(n));
+            put(size_field, 4);
+            put(compressed_.data(), n);
+        }
+        block_.clear();
+    }
+
+public:
+    explicit FrameWriter(std::ostream& out, BlockSize block_size = BlockSize::Max4MB)
+        : out_(out)
+        , block_size_(block_size)
+        , header_written_(false)
+        , finished_(false)
+        , bytes_in_(0)
+        , bytes_out_(0) {
+        block_.reserve(block_size_bytes(block_size));
+        compressed_.resize(compress_bound(block_size_bytes(block_size)));
+    }
+
+    ~FrameWriter() {
+        try {
+            finish();
+        } catch (...) {
+            // Destructors must not throw; call finish() explicitly to observe errors
+        }
+    }
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    void write(const uint8_t* data, size_t len) {
+        if (finished_) {
+            throw std::logic_error("LZ4: write after finish");
+        }
+        content_hash_.update(data, len);
+        bytes_in_ += len;
+
+        size_t capacity = block_size_bytes(block_size_);
+        while (len > 0) {
+            size_t take = std::min(len, capacity - block_.size());
+            block_.insert(block_.end(), data, data + take);
+            data += take;
+            len -= take;
+            if (block_.size() == capacity) flush_block();
+        }
+    }
+
+    void write(const Bytes& bytes) { write(bytes.as_ptr(), bytes.size()); }
+    void write(const Buffer& buffer) { write(buffer.data(), buffer.size()); }
+
+    void write(const String& str) {
+        const std::string& s = str.as_std_string();
+        write(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+
+    // Terminate the frame: flush the last block, end mark and content checksum
+    void finish() {
+        if (finished_) return;
+        flush_block();
+        if (!header_written_) write_header();
+
+        uint8_t trailer[8];
+        detail::write_le32(trailer, 0);
+        detail::write_le32(trailer + 4, content_hash_.digest());
+        put(trailer, sizeof(trailer));
+        out_.flush();
+        finished_ = true;
+    }
+
+    uint64_t bytes_in() const { return bytes_in_; }
+    uint64_t bytes_out() const { return bytes_out_; }
+};
+
+// Reads LZ4 frames from an input stream. Concatenated frames are decoded
+// back to back and skippable frames are ignored.
+class FrameReader {
+private:
+    std::istream& in_;
+    std::vector<uint8_t> block_;
+    std::vector<uint8_t> compressed_;
+    size_t block_pos_;
+    size_t block_end_;
+    uint8_t flags_;
+    XXH32 content_hash_;
+    bool in_frame_;
+    bool eof_;
+
+    bool get(uint8_t* data, size_t len) {
+        in_.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(len));
+        return static_cast<size_t>(in_.gcount()) == len;
+    }
+
+    void get_exact(uint8_t* data, size_t len) {
+        if (!get(data, len)) {
+            throw std::runtime_error("LZ4: truncated frame");
+        }
+    }
+
+    // Returns false at a clean end of stream
+    bool read_frame_header() {
+        while (true) {
+            uint8_t magic_bytes[4];
+            in_.read(reinterpret_cast<char*>(magic_bytes), 4);
+            if (in_.gcount() == 0) return false;
+            if (in_.gcount() != 4) {
+                throw std::runtime_error("LZ4: truncated frame");
+            }
+
+            uint32_t magic = detail::read_le32(magic_bytes);
+            if ((magic & detail::SKIPPABLE_MAGIC_MASK) == detail::SKIPPABLE_MAGIC) {
+                uint8_t size_field[4];
+                get_exact(size_field, 4);
+                in_.ignore(detail::read_le32(size_field));
+                continue;
+            }
+            if (magic != detail::FRAME_MAGIC) {
+                throw std::runtime_error("LZ4: bad frame magic");
+            }
+            break;
+        }
+
+        uint8_t descriptor[11];
+        get_exact(descriptor, 2);
+        flags_ = descriptor[0];
+        if ((flags_ & 0xC0) != detail::FLG_VERSION) {
+            throw std::runtime_error("LZ4: unsupported frame version");
+        }
+        if (!(flags_ & detail::FLG_BLOCK_INDEPENDENT)) {
+            throw std::runtime_error("LZ4: linked blocks are not supported");
+        }
+
+        size_t descriptor_len = 2;
+        if (flags_ & detail::FLG_CONTENT_SIZE) {
+            get_exact(descriptor + descriptor_len, 8);
+            descriptor_len += 8;
+        }
+        if (flags_ & detail::FLG_DICT_ID) {
+            throw std::runtime_error("LZ4: dictionaries are not supported");
+        }
+
+        uint8_t checksum;
+        get_exact(&checksum, 1);
+        if (checksum != static_cast<uint8_t>((XXH32::hash(descriptor, descriptor_len) >> 8) & 0xFF)) {
+            throw std::runtime_error("LZ4: frame header checksum mismatch");
+        }
+
+        uint8_t bd = (descriptor[1] >> 4) & 0x07;
+        if (bd < 4) {
+            throw std::runtime_error("LZ4: invalid block size");
+        }
+        size_t max_block = block_size_bytes(static_cast<BlockSize>(bd));
+        block_.resize(max_block);
+        compressed_.resize(max_block);
+        content_hash_.reset();
+        in_frame_ = true;
+        return true;
+    }
+
+    void finish_frame() {
+        if (flags_ & detail::FLG_CONTENT_CHECKSUM) {
+            uint8_t stored[4];
+            get_exact(stored, 4);
+            if (detail::read_le32(stored) != content_hash_.digest()) {
+                throw std::runtime_error("LZ4: content checksum mismatch");
+            }
+        }
+        in_frame_ = false;
+    }
+
+    // Decode the next block into block_. Returns false at end of stream.
+    bool next_block() {
+        while (true) {
+            if (!in_frame_ && !read_frame_header()) return false;
+
+            uint8_t size_field[4];
+            get_exact(size_field, 4);
+            uint32_t size = detail::read_le32(size_field);
+            if (size == 0) {
+                finish_frame();
+                continue;
+            }
+
+            bool raw = (size & detail::UNCOMPRESSED_BIT) != 0;
+            size &= ~detail::UNCOMPRESSED_BIT;
+            if (size > compressed_.size()) {
+                throw std::runtime_error("LZ4: block exceeds declared maximum");
+            }
+
+            get_exact(compressed_.data(), size);
+            if (flags_ & detail::FLG_BLOCK_CHECKSUM) {
+                uint8_t stored[4];
+                get_exact(stored, 4);
+                if (detail::read_le32(stored) != XXH32::hash(compressed_.data(), size)) {
+                    throw std::runtime_error("LZ4: block checksum mismatch");
+                }
+            }
+
+            size_t n;
+            if (raw) {
+                std::memcpy(block_.data(), compressed_.data(), size);
+                n = size;
+            } else {
+                n = decompress_block(compressed_.data(), size, block_.data(), block_.size());
+            }
+            content_hash_.update(block_.data(), n);
+            block_end_ = n;
+            block_pos_ = 0;
+            if (n > 0) return true;
+        }
+    }
+
+public:
+    explicit FrameReader(std::istream& in)
+        : in_(in), block_pos_(0), block_end_(0), flags_(0), in_frame_(false), eof_(false) {}
+
+    FrameReader(const FrameReader&) = delete;
+    FrameReader& operator=(const FrameReader&) = delete;
+
+    // Read up to len decompressed bytes. Returns 0 at end of stream.
+    size_t read(uint8_t* data, size_t len) {
+        size_t total = 0;
+        while (total < len && !eof_) {
+            if (block_pos_ == block_end_ && !next_block()) {
+                eof_ = true;
+                break;
+            }
+            size_t take = std::min(len - total, block_end_ - block_pos_);
+            std::memcpy(data + total, block_.data() + block_pos_, take);
+            block_pos_ += take;
+            total += take;
+        }
+        return total;
+    }
+
+    // Read everything remaining in the stream
+    std::vector<uint8_t> read_all() {
+        std::vector<uint8_t> out;
+        while (!eof_) {
+            if (block_pos_ == block_end_ && !next_block()) {
+                eof_ = true;
+                break;
+            }
+            out.insert(out.end(), block_.data() + block_pos_, block_.data() + block_end_);
+            block_pos_ = block_end_;
+        }
+        return out;
+    }
+
+    bool eof() const { return eof_; }
+};
+
+// ============================================================================
+// Frame helpers for in-memory data and files
+// ============================================================================
+
+inline Bytes compress_frame(const Bytes& input, BlockSize block_size = BlockSize::Max4MB) {
+    std::ostringstream out(std::ios::binary);
+    FrameWriter writer(out, block_size);
+    writer.write(input);
+    writer.finish();
+    const std::string s = out.str();
+    return Bytes(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+inline Bytes decompress_frame(const Bytes& input) {
+    std::istringstream in(std::string(input.as_ptr(), input.as_ptr() + input.size()), std::ios::binary);
+    FrameReader reader(in);
+    return Bytes(reader.read_all());
+}
+
+// Stream-compress src into an LZ4 frame file at dst
+inline bool compress_file(const String& src, const String& dst) {
+    std::ifstream in(src.as_std_string(), std::ios::binary);
+    std::ofstream out(dst.as_std_string(), std::ios::binary | std::ios::trunc);
+    if (!in.is_open() || !out.is_open()) {
+        return false;
+    }
+
+    try {
+        FrameWriter writer(out);
+        std::vector<char> chunk(block_size_bytes(BlockSize::Max4MB));
+        while (in) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            size_t n = static_cast<size_t>(in.gcount());
+            if (n == 0) break;
+            writer.write(reinterpret_cast<const uint8_t*>(chunk.data()), n);
+        }
+        if (in.bad()) return false;
+        writer.finish();
+    } catch (const std::exception&) {
+        return false;
+    }
+    return out.good();
+}
+
+// Stream-decompress an LZ4 frame file at src into dst
+inline bool decompress_file(const String& src, const String& dst) {
+    std::ifstream in(src.as_std_string(), std::ios::binary);
+    std::ofstream out(dst.as_std_string(), std::ios::binary | std::ios::trunc);
+    if (!in.is_open() || !out.is_open()) {
+        return false;
+    }
+
+    try {
+        FrameReader reader(in);
+        std::vector<uint8_t> chunk(block_size_bytes(BlockSize::Max4MB));
+        while (size_t n = reader.read(chunk.data(), chunk.size())) {
+            out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(n));
+            if (!out) return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return out.good();
+}
+
+// Write content as a single LZ4 frame (compressed counterpart of file::write_string)
+inline bool write_compressed(const String& path, const String& content) {
+    std::ofstream out(path.as_std_string(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    try {
+        FrameWriter writer(out);
+        writer.write(content);
+        writer.finish();
+    } catch (const std::exception&) {
+        return false;
+    }
+    return out.good();
+}
+
+inline bool write_compressed(const String& path, const Buffer& buffer) {
+    std::ofstream out(path.as_std_string(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    try {
+        FrameWriter writer(out);
+        writer.write(buffer);
+        writer.finish();
+    } catch (const std::exception&) {
+        return false;
+    }
+    return out.good();
+}
+
+// Read an LZ4 frame file. Returns an empty string on error.
+inline String read_compressed(const String& path) {
+    std::ifstream in(path.as_std_string(), std::ios::binary);
+    if (!in.is_open()) {
+        return String("");
+    }
+
+    try {
+        FrameReader reader(in);
+        auto data = reader.read_all();
+        return String(std::string(data.begin(), data.end()));
+    } catch (const std::exception&) {
+        return String("");
+    }
+}
+
+inline Buffer read_compressed_buffer(const String& path) {
+    std::ifstream in(path.as_std_string(), std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("LZ4: cannot open " + path.as_std_string());
+    }
+    FrameReader reader(in);
+    auto data = reader.read_all();
+    return Buffer(data.data(), data.size());
+}
+
+} // namespace mlc::compress
+
+#endif // MLC_COMPRESS_HPP
@@ -1,20 +1,670 @@
 #ifndef AURORA_FILE_HPP
 #define AURORA_FILE_HPP
 
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <optional>
 #include "mlc_string.hpp"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MLC_FILE_HAS_MMAP 1
+#endif
+
 namespace mlc::file {
 
-// File handle wrapper with RAII
+// Read-only view of a whole file. Regular files are memory-mapped; anything
+// mmap cannot handle (pipes, /proc files, other platforms) is read into memory.
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    bool ok_ = false;
+    std::string buffer_;
+
+    void release() {
+#ifdef MLC_FILE_HAS_MMAP
+        if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = false;
+        ok_ = false;
+        buffer_.clear();
+    }
+
+    bool read_fallback(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+    }
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { release(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        release();
+#ifdef MLC_FILE_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(addr);
+                size_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+            }
+        }
+        ::close(fd);
+        ok_ = mapped_ || read_fallback(path);
+#else
+        ok_ = read_fallback(path);
+#endif
+        return ok_;
+    }
+
+    bool is_open() const { return ok_; }
+    std::string_view view() const { return std::string_view(data_ ? data_ : "", size_); }
+    size_t size() const { return size_; }
+};
+
+namespace detail {
+
+// Input iterator over a source with `bool next(std::string_view&)`; each view
+// is valid until the iterator advances
+template <typename Source>
+class ViewIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    ViewIterator() = default;
+    explicit ViewIterator(Source* source) : source_(source) { ++*this; }
+
+    reference operator*() const { return view_; }
+    pointer operator->() const { return &view_; }
+    ViewIterator& operator++() {
+        if (source_ && !source_->next(view_)) source_ = nullptr;
+        return *this;
+    }
+    void operator++(int) { ++*this; }
+    bool operator==(const ViewIterator& other) const { return source_ == other.source_; }
+
+private:
+    Source* source_ = nullptr;
+    std::string_view view_;
+};
+
+} // namespace detail
+
+// Lines of a file without their line endings ("\n" or "\r\n"), read lazily:
+//     for (std::string_view line : file::lines(path)) ...
+// Regular files are memory-mapped and scanned in place. Pipes and files mmap
+// cannot handle are read in chunks, so memory is bounded by the longest line.
+// A view is valid until the next line is read. A file that cannot be opened
+// has no lines.
+class Lines {
+public:
+    static constexpr size_t kChunk = 256 * 1024;
+
+    explicit Lines(const std::string& path) {
+#ifdef MLC_FILE_HAS_MMAP
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return;
+        struct stat st;
+        if (fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (addr != MAP_FAILED) {
+                madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(addr);
+                end_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+#else
+        stream_.open(path, std::ios::binary);
+#endif
+    }
+
+    ~Lines() {
+#ifdef MLC_FILE_HAS_MMAP
+        if (mapped_) munmap(const_cast<char*>(data_), end_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    Lines(const Lines&) = delete;
+    Lines& operator=(const Lines&) = delete;
+
+    bool next(std::string_view& line) {
+        size_t scanned = pos_;
+        for (;;) {
+            if (const void* nl = std::memchr(data_ + scanned, '\n', end_ - scanned)) {
+                const size_t at = static_cast<size_t>(static_cast<const char*>(nl) - data_);
+                size_t stop = at;
+                if (stop > pos_ && data_[stop - 1] == '\r') --stop;
+                line = std::string_view(data_ + pos_, stop - pos_);
+                pos_ = at + 1;
+                return true;
+            }
+            const size_t offset = end_ - pos_;
+            if (!refill()) break;
+            scanned = pos_ + offset;
+        }
+        if (pos_ == end_) return false;
+        line = std::string_view(data_ + pos_, end_ - pos_);
+        pos_ = end_;
+        return true;
+    }
+
+    using iterator = detail::ViewIterator<Lines>;
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+    // Every remaining line, copied
+    operator std::vector<mlc::String>() {
+        std::vector<mlc::String> result;
+        for (std::string_view line : *this) result.emplace_back(line);
+        return result;
+    }
+
+private:
+    const char* data_ = "";
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    bool mapped_ = false;
+    std::string buffer_;
+#ifdef MLC_FILE_HAS_MMAP
+    int fd_ = -1;
+#else
+    std::ifstream stream_;
+#endif
+
+    // Keeps the unread tail, reads the next chunk after it; false at the end
+    bool refill() {
+        if (mapped_) return false;
+        if (pos_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0;
+        }
+        if (end_ == buffer_.size()) buffer_.resize(std::max(kChunk, buffer_.size() * 2));
+        data_ = buffer_.data();
+        const size_t n = read_chunk(buffer_.data() + end_, buffer_.size() - end_);
+        end_ += n;
+        return n > 0;
+    }
+
+    size_t read_chunk(char* out, size_t size) {
+#ifdef MLC_FILE_HAS_MMAP
+        if (fd_ < 0) return 0;
+        for (;;) {
+            ssize_t n = ::read(fd_, out, size);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR) return 0;
+        }
+#else
+        if (!stream_.is_open()) return 0;
+        stream_.read(out, static_cast<std::streamsize>(size));
+        return static_cast<size_t>(stream_.gcount());
+#endif
+    }
+};
+
+// Access pattern hints for File::advise (posix_fadvise)
+enum class Advice { Normal, Sequential, Random, WillNeed, DontNeed };
+
+#ifdef MLC_FILE_HAS_MMAP
+
+// File handle on a POSIX descriptor with RAII. Writes collect in a buffer
+// of buffer_size() bytes (0 writes straight through) and read_line reads
+// through a refill buffer; read_at and write_at are positional and do not
+// move the file position. set_direct(true) before open_write asks for
+// O_DIRECT: whole blocks then bypass the page cache, and flush() writes an
+// unaligned tail with O_DIRECT switched off; read_at and write_at switch
+// it off before they start. Filesystems without O_DIRECT (tmpfs) get
+// ordinary writes.
 class File {
+public:
+    static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+    File() = default;
+    explicit File(const std::string& path) : path_(path) {}
+
+    ~File() {
+        close();
+    }
+
+    // Delete copy, allow move
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    File(File&& other) noexcept {
+        swap(other);
+    }
+
+    File& operator=(File&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    bool open_read() {
+        return open_with(O_RDONLY, false);
+    }
+
+    bool open_write() {
+        return open_with(O_WRONLY | O_CREAT | O_TRUNC, direct_);
+    }
+
+    bool open_append() {
+        return open_with(O_WRONLY | O_CREAT | O_APPEND, false);
+    }
+
+    void close() {
+        if (fd_ < 0) return;
+        flush();
+        ::close(fd_);
+        fd_ = -1;
+        direct_open_ = false;
+        read_pos_ = read_end_ = 0;
+    }
+
+    bool is_open() const {
+        return fd_ >= 0;
+    }
+
+    const std::string& path() const {
+        return path_;
+    }
+
+    int fd() const {
+        return fd_;
+    }
+
+    // Write buffer size in bytes; 0 writes straight through. Pending output
+    // is flushed first.
+    void set_buffer_size(size_t size) {
+        flush();
+        if (direct_open_) size = std::max(kDirectAlign, (size + kDirectAlign - 1) / kDirectAlign * kDirectAlign);
+        buffer_size_ = size;
+        write_buffer_.reset();
+    }
+
+    size_t buffer_size() const {
+        return buffer_size_;
+    }
+
+    // Ask for O_DIRECT on the next open_write (needs a write buffer)
+    void set_direct(bool direct) {
+        direct_ = direct;
+    }
+
+    bool is_direct() const {
+        return direct_open_;
+    }
+
+    // Current size of the file, or -1 when it is not open
+    int64_t size() const {
+        struct stat st;
+        if (fd_ < 0 || fstat(fd_, &st) != 0) return -1;
+        return static_cast<int64_t>(st.st_size);
+    }
+
+    bool advise(Advice advice, uint64_t offset = 0, uint64_t length = 0) {
+        if (fd_ < 0) return false;
+#ifdef POSIX_FADV_NORMAL
+        static constexpr int kAdvice[] = {POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM,
+                                          POSIX_FADV_WILLNEED, POSIX_FADV_DONTNEED};
+        return posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(length),
+                             kAdvice[static_cast<int>(advice)]) == 0;
+#else
+        (void)advice;
+        (void)offset;
+        (void)length;
+        return false;
+#endif
+    }
+
+    // Reserves disk blocks for `size` bytes without changing the file size,
+    // so a file written sequentially does not fragment
+    bool preallocate(uint64_t size) {
+        if (fd_ < 0) return false;
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+        int rc;
+        do {
+            rc = fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size));
+        } while (rc != 0 && errno == EINTR);
+        return rc == 0;
+#else
+        (void)size;
+        return false;
+#endif
+    }
+
+    // Read entire file as string (from the start, whatever the position)
+    std::optional<mlc::String> read_all() {
+        if (fd_ < 0) return std::nullopt;
+        flush();
+
+        std::string content;
+        struct stat st;
+        if (fstat(fd_, &st) == 0 && S_ISREG(st.st_mode)) {
+            // One byte of room past the size notices a file that grew
+            content.resize(static_cast<size_t>(st.st_size) + 1);
+            size_t used = 0;
+            for (;;) {
+                if (used == content.size()) content.resize(content.size() * 2);
+                ssize_t n = ::pread(fd_, content.data() + used, content.size() - used, static_cast<off_t>(used));
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) return std::nullopt;
+                if (n == 0) break;
+                used += static_cast<size_t>(n);
+            }
+            content.resize(used);
+        } else {
+            // Pipes and terminals: whatever is left
+            std::string_view rest(read_buffer_.data() + read_pos_, read_end_ - read_pos_);
+            content.assign(rest);
+            read_pos_ = read_end_ = 0;
+            char chunk[64 * 1024];
+            for (;;) {
+                ssize_t n = ::read(fd_, chunk, sizeof(chunk));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                content.append(chunk, static_cast<size_t>(n));
+            }
+            eof_ = true;
+        }
+        return mlc::String(std::move(content));
+    }
+
+    // Read one line
+    std::optional<mlc::String> read_line() {
+        std::string_view line;
+        if (!next_line(line)) return std::nullopt;
+        return mlc::String(line);
+    }
+
+    // Read all lines
+    std::vector<mlc::String> read_lines() {
+        std::vector<mlc::String> lines;
+        std::string_view line;
+        while (next_line(line)) lines.emplace_back(line);
+        return lines;
+    }
+
+    // Up to `size` bytes at `offset` (fewer at the end of the file)
+    std::optional<mlc::String> read_at(uint64_t offset, size_t size) {
+        if (fd_ < 0) return std::nullopt;
+        leave_direct();
+        std::string data(size, '\0');
+        size_t used = 0;
+        while (used < size) {
+            ssize_t n = ::pread(fd_, data.data() + used, size - used, static_cast<off_t>(offset + used));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return std::nullopt;
+            if (n == 0) break;
+            used += static_cast<size_t>(n);
+        }
+        data.resize(used);
+        return mlc::String(std::move(data));
+    }
+
+    // Writes all of `data` at `offset`, after any buffered output
+    bool write_at(uint64_t offset, std::string_view data) {
+        if (fd_ < 0) return false;
+        leave_direct();
+        while (!data.empty()) {
+            ssize_t n = ::pwrite(fd_, data.data(), data.size(), static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return false;
+            data.remove_prefix(static_cast<size_t>(n));
+            offset += static_cast<uint64_t>(n);
+        }
+        return true;
+    }
+
+    // Write string to file
+    bool write(const mlc::String& content) {
+        return append(content.as_std_string());
+    }
+
+    // Write line to file (adds newline)
+    bool write_line(const mlc::String& line) {
+        return append(line.as_std_string(), true);
+    }
+
+    // Write multiple lines
+    bool write_lines(const std::vector<mlc::String>& lines) {
+        for (const auto& line : lines) {
+            if (!write_line(line)) return false;
+        }
+        return true;
+    }
+
+    // Check if at end of file
+    bool eof() const {
+        return eof_;
+    }
+
+    // Write out the buffer
+    void flush() {
+        if (fd_ >= 0 && write_used_ > 0) drain(true);
+    }
+
+private:
+    static constexpr size_t kDirectAlign = 4096;
+
+    struct FreeAligned {
+        void operator()(char* p) const { std::free(p); }
+    };
+
+    int fd_ = -1;
+    std::string path_;
+    bool direct_ = false;
+    bool direct_open_ = false;
+    bool eof_ = false;
+    bool failed_ = false;
+    size_t buffer_size_ = kDefaultBufferSize;
+    std::unique_ptr<char, FreeAligned> write_buffer_;
+    size_t write_used_ = 0;
+    std::string read_buffer_;
+    size_t read_pos_ = 0;
+    size_t read_end_ = 0;
+
+    void swap(File& other) noexcept {
+        std::swap(fd_, other.fd_);
+        std::swap(path_, other.path_);
+        std::swap(direct_, other.direct_);
+        std::swap(direct_open_, other.direct_open_);
+        std::swap(eof_, other.eof_);
+        std::swap(failed_, other.failed_);
+        std::swap(buffer_size_, other.buffer_size_);
+        std::swap(write_buffer_, other.write_buffer_);
+        std::swap(write_used_, other.write_used_);
+        std::swap(read_buffer_, other.read_buffer_);
+        std::swap(read_pos_, other.read_pos_);
+        std::swap(read_end_, other.read_end_);
+    }
+
+    bool open_with(int flags, bool direct) {
+        close();
+        eof_ = false;
+        failed_ = false;
+        direct = direct && buffer_size_ > 0;
+#ifdef O_DIRECT
+        if (direct) {
+            fd_ = ::open(path_.c_str(), flags | O_DIRECT | O_CLOEXEC, 0644);
+            if (fd_ >= 0) {
+                direct_open_ = true;
+                // Whole, aligned blocks only
+                buffer_size_ = std::max(kDirectAlign, (buffer_size_ + kDirectAlign - 1) / kDirectAlign * kDirectAlign);
+                write_buffer_.reset();
+                return true;
+            }
+        }
+#endif
+        fd_ = ::open(path_.c_str(), flags | O_CLOEXEC, 0644);
+        return fd_ >= 0;
+    }
+
+    bool write_all(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd_, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                failed_ = true;
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void clear_direct() {
+        ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT);
+        direct_open_ = false;
+    }
+
+    // Flushes and ends direct mode: positional I/O takes buffers and
+    // offsets of any alignment, which O_DIRECT refuses
+    void leave_direct() {
+        flush();
+        if (direct_open_) clear_direct();
+    }
+
+    // Writes the buffer out. Under O_DIRECT only whole blocks go unless
+    // `all` is set; a partial last block then ends direct mode.
+    bool drain(bool all) {
+        size_t size = write_used_;
+        if (direct_open_) {
+            size = write_used_ / kDirectAlign * kDirectAlign;
+            if (size > 0 && !write_all(write_buffer_.get(), size)) return false;
+            std::memmove(write_buffer_.get(), write_buffer_.get() + size, write_used_ - size);
+            write_used_ -= size;
+            if (!all || write_used_ == 0) return true;
+            clear_direct();
+            size = write_used_;
+        }
+        write_used_ = 0;
+        return write_all(write_buffer_.get(), size);
+    }
+
+    bool append(std::string_view data, bool newline = false) {
+        if (fd_ < 0 || failed_) return false;
+        if (buffer_size_ == 0) return write_all(data.data(), data.size()) && (!newline || write_all("\n", 1));
+        if (!write_buffer_) {
+            const size_t capacity = (buffer_size_ + kDirectAlign - 1) / kDirectAlign * kDirectAlign;
+            write_buffer_.reset(static_cast<char*>(std::aligned_alloc(kDirectAlign, capacity)));
+        }
+        // The common case: everything fits
+        if (write_used_ + data.size() < buffer_size_) {
+            std::memcpy(write_buffer_.get() + write_used_, data.data(), data.size());
+            write_used_ += data.size();
+            if (newline) write_buffer_.get()[write_used_++] = '\n';
+            return true;
+        }
+        // A large write with nothing pending skips the copy
+        if (write_used_ == 0 && data.size() >= buffer_size_ && !direct_open_) {
+            return write_all(data.data(), data.size()) && (!newline || append("\n"));
+        }
+        while (!data.empty()) {
+            const size_t n = std::min(data.size(), buffer_size_ - write_used_);
+            std::memcpy(write_buffer_.get() + write_used_, data.data(), n);
+            write_used_ += n;
+            data.remove_prefix(n);
+            if (write_used_ == buffer_size_ && !drain(false)) return false;
+        }
+        return !newline || append("\n");
+    }
+
+    // Next line without its '\n', as a view into the read buffer
+    bool next_line(std::string_view& line) {
+        if (fd_ < 0) return false;
+        size_t scanned = read_pos_;
+        for (;;) {
+            const char* begin = read_buffer_.data();
+            if (const void* nl = std::memchr(begin + scanned, '\n', read_end_ - scanned)) {
+                const size_t at = static_cast<size_t>(static_cast<const char*>(nl) - begin);
+                line = std::string_view(begin + read_pos_, at - read_pos_);
+                read_pos_ = at + 1;
+                return true;
+            }
+            const size_t offset = read_end_ - read_pos_;
+            if (!refill()) break;
+            scanned = read_pos_ + offset;
+        }
+        eof_ = true;
+        if (read_pos_ == read_end_) return false;
+        line = std::string_view(read_buffer_.data() + read_pos_, read_end_ - read_pos_);
+        read_pos_ = read_end_;
+        return true;
+    }
+
+    bool refill() {
+        if (read_pos_ > 0) {
+            std::memmove(read_buffer_.data(), read_buffer_.data() + read_pos_, read_end_ - read_pos_);
+            read_end_ -= read_pos_;
+            read_pos_ = 0;
+        }
+        if (read_end_ == read_buffer_.size()) read_buffer_.resize(std::max(kDefaultBufferSize, read_buffer_.size() * 2));
+        for (;;) {
+            ssize_t n = ::read(fd_, read_buffer_.data() + read_end_, read_buffer_.size() - read_end_);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            read_end_ += static_cast<size_t>(n);
+            return true;
+        }
+    }
+};
+
+#else
+
+// File handle wrapper with RAII, on std::fstream where there are no POSIX descriptors
+class File {
+public:
+    static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
 private:
     std::fstream stream_;
     std::string path_;
     bool is_open_;
+    size_t buffer_size_ = kDefaultBufferSize;
 
 public:
     File() : is_open_(false) {}
@@ -33,7 +683,8 @@ public:
     File(File&& other) noexcept
         : stream_(std::move(other.stream_))
         , path_(std::move(other.path_))
-        , is_open_(other.is_open_) {
+        , is_open_(other.is_open_)
+        , buffer_size_(other.buffer_size_) {
         other.is_open_ = false;
     }
 
@@ -43,6 +694,7 @@ public:
             stream_ = std::move(other.stream_);
             path_ = std::move(other.path_);
             is_open_ = other.is_open_;
+            buffer_size_ = other.buffer_size_;
             other.is_open_ = false;
         }
         return *this;
@@ -84,6 +736,73 @@ public:
         return path_;
     }
 
+    // Recorded only: std::fstream keeps its own buffer
+    void set_buffer_size(size_t size) {
+        flush();
+        buffer_size_ = size;
+    }
+
+    size_t buffer_size() const {
+        return buffer_size_;
+    }
+
+    // No O_DIRECT without POSIX descriptors
+    void set_direct(bool) {}
+
+    bool is_direct() const {
+        return false;
+    }
+
+    // Current size of the file, or -1 when it is not open
+    int64_t size() {
+        if (!is_open_) return -1;
+        flush();
+        std::ifstream probe(path_, std::ios::binary | std::ios::ate);
+        return probe ? static_cast<int64_t>(probe.tellg()) : -1;
+    }
+
+    bool advise(Advice, uint64_t = 0, uint64_t = 0) {
+        return false;
+    }
+
+    bool preallocate(uint64_t) {
+        return false;
+    }
+
+    // Up to `size` bytes at `offset`; the stream position is put back
+    std::optional<mlc::String> read_at(uint64_t offset, size_t size) {
+        if (!is_open_) return std::nullopt;
+        flush();
+        const auto state = stream_.rdstate();
+        stream_.clear();
+        const auto pos = stream_.tellg();
+        std::string data(size, '\0');
+        stream_.seekg(static_cast<std::streamoff>(offset));
+        stream_.read(data.data(), static_cast<std::streamsize>(size));
+        data.resize(static_cast<size_t>(stream_.gcount()));
+        const bool ok = !stream_.bad();
+        stream_.clear();
+        stream_.seekg(pos);
+        stream_.setstate(state);
+        if (!ok) return std::nullopt;
+        return mlc::String(std::move(data));
+    }
+
+    // Writes `data` at `offset`; the stream position is put back
+    bool write_at(uint64_t offset, std::string_view data) {
+        if (!is_open_) return false;
+        const auto state = stream_.rdstate();
+        stream_.clear();
+        const auto pos = stream_.tellp();
+        stream_.seekp(static_cast<std::streamoff>(offset));
+        stream_.write(data.data(), static_cast<std::streamsize>(data.size()));
+        stream_.flush();
+        const bool ok = stream_.good();
+        stream_.seekp(pos);
+        stream_.setstate(state);
+        return ok;
+    }
+
     // Read entire file as string
     std::optional<mlc::String> read_all() {
         if (!is_open_) return std::nullopt;
@@ -158,6 +877,92 @@ public:
     }
 };
 
+#endif
+
+// Handles for MLC, where an opaque File is a File*. file_handle does not
+// open the file, so set_direct and set_buffer_size can come before
+// file_open_write; close_file closes and deletes the handle.
+
+inline File* file_handle(const mlc::String& path) {
+    return new File(path.as_std_string());
+}
+
+inline bool file_open_read(File* file) {
+    return file->open_read();
+}
+
+inline bool file_open_write(File* file) {
+    return file->open_write();
+}
+
+inline bool file_open_append(File* file) {
+    return file->open_append();
+}
+
+// The next line, or "" past the last one (file_eof tells the two apart)
+inline mlc::String file_read_line(File* file) {
+    return file->read_line().value_or(mlc::String(""));
+}
+
+inline bool file_eof(File* file) {
+    return file->eof();
+}
+
+inline bool file_write(File* file, const mlc::String& data) {
+    return file->write(data);
+}
+
+inline bool file_write_line(File* file, const mlc::String& line) {
+    return file->write_line(line);
+}
+
+// Positional; the sequential read and write position stays where it is
+inline mlc::String file_read_at(File* file, int64_t offset, int size) {
+    if (offset < 0 || size <= 0) return mlc::String("");
+    return file->read_at(static_cast<uint64_t>(offset), static_cast<size_t>(size)).value_or(mlc::String(""));
+}
+
+inline bool file_write_at(File* file, int64_t offset, const mlc::String& data) {
+    return offset >= 0 && file->write_at(static_cast<uint64_t>(offset), data.as_std_string());
+}
+
+// "normal", "sequential", "random", "willneed" or "dontneed", for the whole file
+inline bool file_advise(File* file, const mlc::String& advice) {
+    static constexpr std::pair<std::string_view, Advice> kAdvice[] = {
+        {"normal", Advice::Normal},     {"sequential", Advice::Sequential}, {"random", Advice::Random},
+        {"willneed", Advice::WillNeed}, {"dontneed", Advice::DontNeed},
+    };
+    for (const auto& [name, value] : kAdvice) {
+        if (advice.as_std_string() == name) return file->advise(value);
+    }
+    return false;
+}
+
+inline bool file_preallocate(File* file, int64_t size) {
+    return size >= 0 && file->preallocate(static_cast<uint64_t>(size));
+}
+
+inline void file_set_direct(File* file, bool direct) {
+    file->set_direct(direct);
+}
+
+inline void file_set_buffer_size(File* file, int size) {
+    file->set_buffer_size(size > 0 ? static_cast<size_t>(size) : 0);
+}
+
+inline int64_t file_size(File* file) {
+    return file->size();
+}
+
+inline void file_flush(File* file) {
+    file->flush();
+}
+
+inline void close_file(File* file) {
+    file->close();
+    delete file;
+}
+
 // Convenience functions for reading files
 
 inline mlc::String read_to_string(const mlc::String& path) {
@@ -191,6 +996,10 @@ inline std::vector<mlc::String> read_lines(const mlc::String& path) {
     return lines;
 }
 
+inline Lines lines(const mlc::String& path) {
+    return Lines(path.as_std_string());
+}
+
 // Convenience functions for writing files
 
 inline bool write_string(const mlc::String& path, const mlc::String& content) {
@@ -0,0 +1,449 @@
+#ifndef MLC_FILE_ASYNC_HPP
+#define MLC_FILE_ASYNC_HPP
+
+#include "mlc_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define MLC_FILE_HAS_IO_URING 1
+#endif
+
+// Reading many files at once. On Linux the opens and reads are submitted to
+// an io_uring, up to kUringDepth files in flight; where io_uring is missing
+// or not permitted (kernels before 5.6, seccomp filters in containers), a
+// pool of threads reads the files with blocking calls instead. A file that
+// cannot be read comes back as "", as with read_to_string.
+
+namespace mlc::file {
+
+enum class ReadBackend { Auto, IoUring, Threads };
+
+namespace detail {
+
+inline constexpr unsigned kUringDepth = 256;
+
+// Reads fd to the end, appending to out; false on a read error
+inline bool read_fd_to_end(int fd, std::string& out) {
+    size_t used = out.size();
+    for (;;) {
+        if (used == out.size()) out.resize(std::max<size_t>(used * 2, 16 * 1024));
+        ssize_t n = ::read(fd, out.data() + used, out.size() - used);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            out.resize(used);
+            return n == 0;
+        }
+        used += static_cast<size_t>(n);
+    }
+}
+
+inline std::string read_file_blocking(const std::string& path) {
+    std::string out;
+#ifdef MLC_FILE_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return out;
+    struct stat st;
+    bool ok = true;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        // Room for one byte more than the size, so a file that grew is noticed
+        out.resize(static_cast<size_t>(st.st_size) + 1);
+        size_t used = 0;
+        while (used < out.size()) {
+            ssize_t n = ::read(fd, out.data() + used, out.size() - used);
+            if (n < 0 && errno == EINTR) continue;
+            ok = n >= 0;
+            if (n <= 0) break;
+            used += static_cast<size_t>(n);
+        }
+        out.resize(used);
+        if (ok && used > static_cast<size_t>(st.st_size)) ok = read_fd_to_end(fd, out);
+    } else {
+        ok = read_fd_to_end(fd, out);
+    }
+    if (!ok) out.clear();
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (file.is_open()) out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+#endif
+    return out;
+}
+
+#ifdef MLC_FILE_HAS_IO_URING
+
+// Minimal io_uring over the raw system calls: one submission and one
+// completion ring, used from a single thread
+class Uring {
+public:
+    explicit Uring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return;
+        fd_ = fd;
+        // IORING_OP_OPENAT arrived in 5.6 together with this feature bit
+        if (!(params.features & IORING_FEAT_CUR_PERSONALITY)) return;
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+        sq_ring_ = map(sq_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single ? sq_ring_ : map(cq_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+        if (!sq_ring_ || !cq_ring_ || !sqes_) return;
+
+        char* sq = static_cast<char*>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+        char* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        ok_ = true;
+    }
+
+    ~Uring() {
+        if (sqes_) munmap(sqes_, sqes_size_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_size_);
+        if (sq_ring_) munmap(sq_ring_, sq_size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    bool ok() const { return ok_; }
+
+    // Next free submission entry, zeroed; nullptr when the ring is full
+    io_uring_sqe* next_sqe() {
+        const unsigned tail = *sq_tail_;
+        if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) return nullptr;
+        const unsigned index = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+        return sqe;
+    }
+
+    // Submits queued entries and waits for at least one completion
+    bool submit_and_wait() {
+        for (;;) {
+            long n = ::syscall(__NR_io_uring_enter, fd_, pending_, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (n >= 0) {
+                pending_ -= static_cast<unsigned>(n);
+                return true;
+            }
+            if (errno != EINTR && errno != EAGAIN) return false;
+        }
+    }
+
+    // Takes back the entries queued since the last successful submission,
+    // which the kernel has not seen, calling fn(user_data) for each
+    template <typename Fn>
+    void discard_unsubmitted(Fn&& fn) {
+        const unsigned tail = *sq_tail_;
+        for (unsigned i = tail - pending_; i != tail; ++i) fn(sqes_[sq_array_[i & sq_mask_]].user_data);
+        __atomic_store_n(sq_tail_, tail - pending_, __ATOMIC_RELEASE);
+        pending_ = 0;
+    }
+
+    // Calls fn(user_data, res) for every available completion
+    template <typename Fn>
+    void drain(Fn&& fn) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            const uint64_t user_data = cqe.user_data;
+            const int res = cqe.res;
+            ++head;
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            fn(user_data, res);
+        }
+    }
+
+private:
+    int fd_ = -1;
+    bool ok_ = false;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    size_t sqes_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned pending_ = 0;
+
+    void* map(size_t size, off_t offset) {
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return addr == MAP_FAILED ? nullptr : addr;
+    }
+};
+
+// Opens and reads every file through the ring, calling done(index, content)
+// as each one finishes. Returns false when no ring can be set up or the ring
+// fails part-way; files already passed to done are not passed again.
+template <typename Done>
+bool read_files_uring(const std::vector<mlc::String>& paths, Done& done) {
+    Uring ring(kUringDepth);
+    if (!ring.ok()) return false;
+
+    struct Pending {
+        int fd = -1;
+        size_t size = 0;
+        size_t offset = 0;
+        std::string data;
+        bool busy = false;  // An open (fd < 0) or read is queued or in the kernel
+    };
+    enum : uint64_t { kOpen = 0, kRead = 1 };
+    constexpr uint64_t kCancel = ~uint64_t{0};
+    std::vector<Pending> files(paths.size());
+    size_t next = 0;
+    size_t in_flight = 0;
+
+    auto finish = [&](size_t index, bool ok) {
+        Pending& file = files[index];
+        if (file.fd >= 0) ::close(file.fd);
+        std::string data = ok ? std::move(file.data) : std::string();
+        file = Pending();
+        --in_flight;
+        done(index, std::move(data));
+    };
+    auto queue_read = [&](size_t index) {
+        Pending& file = files[index];
+        io_uring_sqe* sqe = ring.next_sqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = file.fd;
+        sqe->addr = reinterpret_cast<uint64_t>(file.data.data() + file.offset);
+        sqe->len = static_cast<unsigned>(std::min<size_t>(file.size - file.offset, 1u << 30));
+        sqe->off = file.offset;
+        sqe->user_data = index * 2 + kRead;
+        file.busy = true;
+    };
+
+    // After a failed submission nothing may be left behind: the kernel must
+    // not read into buffers that are about to be freed, and an open that
+    // completes late returns a descriptor to close. Entries the kernel never
+    // saw are taken back; the rest are cancelled and reaped.
+    auto abandon = [&] {
+        ring.discard_unsubmitted([&](uint64_t user_data) { files[user_data / 2].busy = false; });
+        size_t outstanding = 0;
+        for (size_t i = 0; i < next; ++i) {
+            if (!files[i].busy) continue;
+            ++outstanding;
+            io_uring_sqe* sqe = ring.next_sqe();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = i * 2 + (files[i].fd >= 0 ? kRead : kOpen);
+            sqe->user_data = kCancel;
+        }
+        while (outstanding > 0 && ring.submit_and_wait()) {
+            ring.drain([&](uint64_t user_data, int res) {
+                if (user_data == kCancel) return;
+                if (user_data % 2 == kOpen && res >= 0) ::close(res);
+                files[user_data / 2].busy = false;
+                --outstanding;
+            });
+        }
+        for (Pending& file : files) {
+            if (file.fd >= 0) ::close(file.fd);
+        }
+        // A ring that cannot even be waited on may still write to the
+        // buffers of reads in flight: they are leaked rather than freed
+        if (outstanding > 0) new std::vector<Pending>(std::move(files));
+    };
+
+    while (next < paths.size() || in_flight > 0) {
+        // Each file has one operation in flight, so the ring never overflows
+        while (next < paths.size() && in_flight < kUringDepth) {
+            io_uring_sqe* sqe = ring.next_sqe();
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<uint64_t>(paths[next].as_std_string().c_str());
+            sqe->open_flags = O_RDONLY | O_CLOEXEC;
+            sqe->user_data = next * 2 + kOpen;
+            files[next].busy = true;
+            ++next;
+            ++in_flight;
+        }
+        if (!ring.submit_and_wait()) {
+            // read_files reads whatever was not delivered the blocking way
+            abandon();
+            return false;
+        }
+        ring.drain([&](uint64_t user_data, int res) {
+            const size_t index = static_cast<size_t>(user_data / 2);
+            Pending& file = files[index];
+            file.busy = false;
+            if (user_data % 2 == kOpen) {
+                if (res < 0) return finish(index, false);
+                file.fd = res;
+                struct stat st;
+                if (fstat(file.fd, &st) != 0) return finish(index, false);
+                if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+                    // Pipes and /proc files have no size up front
+                    return finish(index, read_fd_to_end(file.fd, file.data));
+                }
+                file.size = static_cast<size_t>(st.st_size);
+                file.data.resize(file.size);
+                return queue_read(index);
+            }
+            if (res < 0) return finish(index, false);
+            file.offset += static_cast<size_t>(res);
+            if (res == 0 || file.offset == file.size) {
+                file.data.resize(file.offset);
+                return finish(index, true);
+            }
+            queue_read(index);
+        });
+    }
+    return true;
+}
+
+#endif
+
+// Reads the files on a pool of threads. With on_caller set, done(index,
+// content) runs on the calling thread in completion order; otherwise the
+// workers call it themselves, concurrently for different indices.
+template <typename Done>
+void read_files_threads(const std::vector<mlc::String>& paths, Done& done, bool on_caller) {
+    const size_t workers = std::min<size_t>(paths.size(), std::max(4u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<std::pair<size_t, std::string>> finished;
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+        pool.emplace_back([&] {
+            for (size_t i = next.fetch_add(1); i < paths.size(); i = next.fetch_add(1)) {
+                std::string data = read_file_blocking(paths[i].as_std_string());
+                if (!on_caller) {
+                    done(i, std::move(data));
+                    continue;
+                }
+                bool was_empty;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    was_empty = finished.empty();
+                    finished.emplace_back(i, std::move(data));
+                }
+                if (was_empty) ready.notify_one();
+            }
+        });
+    }
+    if (on_caller) {
+        std::vector<std::pair<size_t, std::string>> batch;
+        for (size_t received = 0; received < paths.size();) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&] { return !finished.empty(); });
+                batch.swap(finished);
+            }
+            for (auto& item : batch) done(item.first, std::move(item.second));
+            received += batch.size();
+            batch.clear();
+        }
+    }
+    for (auto& t : pool) t.join();
+}
+
+// done(index, content) is called once per path. The ring delivers on the
+// calling thread; the thread pool does too when on_caller is set.
+template <typename Done>
+void read_files(const std::vector<mlc::String>& paths, ReadBackend backend, bool on_caller, Done&& done) {
+    if (paths.empty()) return;
+#ifdef MLC_FILE_HAS_IO_URING
+    if (backend != ReadBackend::Threads) {
+        std::vector<bool> delivered(paths.size(), false);
+        auto deliver = [&](size_t index, std::string&& data) {
+            delivered[index] = true;
+            done(index, std::move(data));
+        };
+        if (read_files_uring(paths, deliver)) return;
+        // Whatever the ring did not deliver is read the blocking way
+        std::vector<mlc::String> rest;
+        std::vector<size_t> rest_index;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (!delivered[i]) {
+                rest.push_back(paths[i]);
+                rest_index.push_back(i);
+            }
+        }
+        auto remap = [&](size_t index, std::string&& data) { done(rest_index[index], std::move(data)); };
+        if (!rest.empty()) read_files_threads(rest, remap, on_caller);
+        return;
+    }
+#else
+    (void)backend;
+#endif
+    read_files_threads(paths, done, on_caller);
+}
+
+} // namespace detail
+
+// Whether read_many can use io_uring here
+inline bool io_uring_available() {
+#ifdef MLC_FILE_HAS_IO_URING
+    static const bool available = detail::Uring(1).ok();
+    return available;
+#else
+    return false;
+#endif
+}
+
+// Contents of every file, in the order of `paths`
+inline std::vector<mlc::String> read_many(const std::vector<mlc::String>& paths,
+                                          ReadBackend backend = ReadBackend::Auto) {
+    std::vector<mlc::String> contents(paths.size());
+    detail::read_files(paths, backend, false,
+                       [&](size_t index, std::string&& data) { contents[index] = mlc::String(std::move(data)); });
+    return contents;
+}
+
+// read_many on a background thread
+inline std::future<std::vector<mlc::String>> read_many_async(std::vector<mlc::String> paths,
+                                                             ReadBackend backend = ReadBackend::Auto) {
+    return std::async(std::launch::async,
+                      [paths = std::move(paths), backend] { return read_many(paths, backend); });
+}
+
+// Calls on_read(path, content) on the calling thread as each file finishes,
+// in completion order, so work on early files overlaps the remaining reads
+template <typename Fn>
+void read_each(const std::vector<mlc::String>& paths, Fn&& on_read, ReadBackend backend = ReadBackend::Auto) {
+    detail::read_files(paths, backend, true,
+                       [&](size_t index, std::string&& data) { on_read(paths[index], mlc::String(std::move(data))); });
+}
+
+} // namespace mlc::file
+
+#endif // MLC_FILE_ASYNC_HPP
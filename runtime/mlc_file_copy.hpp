@@ -0,0 +1,276 @@
+#ifndef MLC_FILE_COPY_HPP
+#define MLC_FILE_COPY_HPP
+
+#include "mlc_file.hpp"
+#include "mlc_io.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#define MLC_FILE_HAS_KERNEL_COPY 1
+#endif
+
+// Copying bytes between files without routing them through user space.
+// On Linux the kernel moves them with copy_file_range (which can share
+// blocks on filesystems that support reflinks), sendfile or splice, in that
+// order, each tried when the previous one is refused for this pair of
+// descriptors; elsewhere, and as the last resort, a read/write loop.
+
+namespace mlc::file {
+
+// Outcome of a copy. On failure bytes is what was moved before the error.
+struct CopyStats {
+    bool ok = false;
+    int64_t bytes = 0;
+    double seconds = 0.0;
+    double mb_per_s = 0.0;
+    mlc::String method = "none";  // the mechanism that moved the last bytes
+};
+
+namespace detail {
+
+// Runs body(stats), which reports success, and times it
+template <typename Body>
+CopyStats timed_copy(Body&& body) {
+    CopyStats stats;
+    const auto start = std::chrono::steady_clock::now();
+    stats.ok = body(stats);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stats.seconds = elapsed.count();
+    stats.mb_per_s = stats.seconds > 0 ? static_cast<double>(stats.bytes) / stats.seconds / 1e6 : 0.0;
+    return stats;
+}
+
+#ifdef MLC_FILE_HAS_MMAP
+
+// Errors that mean "not for these descriptors", after which the next
+// mechanism is tried from the current offsets
+inline bool copy_unsupported(int error) {
+    return error == EINVAL || error == ENOSYS || error == EXDEV || error == EOPNOTSUPP || error == EBADF ||
+           error == ESPIPE;
+}
+
+inline constexpr size_t kCopyChunk = size_t{1} << 30;
+
+// Runs step(max) until it reports end of input (0) or an error (-1, with
+// errno set). Returns 1 when the input was moved to the end, 0 when step
+// does not apply to these descriptors and nothing has failed, -1 on error.
+template <typename Step>
+int move_with(CopyStats& stats, const char* method, Step&& step) {
+    bool moved = false;
+    for (;;) {
+        ssize_t n = step(kCopyChunk);
+        if (n > 0) {
+            stats.bytes += n;
+            if (!moved) stats.method = method;
+            moved = true;
+            continue;
+        }
+        if (n == 0) {
+            if (!moved) stats.method = method;
+            return 1;
+        }
+        if (errno == EINTR || errno == EAGAIN) continue;
+        return copy_unsupported(errno) ? 0 : -1;
+    }
+}
+
+inline bool write_all_fd(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#ifdef MLC_FILE_HAS_KERNEL_COPY
+// splice needs a pipe on one side: straight into out when it is one,
+// otherwise through a pipe of our own. It refuses O_APPEND outputs only
+// after taking the bytes from in, so those are left to the caller.
+inline int splice_fd(int in, int out, CopyStats& stats) {
+    if (::fcntl(out, F_GETFL) & O_APPEND) return 0;
+    struct stat st;
+    if (::fstat(out, &st) == 0 && S_ISFIFO(st.st_mode)) {
+        return move_with(stats, "splice",
+                         [&](size_t max) { return ::splice(in, nullptr, out, nullptr, max, SPLICE_F_MOVE); });
+    }
+    int pipe_fds[2];
+    if (::pipe2(pipe_fds, O_CLOEXEC) != 0) return 0;
+    ::fcntl(pipe_fds[1], F_SETPIPE_SZ, 1 << 20);  // best effort; 64 KB otherwise
+    const int result = move_with(stats, "splice", [&](size_t max) -> ssize_t {
+        ssize_t n = ::splice(in, nullptr, pipe_fds[1], nullptr, max, SPLICE_F_MOVE);
+        if (n <= 0) return n;
+        // The pipe must be drained into out before the next splice
+        for (ssize_t left = n; left > 0;) {
+            ssize_t m = ::splice(pipe_fds[0], nullptr, out, nullptr, static_cast<size_t>(left), SPLICE_F_MOVE);
+            if (m < 0 && errno == EINTR) continue;
+            if (m <= 0) {
+                // Bytes stuck in the pipe cannot be handed to the fallback
+                errno = EIO;
+                return -1;
+            }
+            left -= m;
+        }
+        return n;
+    });
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    return result;
+}
+#endif
+
+// Moves everything from in's offset to its end onto out's offset
+inline bool move_fd(int in, int out, CopyStats& stats) {
+#ifdef MLC_FILE_HAS_KERNEL_COPY
+    int result = move_with(stats, "copy_file_range",
+                           [&](size_t max) { return ::copy_file_range(in, nullptr, out, nullptr, max, 0); });
+    if (result != 0) return result > 0;
+
+    result = move_with(stats, "sendfile", [&](size_t max) { return ::sendfile(out, in, nullptr, max); });
+    if (result != 0) return result > 0;
+
+    result = splice_fd(in, out, stats);
+    if (result != 0) return result > 0;
+#endif
+    std::vector<char> buffer(1 << 20);
+    stats.method = "read/write";
+    for (;;) {
+        ssize_t n = ::read(in, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return false;
+        if (n == 0) return true;
+        if (!write_all_fd(out, buffer.data(), static_cast<size_t>(n))) return false;
+        stats.bytes += n;
+    }
+}
+
+#else
+
+inline bool move_stream(std::ifstream& in, std::ofstream& out, CopyStats& stats) {
+    std::vector<char> buffer(1 << 20);
+    stats.method = "read/write";
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize n = in.gcount();
+        if (n <= 0) break;
+        out.write(buffer.data(), n);
+        if (!out) return false;
+        stats.bytes += n;
+    }
+    return in.eof();
+}
+
+#endif
+
+} // namespace detail
+
+// Copies src over dst, which is created with src's permissions or
+// truncated. Copying a file onto itself fails and leaves it untouched.
+inline CopyStats copy(const mlc::String& src, const mlc::String& dst) {
+    return detail::timed_copy([&](CopyStats& stats) {
+#ifdef MLC_FILE_HAS_MMAP
+        int in = ::open(src.as_std_string().c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) return false;
+        struct stat in_st;
+        if (::fstat(in, &in_st) != 0) {
+            ::close(in);
+            return false;
+        }
+        int out = ::open(dst.as_std_string().c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, in_st.st_mode & 0777);
+        struct stat out_st;
+        if (out < 0 || ::fstat(out, &out_st) != 0 ||
+            (out_st.st_dev == in_st.st_dev && out_st.st_ino == in_st.st_ino) || ::ftruncate(out, 0) != 0) {
+            if (out >= 0) ::close(out);
+            ::close(in);
+            return false;
+        }
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        bool ok = detail::move_fd(in, out, stats);
+        ::close(in);
+        return ::close(out) == 0 && ok;
+#else
+        std::ifstream in(src.as_std_string(), std::ios::binary);
+        std::ofstream out(dst.as_std_string(), std::ios::binary | std::ios::trunc);
+        if (!in.is_open() || !out.is_open()) return false;
+        bool ok = detail::move_stream(in, out, stats);
+        out.close();
+        return ok && !out.fail();
+#endif
+    });
+}
+
+// Writes the files in srcs one after another into dst, created or
+// truncated. Stops at the first source that cannot be read. Like cat, it
+// fails with dst untouched when dst is also one of the sources.
+inline CopyStats concat(const std::vector<mlc::String>& srcs, const mlc::String& dst) {
+    return detail::timed_copy([&](CopyStats& stats) {
+        bool ok = true;
+#ifdef MLC_FILE_HAS_MMAP
+        int out = ::open(dst.as_std_string().c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+        if (out < 0) return false;
+        struct stat out_st;
+        ok = ::fstat(out, &out_st) == 0;
+        for (const auto& src : srcs) {
+            struct stat in_st;
+            if (ok && ::stat(src.as_std_string().c_str(), &in_st) == 0 && in_st.st_dev == out_st.st_dev &&
+                in_st.st_ino == out_st.st_ino) {
+                ok = false;
+            }
+        }
+        if (!ok || ::ftruncate(out, 0) != 0) {
+            ::close(out);
+            return false;
+        }
+        for (const auto& src : srcs) {
+            int in = ::open(src.as_std_string().c_str(), O_RDONLY | O_CLOEXEC);
+            ok = in >= 0 && detail::move_fd(in, out, stats);
+            if (in >= 0) ::close(in);
+            if (!ok) break;
+        }
+        return ::close(out) == 0 && ok;
+#else
+        std::ofstream out(dst.as_std_string(), std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        for (const auto& src : srcs) {
+            std::ifstream in(src.as_std_string(), std::ios::binary);
+            ok = in.is_open() && detail::move_stream(in, out, stats);
+            if (!ok) break;
+        }
+        out.close();
+        return ok && !out.fail();
+#endif
+    });
+}
+
+// Writes the file at path to an open descriptor (1 for stdout), from the
+// descriptor's current position. Buffered output of IO is flushed first so
+// it stays in order.
+inline CopyStats write_bytes_to_fd(const mlc::String& path, int fd) {
+    return detail::timed_copy([&](CopyStats& stats) {
+        mlc::io::flush();
+#ifdef MLC_FILE_HAS_MMAP
+        int in = ::open(path.as_std_string().c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) return false;
+        bool ok = detail::move_fd(in, fd, stats);
+        ::close(in);
+        return ok;
+#else
+        (void)path;
+        (void)fd;
+        (void)stats;
+        return false;
+#endif
+    });
+}
+
+} // namespace mlc::file
+
+#endif // MLC_FILE_COPY_HPP
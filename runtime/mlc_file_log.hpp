@@ -0,0 +1,334 @@
+#ifndef MLC_FILE_LOG_HPP
+#define MLC_FILE_LOG_HPP
+
+#include "mlc_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Append-only log with group commit. Appends from any number of threads are
+// pushed onto a lock-free list; one writer thread takes everything queued,
+// writes it with a single write(2) and makes it durable with a single
+// fdatasync(2). Records that arrive while a batch is being synced form the
+// next batch, so under load the cost of a sync is shared by many appends.
+
+namespace mlc::file {
+
+struct AppendLogOptions {
+    // Latency bound: how long the writer waits after the first record of a
+    // batch for more to arrive. 0 writes as soon as the writer is free.
+    std::chrono::microseconds max_delay{0};
+    // Throughput bound: a batch is written once this many bytes are
+    // pending, even within max_delay
+    size_t max_batch_bytes = 4 << 20;
+    // fdatasync each batch; without it batches only reach the page cache
+    bool sync = true;
+};
+
+struct AppendLogStats {
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    uint64_t batches = 0;
+    uint64_t max_batch_records = 0;
+    uint64_t syncs = 0;
+    uint64_t sync_ns = 0;      // total time spent in fdatasync
+    uint64_t max_sync_ns = 0;
+
+    double mean_batch_records() const { return batches ? static_cast<double>(records) / batches : 0.0; }
+    double mean_sync_us() const { return syncs ? sync_ns / 1e3 / syncs : 0.0; }
+};
+
+class AppendLog {
+public:
+    // The file is created if missing and always appended to. A log that
+    // cannot be opened refuses appends.
+    explicit AppendLog(const std::string& path, AppendLogOptions options = {}) : options_(options) {
+#ifdef MLC_FILE_HAS_MMAP
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0) return;
+#else
+        stream_.open(path, std::ios::out | std::ios::app | std::ios::binary);
+        if (!stream_.is_open()) return;
+#endif
+        open_.store(true);
+        writer_ = std::thread([this] { write_loop(); });
+    }
+
+    ~AppendLog() { close(); }
+
+    AppendLog(const AppendLog&) = delete;
+    AppendLog& operator=(const AppendLog&) = delete;
+
+    bool is_open() const { return open_.load(std::memory_order_relaxed); }
+    // False once a write or sync has failed; later appends are refused
+    bool ok() const { return !failed_.load(std::memory_order_relaxed); }
+
+    // Queues data as is. With wait, returns once it is written and synced.
+    bool append(std::string_view data, bool wait = false) { return push(data, false, wait); }
+
+    // Queues line followed by '\n'
+    bool append_line(std::string_view line, bool wait = false) { return push(line, true, wait); }
+
+    // Returns once everything this thread appended before the call is durable
+    bool sync() { return push(std::string_view(), false, true); }
+
+    // Writes and syncs what is queued, then closes the file. Appends must not
+    // race with close.
+    bool close() {
+        if (!writer_.joinable()) return false;
+        open_.store(false);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+#ifdef MLC_FILE_HAS_MMAP
+        if (::close(fd_) != 0) failed_.store(true);
+        fd_ = -1;
+#else
+        stream_.close();
+#endif
+        return ok();
+    }
+
+    AppendLogStats stats() const {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+
+private:
+    // Queued record. Waited-for records live on the appending thread's stack
+    // and are released by setting done; the rest are owned by the writer.
+    struct Node {
+        Node* next = nullptr;
+        std::string data;
+        bool owned = true;
+        bool done = false;
+        bool succeeded = false;
+    };
+
+    static constexpr size_t kNeverWake = std::numeric_limits<size_t>::max();
+
+    AppendLogOptions options_;
+    std::atomic<bool> open_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<Node*> head_{nullptr};          // newest first
+    std::atomic<size_t> pending_bytes_{0};
+    std::atomic<size_t> wake_at_{kNeverWake};   // pending bytes that wake the writer
+    std::mutex mutex_;
+    std::condition_variable wake_;              // writer sleeps here
+    std::condition_variable done_;              // waiting appenders sleep here
+    bool stop_ = false;
+    mutable std::mutex stats_mutex_;
+    AppendLogStats stats_;
+    std::string batch_;
+    std::thread writer_;
+#ifdef MLC_FILE_HAS_MMAP
+    int fd_ = -1;
+#else
+    std::ofstream stream_;
+#endif
+
+    bool push(std::string_view data, bool newline, bool wait) {
+        if (!is_open() || !ok()) return false;
+        const size_t size = data.size() + (newline ? 1 : 0);
+        Node local;
+        Node* node = wait ? &local : new Node;
+        node->owned = !wait;
+        node->data.reserve(size);
+        node->data.append(data);
+        if (newline) node->data += '\n';
+
+        // Counted before it is visible, so the writer never subtracts first.
+        // An empty record (sync) counts as one byte so it still wakes the writer.
+        const size_t weight = std::max<size_t>(size, 1);
+        const size_t pending = pending_bytes_.fetch_add(weight) + weight;
+        node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        if (pending >= wake_at_.load()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_at_.store(kNeverWake);
+            wake_.notify_one();
+        }
+        if (!wait) return true;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return local.done; });
+        return local.succeeded;
+    }
+
+    // Sleeps until pending bytes reach threshold, the deadline passes or the
+    // log is closing. wake_at_ is published before the queue is checked, so
+    // an append either sees it and wakes the writer or is seen here.
+    void wait_for_pending(size_t threshold, std::chrono::steady_clock::time_point deadline, bool timed) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_at_.store(threshold);
+        auto ready = [&] {
+            return stop_ || wake_at_.load() == kNeverWake || pending_bytes_.load() >= threshold;
+        };
+        if (timed) {
+            wake_.wait_until(lock, deadline, ready);
+        } else {
+            wake_.wait(lock, ready);
+        }
+        wake_at_.store(kNeverWake);
+    }
+
+    void write_loop() {
+        for (;;) {
+            if (head_.load(std::memory_order_acquire) == nullptr) {
+                bool stopping;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping = stop_;
+                }
+                if (stopping) return;
+                wait_for_pending(1, {}, false);
+                continue;
+            }
+            if (options_.max_delay.count() > 0 && pending_bytes_.load() < options_.max_batch_bytes) {
+                wait_for_pending(options_.max_batch_bytes,
+                                 std::chrono::steady_clock::now() + options_.max_delay, true);
+            }
+            write_batch(head_.exchange(nullptr, std::memory_order_acquire));
+        }
+    }
+
+    // Writes a list taken from head_ (newest first) in append order
+    void write_batch(Node* list) {
+        Node* ordered = nullptr;
+        size_t records = 0;
+        while (list) {
+            Node* next = list->next;
+            list->next = ordered;
+            ordered = list;
+            list = next;
+        }
+        batch_.clear();
+        size_t taken = 0;
+        for (Node* node = ordered; node; node = node->next) {
+            batch_.append(node->data);
+            taken += std::max<size_t>(node->data.size(), 1);
+            if (!node->data.empty()) ++records;
+        }
+        pending_bytes_.fetch_sub(taken);
+
+        bool succeeded = !failed_.load();
+        uint64_t sync_ns = 0;
+        if (succeeded && !batch_.empty()) {
+            succeeded = write_all(batch_.data(), batch_.size());
+            if (succeeded && options_.sync) {
+                const auto start = std::chrono::steady_clock::now();
+                succeeded = sync_file();
+                sync_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                    std::chrono::steady_clock::now() - start)
+                                                    .count());
+            }
+            if (!succeeded) failed_.store(true);
+        }
+        if (!batch_.empty()) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.records += records;
+            stats_.bytes += batch_.size();
+            stats_.batches += 1;
+            stats_.max_batch_records = std::max<uint64_t>(stats_.max_batch_records, records);
+            if (options_.sync && succeeded) {
+                stats_.syncs += 1;
+                stats_.sync_ns += sync_ns;
+                stats_.max_sync_ns = std::max(stats_.max_sync_ns, sync_ns);
+            }
+        }
+
+        bool waiters = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Node* node = ordered; node;) {
+                Node* next = node->next;
+                if (node->owned) {
+                    delete node;
+                } else {
+                    node->succeeded = succeeded;
+                    node->done = true;
+                    waiters = true;
+                }
+                node = next;
+            }
+        }
+        if (waiters) done_.notify_all();
+    }
+
+    bool write_all(const char* data, size_t size) {
+#ifdef MLC_FILE_HAS_MMAP
+        while (size > 0) {
+            ssize_t n = ::write(fd_, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+#else
+        stream_.write(data, static_cast<std::streamsize>(size));
+        return stream_.good();
+#endif
+    }
+
+    bool sync_file() {
+#ifdef MLC_FILE_HAS_MMAP
+#if defined(__APPLE__)
+        return ::fsync(fd_) == 0;
+#else
+        while (::fdatasync(fd_) != 0) {
+            if (errno != EINTR) return false;
+        }
+        return true;
+#endif
+#else
+        stream_.flush();
+        return stream_.good();
+#endif
+    }
+};
+
+// Handles for MLC, where an opaque AppendLog is an AppendLog*. The log is
+// deleted by close_log.
+
+inline AppendLog* open_log(const mlc::String& path) {
+    return new AppendLog(path.as_std_string());
+}
+
+inline bool log_is_open(AppendLog* log) {
+    return log->is_open();
+}
+
+inline bool log_line(AppendLog* log, const mlc::String& line) {
+    return log->append_line(line.as_std_string());
+}
+
+// Returns once line is on disk
+inline bool commit_line(AppendLog* log, const mlc::String& line) {
+    return log->append_line(line.as_std_string(), true);
+}
+
+inline bool sync_log(AppendLog* log) {
+    return log->sync();
+}
+
+inline bool close_log(AppendLog* log) {
+    const bool ok = log->close();
+    delete log;
+    return ok;
+}
+
+} // namespace mlc::file
+
+#endif // MLC_FILE_LOG_HPP
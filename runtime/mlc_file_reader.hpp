@@ -0,0 +1,236 @@
+#ifndef MLC_FILE_READER_HPP
+#define MLC_FILE_READER_HPP
+
+#include "mlc_file.hpp"
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Streaming reads of files too large to hold in memory, and of pipes. A
+// Reader hands out fixed-size chunks from two buffers; with prefetching on,
+// a background thread fills one buffer while the caller works on the other.
+// Records splits that chunk stream on a delimiter.
+
+namespace mlc::file {
+
+class Reader {
+public:
+    static constexpr size_t kDefaultChunk = 1 << 20;
+
+    // chunk_size == 0 uses kDefaultChunk. A file that cannot be opened has no chunks.
+    explicit Reader(const std::string& path, size_t chunk_size = kDefaultChunk, bool prefetch = true)
+        : chunk_size_(chunk_size == 0 ? kDefaultChunk : chunk_size) {
+#ifdef MLC_FILE_HAS_MMAP
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return;
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+        stream_.open(path, std::ios::binary);
+        if (!stream_.is_open()) return;
+#endif
+        open_ = true;
+        slots_[0].data.resize(chunk_size_);
+        if (prefetch) {
+            slots_[1].data.resize(chunk_size_);
+            worker_ = std::thread([this] { prefetch_loop(); });
+        }
+    }
+
+    ~Reader() {
+        if (worker_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            ready_.notify_all();
+            worker_.join();
+        }
+#ifdef MLC_FILE_HAS_MMAP
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    bool is_open() const { return open_; }
+    size_t chunk_size() const { return chunk_size_; }
+
+    // Next chunk: chunk_size bytes, except for the last one. The view is
+    // valid until the following call; false at the end of the file.
+    bool next(std::string_view& chunk) {
+        if (!open_) return false;
+        if (!worker_.joinable()) {
+            Slot& slot = slots_[0];
+            slot.size = read_full(slot.data.data(), chunk_size_);
+            chunk = std::string_view(slot.data.data(), slot.size);
+            return slot.size > 0;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (held_ >= 0) {
+            slots_[held_].full = false;
+            held_ = -1;
+            ready_.notify_all();
+        }
+        ready_.wait(lock, [&] { return slots_[next_].full; });
+        Slot& slot = slots_[next_];
+        if (slot.size == 0) return false;
+        chunk = std::string_view(slot.data.data(), slot.size);
+        held_ = static_cast<int>(next_);
+        next_ ^= 1;
+        return true;
+    }
+
+    using iterator = detail::ViewIterator<Reader>;
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+    // Every remaining chunk, copied
+    operator std::vector<mlc::String>() {
+        std::vector<mlc::String> result;
+        for (std::string_view chunk : *this) result.emplace_back(chunk);
+        return result;
+    }
+
+private:
+    struct Slot {
+        std::string data;
+        size_t size = 0;
+        bool full = false;
+    };
+
+    size_t chunk_size_;
+    bool open_ = false;
+    Slot slots_[2];
+    size_t next_ = 0;  // slot handed out by the next call
+    int held_ = -1;    // slot the caller is reading, if any
+    bool stop_ = false;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::thread worker_;
+#ifdef MLC_FILE_HAS_MMAP
+    int fd_ = -1;
+#else
+    std::ifstream stream_;
+#endif
+
+    // Fills the slots in turn, each as soon as the caller has released it.
+    // An empty slot marks the end of the file.
+    void prefetch_loop() {
+        for (size_t index = 0;; index ^= 1) {
+            Slot& slot = slots_[index];
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [&] { return stop_ || !slot.full; });
+                if (stop_) return;
+            }
+            const size_t size = read_full(slot.data.data(), chunk_size_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slot.size = size;
+                slot.full = true;
+            }
+            ready_.notify_all();
+            if (size == 0) return;
+        }
+    }
+
+    // Reads until `size` bytes arrive or the input ends; errors end the input
+    size_t read_full(char* out, size_t size) {
+        size_t total = 0;
+#ifdef MLC_FILE_HAS_MMAP
+        while (total < size) {
+            ssize_t n = ::read(fd_, out + total, size - total);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            total += static_cast<size_t>(n);
+        }
+#else
+        stream_.read(out, static_cast<std::streamsize>(size));
+        total = static_cast<size_t>(stream_.gcount());
+#endif
+        return total;
+    }
+};
+
+// Records of a file separated by `delimiter`, which is not part of the
+// record. A record that spans chunks is stitched together in a carry buffer;
+// the rest are views into the chunk. Memory is two chunks plus the longest
+// record. An empty final record (a trailing delimiter) is not produced.
+class Records {
+public:
+    explicit Records(const std::string& path, char delimiter = '\n', size_t chunk_size = Reader::kDefaultChunk,
+                     bool prefetch = true)
+        : reader_(path, chunk_size, prefetch), delimiter_(delimiter) {}
+
+    bool next(std::string_view& record) {
+        if (carry_returned_) {
+            carry_.clear();
+            carry_returned_ = false;
+        }
+        for (;;) {
+            const void* found = chunk_.empty() ? nullptr : std::memchr(chunk_.data(), delimiter_, chunk_.size());
+            if (found) {
+                const size_t size = static_cast<size_t>(static_cast<const char*>(found) - chunk_.data());
+                if (carry_.empty()) {
+                    record = chunk_.substr(0, size);
+                } else {
+                    carry_.append(chunk_.data(), size);
+                    record = carry_;
+                    carry_returned_ = true;
+                }
+                chunk_.remove_prefix(size + 1);
+                return true;
+            }
+            carry_.append(chunk_);
+            chunk_ = std::string_view();
+            if (!reader_.next(chunk_)) break;
+        }
+        if (carry_.empty()) return false;
+        record = carry_;
+        carry_returned_ = true;
+        return true;
+    }
+
+    using iterator = detail::ViewIterator<Records>;
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+    // Every remaining record, copied
+    operator std::vector<mlc::String>() {
+        std::vector<mlc::String> result;
+        for (std::string_view record : *this) result.emplace_back(record);
+        return result;
+    }
+
+private:
+    Reader reader_;
+    char delimiter_;
+    std::string_view chunk_;
+    std::string carry_;
+    bool carry_returned_ = false;
+};
+
+// Chunks of chunk_size bytes (<= 0 uses the default), prefetched
+inline Reader chunks(const mlc::String& path, int chunk_size) {
+    return Reader(path.as_std_string(), chunk_size > 0 ? static_cast<size_t>(chunk_size) : 0);
+}
+
+// Records split on the first byte of `delimiter` ("\n" when it is empty)
+inline Records records(const mlc::String& path, const mlc::String& delimiter) {
+    const std::string& d = delimiter.as_std_string();
+    return Records(path.as_std_string(), d.empty() ? '\n' : d[0]);
+}
+
+} // namespace mlc::file
+
+#endif // MLC_FILE_READER_HPP
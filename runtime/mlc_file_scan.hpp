@@ -0,0 +1,137 @@
+#ifndef MLC_FILE_SCAN_HPP
+#define MLC_FILE_SCAN_HPP
+
+#include "mlc_file.hpp"
+#include "mlc_regex.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Parallel grep over large files: the file is memory-mapped, split into
+// chunks on line boundaries, and the chunks are scanned on worker threads.
+// Results are returned in file order.
+
+namespace mlc::file {
+
+namespace detail {
+
+// Chunks smaller than this are not worth a thread hand-off
+inline constexpr size_t kMinScanChunk = 1 << 20;
+
+inline size_t scan_thread_count(int threads) {
+    if (threads > 0) return static_cast<size_t>(threads);
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : hw;
+}
+
+// Split text into about `parts` ranges, each ending just after a '\n' (or at the end)
+inline std::vector<std::pair<size_t, size_t>> line_chunks(std::string_view text, size_t parts) {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    size_t target = std::max(kMinScanChunk, text.size() / std::max<size_t>(parts, 1) + 1);
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = begin + target;
+        if (end >= text.size()) {
+            end = text.size();
+        } else {
+            const void* nl = std::memchr(text.data() + end, '\n', text.size() - end);
+            end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - text.data()) + 1 : text.size();
+        }
+        chunks.emplace_back(begin, end);
+        begin = end;
+    }
+    return chunks;
+}
+
+// Call hit(line_start, line) for every line in text[begin, end) that contains
+// a match. Lines holding the pattern's required literal are located with a
+// literal search over the whole chunk, so most lines are never tested.
+template <typename Hit>
+void scan_chunk(std::string_view text, size_t begin, size_t end, const Regex& re, Hit&& hit) {
+    std::string_view chunk = text.substr(0, end);
+    size_t pos = begin;
+    while (pos < end) {
+        size_t candidate = re.next_candidate(chunk, pos);
+        if (candidate == std::string_view::npos) break;
+
+        size_t line_start = candidate;
+        while (line_start > pos && chunk[line_start - 1] != '\n') --line_start;
+        const void* nl = std::memchr(chunk.data() + candidate, '\n', end - candidate);
+        size_t line_end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - chunk.data()) : end;
+
+        std::string_view line = chunk.substr(line_start, line_end - line_start);
+        if (re.test_view(line)) hit(line_start, line);
+        pos = line_end + 1;
+    }
+}
+
+// Scan the chunks on up to `threads` workers; make(line_start, line) builds
+// one result element. Per-chunk results are concatenated in file order.
+template <typename T, typename Make>
+std::vector<T> scan_lines(std::string_view text, const Regex& re, int threads, Make make) {
+    std::vector<T> results;
+    if (!re.is_valid() || text.empty()) return results;
+
+    size_t workers = scan_thread_count(threads);
+    auto chunks = line_chunks(text, workers * 4);
+    std::vector<std::vector<T>> per_chunk(chunks.size());
+
+    auto run_chunk = [&](size_t index) {
+        scan_chunk(text, chunks[index].first, chunks[index].second, re,
+                   [&](size_t start, std::string_view line) { per_chunk[index].push_back(make(start, line)); });
+    };
+
+    workers = std::min(workers, chunks.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < chunks.size(); ++i) run_chunk(i);
+    } else {
+        std::atomic<size_t> next{0};
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t w = 0; w < workers; ++w) {
+            pool.emplace_back([&] {
+                for (size_t i = next.fetch_add(1); i < chunks.size(); i = next.fetch_add(1)) run_chunk(i);
+            });
+        }
+        for (auto& t : pool) t.join();
+    }
+
+    size_t total = 0;
+    for (const auto& part : per_chunk) total += part.size();
+    results.reserve(total);
+    for (auto& part : per_chunk) {
+        std::move(part.begin(), part.end(), std::back_inserter(results));
+    }
+    return results;
+}
+
+} // namespace detail
+
+// Lines of the file at `path` containing a match of `re`, in file order and
+// without their trailing newline (like read_lines). threads <= 0 uses every core.
+inline std::vector<mlc::String> regex_scan_file(const mlc::String& path, const mlc::Regex& re, int threads = 0) {
+    MappedFile file(path.as_std_string());
+    if (!file.is_open()) return {};
+    return detail::scan_lines<mlc::String>(file.view(), re, threads, [](size_t, std::string_view line) {
+        return mlc::String(std::string(line));
+    });
+}
+
+// Byte offsets of the matching lines' first characters, in file order
+inline std::vector<int64_t> regex_scan_offsets(const mlc::String& path, const mlc::Regex& re, int threads = 0) {
+    MappedFile file(path.as_std_string());
+    if (!file.is_open()) return {};
+    return detail::scan_lines<int64_t>(file.view(), re, threads, [](size_t start, std::string_view) {
+        return static_cast<int64_t>(start);
+    });
+}
+
+} // namespace mlc::file
+
+#endif // MLC_FILE_SCAN_HPP
@@ -0,0 +1,334 @@
+#ifndef MLC_FILE_WALK_HPP
+#define MLC_FILE_WALK_HPP
+
+#include "mlc_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef MLC_FILE_HAS_MMAP
+#include <dirent.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#define MLC_FILE_HAS_GETDENTS 1
+#endif
+
+// Parallel directory traversal. Each thread owns a deque of directories
+// still to be listed: it takes its newest entry (depth first, so few names
+// are queued at once) and idle threads steal the oldest entry of another
+// deque, which is usually the largest subtree left. Directories are opened
+// with openat relative to the root and listed with getdents64 on Linux, or
+// readdir elsewhere; the file type comes from the directory entry, so
+// regular files are never stat'ed. Symbolic links are not followed.
+
+namespace mlc::file {
+
+struct WalkOptions {
+    int threads = 0;  // <= 0 uses every core
+};
+
+// Glob match: * and ? stay within one path component, ** spans any number
+// of them ("src/**/*.mlc" also matches "src/a.mlc"), [abc], [a-z] and [!x]
+// match one character from a class, and \ escapes the next character.
+inline bool glob_match(std::string_view pattern, std::string_view text) {
+    while (!pattern.empty()) {
+        const char c = pattern.front();
+        if (c == '*') {
+            if (pattern.size() > 1 && pattern[1] == '*') {
+                std::string_view rest = pattern.substr(2);
+                if (!rest.empty() && rest.front() == '/' && glob_match(rest.substr(1), text)) return true;
+                for (size_t i = 0; i <= text.size(); ++i) {
+                    if (glob_match(rest, text.substr(i))) return true;
+                }
+                return false;
+            }
+            std::string_view rest = pattern.substr(1);
+            for (size_t i = 0; i <= text.size(); ++i) {
+                if (glob_match(rest, text.substr(i))) return true;
+                if (i < text.size() && text[i] == '/') break;
+            }
+            return false;
+        }
+        if (text.empty()) return false;
+        const char t = text.front();
+        if (c == '?') {
+            if (t == '/') return false;
+            pattern.remove_prefix(1);
+        } else if (c == '[' && pattern.find(']', 2) != std::string_view::npos) {
+            size_t i = 1;
+            const bool negated = pattern[i] == '!' || pattern[i] == '^';
+            if (negated) ++i;
+            bool matched = false;
+            // A ']' right after '[' or '[!' is a member, not the end
+            for (bool first = true; i < pattern.size() && (first || pattern[i] != ']'); first = false) {
+                if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+                    matched = matched || (pattern[i] <= t && t <= pattern[i + 2]);
+                    i += 3;
+                } else {
+                    matched = matched || pattern[i] == t;
+                    ++i;
+                }
+            }
+            if (i >= pattern.size() || matched == negated || t == '/') return false;
+            pattern.remove_prefix(i + 1);
+        } else {
+            if (c == '\\' && pattern.size() > 1) pattern.remove_prefix(1);
+            if (pattern.front() != t) return false;
+            pattern.remove_prefix(1);
+        }
+        text.remove_prefix(1);
+    }
+    return text.empty();
+}
+
+namespace detail {
+
+#ifdef MLC_FILE_HAS_MMAP
+
+// A pattern without '/' applies to the file name, as with find -name; one
+// with '/' to the path below the root. An empty pattern matches every file.
+inline bool walk_matches(std::string_view pattern, std::string_view relative, size_t name_at) {
+    if (pattern.empty()) return true;
+    if (pattern.find('/') == std::string_view::npos) return glob_match(pattern, relative.substr(name_at));
+    return glob_match(pattern, relative);
+}
+
+// Calls on_entry(name, type) for each entry of the open directory fd
+// except "." and "..", with type a DT_ constant (DT_UNKNOWN where the
+// filesystem does not record it). Closes fd.
+template <typename OnEntry>
+void list_directory(int fd, std::vector<char>& buffer, OnEntry&& on_entry) {
+#ifdef MLC_FILE_HAS_GETDENTS
+    struct linux_dirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+    for (;;) {
+        const long n = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        for (long at = 0; at < n;) {
+            const auto* entry = reinterpret_cast<const linux_dirent64*>(buffer.data() + at);
+            at += entry->d_reclen;
+            const char* name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+            on_entry(std::string_view(name), entry->d_type);
+        }
+    }
+    ::close(fd);
+#else
+    (void)buffer;
+    DIR* dir = ::fdopendir(fd);
+    if (!dir) {
+        ::close(fd);
+        return;
+    }
+    while (const dirent* entry = ::readdir(dir)) {
+        const char* name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+#ifdef DT_UNKNOWN
+        on_entry(std::string_view(name), entry->d_type);
+#else
+        on_entry(std::string_view(name), 0);
+#endif
+    }
+    ::closedir(dir);
+#endif
+}
+
+// Work-stealing traversal. on_file(path, worker) receives the full path of
+// each matching regular file on the thread that found it.
+class Walker {
+public:
+    Walker(const std::string& root, const std::string& pattern, int threads)
+        : root_(root), pattern_(pattern) {
+        if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+        workers_.resize(static_cast<size_t>(std::max(threads, 1)));
+        for (auto& worker : workers_) worker = std::make_unique<Worker>();
+        prefix_ = root_.empty() || root_.back() == '/' ? root_ : root_ + '/';
+    }
+
+    size_t threads() const { return workers_.size(); }
+
+    // False when root is not a directory that can be opened
+    template <typename OnFile>
+    bool run(OnFile&& on_file) {
+        root_fd_ = ::open(root_.empty() ? "." : root_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (root_fd_ < 0) return false;
+        pending_.store(1);
+        push(0, std::string());
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < workers_.size(); ++i) {
+            threads.emplace_back([this, i, &on_file] { work(i, on_file); });
+        }
+        work(0, on_file);
+        for (auto& thread : threads) thread.join();
+        ::close(root_fd_);
+        return true;
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::string> dirs;  // paths below the root, "" for the root
+        std::vector<char> buffer = std::vector<char>(64 * 1024);
+    };
+
+    std::string root_;
+    std::string prefix_;
+    std::string pattern_;
+    int root_fd_ = -1;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> pending_{0};  // directories queued or being listed
+    std::atomic<size_t> queued_{0};
+    std::atomic<int> idle_{0};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
+    void push(size_t self, std::string dir) {
+        {
+            std::lock_guard<std::mutex> lock(workers_[self]->mutex);
+            workers_[self]->dirs.push_back(std::move(dir));
+        }
+        queued_.fetch_add(1);
+        if (idle_.load() > 0) {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            idle_cv_.notify_one();
+        }
+    }
+
+    // Own newest directory, else another worker's oldest
+    bool take(size_t self, std::string& dir) {
+        for (size_t k = 0; k < workers_.size(); ++k) {
+            Worker& worker = *workers_[(self + k) % workers_.size()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.dirs.empty()) continue;
+            if (k == 0) {
+                dir = std::move(worker.dirs.back());
+                worker.dirs.pop_back();
+            } else {
+                dir = std::move(worker.dirs.front());
+                worker.dirs.pop_front();
+            }
+            queued_.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename OnFile>
+    void work(size_t self, OnFile& on_file) {
+        std::string dir;
+        for (;;) {
+            if (take(self, dir)) {
+                list(self, dir, on_file);
+                if (pending_.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(idle_mutex_);
+                    idle_cv_.notify_all();
+                    return;
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            idle_.fetch_add(1);
+            idle_cv_.wait(lock, [&] { return queued_.load() > 0 || pending_.load() == 0; });
+            idle_.fetch_sub(1);
+            if (pending_.load() == 0) return;
+        }
+    }
+
+    template <typename OnFile>
+    void list(size_t self, const std::string& dir, OnFile& on_file) {
+        const int fd = dir.empty() ? ::dup(root_fd_)
+                                   : ::openat(root_fd_, dir.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) return;
+        std::string relative = dir.empty() ? std::string() : dir + '/';
+        const size_t name_at = relative.size();
+        std::string path;
+        list_directory(fd, workers_[self]->buffer, [&](std::string_view name, unsigned char type) {
+            relative.resize(name_at);
+            relative.append(name);
+            if (type == DT_UNKNOWN) {
+                struct stat st;
+                if (::fstatat(root_fd_, relative.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) return;
+                type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+            }
+            if (type == DT_DIR) {
+                pending_.fetch_add(1);
+                push(self, relative);
+            } else if (type == DT_REG && walk_matches(pattern_, relative, name_at)) {
+                path.assign(prefix_);
+                path.append(relative);
+                on_file(path, self);
+            }
+        });
+    }
+};
+
+#endif
+
+} // namespace detail
+
+// Paths (root joined with the path below it) of the regular files under
+// root that match pattern, sorted. Empty when root cannot be listed.
+inline std::vector<mlc::String> walk(const mlc::String& root, const mlc::String& pattern, WalkOptions options = {}) {
+    std::vector<mlc::String> result;
+#ifdef MLC_FILE_HAS_MMAP
+    detail::Walker walker(root.as_std_string(), pattern.as_std_string(), options.threads);
+    std::vector<std::vector<std::string>> found(walker.threads());
+    walker.run([&](const std::string& path, size_t worker) { found[worker].push_back(path); });
+    std::vector<std::string> paths;
+    for (auto& part : found) {
+        if (paths.empty()) {
+            paths = std::move(part);
+        } else {
+            paths.insert(paths.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    result.reserve(paths.size());
+    for (auto& path : paths) result.emplace_back(std::move(path));
+#else
+    (void)root;
+    (void)pattern;
+    (void)options;
+#endif
+    return result;
+}
+
+// Calls fn(path) for each matching file as it is found, on the walker's
+// threads: calls run concurrently and in no particular order. Returns the
+// number of files passed to fn.
+template <typename Fn>
+int walk_each(const mlc::String& root, const mlc::String& pattern, Fn&& fn, WalkOptions options = {}) {
+    std::atomic<int> count{0};
+#ifdef MLC_FILE_HAS_MMAP
+    detail::Walker walker(root.as_std_string(), pattern.as_std_string(), options.threads);
+    walker.run([&](const std::string& path, size_t) {
+        fn(mlc::String(path));
+        count.fetch_add(1, std::memory_order_relaxed);
+    });
+#else
+    (void)root;
+    (void)pattern;
+    (void)fn;
+    (void)options;
+#endif
+    return count.load();
+}
+
+} // namespace mlc::file
+
+#endif // MLC_FILE_WALK_HPP
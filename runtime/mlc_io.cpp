@@ -1,50 +1,287 @@
 #include "mlc_io.hpp"
 
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace mlc::io {
 namespace {
 std::vector<String> g_args;
 
-int write_to_stream(std::ostream& stream, const String& value, bool newline) {
-    stream << value.as_std_string();
-    if (newline) {
-        stream << '\n';
+// Buffered writer for one of the standard descriptors. Writes that do not
+// fit are preceded by a flush; a single write larger than the buffer goes
+// straight to the descriptor.
+class OutputBuffer {
+public:
+    static constexpr size_t kCapacity = 64 * 1024;
+
+    OutputBuffer(int fd, FlushPolicy policy) : fd_(fd) {
+        buffer_.reserve(kCapacity);
+        apply_policy(policy);
     }
-    stream.flush();
-    return 0;
+
+    void set_policy(FlushPolicy policy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_locked();
+        apply_policy(policy);
+    }
+
+    bool line_buffered() const { return line_; }
+
+    void write(std::string_view text, bool newline) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        append(text, newline);
+        if (capacity_ == 0 || (line_ && (newline || text.find('\n') != std::string_view::npos))) flush_locked();
+    }
+
+    void write_lines(const std::vector<String>& lines) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const String& line : lines) append(line.as_std_string(), true);
+        if (capacity_ == 0 || (line_ && !lines.empty())) flush_locked();
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_locked();
+    }
+
+private:
+    int fd_;
+    size_t capacity_ = kCapacity;
+    bool line_ = false;
+    std::string buffer_;
+    std::mutex mutex_;
+
+    void apply_policy(FlushPolicy policy) {
+        if (policy == FlushPolicy::Auto) policy = ::isatty(fd_) ? FlushPolicy::Line : FlushPolicy::Block;
+        line_ = policy == FlushPolicy::Line;
+        capacity_ = policy == FlushPolicy::Unbuffered ? 0 : kCapacity;
+    }
+
+    void append(std::string_view text, bool newline) {
+        const size_t size = text.size() + (newline ? 1 : 0);
+        if (buffer_.size() + size > capacity_) {
+            flush_locked();
+            if (size > capacity_) {
+                write_all(text.data(), text.size());
+                if (newline) write_all("\n", 1);
+                return;
+            }
+        }
+        buffer_.append(text);
+        if (newline) buffer_ += '\n';
+    }
+
+    void flush_locked() {
+        if (buffer_.empty()) return;
+        write_all(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    // Output to a closed pipe or full disk is dropped, as it was with iostreams
+    void write_all(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd_, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+};
+
+// Never destroyed, so output from other static destructors still works;
+// everything pending is flushed at exit instead.
+alignas(OutputBuffer) unsigned char g_stdout_storage[sizeof(OutputBuffer)];
+alignas(OutputBuffer) unsigned char g_stderr_storage[sizeof(OutputBuffer)];
+
+void flush_at_exit() {
+    flush();
+}
+
+struct OutputStreams {
+    OutputBuffer* out;
+    OutputBuffer* err;
+
+    OutputStreams()
+        : out(new (g_stdout_storage) OutputBuffer(STDOUT_FILENO, FlushPolicy::Auto)),
+          err(new (g_stderr_storage) OutputBuffer(STDERR_FILENO, FlushPolicy::Line)) {
+        std::atexit(flush_at_exit);
+    }
+};
+
+const OutputStreams& streams() {
+    static const OutputStreams instance;
+    return instance;
+}
+
+OutputBuffer& stream_for(int stream) {
+    return stream == 2 ? *streams().err : *streams().out;
+}
+
+// An interactive prompt must be visible before waiting for input
+void flush_before_input() {
+    OutputBuffer& out = *streams().out;
+    if (out.line_buffered()) out.flush();
+}
+
+// Refill buffer over fd 0. Unread input is [pos_, end_); a line that does
+// not fit is moved to the front and the buffer doubles. End of input is not
+// sticky: once it is reached, every call tries read(2) again.
+class InputBuffer {
+public:
+    static constexpr size_t kRefill = 256 * 1024;
+
+    bool next_line(std::string_view& line) {
+        size_t scanned = pos_;
+        for (;;) {
+            const char* begin = buffer_.data();
+            if (const void* nl = std::memchr(begin + scanned, '\n', end_ - scanned)) {
+                const size_t at = static_cast<size_t>(static_cast<const char*>(nl) - begin);
+                line = std::string_view(begin + pos_, at - pos_);
+                pos_ = at + 1;
+                return true;
+            }
+            const size_t offset = end_ - pos_;
+            if (!refill()) break;
+            scanned = pos_ + offset;
+        }
+        if (pos_ == end_) return false;
+        line = std::string_view(buffer_.data() + pos_, end_ - pos_);
+        pos_ = end_;
+        return true;
+    }
+
+    // Buffered input first, then the rest of fd 0: a regular file is read
+    // with one read(2) of its remaining size, anything else in growing chunks
+    std::string read_all() {
+        std::string out(buffer_.data() + pos_, end_ - pos_);
+        pos_ = end_ = 0;
+        flush_before_input();
+
+        bool sized = false;
+        struct stat st;
+        if (::fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode)) {
+            const off_t at = ::lseek(STDIN_FILENO, 0, SEEK_CUR);
+            if (at >= 0 && st.st_size > at) {
+                const size_t have = out.size();
+                out.resize(have + static_cast<size_t>(st.st_size - at));
+                out.resize(have + read_into(out.data() + have, out.size() - have));
+                sized = true;
+            }
+        }
+        // After a sized read only a file that grew meanwhile has more to give
+        size_t used = out.size();
+        for (;;) {
+            if (used == out.size()) out.resize(sized ? used + kRefill : std::max(used * 2, used + kRefill));
+            const size_t n = read_some(out.data() + used, out.size() - used);
+            if (n == 0) break;
+            used += n;
+        }
+        out.resize(used);
+        return out;
+    }
+
+private:
+    std::string buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+
+    bool refill() {
+        if (pos_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0;
+        }
+        if (end_ == buffer_.size()) buffer_.resize(std::max(kRefill, buffer_.size() * 2));
+        flush_before_input();
+        const size_t n = read_some(buffer_.data() + end_, buffer_.size() - end_);
+        end_ += n;
+        return n > 0;
+    }
+
+    // One read(2); 0 at end of input or on error
+    static size_t read_some(char* data, size_t size) {
+        for (;;) {
+            ssize_t n = ::read(STDIN_FILENO, data, size);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR) return 0;
+        }
+    }
+
+    // Fills up to size bytes unless input ends first
+    static size_t read_into(char* data, size_t size) {
+        size_t total = 0;
+        while (total < size) {
+            const size_t n = read_some(data + total, size - total);
+            if (n == 0) break;
+            total += n;
+        }
+        return total;
+    }
+};
+
+InputBuffer& input() {
+    static InputBuffer instance;
+    return instance;
 }
 } // namespace
 
+void set_flush_policy(int stream, FlushPolicy policy) {
+    stream_for(stream).set_policy(policy);
+}
+
 int print(const String& value) {
-    return write_to_stream(std::cout, value, false);
+    streams().out->write(value.as_std_string(), false);
+    return 0;
 }
 
 int println(const String& value) {
-    return write_to_stream(std::cout, value, true);
+    streams().out->write(value.as_std_string(), true);
+    return 0;
+}
+
+void print_many(const std::vector<String>& lines) {
+    streams().out->write_lines(lines);
 }
 
 int eprint(const String& value) {
-    return write_to_stream(std::cerr, value, false);
+    streams().err->write(value.as_std_string(), false);
+    return 0;
 }
 
 int eprintln(const String& value) {
-    return write_to_stream(std::cerr, value, true);
+    streams().err->write(value.as_std_string(), true);
+    return 0;
+}
+
+void flush() {
+    streams().out->flush();
+    streams().err->flush();
 }
 
 String read_line() {
-    std::string line;
-    if (!std::getline(std::cin, line)) {
+    std::string_view line;
+    if (!input().next_line(line)) {
         return String("");
     }
     return String(line);
 }
 
 String read_all() {
-    std::ostringstream oss;
-    oss << std::cin.rdbuf();
-    return String(oss.str());
+    return String(input().read_all());
+}
+
+bool next_line_view(std::string_view& line) {
+    return input().next_line(line);
 }
 
 const std::vector<String>& args() {
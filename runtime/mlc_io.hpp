@@ -2,25 +2,99 @@
 #define AURORA_IO_HPP
 
 #include <iostream>
+#include <cstddef>
 #include <cstdlib>
+#include <iterator>
+#include <string_view>
 #include <vector>
 #include "mlc_string.hpp"
 
 namespace mlc {
 namespace io {
 
+// Console output goes through a user-space buffer per stream. The buffers
+// are flushed by flush(), when full, at exit, before reading stdin from a
+// terminal, and after every line under FlushPolicy::Line. stdout starts out
+// Auto; stderr starts out Line so that diagnostics are not held back. Output
+// still buffered when the process dies abnormally is lost.
+enum class FlushPolicy {
+    Auto,        // Line on a terminal, Block otherwise
+    Line,        // Flush after each write that ends a line
+    Block,       // Flush only when the buffer fills up
+    Unbuffered,  // Write through immediately
+};
+
+// stream: 1 (stdout) or 2 (stderr); flushes what is pending first
+void set_flush_policy(int stream, FlushPolicy policy);
+
 // Basic console output
 int print(const String& s);
 int println(const String& s);
 
+// println for each line, batched into as few writes as the buffer allows
+void print_many(const std::vector<String>& lines);
+
 // Error output
 int eprint(const String& s);
 int eprintln(const String& s);
 
-// I/O functions
+// Write out whatever stdout and stderr have buffered
+void flush();
+
+// Input: stdin is read with read(2) into a refill buffer that grows to hold
+// the longest line. Lines exclude their '\n'; read_line returns "" at the
+// end of input.
 String read_line();
 String read_all();
 
+// Next line of stdin as a view that stays valid until stdin is read again;
+// false at the end of input
+bool next_line_view(std::string_view& line);
+
+// Lazy range over the remaining lines of stdin, yielding views:
+//     for (std::string_view line : stdin_lines()) ...
+// It converts to a vector of every remaining line.
+class StdinLines {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        explicit iterator(bool more) : done_(!more) { ++*this; }
+
+        reference operator*() const { return line_; }
+        pointer operator->() const { return &line_; }
+        iterator& operator++() {
+            if (!done_) done_ = !next_line_view(line_);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(const iterator& other) const { return done_ == other.done_; }
+
+    private:
+        std::string_view line_;
+        bool done_ = true;
+    };
+
+    iterator begin() const { return iterator(true); }
+    iterator end() const { return iterator(); }
+
+    operator std::vector<String>() const {
+        std::vector<String> lines;
+        for (std::string_view line : *this) lines.emplace_back(std::string(line));
+        return lines;
+    }
+};
+
+inline StdinLines stdin_lines() {
+    return StdinLines();
+}
+
 // Command line arguments
 const std::vector<String>& args();
 void set_args(std::vector<String>&& new_args);
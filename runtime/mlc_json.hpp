@@ -1,147 +1,207 @@
 #ifndef AURORA_JSON_HPP
 #define AURORA_JSON_HPP
 
+#include <charconv>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
-#include <string>
-#include <optional>
-#include "json.hpp"
+#include "mlc_json_dom.hpp"
+#include "mlc_json_writer.hpp"
 #include "mlc_string.hpp"
 
 namespace mlc::json {
 
-using json = nlohmann::json;
-
-// Forward declaration for JsonValue
-struct JsonValue;
+// JsonValue type that mirrors Aurora's JsonValue sum type.
+// A value is a Node plus a shared reference to the Document whose storage it
+// points into, so parsed values, json_get results and array elements are
+// handles into one immutable arena rather than copies. Scalars need no document.
+// Documents can also share nodes with the documents they retain, which is how
+// json_set and json_array_push produce new versions without deep copies; only
+// a document with a single handle is ever changed in place.
+class JsonValue {
+private:
+    std::shared_ptr<const Document> doc_;
+    Node node_;
+
+    // Build a value that owns a copy of `node`
+    static JsonValue owning(const Node& node) {
+        auto doc = Document::copy_of(node);
+        Node root = doc->root();
+        return JsonValue(std::move(doc), root);
+    }
 
-// JsonValue type that mirrors Aurora's JsonValue sum type
-struct JsonValue {
-    // Variant holding different JSON types
-    std::variant<
-        std::monostate,              // JsonNull
-        bool,                        // JsonBool
-        double,                      // JsonNumber (using double for better precision)
-        mlc::String,              // JsonString
-        std::vector<JsonValue>,      // JsonArray
-        json                         // JsonObject (using nlohmann::json for objects)
-    > value;
+    // Whether node_ is (still) the root container of doc_
+    bool owns_root() const {
+        const Node& root = doc_->root();
+        if (root.type != node_.type || root.size != node_.size) return false;
+        return node_.type == Type::Array ? root.items == node_.items : root.members == node_.members;
+    }
 
+public:
     // Constructors
-    JsonValue() : value(std::monostate{}) {}
-    JsonValue(std::monostate) : value(std::monostate{}) {}
-    JsonValue(bool b) : value(b) {}
-    JsonValue(double n) : value(n) {}
-    JsonValue(float n) : value(static_cast<double>(n)) {}
-    JsonValue(int32_t n) : value(static_cast<double>(n)) {}
-    JsonValue(const mlc::String& s) : value(s) {}
-    JsonValue(const std::vector<JsonValue>& arr) : value(arr) {}
-    JsonValue(const json& obj) : value(obj) {}
+    JsonValue() = default;
+    JsonValue(std::monostate) {}
+    JsonValue(bool b) : node_(Node::from_bool(b)) {}
+    JsonValue(double n) : node_(Node::from_number(n)) {}
+    JsonValue(float n) : node_(Node::from_number(static_cast<double>(n))) {}
+    JsonValue(int32_t n) : node_(Node::from_number(static_cast<double>(n))) {}
+    JsonValue(const char* s) : JsonValue(owning(Node::from_string(s, std::strlen(s)))) {}
+    JsonValue(const mlc::String& s) : JsonValue(owning(Node::from_string(s.c_str(), s.as_std_string().size()))) {}
+
+    JsonValue(const std::vector<JsonValue>& arr) {
+        auto doc = std::make_shared<Document>();
+        std::vector<Node> items;
+        items.reserve(arr.size());
+        for (const auto& elem : arr) items.push_back(elem.adopt_into(*doc));
+        doc->set_root(make_array(doc->arena(), items.data(), items.size()));
+        node_ = doc->root();
+        doc_ = std::move(doc);
+    }
+
+    JsonValue(std::shared_ptr<const Document> doc, const Node& node) : doc_(std::move(doc)), node_(node) {}
+
+    // The root of a document that was being grown in place
+    explicit JsonValue(std::shared_ptr<Document> doc) : node_(doc->root()) { doc_ = std::move(doc); }
+
+    // This value's node for storing inside `doc`: strings are copied into it,
+    // containers stay in their own document, which `doc` then retains
+    Node adopt_into(Document& doc) const {
+        if (node_.type == Type::String) return Node::from_string(doc.arena().copy_string(node_.string()), node_.size);
+        if (node_.type == Type::Array || node_.type == Type::Object) doc.retain(doc_);
+        return node_;
+    }
+
+    // A document whose root container of `type` starts as this value and can
+    // grow in place. If this handle is the only one on its document and holds
+    // its root, that document is reused; otherwise a new one shares this
+    // value's nodes (so other handles keep seeing the old version).
+    std::shared_ptr<Document> take_growable(Type type) && {
+        if (doc_ && doc_.use_count() == 1 && node_.type == type && owns_root()) {
+            node_ = Node();
+            return std::const_pointer_cast<Document>(std::move(doc_));
+        }
+        auto doc = std::make_shared<Document>();
+        if (node_.type == type) {
+            doc->retain(std::move(doc_));
+            doc->set_root(node_);
+        } else {
+            doc->set_root(type == Type::Array ? make_array(doc->arena(), nullptr, 0) : make_object(doc->arena(), nullptr, 0));
+        }
+        return doc;
+    }
+
+    // Object from key/value pairs (document order is kept)
+    static JsonValue object(const std::vector<std::pair<mlc::String, JsonValue>>& entries) {
+        auto doc = std::make_shared<Document>();
+        std::vector<Member> members;
+        members.reserve(entries.size());
+        for (const auto& [key, value] : entries) {
+            members.push_back({doc->arena().copy_string(key.as_std_string()),
+                               static_cast<uint32_t>(key.as_std_string().size()),
+                               value.adopt_into(*doc)});
+        }
+        doc->set_root(make_object(doc->arena(), members.data(), members.size()));
+        Node root = doc->root();
+        return JsonValue(std::move(doc), root);
+    }
+
+    const Node& node() const { return node_; }
+    const std::shared_ptr<const Document>& document() const { return doc_; }
+    Type type() const { return node_.type; }
 
     // Type checking
-    bool is_null() const { return std::holds_alternative<std::monostate>(value); }
-    bool is_bool() const { return std::holds_alternative<bool>(value); }
-    bool is_number() const { return std::holds_alternative<double>(value); }
-    bool is_string() const { return std::holds_alternative<mlc::String>(value); }
-    bool is_array() const { return std::holds_alternative<std::vector<JsonValue>>(value); }
-    bool is_object() const { return std::holds_alternative<json>(value); }
+    bool is_null() const { return node_.type == Type::Null; }
+    bool is_bool() const { return node_.type == Type::Bool; }
+    bool is_number() const { return node_.type == Type::Number; }
+    bool is_string() const { return node_.type == Type::String; }
+    bool is_array() const { return node_.type == Type::Array; }
+    bool is_object() const { return node_.type == Type::Object; }
 
     // Value getters (return std::optional for safety)
     std::optional<bool> as_bool() const {
-        if (auto* b = std::get_if<bool>(&value)) return *b;
+        if (is_bool()) return node_.boolean;
         return std::nullopt;
     }
 
     std::optional<double> as_number() const {
-        if (auto* n = std::get_if<double>(&value)) return *n;
+        if (is_number()) return node_.number;
         return std::nullopt;
     }
 
     std::optional<mlc::String> as_string() const {
-        if (auto* s = std::get_if<mlc::String>(&value)) return *s;
+        if (is_string()) return mlc::String(std::string(node_.string()));
         return std::nullopt;
     }
 
-    std::optional<std::vector<JsonValue>> as_array() const {
-        if (auto* arr = std::get_if<std::vector<JsonValue>>(&value)) return *arr;
+    // String contents without copying (valid while this value is alive)
+    std::optional<std::string_view> string_view() const {
+        if (is_string()) return node_.string();
         return std::nullopt;
     }
 
-    std::optional<json> as_object() const {
-        if (auto* obj = std::get_if<json>(&value)) return *obj;
-        return std::nullopt;
+    std::optional<std::vector<JsonValue>> as_array() const {
+        if (!is_array()) return std::nullopt;
+        std::vector<JsonValue> out;
+        out.reserve(node_.size);
+        for (uint32_t i = 0; i < node_.size; ++i) out.emplace_back(doc_, node_.items[i]);
+        return out;
     }
-};
 
-// Convert nlohmann::json to Aurora JsonValue
-inline JsonValue from_nlohmann_json(const json& j) {
-    if (j.is_null()) {
-        return JsonValue(std::monostate{});
-    } else if (j.is_boolean()) {
-        return JsonValue(j.get<bool>());
-    } else if (j.is_number()) {
-        return JsonValue(j.get<double>());
-    } else if (j.is_string()) {
-        return JsonValue(mlc::String(j.get<std::string>().c_str()));
-    } else if (j.is_array()) {
-        std::vector<JsonValue> arr;
-        arr.reserve(j.size());
-        for (const auto& elem : j) {
-            arr.push_back(from_nlohmann_json(elem));
+    std::optional<std::vector<std::pair<mlc::String, JsonValue>>> as_object() const {
+        if (!is_object()) return std::nullopt;
+        std::vector<std::pair<mlc::String, JsonValue>> out;
+        out.reserve(node_.size);
+        for (uint32_t i = 0; i < node_.size; ++i) {
+            const Member& member = node_.members[i];
+            out.emplace_back(mlc::String(std::string(member.name())), JsonValue(doc_, member.value));
         }
-        return JsonValue(arr);
-    } else if (j.is_object()) {
-        return JsonValue(j);  // Store object as nlohmann::json directly
+        return out;
     }
-    return JsonValue(std::monostate{});
-}
 
-// Convert Aurora JsonValue to nlohmann::json
-inline json to_nlohmann_json(const JsonValue& jv) {
-    if (jv.is_null()) {
-        return json(nullptr);
-    } else if (jv.is_bool()) {
-        return json(*jv.as_bool());
-    } else if (jv.is_number()) {
-        return json(*jv.as_number());
-    } else if (jv.is_string()) {
-        return json(jv.as_string()->c_str());
-    } else if (jv.is_array()) {
-        json arr = json::array();
-        for (const auto& elem : *jv.as_array()) {
-            arr.push_back(to_nlohmann_json(elem));
-        }
-        return arr;
-    } else if (jv.is_object()) {
-        return *jv.as_object();
+    // Number of array elements or object members (0 for scalars)
+    size_t size() const { return is_array() || is_object() ? node_.size : 0; }
+
+    // Object member by key / array element by index, sharing this document
+    std::optional<JsonValue> get(std::string_view key) const {
+        if (const Node* found = find_member(node_, key)) return JsonValue(doc_, *found);
+        return std::nullopt;
     }
-    return json(nullptr);
-}
+
+    std::optional<JsonValue> at(size_t index) const {
+        if (is_array() && index < node_.size) return JsonValue(doc_, node_.items[index]);
+        return std::nullopt;
+    }
+};
+
+// Declared with JsonWriter, which is defined before JsonValue
+inline JsonWriter& JsonWriter::value(const JsonValue& json) { return value(json.node()); }
 
 // Parse JSON string - returns JsonValue or JsonNull on error
 // TODO: Return Result<JsonValue, String> when Result type is available
 inline JsonValue parse_json(const mlc::String& json_str) {
-    try {
-        json parsed = json::parse(json_str.c_str());
-        return from_nlohmann_json(parsed);
-    } catch (const json::parse_error& e) {
-        // Return null on parse error for now
-        return JsonValue(std::monostate{});
-    } catch (const std::exception& e) {
-        return JsonValue(std::monostate{});
-    }
+    std::shared_ptr<const Document> doc = Document::parse(json_str.as_std_string());
+    if (!doc->ok()) return JsonValue(std::monostate{});
+    Node root = doc->root();
+    return JsonValue(std::move(doc), root);
 }
 
 // Stringify JSON value to string
 inline mlc::String stringify_json(const JsonValue& value) {
-    json j = to_nlohmann_json(value);
-    return mlc::String(j.dump().c_str());
+    std::string out;
+    JsonWriter(out).value(value);
+    return mlc::String(std::move(out));
 }
 
 // Stringify JSON value with pretty printing
 inline mlc::String stringify_json_pretty(const JsonValue& value, int32_t indent) {
-    json j = to_nlohmann_json(value);
-    return mlc::String(j.dump(indent).c_str());
+    std::string out;
+    JsonWriter(out, indent < 0 ? 0 : indent).value(value);
+    return mlc::String(std::move(out));
 }
 
 // Helper constructors
@@ -167,86 +227,101 @@ inline JsonValue json_array(const std::vector<JsonValue>& arr) {
 
 // Object construction helper - creates empty object
 inline JsonValue json_object() {
-    return JsonValue(json::object());
+    return JsonValue::object({});
 }
 
-// Get value from JSON object by key
+// Get value from JSON object by key (shares the object's document; no copy)
 inline std::optional<JsonValue> json_get(const JsonValue& obj, const mlc::String& key) {
-    if (auto* j = std::get_if<json>(&obj.value)) {
-        if (j->is_object() && j->contains(key.c_str())) {
-            return from_nlohmann_json((*j)[key.c_str()]);
-        }
-    }
-    return std::nullopt;
+    return obj.get(key.as_std_string());
 }
 
-// Set value in JSON object
+// Set value in JSON object (a non-object becomes a new object). When `obj`
+// was the last handle on its document, e.g. passed with std::move, the
+// document is updated in place; otherwise the result shares obj's members.
 inline JsonValue json_set(JsonValue obj, const mlc::String& key, const JsonValue& value) {
-    if (auto* j = std::get_if<json>(&obj.value)) {
-        if (j->is_object()) {
-            json new_obj = *j;
-            new_obj[key.c_str()] = to_nlohmann_json(value);
-            return JsonValue(new_obj);
-        }
-    }
-    // If not an object, create a new object with this key-value pair
-    json new_obj = json::object();
-    new_obj[key.c_str()] = to_nlohmann_json(value);
-    return JsonValue(new_obj);
+    std::shared_ptr<Document> doc = std::move(obj).take_growable(Type::Object);
+    doc->set_member(key.as_std_string(), value.adopt_into(*doc));
+    return JsonValue(std::move(doc));
 }
 
 // Check if object has key
 inline bool json_has_key(const JsonValue& obj, const mlc::String& key) {
-    if (auto* j = std::get_if<json>(&obj.value)) {
-        if (j->is_object()) {
-            return j->contains(key.c_str());
-        }
-    }
-    return false;
+    return find_member(obj.node(), key.as_std_string()) != nullptr;
 }
 
-// Get all keys from JSON object
+// Get all keys from JSON object (in document order)
 inline std::vector<mlc::String> json_keys(const JsonValue& obj) {
     std::vector<mlc::String> keys;
-    if (auto* j = std::get_if<json>(&obj.value)) {
-        if (j->is_object()) {
-            for (auto it = j->begin(); it != j->end(); ++it) {
-                keys.push_back(mlc::String(it.key().c_str()));
-            }
-        }
+    if (obj.is_object()) {
+        const Node& node = obj.node();
+        keys.reserve(node.size);
+        for (uint32_t i = 0; i < node.size; ++i) keys.push_back(mlc::String(std::string(node.members[i].name())));
     }
     return keys;
 }
 
 // Get array length
 inline int32_t json_array_length(const JsonValue& arr) {
-    if (auto* vec = std::get_if<std::vector<JsonValue>>(&arr.value)) {
-        return static_cast<int32_t>(vec->size());
-    }
-    return 0;
+    return arr.is_array() ? static_cast<int32_t>(arr.size()) : 0;
 }
 
 // Get element from JSON array by index
 inline std::optional<JsonValue> json_array_get(const JsonValue& arr, int32_t index) {
-    if (auto* vec = std::get_if<std::vector<JsonValue>>(&arr.value)) {
-        if (index >= 0 && index < static_cast<int32_t>(vec->size())) {
-            return (*vec)[index];
-        }
-    }
-    return std::nullopt;
+    if (index < 0) return std::nullopt;
+    return arr.at(static_cast<size_t>(index));
+}
+
+// Push element to JSON array (a non-array becomes a new array), in place
+// when `arr` was the last handle on its document, as with json_set
+inline JsonValue json_array_push(JsonValue arr, const JsonValue& value) {
+    std::shared_ptr<Document> doc = std::move(arr).take_growable(Type::Array);
+    doc->push_item(value.adopt_into(*doc));
+    return JsonValue(std::move(doc));
 }
 
-// Push element to JSON array
-inline JsonValue json_array_push(const JsonValue& arr, const JsonValue& value) {
-    std::vector<JsonValue> new_arr;
+// ============================================================================
+// JsonBuilder
+// ============================================================================
+
+// Mutable array or object under construction. push() and set() append in
+// place (amortized O(1)); build() hands the document over as a JsonValue and
+// leaves the builder empty.
+class JsonBuilder {
+private:
+    std::shared_ptr<Document> doc_;
+    Type type_;
 
-    if (auto* vec = std::get_if<std::vector<JsonValue>>(&arr.value)) {
-        new_arr = *vec;
+    explicit JsonBuilder(Type type) : type_(type) { reset(); }
+
+    void reset() {
+        doc_ = std::make_shared<Document>();
+        doc_->set_root(type_ == Type::Array ? make_array(doc_->arena(), nullptr, 0) : make_object(doc_->arena(), nullptr, 0));
     }
 
-    new_arr.push_back(value);
-    return JsonValue(new_arr);
-}
+public:
+    static JsonBuilder array() { return JsonBuilder(Type::Array); }
+    static JsonBuilder object() { return JsonBuilder(Type::Object); }
+
+    // Append to an array builder
+    JsonBuilder& push(const JsonValue& value) {
+        doc_->push_item(value.adopt_into(*doc_));
+        return *this;
+    }
+
+    // Set a member of an object builder (replacing an earlier value)
+    JsonBuilder& set(std::string_view key, const JsonValue& value) {
+        doc_->set_member(key, value.adopt_into(*doc_));
+        return *this;
+    }
+
+    size_t size() const { return doc_->root().size; }
+
+    JsonValue build() {
+        JsonValue value(std::move(doc_));
+        reset();
+        return value;
+    }
+};
 
 } // namespace mlc::json
 
@@ -0,0 +1,685 @@
+#ifndef MLC_JSON_CODEC_HPP
+#define MLC_JSON_CODEC_HPP
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "mlc_json.hpp"
+#include "mlc_json_lazy.hpp"
+#include "mlc_string.hpp"
+
+// Typed JSON codecs: values are encoded straight to text through JsonWriter
+// and decoded straight from text into the C++ value, with no DOM in between.
+//
+// A type opts in through an argument-dependent hook, a function declaration
+// naming its codec:
+//
+//     mlc::json::RecordCodec<Point, mlc::json::Field<"x", &Point::x>> mlc_json_codec(const Point*);
+//
+// which the compiler emits for MLC types declared with `derive Json`.
+// Records are objects keyed by field name; decoding dispatches every key
+// through a perfect hash built at compile time, skips unknown keys and fails
+// when a field is missing. Sum types are externally tagged: a variant without
+// fields is its name as a string, any other a one-entry object
+// {"Name": payload}. Positional variant fields are the payload itself (one
+// field) or an array (several).
+
+namespace mlc::json {
+
+// ============================================================================
+// Compile-time names
+// ============================================================================
+
+// String literal usable as a template argument
+template <size_t N>
+struct FixedString {
+    char chars[N] = {};
+
+    constexpr FixedString(const char (&text)[N]) {
+        for (size_t i = 0; i < N; ++i) chars[i] = text[i];
+    }
+
+    constexpr std::string_view view() const { return {chars, N - 1}; }
+};
+
+namespace detail {
+
+// Seeded FNV-1a with a final mix, so the low bits depend on every byte
+constexpr uint32_t name_hash(std::string_view name, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+} // namespace detail
+
+// Perfect hash over N distinct names: every name lands in a slot of its own,
+// so a lookup is one hash, one probe and one comparison. The table starts at
+// twice N slots and doubles until some seed separates all names.
+template <size_t N>
+class NameTable {
+private:
+    static_assert(N < 255, "too many names for one table");
+    static constexpr size_t kMaxSlots = std::bit_ceil(N * 16 + 1);
+
+    std::array<std::string_view, N> names_{};
+    std::array<uint8_t, kMaxSlots> slots_{};  // Name index + 1; 0 is empty
+    uint32_t seed_ = 0;
+    uint32_t mask_ = 0;
+
+    constexpr bool place(uint32_t seed, size_t size) {
+        slots_ = {};
+        for (size_t i = 0; i < N; ++i) {
+            uint8_t& slot = slots_[detail::name_hash(names_[i], seed) & (size - 1)];
+            if (slot != 0) return false;
+            slot = static_cast<uint8_t>(i + 1);
+        }
+        seed_ = seed;
+        mask_ = static_cast<uint32_t>(size - 1);
+        return true;
+    }
+
+public:
+    constexpr explicit NameTable(std::array<std::string_view, N> names) : names_(names) {
+        for (size_t size = std::bit_ceil(N * 2 + 1); size <= kMaxSlots; size *= 2) {
+            for (uint32_t seed = 0; seed < 256; ++seed) {
+                if (place(seed, size)) return;
+            }
+        }
+        throw std::logic_error("JSON codec: duplicate names");
+    }
+
+    // Index of `name`, or -1 if it is not in the table
+    constexpr int find(std::string_view name) const {
+        uint8_t slot = slots_[detail::name_hash(name, seed_) & mask_];
+        return slot != 0 && names_[slot - 1] == name ? slot - 1 : -1;
+    }
+};
+
+// ============================================================================
+// CodecReader
+// ============================================================================
+
+namespace detail {
+
+inline bool has_high_byte(const char* p, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        if (word & 0x8080808080808080ull) return true;
+    }
+    for (; i < n; ++i) {
+        if (static_cast<unsigned char>(p[i]) >= 0x80) return true;
+    }
+    return false;
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace detail
+
+// Pull tokenizer over one JSON text for the codecs. It validates what it
+// reads, including values it skips, and keeps the first error with its offset.
+class CodecReader {
+private:
+    static constexpr size_t kMaxDepth = 1024;
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    std::string scratch_;
+    std::string error_;
+    size_t error_offset_ = 0;
+
+    // Past the number at p_ under the JSON grammar, or nullptr
+    const char* scan_number(bool& integer) const {
+        const char* q = p_;
+        integer = true;
+        if (q < end_ && *q == '-') ++q;
+        if (q >= end_ || !detail::is_digit(*q)) return nullptr;
+        if (*q == '0') {
+            ++q;
+        } else {
+            while (q < end_ && detail::is_digit(*q)) ++q;
+        }
+        if (q < end_ && *q == '.') {
+            integer = false;
+            if (++q >= end_ || !detail::is_digit(*q)) return nullptr;
+            while (q < end_ && detail::is_digit(*q)) ++q;
+        }
+        if (q < end_ && (*q == 'e' || *q == 'E')) {
+            integer = false;
+            ++q;
+            if (q < end_ && (*q == '+' || *q == '-')) ++q;
+            if (q >= end_ || !detail::is_digit(*q)) return nullptr;
+            while (q < end_ && detail::is_digit(*q)) ++q;
+        }
+        return q;
+    }
+
+    bool skip(size_t depth) {
+        skip_whitespace();
+        if (p_ >= end_) return fail("unexpected end of input");
+        switch (*p_) {
+        case '"': {
+            std::string_view ignored;
+            return read_string(ignored);
+        }
+        case '{':
+        case '[': {
+            if (depth >= kMaxDepth) return fail("nesting too deep");
+            const bool object = *p_++ == '{';
+            if (consume(object ? '}' : ']')) return true;
+            do {
+                if (object) {
+                    std::string_view ignored;
+                    if (!read_key(ignored)) return false;
+                }
+                if (!skip(depth + 1)) return false;
+            } while (consume(','));
+            if (consume(object ? '}' : ']')) return true;
+            return fail(object ? "expected ',' or '}'" : "expected ',' or ']'");
+        }
+        case 't':
+            return read_literal("true");
+        case 'f':
+            return read_literal("false");
+        case 'n':
+            return read_literal("null");
+        default: {
+            bool integer;
+            const char* stop = scan_number(integer);
+            if (!stop) return fail("invalid number");
+            p_ = stop;
+            return true;
+        }
+        }
+    }
+
+public:
+    explicit CodecReader(std::string_view text)
+        : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()) {}
+
+    void skip_whitespace() { p_ = lazy::skip_whitespace(p_, end_); }
+
+    // Skips whitespace, then consumes `c` if it comes next
+    bool consume(char c) {
+        skip_whitespace();
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    // Skips whitespace, then tells whether `c` comes next
+    bool peek(char c) {
+        skip_whitespace();
+        return p_ < end_ && *p_ == c;
+    }
+
+    bool starts_with_digit() {
+        skip_whitespace();
+        return p_ < end_ && detail::is_digit(*p_);
+    }
+
+    // Records the first error; always returns false
+    bool fail(std::string_view message) {
+        if (error_.empty()) {
+            error_ = message;
+            error_offset_ = static_cast<size_t>(p_ - begin_);
+        }
+        return false;
+    }
+
+    bool ok() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+    size_t error_offset() const { return error_offset_; }
+
+    bool read_literal(std::string_view word) {
+        skip_whitespace();
+        if (static_cast<size_t>(end_ - p_) < word.size() || std::memcmp(p_, word.data(), word.size()) != 0) {
+            return fail("invalid literal");
+        }
+        p_ += word.size();
+        return true;
+    }
+
+    bool read_bool(bool& out) {
+        skip_whitespace();
+        if (p_ < end_ && *p_ == 't') return out = true, read_literal("true");
+        if (p_ < end_ && *p_ == 'f') return out = false, read_literal("false");
+        return fail("expected a boolean");
+    }
+
+    // Decoded string body; the view stays valid until the next read_string
+    bool read_string(std::string_view& out) {
+        if (!consume('"')) return fail("expected a string");
+        const char* start = p_;
+        const char* q = start;
+        bool escaped = false;
+        for (;;) {
+            q += simd::find_escape(q, static_cast<size_t>(end_ - q));
+            if (q >= end_) {
+                p_ = end_;
+                return fail("unterminated string");
+            }
+            if (*q == '"') break;
+            if (*q != '\\') {
+                p_ = q;
+                return fail("control character in string");
+            }
+            escaped = true;
+            if (end_ - q < 2) {
+                p_ = end_;
+                return fail("unterminated string");
+            }
+            q += 2;
+        }
+        // Escapes are ASCII, so validating the raw bytes covers the decoded text
+        const size_t length = static_cast<size_t>(q - start);
+        if (detail::has_high_byte(start, length) &&
+            !detail::valid_utf8(reinterpret_cast<const unsigned char*>(start), length)) {
+            return fail("invalid UTF-8 in string");
+        }
+        if (escaped) {
+            scratch_.resize(length);
+            const char* error = nullptr;
+            char* stop = detail::decode_escapes(p_, q, scratch_.data(), error);
+            if (!stop) return fail(error);
+            scratch_.resize(static_cast<size_t>(stop - scratch_.data()));
+            out = scratch_;
+        } else {
+            out = std::string_view(start, length);
+        }
+        p_ = q + 1;
+        return true;
+    }
+
+    // An object key and the colon after it
+    bool read_key(std::string_view& key) {
+        if (!peek('"')) return fail("expected a key");
+        if (!read_string(key)) return false;
+        return consume(':') || fail("expected ':'");
+    }
+
+    template <typename Int>
+    bool read_integer(Int& out) {
+        skip_whitespace();
+        bool integer;
+        const char* stop = scan_number(integer);
+        if (!stop || !integer) return fail("expected an integer");
+        auto [ptr, ec] = std::from_chars(p_, stop, out);
+        if (ec != std::errc() || ptr != stop) return fail("integer out of range");
+        p_ = stop;
+        return true;
+    }
+
+    template <typename Float>
+    bool read_float(Float& out) {
+        skip_whitespace();
+        bool integer;
+        const char* stop = scan_number(integer);
+        if (!stop) return fail("expected a number");
+        auto [ptr, ec] = std::from_chars(p_, stop, out);
+        if (ec != std::errc() || ptr != stop) return fail("number out of range");
+        p_ = stop;
+        return true;
+    }
+
+    // Validates and steps over one value of any type
+    bool skip_value() { return skip(0); }
+
+    // The text of the next value, validated
+    bool read_raw(std::string_view& span) {
+        skip_whitespace();
+        const char* start = p_;
+        if (!skip_value()) return false;
+        span = std::string_view(start, static_cast<size_t>(p_ - start));
+        return true;
+    }
+
+    // Only whitespace may follow the decoded value
+    bool finish() {
+        skip_whitespace();
+        return p_ == end_ || fail("trailing characters after JSON value");
+    }
+};
+
+// ============================================================================
+// Codecs
+// ============================================================================
+
+// Codec<T>::write(JsonWriter&, const T&) and Codec<T>::read(CodecReader&, T&)
+template <typename T>
+concept DerivesJson = requires(const T* value) { mlc_json_codec(value); };
+
+template <typename T>
+struct Codec {
+    static_assert(DerivesJson<T>, "no JSON codec for this type: declare it with `derive Json`");
+    using Impl = decltype(mlc_json_codec(static_cast<const T*>(nullptr)));
+
+    static void write(JsonWriter& writer, const T& value) { Impl::write(writer, value); }
+    static bool read(CodecReader& reader, T& value) { return Impl::read(reader, value); }
+};
+
+template <>
+struct Codec<bool> {
+    static void write(JsonWriter& writer, bool value) { writer.value(value); }
+    static bool read(CodecReader& reader, bool& value) { return reader.read_bool(value); }
+};
+
+template <typename T>
+    requires(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+struct Codec<T> {
+    static void write(JsonWriter& writer, T value) {
+        if constexpr (std::is_signed_v<T>) {
+            writer.value(static_cast<int64_t>(value));
+        } else {
+            writer.value(static_cast<uint64_t>(value));
+        }
+    }
+    static bool read(CodecReader& reader, T& value) { return reader.read_integer(value); }
+};
+
+template <typename T>
+    requires std::is_floating_point_v<T>
+struct Codec<T> {
+    static void write(JsonWriter& writer, T value) {
+        if constexpr (std::is_same_v<T, float>) {
+            writer.value(value);
+        } else {
+            writer.value(static_cast<double>(value));
+        }
+    }
+    static bool read(CodecReader& reader, T& value) { return reader.read_float(value); }
+};
+
+template <>
+struct Codec<mlc::String> {
+    static void write(JsonWriter& writer, const mlc::String& value) { writer.value(value); }
+    static bool read(CodecReader& reader, mlc::String& value) {
+        std::string_view text;
+        if (!reader.read_string(text)) return false;
+        value = mlc::String(std::string(text));
+        return true;
+    }
+};
+
+template <typename T>
+struct Codec<std::vector<T>> {
+    static void write(JsonWriter& writer, const std::vector<T>& value) {
+        writer.begin_array();
+        for (const T& item : value) Codec<T>::write(writer, item);
+        writer.end_array();
+    }
+    static bool read(CodecReader& reader, std::vector<T>& value) {
+        if (!reader.consume('[')) return reader.fail("expected an array");
+        value.clear();
+        if (reader.consume(']')) return true;
+        do {
+            if (!Codec<T>::read(reader, value.emplace_back())) return false;
+        } while (reader.consume(','));
+        return reader.consume(']') || reader.fail("expected ',' or ']'");
+    }
+};
+
+// Untyped values: scalars are held inline, strings and containers are
+// parsed into a Document of their own
+template <>
+struct Codec<JsonValue> {
+    static void write(JsonWriter& writer, const JsonValue& value) { writer.value(value); }
+    static bool read(CodecReader& reader, JsonValue& value) {
+        if (reader.peek('n')) {
+            value = JsonValue();
+            return reader.read_literal("null");
+        }
+        if (reader.peek('t') || reader.peek('f')) {
+            bool b;
+            if (!reader.read_bool(b)) return false;
+            value = JsonValue(b);
+            return true;
+        }
+        if (reader.peek('-') || reader.starts_with_digit()) {
+            double number;
+            if (!reader.read_float(number)) return false;
+            value = JsonValue(number);
+            return true;
+        }
+        std::string_view text;
+        if (!reader.read_raw(text)) return false;
+        std::shared_ptr<const Document> doc = Document::parse(std::string(text));
+        if (!doc->ok()) return reader.fail(doc->error());
+        Node root = doc->root();
+        value = JsonValue(std::move(doc), root);
+        return true;
+    }
+};
+
+namespace detail {
+
+// Printable ASCII without quotes or backslashes
+constexpr bool plain_name(std::string_view name) {
+    for (char c : name) {
+        if (c < 0x20 || c > 0x7E || c == '"' || c == '\\') return false;
+    }
+    return true;
+}
+
+template <auto Member>
+struct MemberOf;
+
+template <typename Class, typename Type, Type Class::*Member>
+struct MemberOf<Member> {
+    using type = Type;
+};
+
+} // namespace detail
+
+// A record field: its JSON name and the data member it maps to
+template <FixedString Name, auto Member>
+struct Field {
+    static_assert(detail::plain_name(Name.view()), "field names are written without escaping");
+    using type = typename detail::MemberOf<Member>::type;
+    static constexpr std::string_view name = Name.view();
+    static constexpr auto member = Member;
+};
+
+// An object with one entry per field, in declaration order. Every field must
+// be present; unknown keys are validated and skipped, and for a repeated key
+// the last value wins.
+template <typename T, typename... Fields>
+struct RecordCodec {
+    static_assert(sizeof...(Fields) <= 64, "JSON records support at most 64 fields");
+
+    static constexpr NameTable<sizeof...(Fields)> names{{Fields::name...}};
+    static constexpr uint64_t kAllFields = sizeof...(Fields) == 64 ? ~0ull : (1ull << sizeof...(Fields)) - 1;
+
+    template <typename F>
+    static bool read_field(CodecReader& reader, T& value) {
+        return Codec<typename F::type>::read(reader, value.*F::member);
+    }
+
+    static constexpr bool (*readers[sizeof...(Fields) + 1])(CodecReader&, T&) = {&read_field<Fields>..., nullptr};
+
+    static void write(JsonWriter& writer, const T& value) {
+        writer.begin_object();
+        ((writer.plain_key(Fields::name), Codec<typename Fields::type>::write(writer, value.*Fields::member)), ...);
+        writer.end_object();
+    }
+
+    static bool read(CodecReader& reader, T& value) {
+        if (!reader.consume('{')) return reader.fail("expected an object");
+        uint64_t seen = 0;
+        if (!reader.consume('}')) {
+            do {
+                std::string_view key;
+                if (!reader.read_key(key)) return false;
+                const int index = names.find(key);
+                if (index < 0) {
+                    if (!reader.skip_value()) return false;
+                    continue;
+                }
+                if (!readers[index](reader, value)) return false;
+                seen |= 1ull << index;
+            } while (reader.consume(','));
+            if (!reader.consume('}')) return reader.fail("expected ',' or '}'");
+        }
+        if (seen != kAllFields) {
+            static constexpr std::string_view all[sizeof...(Fields) + 1] = {Fields::name..., ""};
+            return reader.fail("missing field \"" + std::string(all[std::countr_one(seen)]) + "\"");
+        }
+        return true;
+    }
+};
+
+// Positional fields: the value itself for one member, an array for several
+template <typename T, auto... Members>
+struct TupleCodec {
+    static_assert(sizeof...(Members) > 0, "a tuple codec needs a member");
+
+    static void write(JsonWriter& writer, const T& value) {
+        if constexpr (sizeof...(Members) == 1) {
+            (Codec<typename detail::MemberOf<Members>::type>::write(writer, value.*Members), ...);
+        } else {
+            writer.begin_array();
+            (Codec<typename detail::MemberOf<Members>::type>::write(writer, value.*Members), ...);
+            writer.end_array();
+        }
+    }
+
+    static bool read(CodecReader& reader, T& value) {
+        if constexpr (sizeof...(Members) == 1) {
+            return (Codec<typename detail::MemberOf<Members>::type>::read(reader, value.*Members) && ...);
+        } else {
+            if (!reader.consume('[')) return reader.fail("expected an array");
+            bool first = true;
+            auto item = [&](auto& member) {
+                if (!first && !reader.consume(',')) return reader.fail("expected ','");
+                first = false;
+                return Codec<std::remove_reference_t<decltype(member)>>::read(reader, member);
+            };
+            if (!(item(value.*Members) && ...)) return false;
+            return reader.consume(']') || reader.fail("expected ']'");
+        }
+    }
+};
+
+// A sum type variant: its JSON name and the struct holding its fields
+template <FixedString Name, typename V>
+struct Alternative {
+    static_assert(detail::plain_name(Name.view()), "variant names are written without escaping");
+    using type = V;
+    static constexpr std::string_view name = Name.view();
+};
+
+// std::variant over the alternatives' structs, in the same order
+template <typename T, typename... Alternatives>
+struct VariantCodec {
+    static constexpr NameTable<sizeof...(Alternatives)> names{{Alternatives::name...}};
+    static constexpr bool unit[sizeof...(Alternatives)] = {std::is_empty_v<typename Alternatives::type>...};
+
+    template <size_t I>
+    using AlternativeAt = std::tuple_element_t<I, std::tuple<Alternatives...>>;
+
+    template <size_t I>
+    static void write_alternative(JsonWriter& writer, const T& value) {
+        using A = AlternativeAt<I>;
+        if constexpr (std::is_empty_v<typename A::type>) {
+            writer.value(A::name);
+        } else {
+            writer.begin_object().plain_key(A::name);
+            Codec<typename A::type>::write(writer, std::get<I>(value));
+            writer.end_object();
+        }
+    }
+
+    // Unit variants have no payload to read: the name was all there was
+    template <size_t I>
+    static bool read_alternative(CodecReader& reader, T& value) {
+        using V = typename AlternativeAt<I>::type;
+        if constexpr (std::is_empty_v<V>) {
+            value.template emplace<I>();
+            return true;
+        } else {
+            return Codec<V>::read(reader, value.template emplace<I>());
+        }
+    }
+
+    template <size_t... I>
+    static constexpr auto tables(std::index_sequence<I...>) {
+        return std::pair{std::array{&write_alternative<I>...}, std::array{&read_alternative<I>...}};
+    }
+    static constexpr auto table = tables(std::index_sequence_for<Alternatives...>{});
+
+    static void write(JsonWriter& writer, const T& value) { table.first[value.index()](writer, value); }
+
+    static bool read(CodecReader& reader, T& value) {
+        std::string_view name;
+        if (reader.peek('"')) {
+            if (!reader.read_string(name)) return false;
+            const int index = names.find(name);
+            if (index < 0 || !unit[index]) return reader.fail("unknown variant \"" + std::string(name) + "\"");
+            return table.second[index](reader, value);
+        }
+        if (!reader.consume('{')) return reader.fail("expected a variant name or a one-entry object");
+        if (!reader.read_key(name)) return false;
+        const int index = names.find(name);
+        if (index < 0 || unit[index]) return reader.fail("unknown variant \"" + std::string(name) + "\"");
+        if (!table.second[index](reader, value)) return false;
+        return reader.consume('}') || reader.fail("expected '}' after the variant");
+    }
+};
+
+// ============================================================================
+// Entry points
+// ============================================================================
+
+template <typename T>
+inline mlc::String encode(const T& value) {
+    std::string out;
+    {
+        JsonWriter writer(out);
+        Codec<T>::write(writer, value);
+    }
+    return mlc::String(std::move(out));
+}
+
+// Decodes one complete JSON text into `value`; on failure `value` may be
+// partly overwritten and `error` (when given) says what went wrong where
+template <typename T>
+inline bool decode(std::string_view text, T& value, std::string* error = nullptr) {
+    CodecReader reader(text);
+    if (Codec<T>::read(reader, value) && reader.finish()) return true;
+    if (error) *error = reader.error() + " at offset " + std::to_string(reader.error_offset());
+    return false;
+}
+
+// The decoded value, or `fallback` if the text does not decode
+template <typename T>
+inline T decode_or(const mlc::String& text, const T& fallback) {
+    T value = fallback;
+    return decode(text.as_std_string(), value) ? value : fallback;
+}
+
+} // namespace mlc::json
+
+#endif // MLC_JSON_CODEC_HPP
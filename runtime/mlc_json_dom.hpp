@@ -0,0 +1,951 @@
+#ifndef MLC_JSON_DOM_HPP
+#define MLC_JSON_DOM_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "mlc_json_simd.hpp"
+
+// Native JSON document model.
+//
+// A parsed document owns a copy of its source text and one Arena: every node
+// array, member array and unescaped string is bump-allocated there and freed
+// together with the Document. Strings without escapes point straight into the
+// source text. Objects are flat member arrays in document order; small ones
+// are searched linearly, larger ones carry a hash index built with them.
+//
+// Parsing runs in two stages: simd::build_structural_index (mlc_json_simd.hpp)
+// locates every token and validates strings, then Parser walks that index to
+// build the nodes without looking at whitespace or string bodies again.
+
+namespace mlc::json {
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+class Arena {
+private:
+    static constexpr size_t kFirstBlock = 4096;
+    static constexpr size_t kMaxBlock = 1 << 20;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cursor_ = nullptr;
+    size_t left_ = 0;
+    size_t next_block_ = kFirstBlock;
+    size_t reserved_ = 0;
+
+    void grow(size_t bytes) {
+        size_t size = std::max(next_block_, bytes);
+        blocks_.push_back(std::make_unique<char[]>(size));
+        cursor_ = blocks_.back().get();
+        left_ = size;
+        reserved_ += size;
+        next_block_ = std::min(next_block_ * 2, kMaxBlock);
+    }
+
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+
+    // Size the first block for a document of about `bytes` bytes
+    void reserve(size_t bytes) {
+        if (blocks_.empty() && bytes > kFirstBlock) next_block_ = std::min(bytes, kMaxBlock);
+    }
+
+    void* allocate(size_t bytes, size_t align) {
+        size_t pad = (align - reinterpret_cast<uintptr_t>(cursor_) % align) % align;
+        if (bytes + pad > left_) {
+            grow(bytes + align);
+            pad = (align - reinterpret_cast<uintptr_t>(cursor_) % align) % align;
+        }
+        char* out = cursor_ + pad;
+        cursor_ += pad + bytes;
+        left_ -= pad + bytes;
+        return out;
+    }
+
+    // Arrays of trivially destructible objects; never freed individually
+    template <typename T>
+    T* allocate_array(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        if (count == 0) return nullptr;
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    const char* copy_string(std::string_view text) {
+        if (text.empty()) return "";
+        char* out = static_cast<char*>(allocate(text.size(), 1));
+        std::memcpy(out, text.data(), text.size());
+        return out;
+    }
+
+    size_t bytes_reserved() const { return reserved_; }
+};
+
+// ============================================================================
+// Nodes
+// ============================================================================
+
+enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+struct Member;
+
+// One JSON value. Strings, arrays and objects point into their document's
+// source text or arena; a Node is only valid while that document is alive.
+struct Node {
+    Type type = Type::Null;
+    uint32_t size = 0;  // String: bytes, Array: elements, Object: members
+    union {
+        bool boolean;
+        double number;
+        const char* chars;
+        const Node* items;
+        const Member* members;
+    };
+
+    Node() : number(0) {}
+
+    static Node null() { return Node(); }
+
+    static Node from_bool(bool value) {
+        Node node;
+        node.type = Type::Bool;
+        node.boolean = value;
+        return node;
+    }
+
+    static Node from_number(double value) {
+        Node node;
+        node.type = Type::Number;
+        node.number = value;
+        return node;
+    }
+
+    static Node from_string(const char* chars, size_t size) {
+        Node node;
+        node.type = Type::String;
+        node.size = static_cast<uint32_t>(size);
+        node.chars = chars;
+        return node;
+    }
+
+    std::string_view string() const { return std::string_view(chars, size); }
+};
+
+struct Member {
+    const char* key;
+    uint32_t key_size;
+    Node value;
+
+    std::string_view name() const { return std::string_view(key, key_size); }
+};
+
+// ============================================================================
+// Object layout: for large objects a hash index of index_capacity(size) slots
+// holding member index + 1 (0 = empty), followed by members[size]. Keeping the
+// index in front lets a growable object append members without moving it.
+// ============================================================================
+
+inline constexpr uint32_t kLinearLookup = 16;
+
+inline uint32_t index_capacity(uint32_t members) {
+    if (members <= kLinearLookup) return 0;
+    uint32_t capacity = 1;
+    while (capacity < members * 2) capacity <<= 1;
+    return capacity;
+}
+
+inline uint32_t hash_key(std::string_view key) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline const uint32_t* object_index(const Node& object) {
+    return reinterpret_cast<const uint32_t*>(object.members) - index_capacity(object.size);
+}
+
+// Slot of `key` in an index of `capacity` slots, or the empty slot it would take
+inline uint32_t find_slot(const uint32_t* slots, uint32_t capacity, const Member* members, std::string_view key) {
+    uint32_t slot = hash_key(key) & (capacity - 1);
+    while (slots[slot] != 0 && members[slots[slot] - 1].name() != key) slot = (slot + 1) & (capacity - 1);
+    return slot;
+}
+
+// Add members[i] to an index of `capacity` slots; false (index unchanged)
+// if its key is already there
+inline bool index_member(uint32_t* slots, uint32_t capacity, const Member* members, uint32_t i) {
+    const uint32_t slot = find_slot(slots, capacity, members, members[i].name());
+    if (slots[slot] != 0) return false;
+    slots[slot] = i + 1;
+    return true;
+}
+
+// One member per key: the value of the last occurrence at the position of the first
+inline std::vector<Member> collapse_duplicates(const Member* members, size_t count) {
+    uint32_t capacity = 1;
+    while (capacity < count * 2) capacity <<= 1;
+    std::vector<uint32_t> slots(capacity, 0);
+    std::vector<Member> unique;
+    unique.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t slot = find_slot(slots.data(), capacity, unique.data(), members[i].name());
+        if (slots[slot] != 0) {
+            unique[slots[slot] - 1].value = members[i].value;
+        } else {
+            unique.push_back(members[i]);
+            slots[slot] = static_cast<uint32_t>(unique.size());
+        }
+    }
+    return unique;
+}
+
+// Copy members into the arena as an object node (building the index if large).
+// Duplicate keys collapse as they are copied: the last value wins, as in most
+// JSON libraries, and keeps the first key's position, so lookup, iteration
+// and stringify_json all see one member.
+inline Node make_object(Arena& arena, const Member* members, size_t count) {
+    uint32_t size = static_cast<uint32_t>(count);
+    uint32_t capacity = index_capacity(size);
+    size_t bytes = sizeof(Member) * count + sizeof(uint32_t) * capacity;
+
+    Node node;
+    node.type = Type::Object;
+    node.size = size;
+    node.members = nullptr;
+    if (count == 0) return node;
+
+    if (capacity == 0) {
+        for (uint32_t i = 1; i < size; ++i) {
+            for (uint32_t j = 0; j < i; ++j) {
+                if (members[j].name() == members[i].name()) {
+                    const std::vector<Member> unique = collapse_duplicates(members, count);
+                    return make_object(arena, unique.data(), unique.size());
+                }
+            }
+        }
+    }
+
+    auto* slots = static_cast<uint32_t*>(arena.allocate(bytes, alignof(Member)));
+    auto* out = reinterpret_cast<Member*>(slots + capacity);
+    std::memcpy(static_cast<void*>(out), members, sizeof(Member) * count);
+    node.members = out;
+
+    if (capacity > 0) {
+        std::memset(slots, 0, sizeof(uint32_t) * capacity);
+        for (uint32_t i = 0; i < size; ++i) {
+            if (!index_member(slots, capacity, out, i)) {
+                // The copy stays in the arena unused; the index was sized for count
+                const std::vector<Member> unique = collapse_duplicates(members, count);
+                return make_object(arena, unique.data(), unique.size());
+            }
+        }
+    }
+    return node;
+}
+
+inline Node make_array(Arena& arena, const Node* items, size_t count) {
+    Node node;
+    node.type = Type::Array;
+    node.size = static_cast<uint32_t>(count);
+    Node* out = arena.allocate_array<Node>(count);
+    if (count > 0) std::memcpy(static_cast<void*>(out), items, sizeof(Node) * count);
+    node.items = out;
+    return node;
+}
+
+// Value of `key` in an object node, or nullptr
+inline const Node* find_member(const Node& object, std::string_view key) {
+    if (object.type != Type::Object) return nullptr;
+    uint32_t capacity = index_capacity(object.size);
+    if (capacity == 0) {
+        for (uint32_t i = object.size; i-- > 0;) {
+            const Member& member = object.members[i];
+            if (member.key_size == key.size() && std::memcmp(member.key, key.data(), key.size()) == 0) {
+                return &member.value;
+            }
+        }
+        return nullptr;
+    }
+
+    const uint32_t* slots = object_index(object);
+    const uint32_t slot = find_slot(slots, capacity, object.members, key);
+    return slots[slot] != 0 ? &object.members[slots[slot] - 1].value : nullptr;
+}
+
+// Deep-copy a node (from any document) into `arena`
+inline Node copy_node(Arena& arena, const Node& node) {
+    switch (node.type) {
+    case Type::String:
+        return Node::from_string(arena.copy_string(node.string()), node.size);
+    case Type::Array: {
+        std::vector<Node> items(node.items, node.items + node.size);
+        for (auto& item : items) item = copy_node(arena, item);
+        return make_array(arena, items.data(), items.size());
+    }
+    case Type::Object: {
+        std::vector<Member> members(node.members, node.members + node.size);
+        for (auto& member : members) {
+            member.key = arena.copy_string(member.name());
+            member.value = copy_node(arena, member.value);
+        }
+        return make_object(arena, members.data(), members.size());
+    }
+    default:
+        return node;
+    }
+}
+
+// ============================================================================
+// Document
+// ============================================================================
+
+class Document {
+private:
+    friend class Parser;
+
+    std::string source_;
+    Arena arena_;
+    Node root_;
+    std::string error_;
+    size_t error_offset_ = 0;
+    std::vector<std::shared_ptr<const Document>> retained_;
+    uint32_t room_ = 0;  // Capacity of the root container once it has grown
+
+    // Smallest growth step holding `size` entries: a power of two, so a
+    // growable object's index capacity is fixed (2 * room) between steps
+    static uint32_t room_for(uint32_t size) {
+        uint32_t room = 8;
+        while (room < size) room <<= 1;
+        return room;
+    }
+
+    // Move the root container's entries to fresh storage for `room` entries
+    // (`incoming` is the value about to be added)
+    void grow_root(uint32_t room, const Node& incoming) {
+        if (root_.type == Type::Array) {
+            Node* items = arena_.allocate_array<Node>(room);
+            if (root_.size > 0) std::memcpy(static_cast<void*>(items), root_.items, sizeof(Node) * root_.size);
+            root_.items = items;
+        } else {
+            const uint32_t capacity = room > kLinearLookup ? 2 * room : 0;
+            auto* slots = static_cast<uint32_t*>(
+                arena_.allocate(sizeof(uint32_t) * capacity + sizeof(Member) * room, alignof(Member)));
+            auto* members = reinterpret_cast<Member*>(slots + capacity);
+            if (root_.size > 0) std::memcpy(static_cast<void*>(members), root_.members, sizeof(Member) * root_.size);
+            if (capacity > 0) {
+                std::memset(slots, 0, sizeof(uint32_t) * capacity);
+                for (uint32_t i = 0; i < root_.size; ++i) index_member(slots, capacity, members, i);
+            }
+            root_.members = members;
+        }
+        if (room_ == 0 && !retained_.empty()) release_retained(incoming);
+        room_ = room;
+    }
+
+    // After the root's entries were first copied here: copy their strings
+    // too, and if neither an entry nor `incoming` is a container (the only
+    // nodes that can still point into retained documents), stop retaining.
+    // Otherwise versions built from one another by json_array_push would
+    // keep every earlier version alive.
+    void release_retained(const Node& incoming) {
+        bool shares = incoming.type == Type::Array || incoming.type == Type::Object;
+        auto localize = [&](Node& node) {
+            if (node.type == Type::String) node.chars = arena_.copy_string(node.string());
+            shares = shares || node.type == Type::Array || node.type == Type::Object;
+        };
+        if (root_.type == Type::Array) {
+            auto* items = const_cast<Node*>(root_.items);
+            for (uint32_t i = 0; i < root_.size; ++i) localize(items[i]);
+        } else {
+            auto* members = const_cast<Member*>(root_.members);
+            for (uint32_t i = 0; i < root_.size; ++i) {
+                members[i].key = arena_.copy_string(members[i].name());
+                localize(members[i].value);
+            }
+        }
+        if (!shares) retained_.clear();
+    }
+
+public:
+    Document() = default;
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    // Parse JSON text (RFC 8259). On failure ok() is false and root() is null.
+    static std::shared_ptr<Document> parse(std::string text);
+
+    // Parse every non-blank line of `text` as a value of its own (JSON
+    // Lines). The root is an array of the records in order; a line that
+    // does not parse becomes null and is counted in `errors`.
+    static std::shared_ptr<Document> parse_lines(std::string text, size_t* errors = nullptr);
+
+    // Document holding a copy of `node` (and everything it references)
+    static std::shared_ptr<Document> copy_of(const Node& node) {
+        auto doc = std::make_shared<Document>();
+        doc->root_ = copy_node(doc->arena_, node);
+        return doc;
+    }
+
+    bool ok() const { return error_.empty(); }
+    const std::string& error() const { return error_; }
+    size_t error_offset() const { return error_offset_; }
+
+    const Node& root() const { return root_; }
+    void set_root(const Node& node) {
+        root_ = node;
+        room_ = 0;
+    }
+    Arena& arena() { return arena_; }
+    std::string_view source() const { return source_; }
+
+    // Keep `other` alive as long as this document, so nodes may point into it
+    void retain(std::shared_ptr<const Document> other) {
+        if (other && (retained_.empty() || retained_.back() != other)) retained_.push_back(std::move(other));
+    }
+
+    // Growable root containers. These write to nodes in place, so they are
+    // only for a document no other handle can see. The first change copies
+    // the root's entries into storage of this document; from then on it
+    // doubles as it fills, making appends amortized O(1).
+
+    // Append to the root array
+    void push_item(const Node& value) {
+        if (root_.size >= room_) grow_root(room_for(root_.size + 1), value);
+        const_cast<Node*>(root_.items)[root_.size++] = value;
+    }
+
+    // Replace the value of `key` in the root object, or append it
+    void set_member(std::string_view key, const Node& value) {
+        // Until it first grows, the root may be shared with a retained document
+        if (room_ == 0) grow_root(room_for(root_.size), value);
+        if (const Node* existing = find_member(root_, key)) {
+            *const_cast<Node*>(existing) = value;
+            return;
+        }
+        if (root_.size >= room_) grow_root(room_for(root_.size + 1), value);
+        auto* members = const_cast<Member*>(root_.members);
+        const uint32_t i = root_.size++;
+        members[i] = {arena_.copy_string(key), static_cast<uint32_t>(key.size()), value};
+        if (room_ > kLinearLookup) index_member(reinterpret_cast<uint32_t*>(members) - 2 * room_, 2 * room_, members, i);
+    }
+};
+
+namespace detail {
+
+inline bool valid_utf8(const unsigned char* s, size_t n) {
+    for (size_t i = 0; i < n;) {
+        size_t len = utf8_sequence(s + i, n - i);
+        if (len == 0) return false;
+        i += len;
+    }
+    return true;
+}
+
+inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+inline bool read_hex4(const char*& s, const char* end, uint32_t& out) {
+    if (end - s < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        int d = hex_digit(s[i]);
+        if (d < 0) return false;
+        out = (out << 4) | static_cast<uint32_t>(d);
+    }
+    s += 4;
+    return true;
+}
+
+inline char* write_utf8(char* out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// Decode the string body [p, close), which holds escapes, into out (room
+// for close - p bytes: decoding never grows the text). Returns the end of
+// the output, or nullptr with `error` set and p at the bad escape.
+inline char* decode_escapes(const char*& p, const char* close, char* out, const char*& error) {
+    char* o = out;
+    while (p < close) {
+        const auto* escape = static_cast<const char*>(std::memchr(p, '\\', static_cast<size_t>(close - p)));
+        const char* run_end = escape ? escape : close;
+        std::memcpy(o, p, static_cast<size_t>(run_end - p));
+        o += run_end - p;
+        p = run_end;
+        if (!escape) break;
+
+        ++p;  // An escape is never cut off by the closing quote
+        switch (*p++) {
+        case '"': *o++ = '"'; break;
+        case '\\': *o++ = '\\'; break;
+        case '/': *o++ = '/'; break;
+        case 'b': *o++ = '\b'; break;
+        case 'f': *o++ = '\f'; break;
+        case 'n': *o++ = '\n'; break;
+        case 'r': *o++ = '\r'; break;
+        case 't': *o++ = '\t'; break;
+        case 'u': {
+            uint32_t cp;
+            if (!read_hex4(p, close, cp)) return error = "invalid \\u escape", nullptr;
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                uint32_t low;
+                if (close - p < 2 || p[0] != '\\' || p[1] != 'u') return error = "unpaired surrogate", nullptr;
+                p += 2;
+                if (!read_hex4(p, close, low) || low < 0xDC00 || low > 0xDFFF) return error = "unpaired surrogate", nullptr;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                return error = "unpaired surrogate", nullptr;
+            }
+            o = write_utf8(o, cp);
+            break;
+        }
+        default:
+            --p;
+            return error = "invalid escape", nullptr;
+        }
+    }
+    if (p != close) return error = "invalid escape", nullptr;
+    return o;
+}
+
+} // namespace detail
+
+// ============================================================================
+// Parser - iterative, so nesting depth is limited by kMaxDepth, not the stack
+// ============================================================================
+
+class Parser {
+private:
+    struct Frame {
+        bool object;
+        size_t start;  // First pending entry of this container in items_/members_
+    };
+
+    Document& doc_;
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    std::vector<Node> items_;
+    std::vector<Member> members_;
+    std::vector<Frame> frames_;
+    simd::StructuralIndexer* indexer_ = nullptr;  // Stage one, if any
+    const uint32_t* entries_ = nullptr;            // Current window of the structural index
+    size_t entry_count_ = 0;
+    size_t next_ = 0;                              // First entry not yet passed
+
+    // With fewer bytes than this per index entry (short tokens, little
+    // whitespace or text) walking the index costs more than it saves
+    static constexpr size_t kMinBytesPerEntry = 12;
+
+    // Index the next window of input, keeping the entries from next_ on.
+    // A stage-one error is recorded and parsing continues at the end of input.
+    bool refill() {
+        bool ok = indexer_->next(next_);
+        entries_ = indexer_->entries();
+        entry_count_ = indexer_->size();
+        next_ = 0;
+        if (!ok && indexer_->error() && doc_.error_.empty()) {
+            doc_.error_ = indexer_->error();
+            doc_.error_offset_ = indexer_->error_offset();
+        }
+        return ok;
+    }
+
+    // Make entries_[next_ + ahead] available
+    bool ensure_entries(size_t ahead) {
+        while (next_ + ahead >= entry_count_) {
+            if (!refill()) return false;
+        }
+        return true;
+    }
+
+    bool fail(const char* message) {
+        if (doc_.error_.empty()) {
+            doc_.error_ = message;
+            doc_.error_offset_ = static_cast<size_t>(p_ - begin_);
+        }
+        return false;
+    }
+
+    // With a structural index this jumps to the next indexed token at or after p_
+    void skip_whitespace() {
+        if (indexer_) {
+            const uint32_t offset = static_cast<uint32_t>(p_ - begin_);
+            for (;;) {
+                while (next_ < entry_count_ && (entries_[next_] & simd::kOffsetMask) < offset) ++next_;
+                if (next_ < entry_count_) break;
+                if (!refill()) {
+                    p_ = end_;
+                    return;
+                }
+            }
+            p_ = begin_ + (entries_[next_] & simd::kOffsetMask);
+            return;
+        }
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    // p_ is just past the opening quote. Strings without escapes are returned
+    // as views of the source; escaped ones are decoded into the arena.
+    bool parse_string(const char*& chars, uint32_t& size) {
+        const char* start = p_;
+        if (indexer_) {
+            // Stage one found the closing quote, flagged escapes and already
+            // rejected control characters and malformed UTF-8
+            if (!ensure_entries(1)) return fail("unterminated string");
+            const uint32_t close_entry = entries_[next_ + 1];
+            const char* close = begin_ + (close_entry & simd::kOffsetMask);
+            next_ += 2;
+            if (close_entry & simd::kEscapedString) return decode_string(close, chars, size);
+            chars = start;
+            size = static_cast<uint32_t>(close - start);
+            p_ = close + 1;
+            return true;
+        }
+
+        bool high = false;
+        bool escaped = false;
+        const char* close = p_;
+        while (close < end_) {
+            unsigned char c = static_cast<unsigned char>(*close);
+            if (c == '"') break;
+            if (c == '\\') {
+                escaped = true;
+                close += 2;
+                continue;
+            }
+            if (c < 0x20) {
+                p_ = close;
+                return fail("control character in string");
+            }
+            high |= c >= 0x80;
+            ++close;
+        }
+        if (close >= end_) {
+            p_ = end_;
+            return fail("unterminated string");
+        }
+        // Escapes are ASCII, so validating the raw bytes covers the decoded text
+        if (high && !detail::valid_utf8(reinterpret_cast<const unsigned char*>(start), static_cast<size_t>(close - start))) {
+            return fail("invalid UTF-8 in string");
+        }
+        if (escaped) return decode_string(close, chars, size);
+        chars = start;
+        size = static_cast<uint32_t>(close - start);
+        p_ = close + 1;
+        return true;
+    }
+
+    // Decode the string body [p_, close) into the arena. Decoding never
+    // grows the text, so one allocation of the raw length suffices.
+    bool decode_string(const char* close, const char*& chars, uint32_t& size) {
+        char* const out = static_cast<char*>(doc_.arena_.allocate(static_cast<size_t>(close - p_), 1));
+        const char* error = nullptr;
+        char* o = detail::decode_escapes(p_, close, out, error);
+        if (!o) return fail(error);
+        chars = out;
+        size = static_cast<uint32_t>(o - out);
+        p_ = close + 1;
+        return true;
+    }
+
+    bool parse_number(Node& node) {
+        const char* start = p_;
+        bool negative = false;
+        if (p_ < end_ && *p_ == '-') {
+            negative = true;
+            ++p_;
+        }
+        if (p_ >= end_ || !(*p_ >= '0' && *p_ <= '9')) return fail("invalid number");
+
+        // Decimal digits (integer and fraction) accumulate into mantissa
+        uint64_t mantissa = 0;
+        const char* digits = p_;
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') mantissa = mantissa * 10 + static_cast<uint64_t>(*p_++ - '0');
+        }
+        size_t digit_count = static_cast<size_t>(p_ - digits);
+        int64_t exponent = 0;
+        bool negative_exponent = false;
+        if (p_ < end_ && *p_ == '.') {
+            ++p_;
+            const char* fraction = p_;
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') mantissa = mantissa * 10 + static_cast<uint64_t>(*p_++ - '0');
+            if (p_ == fraction) return fail("invalid number");
+            digit_count += static_cast<size_t>(p_ - fraction);
+            exponent = -(p_ - fraction);
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) negative_exponent = *p_++ == '-';
+            if (p_ >= end_ || !(*p_ >= '0' && *p_ <= '9')) return fail("invalid number");
+            int64_t written = 0;
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+                if (written < 100000) written = written * 10 + (*p_ - '0');
+                ++p_;
+            }
+            exponent += negative_exponent ? -written : written;
+        }
+        if (!at_token_end()) return fail("invalid number");
+
+        // Exact when the digits fit a double's mantissa and the power of ten
+        // is itself exact: one correctly rounded multiply or divide
+        static constexpr double kPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        if (digit_count <= 19 && mantissa <= (uint64_t{1} << 53) && exponent >= -22 && exponent <= 22) {
+            double value = static_cast<double>(mantissa);
+            value = exponent < 0 ? value / kPowers[-exponent] : value * kPowers[exponent];
+            node = Node::from_number(negative ? -value : value);
+            return true;
+        }
+
+        double value = 0;
+        auto result = std::from_chars(start, p_, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            value = negative_exponent ? 0.0 : std::numeric_limits<double>::infinity();
+            if (negative) value = -value;
+        } else if (result.ec != std::errc() || result.ptr != p_) {
+            return fail("invalid number");
+        }
+        node = Node::from_number(value);
+        return true;
+    }
+
+    bool parse_literal(const char* word, size_t length) {
+        if (static_cast<size_t>(end_ - p_) < length || std::memcmp(p_, word, length) != 0) {
+            return fail("invalid literal");
+        }
+        p_ += length;
+        return at_token_end() || fail("invalid literal");
+    }
+
+    // A number or literal must be followed by whitespace, an operator, a quote or the end
+    bool at_token_end() const {
+        if (p_ == end_) return true;
+        switch (*p_) {
+        case ' ': case '\t': case '\n': case '\r':
+        case ',': case ':': case '[': case ']': case '{': case '}': case '"':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Object key followed by ':'; pushes a pending member
+    bool parse_key() {
+        skip_whitespace();
+        if (p_ >= end_ || *p_ != '"') return fail("expected object key");
+        ++p_;
+        Member member;
+        if (!parse_string(member.key, member.key_size)) return false;
+        skip_whitespace();
+        if (p_ >= end_ || *p_ != ':') return fail("expected ':'");
+        ++p_;
+        members_.push_back(member);
+        return true;
+    }
+
+public:
+    static constexpr size_t kMaxDepth = 1024;
+
+    // With an indexer (stage one over `text`) tokens are located through the
+    // structural index; without one the text is scanned directly
+    Parser(Document& doc, std::string_view text, simd::StructuralIndexer* indexer = nullptr)
+        : doc_(doc), begin_(text.data()), p_(text.data()), end_(text.data() + text.size()), indexer_(indexer) {}
+
+    // Start over on `text` (scanned directly), keeping the scratch buffers
+    void reset(std::string_view text) {
+        begin_ = p_ = text.data();
+        end_ = text.data() + text.size();
+        items_.clear();
+        members_.clear();
+        frames_.clear();
+        indexer_ = nullptr;
+        entries_ = nullptr;
+        entry_count_ = next_ = 0;
+    }
+
+    bool parse() {
+        // The first window decides whether the rest of the document is indexed
+        if (indexer_) {
+            if (!refill() && !doc_.error_.empty()) return false;
+            if (!indexer_->done() && indexer_->size() * kMinBytesPerEntry > indexer_->bytes_indexed()) {
+                indexer_ = nullptr;
+            }
+        }
+
+        Node value;
+        for (;;) {
+            skip_whitespace();
+            if (p_ >= end_) return fail("unexpected end of input");
+
+            // Parse one value; containers push a frame and continue with their first entry
+            switch (*p_) {
+            case '{':
+            case '[': {
+                bool object = *p_ == '{';
+                if (frames_.size() >= kMaxDepth) return fail("nesting too deep");
+                ++p_;
+                skip_whitespace();
+                if (p_ < end_ && *p_ == (object ? '}' : ']')) {
+                    ++p_;
+                    value = object ? make_object(doc_.arena_, nullptr, 0) : make_array(doc_.arena_, nullptr, 0);
+                    break;
+                }
+                frames_.push_back({object, object ? members_.size() : items_.size()});
+                if (object && !parse_key()) return false;
+                continue;
+            }
+            case '"': {
+                ++p_;
+                const char* chars;
+                uint32_t size;
+                if (!parse_string(chars, size)) return false;
+                value = Node::from_string(chars, size);
+                break;
+            }
+            case 't':
+                if (!parse_literal("true", 4)) return false;
+                value = Node::from_bool(true);
+                break;
+            case 'f':
+                if (!parse_literal("false", 5)) return false;
+                value = Node::from_bool(false);
+                break;
+            case 'n':
+                if (!parse_literal("null", 4)) return false;
+                value = Node::null();
+                break;
+            default:
+                if (!parse_number(value)) return false;
+                break;
+            }
+
+            // Attach the value to the innermost open container, closing
+            // containers as their end brackets arrive
+            for (;;) {
+                if (frames_.empty()) {
+                    doc_.root_ = value;
+                    skip_whitespace();
+                    if (p_ != end_) return fail("trailing characters after JSON value");
+                    return doc_.error_.empty();
+                }
+
+                Frame& frame = frames_.back();
+                if (frame.object) {
+                    members_.back().value = value;
+                } else {
+                    items_.push_back(value);
+                }
+
+                skip_whitespace();
+                if (p_ >= end_) return fail("unexpected end of input");
+                char c = *p_;
+                if (c == ',') {
+                    ++p_;
+                    if (frame.object && !parse_key()) return false;
+                    break;  // Next value
+                }
+                if (c != (frame.object ? '}' : ']')) return fail(frame.object ? "expected ',' or '}'" : "expected ',' or ']'");
+                ++p_;
+                if (frame.object) {
+                    value = make_object(doc_.arena_, members_.data() + frame.start, members_.size() - frame.start);
+                    members_.resize(frame.start);
+                } else {
+                    value = make_array(doc_.arena_, items_.data() + frame.start, items_.size() - frame.start);
+                    items_.resize(frame.start);
+                }
+                frames_.pop_back();
+            }
+        }
+    }
+};
+
+inline std::shared_ptr<Document> Document::parse(std::string text) {
+    auto doc = std::make_shared<Document>();
+    doc->source_ = std::move(text);
+    doc->arena_.reserve(doc->source_.size() / 2);
+
+    // Two stages: the structural index, then the DOM built by walking it.
+    // Offsets are 31-bit, so larger inputs are parsed directly.
+    simd::StructuralIndexer indexer(doc->source_);
+    bool indexed = simd::StructuralIndexer::supports(doc->source_.size());
+    Parser parser(*doc, doc->source_, indexed ? &indexer : nullptr);
+    if (!parser.parse()) doc->root_ = Node::null();
+    return doc;
+}
+
+inline std::shared_ptr<Document> Document::parse_lines(std::string text, size_t* errors) {
+    auto doc = std::make_shared<Document>();
+    doc->source_ = std::move(text);
+    doc->arena_.reserve(doc->source_.size() / 2);
+
+    // Records are short, so each line is scanned directly rather than indexed
+    std::vector<Node> records;
+    size_t failed = 0;
+    Parser parser(*doc, std::string_view());
+    const char* p = doc->source_.data();
+    const char* end = p + doc->source_.size();
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* line_end = nl ? nl : end;
+        std::string_view line(p, static_cast<size_t>(line_end - p));
+        p = nl ? nl + 1 : end;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos) continue;
+
+        doc->error_.clear();
+        parser.reset(line);
+        if (parser.parse()) {
+            records.push_back(doc->root_);
+        } else {
+            records.push_back(Node::null());
+            ++failed;
+        }
+    }
+    doc->error_.clear();
+    doc->root_ = make_array(doc->arena_, records.data(), records.size());
+    if (errors) *errors = failed;
+    return doc;
+}
+
+} // namespace mlc::json
+
+#endif // MLC_JSON_DOM_HPP
@@ -0,0 +1,386 @@
+#ifndef MLC_JSON_LAZY_HPP
+#define MLC_JSON_LAZY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "mlc_json.hpp"
+
+// On-demand JSON access.
+//
+// json_lazy keeps the source text and hands out cursors into it instead of
+// building a DOM. The text is checked once, when the cursor is made: stage one
+// runs over all of it (strings terminated, no control characters, valid
+// UTF-8), its brackets must pair up around a single value, and where each
+// container closes is recorded. get() and at() then walk one container and
+// step over the values they pass with that record; only the value finally
+// read is parsed.
+//
+// A document that fails the check is null, as it is for parse_json, so
+// truncated input finds nothing. Scalars and separators are only checked
+// where a lookup reads them; the DOM also rejects a document whose skipped
+// values are malformed, which is why the compiler only uses cursors when
+// asked to (RuntimePolicy#json_strategy = :lazy). With duplicate keys the
+// last one wins, as in the DOM, so get() reads a whole object.
+
+namespace mlc::json {
+
+namespace lazy {
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline const char* skip_whitespace(const char* p, const char* end) {
+    while (p < end && is_space(*p)) ++p;
+    return p;
+}
+
+// Past the closing quote of the string opening at p; nullptr if unterminated
+inline const char* skip_string(const char* p, const char* end) {
+    const char* q = p + 1;
+    for (;;) {
+        q = static_cast<const char*>(std::memchr(q, '"', static_cast<size_t>(end - q)));
+        if (!q) return nullptr;
+        const char* run = q;
+        while (run > p + 1 && run[-1] == '\\') --run;
+        if ((q - run) % 2 == 0) return q + 1;
+        ++q;
+    }
+}
+
+// Past the bracket closing the container that opens at p, found by counting
+// brackets outside strings 64 bytes at a time; nullptr if unbalanced
+inline const char* scan_container(const char* p, const char* end) {
+    static const simd::ClassifyFn classify = simd::classifier(simd::best_kernel());
+    simd::StringMask strings;
+    unsigned char tail[64];
+    size_t depth = 0;
+    for (const char* block = p; block < end; block += 64) {
+        const size_t avail = static_cast<size_t>(end - block);
+        const auto* data = reinterpret_cast<const unsigned char*>(block);
+        if (avail < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, avail);
+            data = tail;
+        }
+        simd::BlockMasks m;
+        classify(data, 1, &m);
+        uint64_t in_string;
+        strings.next(m, in_string);
+        for (uint64_t ops = m.op & ~in_string; ops; ops &= ops - 1) {
+            const char c = block[__builtin_ctzll(ops)];
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return block + __builtin_ctzll(ops) + 1;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// A document's text and, once indexed, where each of its containers closes:
+// opens holds the offsets of opening brackets in ascending order and
+// closes[i] the offset just past the match of opens[i]
+struct Source {
+    std::string text;
+    std::vector<uint32_t> opens;
+    std::vector<uint32_t> closes;
+    bool indexed = false;  // Texts too large for 31-bit offsets are scanned instead
+
+    const char* begin() const { return text.data(); }
+    const char* end() const { return text.data() + text.size(); }
+
+    // Past the bracket closing the container that opens at p
+    const char* skip_container(const char* p) const {
+        if (!indexed) return scan_container(p, end());
+        const auto offset = static_cast<uint32_t>(p - begin());
+        const auto it = std::lower_bound(opens.begin(), opens.end(), offset);
+        return begin() + closes[static_cast<size_t>(it - opens.begin())];
+    }
+};
+
+// Check source.text and record where its containers close. True if the text
+// is one value whose strings pass stage one and whose brackets pair up,
+// nested no deeper than the parser allows.
+inline bool index(Source& source) {
+    const std::string_view text = source.text;
+    // Offsets are 31-bit: larger texts are checked by a full parse and left unindexed
+    if (!simd::StructuralIndexer::supports(text.size())) return Document::parse(source.text)->ok();
+    simd::StructuralIndexer indexer(text);
+    std::vector<uint32_t> open;  // Containers not closed yet, as indices into opens
+    bool in_string = false;
+    size_t values = 0;           // Top-level values
+    while (indexer.next()) {
+        const uint32_t* entries = indexer.entries();
+        for (size_t i = 0; i < indexer.size(); ++i) {
+            const uint32_t offset = entries[i] & simd::kOffsetMask;
+            if (offset == text.size()) break;  // Sentinel
+            const char c = text[offset];
+            if (in_string) {
+                in_string = false;  // The closing quote always follows the opening one
+                continue;
+            }
+            if (open.empty() && c != '}' && c != ']' && ++values > 1) return false;
+            switch (c) {
+            case '"':
+                in_string = true;
+                break;
+            case '{':
+            case '[':
+                if (open.size() >= Parser::kMaxDepth) return false;
+                open.push_back(static_cast<uint32_t>(source.opens.size()));
+                source.opens.push_back(offset);
+                source.closes.push_back(0);
+                break;
+            case '}':
+            case ']':
+                if (open.empty() || text[source.opens[open.back()]] != (c == '}' ? '{' : '[')) return false;
+                source.closes[open.back()] = offset + 1;
+                open.pop_back();
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    source.indexed = true;
+    return !indexer.error() && values == 1 && open.empty();
+}
+
+// Past the value starting at p; nullptr if it is cut off or missing
+inline const char* skip_value(const Source& source, const char* p) {
+    const char* const end = source.end();
+    if (p >= end) return nullptr;
+    switch (*p) {
+    case '"':
+        return skip_string(p, end);
+    case '{':
+    case '[':
+        return source.skip_container(p);
+    case ',':
+    case ':':
+    case '}':
+    case ']':
+        return nullptr;
+    default: {
+        const char* q = p;
+        while (q < end && !is_space(*q) && *q != ',' && *q != ':' && *q != '}' && *q != ']') ++q;
+        return q;
+    }
+    }
+}
+
+} // namespace lazy
+
+// Cursor to one value of a JSON text. A cursor that found nothing (missing
+// key, index out of range, malformed input) is empty and every lookup on it
+// stays empty, so chains like doc.get("a").get("b").as_number() need one check.
+class LazyValue {
+private:
+    std::shared_ptr<const lazy::Source> source_;
+    const char* p_ = nullptr;  // First byte of the value; nullptr when empty
+
+    const char* end() const { return source_->end(); }
+
+    LazyValue cursor(const char* p) const {
+        LazyValue value;
+        if (p < end()) {
+            value.source_ = source_;
+            value.p_ = p;
+        }
+        return value;
+    }
+
+    // Parse this value alone; meant for scalars, whose text is one token
+    bool parse_into(Document& doc) const {
+        if (!p_) return false;
+        const char* stop = lazy::skip_value(*source_, p_);
+        if (!stop) return false;
+        Parser parser(doc, std::string_view(p_, static_cast<size_t>(stop - p_)));
+        return parser.parse();
+    }
+
+    // Compare the key whose quotes are at open and close-1 with `key`
+    static bool key_equals(const char* open, const char* close, std::string_view key) {
+        const char* chars = open + 1;
+        const size_t size = static_cast<size_t>(close - 1 - chars);
+        if (!std::memchr(chars, '\\', size)) return size == key.size() && std::memcmp(chars, key.data(), size) == 0;
+        Document doc;
+        Parser parser(doc, std::string_view(open, static_cast<size_t>(close - open)));
+        return parser.parse() && doc.root().string() == key;
+    }
+
+    // Calls fn(value_start) for each element, or fn(key_open, key_close, value_start)
+    // for each member, until it returns true; false if nothing matched
+    template <typename Fn>
+    bool for_each_entry(bool object, Fn&& fn) const {
+        if (!p_ || *p_ != (object ? '{' : '[')) return false;
+        const char* const e = end();
+        const char* p = lazy::skip_whitespace(p_ + 1, e);
+        if (p < e && *p == (object ? '}' : ']')) return false;
+        for (;;) {
+            const char* key_open = p;
+            const char* key_close = nullptr;
+            if (object) {
+                if (p >= e || *p != '"' || !(key_close = lazy::skip_string(p, e))) return false;
+                p = lazy::skip_whitespace(key_close, e);
+                if (p >= e || *p != ':') return false;
+                p = lazy::skip_whitespace(p + 1, e);
+            }
+            if (p >= e) return false;
+            bool found;
+            if constexpr (std::is_invocable_v<Fn, const char*>) {
+                found = fn(p);
+            } else {
+                found = fn(key_open, key_close, p);
+            }
+            if (found) return true;
+            if (!(p = lazy::skip_value(*source_, p))) return false;
+            p = lazy::skip_whitespace(p, e);
+            if (p >= e || *p != ',') return false;
+            p = lazy::skip_whitespace(p + 1, e);
+        }
+    }
+
+public:
+    LazyValue() = default;
+
+    // Empty unless `text` passes lazy::index
+    explicit LazyValue(std::string text) {
+        auto source = std::make_shared<lazy::Source>();
+        source->text = std::move(text);
+        const bool ok = lazy::index(*source);
+        source_ = std::move(source);
+        const char* p = lazy::skip_whitespace(source_->begin(), end());
+        if (ok && p < end()) p_ = p;
+    }
+
+    // Whether this cursor points at a value
+    bool exists() const { return p_ != nullptr; }
+    explicit operator bool() const { return exists(); }
+
+    // Type from the first byte; an empty cursor reads as null
+    Type type() const {
+        if (!p_) return Type::Null;
+        switch (*p_) {
+        case '{': return Type::Object;
+        case '[': return Type::Array;
+        case '"': return Type::String;
+        case 't':
+        case 'f': return Type::Bool;
+        case 'n': return Type::Null;
+        default: return Type::Number;
+        }
+    }
+
+    bool is_null() const { return type() == Type::Null; }
+    bool is_bool() const { return type() == Type::Bool; }
+    bool is_number() const { return type() == Type::Number; }
+    bool is_string() const { return type() == Type::String; }
+    bool is_array() const { return type() == Type::Array; }
+    bool is_object() const { return type() == Type::Object; }
+
+    std::optional<bool> as_bool() const {
+        Document doc;
+        if (!is_bool() || !parse_into(doc)) return std::nullopt;
+        return doc.root().boolean;
+    }
+
+    std::optional<double> as_number() const {
+        Document doc;
+        if (!is_number() || !parse_into(doc)) return std::nullopt;
+        return doc.root().number;
+    }
+
+    std::optional<mlc::String> as_string() const {
+        Document doc;
+        if (!is_string() || !parse_into(doc)) return std::nullopt;
+        return mlc::String(std::string(doc.root().string()));
+    }
+
+    // Member of an object (empty if absent); the last one of duplicate keys
+    LazyValue get(std::string_view key) const {
+        const char* found = nullptr;
+        for_each_entry(true, [&](const char* open, const char* close, const char* value) {
+            if (key_equals(open, close, key)) found = value;
+            return false;
+        });
+        return found ? cursor(found) : LazyValue();
+    }
+
+    // Element of an array (empty if out of range)
+    LazyValue at(size_t index) const {
+        const char* found = nullptr;
+        size_t i = 0;
+        for_each_entry(false, [&](const char* value) {
+            if (i++ != index) return false;
+            found = value;
+            return true;
+        });
+        return found ? cursor(found) : LazyValue();
+    }
+
+    // Number of array elements or object members (0 for scalars)
+    size_t size() const {
+        size_t count = 0;
+        if (is_object()) {
+            for_each_entry(true, [&](const char*, const char*, const char*) { return ++count, false; });
+        } else if (is_array()) {
+            for_each_entry(false, [&](const char*) { return ++count, false; });
+        }
+        return count;
+    }
+
+    // Parse this value (and only this value) into a DOM
+    JsonValue value() const {
+        const char* stop = p_ ? lazy::skip_value(*source_, p_) : nullptr;
+        if (!stop) return JsonValue(std::monostate{});
+        std::shared_ptr<const Document> doc = Document::parse(std::string(p_, stop));
+        if (!doc->ok()) return JsonValue(std::monostate{});
+        Node root = doc->root();
+        return JsonValue(std::move(doc), root);
+    }
+
+    operator JsonValue() const { return value(); }
+};
+
+// Cursor over the text of a JSON document; nothing is parsed until accessed
+inline LazyValue json_lazy(const mlc::String& json_str) {
+    return LazyValue(json_str.as_std_string());
+}
+
+// The JsonValue accessors, on a cursor
+
+inline std::optional<LazyValue> json_get(const LazyValue& obj, const mlc::String& key) {
+    LazyValue value = obj.get(key.as_std_string());
+    if (!value) return std::nullopt;
+    return value;
+}
+
+inline bool json_has_key(const LazyValue& obj, const mlc::String& key) {
+    return obj.get(key.as_std_string()).exists();
+}
+
+inline int32_t json_array_length(const LazyValue& arr) {
+    return static_cast<int32_t>(arr.is_array() ? arr.size() : 0);
+}
+
+inline std::optional<LazyValue> json_array_get(const LazyValue& arr, int32_t index) {
+    if (index < 0) return std::nullopt;
+    LazyValue value = arr.at(static_cast<size_t>(index));
+    if (!value) return std::nullopt;
+    return value;
+}
+
+} // namespace mlc::json
+
+#endif // MLC_JSON_LAZY_HPP
@@ -0,0 +1,113 @@
+#ifndef MLC_JSON_NDJSON_HPP
+#define MLC_JSON_NDJSON_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "mlc_file_scan.hpp"
+#include "mlc_json.hpp"
+
+// Newline-delimited JSON (JSON Lines): the file is memory-mapped and split
+// into chunks of about 1 MB on line boundaries; each batch parses as many
+// chunks as there are workers, one thread and one Document (so one arena)
+// per chunk. Records come back in file order and share their chunk's
+// Document, so memory is bounded by the batch plus whatever the caller keeps.
+
+namespace mlc::json {
+
+class NdjsonReader {
+private:
+    file::MappedFile file_;
+    std::vector<std::pair<size_t, size_t>> chunks_;
+    size_t next_chunk_ = 0;
+    size_t workers_;
+    size_t errors_ = 0;
+
+public:
+    // threads <= 0 uses every core
+    explicit NdjsonReader(const std::string& path, int threads = 0)
+        : file_(path), workers_(file::detail::scan_thread_count(threads)) {
+        std::string_view text = file_.view();
+        chunks_ = file::detail::line_chunks(text, text.size() / file::detail::kMinScanChunk + 1);
+    }
+
+    NdjsonReader(const NdjsonReader&) = delete;
+    NdjsonReader& operator=(const NdjsonReader&) = delete;
+
+    bool is_open() const { return file_.is_open(); }
+    bool done() const { return next_chunk_ >= chunks_.size(); }
+
+    // Lines that were not valid JSON so far (they are returned as null)
+    size_t errors() const { return errors_; }
+
+    // Records of the next batch of chunks in file order; empty once done
+    std::vector<JsonValue> next_batch() {
+        std::vector<JsonValue> records;
+        size_t count = std::min(workers_, chunks_.size() - next_chunk_);
+        if (count == 0) return records;
+
+        std::vector<std::shared_ptr<const Document>> docs(count);
+        std::vector<size_t> errors(count, 0);
+        auto parse_chunk = [&](size_t i) {
+            auto [begin, end] = chunks_[next_chunk_ + i];
+            docs[i] = Document::parse_lines(std::string(file_.view().substr(begin, end - begin)), &errors[i]);
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i) pool.emplace_back(parse_chunk, i);
+        parse_chunk(0);
+        for (auto& t : pool) t.join();
+        next_chunk_ += count;
+
+        size_t total = 0;
+        for (const auto& doc : docs) total += doc->root().size;
+        records.reserve(total);
+        for (size_t i = 0; i < count; ++i) {
+            const Node& root = docs[i]->root();
+            for (uint32_t j = 0; j < root.size; ++j) records.emplace_back(docs[i], root.items[j]);
+            errors_ += errors[i];
+        }
+        return records;
+    }
+};
+
+// Every record of a JSON Lines file, in order (empty if it cannot be opened)
+inline std::vector<JsonValue> ndjson_read(const mlc::String& path, int32_t threads = 0) {
+    NdjsonReader reader(path.as_std_string(), threads);
+    std::vector<JsonValue> records;
+    while (!reader.done()) {
+        std::vector<JsonValue> batch = reader.next_batch();
+        if (records.empty()) {
+            records = std::move(batch);
+        } else {
+            records.insert(records.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        }
+    }
+    return records;
+}
+
+// Batch iteration from MLC (NdjsonReader is an opaque type there)
+inline NdjsonReader* ndjson_open(const mlc::String& path, int32_t threads) {
+    return new NdjsonReader(path.as_std_string(), threads);
+}
+
+inline std::vector<JsonValue> ndjson_next_batch(NdjsonReader* reader) {
+    return reader->next_batch();
+}
+
+inline int32_t ndjson_errors(NdjsonReader* reader) {
+    return static_cast<int32_t>(reader->errors());
+}
+
+inline void ndjson_close(NdjsonReader* reader) {
+    delete reader;
+}
+
+} // namespace mlc::json
+
+#endif // MLC_JSON_NDJSON_HPP
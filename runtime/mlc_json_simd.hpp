@@ -0,0 +1,503 @@
+#ifndef MLC_JSON_SIMD_HPP
+#define MLC_JSON_SIMD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define MLC_JSON_X86 1
+#include <immintrin.h>
+#endif
+
+// Stage one of JSON parsing: a structural index.
+//
+// The input is classified 64 bytes at a time into bitmasks (quotes,
+// backslashes, operators, whitespace, control and non-ASCII bytes). Bit
+// arithmetic on those masks finds escaped characters and string interiors,
+// then every value start, operator and string quote outside string
+// interiors is appended to the index. Unescaped control characters inside
+// strings, unterminated strings and malformed UTF-8 are reported here, so
+// stage two (the DOM parser) never rescans whitespace or string bodies.
+//
+// The block classifier is picked once at runtime: AVX2 when the CPU has it,
+// SSE2 on other x86-64 machines, and a table-driven scalar loop elsewhere.
+// The serializer's find_escape scans string bodies for bytes that need
+// escaping with the same choice of instruction set.
+
+namespace mlc::json {
+
+namespace detail {
+
+// Length of the well-formed UTF-8 sequence at s (avail bytes readable), 0 if malformed
+inline size_t utf8_sequence(const unsigned char* s, size_t avail) {
+    unsigned char c = s[0];
+    if (c < 0x80) return 1;
+    size_t len;
+    uint32_t cp;
+    if ((c & 0xE0) == 0xC0) {
+        len = 2;
+        cp = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        len = 3;
+        cp = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        len = 4;
+        cp = c & 0x07;
+    } else {
+        return 0;
+    }
+    if (len > avail) return 0;
+    for (size_t k = 1; k < len; ++k) {
+        if ((s[k] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[k] & 0x3F);
+    }
+    if ((len == 2 && cp < 0x80) || (len == 3 && cp < 0x800) || (len == 4 && cp < 0x10000) || cp > 0x10FFFF ||
+        (cp >= 0xD800 && cp <= 0xDFFF)) {
+        return 0;
+    }
+    return len;
+}
+
+} // namespace detail
+
+namespace simd {
+
+enum class Kernel { Scalar, Sse2, Avx2 };
+
+// Per-byte class bits of one 64-byte block
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;         // { } [ ] : ,
+    uint64_t space;      // space \t \n \r
+    uint64_t control;    // < 0x20
+    uint64_t high;       // >= 0x80
+};
+
+// Classifies `blocks` consecutive 64-byte blocks starting at p
+using ClassifyFn = void (*)(const unsigned char* p, size_t blocks, BlockMasks* out);
+
+inline void classify_scalar(const unsigned char* p, size_t blocks, BlockMasks* out) {
+    enum : uint8_t { kQuote = 1, kBackslash = 2, kOp = 4, kSpace = 8, kControl = 16, kHigh = 32 };
+    static const auto table = [] {
+        struct Table {
+            uint8_t bits[256];
+        } t{};
+        for (int c = 0; c < 0x20; ++c) t.bits[c] = kControl;
+        for (int c = 0x80; c < 0x100; ++c) t.bits[c] = kHigh;
+        t.bits[static_cast<unsigned char>('"')] = kQuote;
+        t.bits[static_cast<unsigned char>('\\')] = kBackslash;
+        for (char c : {'{', '}', '[', ']', ':', ','}) t.bits[static_cast<unsigned char>(c)] = kOp;
+        t.bits[static_cast<unsigned char>(' ')] = kSpace;
+        t.bits[static_cast<unsigned char>('\t')] = kSpace | kControl;
+        t.bits[static_cast<unsigned char>('\n')] = kSpace | kControl;
+        t.bits[static_cast<unsigned char>('\r')] = kSpace | kControl;
+        return t;
+    }();
+
+    for (size_t b = 0; b < blocks; ++b, p += 64) {
+        BlockMasks m{};
+        for (unsigned i = 0; i < 64; ++i) {
+            uint8_t bits = table.bits[p[i]];
+            if (bits == 0) continue;
+            uint64_t bit = uint64_t{1} << i;
+            if (bits & kQuote) m.quote |= bit;
+            if (bits & kBackslash) m.backslash |= bit;
+            if (bits & kOp) m.op |= bit;
+            if (bits & kSpace) m.space |= bit;
+            if (bits & kControl) m.control |= bit;
+            if (bits & kHigh) m.high |= bit;
+        }
+        out[b] = m;
+    }
+}
+
+#ifdef MLC_JSON_X86
+
+inline uint64_t sse2_eq(const __m128i* v, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v[i], needle)))) << (16 * i);
+    }
+    return mask;
+}
+
+inline void classify_sse2(const unsigned char* p, size_t blocks, BlockMasks* out) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    for (size_t b = 0; b < blocks; ++b, p += 64) {
+        __m128i v[4], folded[4];
+        uint64_t control = 0, high = 0;
+        for (int i = 0; i < 4; ++i) {
+            v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            // '[' | 0x20 == '{' and ']' | 0x20 == '}'
+            folded[i] = _mm_or_si128(v[i], case_bit);
+            __m128i is_control = _mm_cmpeq_epi8(_mm_max_epu8(v[i], control_max), control_max);
+            control |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(is_control))) << (16 * i);
+            high |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(v[i]))) << (16 * i);
+        }
+        BlockMasks& m = out[b];
+        m.quote = sse2_eq(v, '"');
+        m.backslash = sse2_eq(v, '\\');
+        m.op = sse2_eq(folded, '{') | sse2_eq(folded, '}') | sse2_eq(v, ':') | sse2_eq(v, ',');
+        m.space = sse2_eq(v, ' ') | sse2_eq(v, '\t') | sse2_eq(v, '\n') | sse2_eq(v, '\r');
+        m.control = control;
+        m.high = high;
+    }
+}
+
+__attribute__((target("avx2"))) inline uint64_t avx2_eq(__m256i lo, __m256i hi, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    uint32_t low_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    uint32_t high_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return low_mask | (static_cast<uint64_t>(high_mask) << 32);
+}
+
+__attribute__((target("avx2"))) inline uint64_t avx2_bits(__m256i lo, __m256i hi) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(lo)) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+}
+
+__attribute__((target("avx2"))) inline void classify_avx2(const unsigned char* p, size_t blocks, BlockMasks* out) {
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+    for (size_t b = 0; b < blocks; ++b, p += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        __m256i folded_lo = _mm256_or_si256(lo, case_bit);
+        __m256i folded_hi = _mm256_or_si256(hi, case_bit);
+        BlockMasks& m = out[b];
+        m.quote = avx2_eq(lo, hi, '"');
+        m.backslash = avx2_eq(lo, hi, '\\');
+        m.op = avx2_eq(folded_lo, folded_hi, '{') | avx2_eq(folded_lo, folded_hi, '}') | avx2_eq(lo, hi, ':') |
+               avx2_eq(lo, hi, ',');
+        m.space = avx2_eq(lo, hi, ' ') | avx2_eq(lo, hi, '\t') | avx2_eq(lo, hi, '\n') | avx2_eq(lo, hi, '\r');
+        m.control = avx2_bits(_mm256_cmpeq_epi8(_mm256_max_epu8(lo, control_max), control_max),
+                              _mm256_cmpeq_epi8(_mm256_max_epu8(hi, control_max), control_max));
+        m.high = avx2_bits(lo, hi);
+    }
+}
+
+#endif // MLC_JSON_X86
+
+// Best kernel supported by this CPU (detected once)
+inline Kernel best_kernel() {
+#ifdef MLC_JSON_X86
+    static const Kernel kernel = __builtin_cpu_supports("avx2") ? Kernel::Avx2 : Kernel::Sse2;
+    return kernel;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+inline bool kernel_supported(Kernel kernel) {
+#ifdef MLC_JSON_X86
+    return kernel != Kernel::Avx2 || best_kernel() == Kernel::Avx2;
+#else
+    return kernel == Kernel::Scalar;
+#endif
+}
+
+inline ClassifyFn classifier(Kernel kernel) {
+#ifdef MLC_JSON_X86
+    if (kernel == Kernel::Avx2) return classify_avx2;
+    if (kernel == Kernel::Sse2) return classify_sse2;
+#endif
+    (void)kernel;
+    return classify_scalar;
+}
+
+// Offset of the first byte of p[0, size) that a JSON string must escape (a
+// control character, '"' or '\\'), or size if there is none
+inline size_t find_escape_scalar(const char* p, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(p[i]);
+        if (c < 0x20 || c == '"' || c == '\\') return i;
+    }
+    return size;
+}
+
+#ifdef MLC_JSON_X86
+
+inline size_t find_escape_sse2(const char* p, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                   _mm_cmpeq_epi8(_mm_max_epu8(v, control_max), control_max));
+        if (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit))) return i + __builtin_ctz(mask);
+    }
+    return i + find_escape_scalar(p + i, size - i);
+}
+
+__attribute__((target("avx2"))) inline size_t find_escape_avx2(const char* p, size_t size) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                                      _mm256_cmpeq_epi8(_mm256_max_epu8(v, control_max), control_max));
+        if (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit))) return i + __builtin_ctz(mask);
+    }
+    return i + find_escape_sse2(p + i, size - i);
+}
+
+#endif // MLC_JSON_X86
+
+inline size_t find_escape(const char* p, size_t size) {
+#ifdef MLC_JSON_X86
+    if (size < 16) return find_escape_scalar(p, size);
+    return best_kernel() == Kernel::Avx2 ? find_escape_avx2(p, size) : find_escape_sse2(p, size);
+#else
+    return find_escape_scalar(p, size);
+#endif
+}
+
+// Running XOR of the bits from least to most significant
+inline uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Tracks backslash escapes and string interiors across consecutive blocks
+class StringMask {
+private:
+    bool escape_carry_ = false;     // Last byte was an unescaped backslash
+    uint64_t in_string_carry_ = 0;  // All ones while inside a string
+
+public:
+    // Unescaped quotes of the block; in_string gets the opening quote and
+    // interior of every string (not the closing quote)
+    uint64_t next(const BlockMasks& m, uint64_t& in_string) {
+        // Escaped characters: the byte after each odd-length run of backslashes
+        const uint64_t even_bits = 0x5555555555555555ULL;
+        const uint64_t backslash = m.backslash;
+        uint64_t run_starts = backslash & ~(backslash << 1);
+        uint64_t even_start_mask = even_bits ^ static_cast<uint64_t>(escape_carry_);
+        uint64_t even_carries = backslash + (run_starts & even_start_mask);
+        uint64_t odd_carries;
+        bool ends_odd = __builtin_add_overflow(backslash, run_starts & ~even_start_mask, &odd_carries);
+        odd_carries |= static_cast<uint64_t>(escape_carry_);
+        uint64_t escaped = (even_carries & ~backslash & ~even_bits) | (odd_carries & ~backslash & even_bits);
+        escape_carry_ = ends_odd;
+
+        uint64_t quote = m.quote & ~escaped;
+        in_string = prefix_xor(quote) ^ in_string_carry_;
+        in_string_carry_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+        return quote;
+    }
+
+    // Whether the last block ended inside a string
+    bool inside() const { return in_string_carry_ != 0; }
+};
+
+// Closing-quote entries of strings that contain escapes carry this bit
+constexpr uint32_t kEscapedString = uint32_t{1} << 31;
+constexpr uint32_t kOffsetMask = kEscapedString - 1;
+
+// Incremental stage one: each call to next() indexes a further window of the
+// input, so a parser can consume the index while it is still in cache.
+// Entries are offsets of operators, string quotes (opening and closing) and
+// the first byte of every other token; after the last block a sentinel equal
+// to text.size() is appended.
+class StructuralIndexer {
+private:
+    static constexpr size_t kBatch = 16;
+
+    const unsigned char* data_;
+    size_t size_;
+    ClassifyFn classify_;
+    size_t window_blocks_;
+    size_t block_ = 0;
+    bool done_ = false;
+    const char* error_ = nullptr;
+    size_t error_offset_ = 0;
+
+    std::unique_ptr<uint32_t[]> entries_;
+    size_t count_ = 0;
+    size_t capacity_ = 0;
+
+    // Carried from one block to the next
+    StringMask strings_;
+    bool clean_carry_ = false;       // Inside a string with no escapes so far
+    bool scalar_carry_ = false;      // Last byte belonged to a bare token
+    size_t utf8_checked_ = 0;        // Bytes before this offset are valid UTF-8
+
+    bool fail(const char* message, size_t offset) {
+        error_ = message;
+        error_offset_ = offset;
+        done_ = true;
+        return false;
+    }
+
+    // Append the entries of one classified block; false on error.
+    // Needs 64 + 8 free entries: extraction writes 8 at a time.
+    bool index_block(const BlockMasks& m, size_t base) {
+        const uint64_t backslash = m.backslash;
+        uint64_t in_string;
+        uint64_t quote = strings_.next(m, in_string);
+        uint64_t string_tail = in_string ^ quote;  // Interiors plus closing quotes
+
+        if (uint64_t bad = m.control & in_string) {
+            return fail("control character in string", base + static_cast<size_t>(__builtin_ctzll(bad)));
+        }
+
+        if (m.high) {
+            size_t limit = std::min(base + 64, size_);
+            size_t pos = std::max(utf8_checked_, base);
+            while (pos < limit) {
+                size_t len = detail::utf8_sequence(data_ + pos, size_ - pos);
+                if (len == 0) return fail("invalid UTF-8", pos);
+                pos += len;
+            }
+            utf8_checked_ = pos;
+        }
+
+        // Strings with escapes: a carry started at each opening quote runs
+        // through the interior and reaches the closing quote only if no
+        // backslash is in the way
+        uint64_t opens = quote & in_string;
+        uint64_t closes = quote & ~in_string;
+        uint64_t reached;
+        bool carry = __builtin_add_overflow(in_string & ~backslash, opens, &reached);
+        carry |= __builtin_add_overflow(reached, static_cast<uint64_t>(clean_carry_), &reached);
+        clean_carry_ = carry;
+        uint64_t escaped_closes = closes & ~reached;
+
+        // Bare tokens (numbers, literals, garbage) are indexed at their first byte
+        uint64_t scalar = ~(m.op | m.space);
+        uint64_t bare = scalar & ~m.quote;
+        uint64_t follows_bare = (bare << 1) | static_cast<uint64_t>(scalar_carry_);
+        scalar_carry_ = bare >> 63;
+        uint64_t starts = scalar & ~follows_bare;
+
+        uint64_t structural = ((m.op | starts) & ~string_tail) | quote;
+        if (base + 64 > size_) {
+            uint64_t in_range = (uint64_t{1} << (size_ - base)) - 1;
+            structural &= in_range;
+            escaped_closes &= in_range;
+        }
+
+        uint32_t* out = entries_.get() + count_;
+        const uint32_t offset = static_cast<uint32_t>(base);
+        const size_t found = static_cast<size_t>(__builtin_popcountll(structural));
+        for (uint64_t bits = structural; bits;) {
+            for (int i = 0; i < 8; ++i) {
+                out[i] = offset + static_cast<uint32_t>(__builtin_ctzll(bits | (uint64_t{1} << 63)));
+                bits &= bits - 1;
+            }
+            out += 8;
+        }
+        for (uint64_t bits = escaped_closes; bits; bits &= bits - 1) {
+            uint64_t below = (uint64_t{1} << __builtin_ctzll(bits)) - 1;
+            entries_[count_ + static_cast<size_t>(__builtin_popcountll(structural & below))] |= kEscapedString;
+        }
+        count_ += found;
+        return true;
+    }
+
+public:
+    // Inputs must be shorter than 2 GiB (offsets are 31-bit)
+    explicit StructuralIndexer(std::string_view text, Kernel kernel = best_kernel(), size_t window_blocks = 1024)
+        : data_(reinterpret_cast<const unsigned char*>(text.data())),
+          size_(text.size()),
+          classify_(classifier(kernel_supported(kernel) ? kernel : best_kernel())),
+          window_blocks_(std::max<size_t>(window_blocks, 1)) {}
+
+    static bool supports(size_t size) { return size < kOffsetMask; }
+
+    bool done() const { return done_; }
+    size_t bytes_indexed() const { return std::min(block_ * 64, size_); }
+    const char* error() const { return error_; }
+    size_t error_offset() const { return error_offset_; }
+
+    // Entries of the current window
+    const uint32_t* entries() const { return entries_.get(); }
+    size_t size() const { return count_; }
+
+    // Index the next window of input. The first `consumed` entries of the
+    // current window are dropped and the rest move to the front, so a reader
+    // can hold on to entries it has not used yet. Returns false on malformed
+    // input (see error()) or when already done.
+    bool next(size_t consumed = SIZE_MAX) {
+        if (done_) return false;
+        consumed = std::min(consumed, count_);
+        size_t kept = count_ - consumed;
+        size_t needed = kept + window_blocks_ * 64 + 72;
+        if (needed > capacity_) {
+            std::unique_ptr<uint32_t[]> grown(new uint32_t[needed]);
+            if (kept > 0) std::memcpy(grown.get(), entries_.get() + consumed, kept * sizeof(uint32_t));
+            entries_ = std::move(grown);
+            capacity_ = needed;
+        } else if (kept > 0 && consumed > 0) {
+            std::memmove(entries_.get(), entries_.get() + consumed, kept * sizeof(uint32_t));
+        }
+        count_ = kept;
+
+        BlockMasks masks[kBatch];
+        unsigned char tail[64];
+        const size_t full_blocks = size_ / 64;
+        for (size_t scanned = 0; scanned < window_blocks_;) {
+            size_t blocks = std::min({kBatch, window_blocks_ - scanned, full_blocks - block_});
+            const unsigned char* p = data_ + block_ * 64;
+            if (blocks == 0) {
+                // Last partial block, padded with spaces
+                std::memset(tail, ' ', sizeof(tail));
+                std::memcpy(tail, p, size_ - block_ * 64);
+                p = tail;
+                blocks = 1;
+            }
+            classify_(p, blocks, masks);
+            for (size_t b = 0; b < blocks; ++b) {
+                if (!index_block(masks[b], (block_ + b) * 64)) return false;
+            }
+            block_ += blocks;
+            scanned += blocks;
+
+            if (block_ * 64 >= size_) {
+                done_ = true;
+                if (strings_.inside()) return fail("unterminated string", size_);
+                entries_[count_++] = static_cast<uint32_t>(size_);
+                return true;
+            }
+        }
+        return true;
+    }
+};
+
+struct IndexResult {
+    const char* error = nullptr;
+    size_t error_offset = 0;
+};
+
+// Build the whole structural index of `text` into `index` at once
+inline IndexResult build_structural_index(std::string_view text, std::vector<uint32_t>& index,
+                                          Kernel kernel = best_kernel()) {
+    StructuralIndexer indexer(text, kernel);
+    index.clear();
+    index.reserve(text.size() / 4 + 1);
+    while (indexer.next()) index.insert(index.end(), indexer.entries(), indexer.entries() + indexer.size());
+    return {indexer.error(), indexer.error_offset()};
+}
+
+} // namespace simd
+
+} // namespace mlc::json
+
+#endif // MLC_JSON_SIMD_HPP
@@ -0,0 +1,371 @@
+#ifndef MLC_JSON_WRITER_HPP
+#define MLC_JSON_WRITER_HPP
+
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+#include "mlc_buffer.hpp"
+#include "mlc_json_dom.hpp"
+#include "mlc_string.hpp"
+
+// JSON serialization: a streaming writer (JsonWriter) that emits begin/key/
+// value/end events as text into a string, a Buffer or a file descriptor, and
+// the node serializer behind it, which stringify_json also uses.
+//
+// String bodies are copied in runs between the bytes that need escaping,
+// found 16 or 32 bytes at a time (simd::find_escape); numbers use the
+// shortest representation that round-trips.
+
+namespace mlc::json {
+
+class JsonValue;
+
+namespace detail {
+
+inline void write_string(std::string& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    size_t run = 0;
+    while (true) {
+        size_t i = run + simd::find_escape(text.data() + run, text.size() - run);
+        out.append(text, run, i - run);
+        if (i == text.size()) break;
+        run = i + 1;
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xF];
+        }
+    }
+    out += '"';
+}
+
+// Integral values print without a fraction; others use the shortest
+// representation that round-trips (at the precision of Float, so a float
+// prints as 0.1 rather than 0.10000000149011612). NaN and infinities become
+// null.
+template <typename Float>
+inline void write_number(std::string& out, Float value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    std::to_chars_result result;
+    if (value == std::trunc(value) && std::fabs(value) < Float(9007199254740992.0)) {
+        result = std::to_chars(buf, buf + sizeof(buf), static_cast<int64_t>(value));
+        if (value == 0 && std::signbit(value)) out += '-';
+    } else {
+        result = std::to_chars(buf, buf + sizeof(buf), value);
+    }
+    out.append(buf, result.ptr);
+}
+
+// Line break plus indentation for `level` (nothing when compact, indent < 0)
+inline void write_newline(std::string& out, int indent, int level) {
+    if (indent < 0) return;
+    out += '\n';
+    out.append(static_cast<size_t>(indent) * static_cast<size_t>(level), ' ');
+}
+
+// indent < 0: compact; otherwise one entry per line indented by `indent` spaces per level
+inline void write_node(std::string& out, const Node& node, int indent, int depth) {
+    switch (node.type) {
+    case Type::Null:
+        out += "null";
+        break;
+    case Type::Bool:
+        out += node.boolean ? "true" : "false";
+        break;
+    case Type::Number:
+        write_number(out, node.number);
+        break;
+    case Type::String:
+        write_string(out, node.string());
+        break;
+    case Type::Array:
+        out += '[';
+        for (uint32_t i = 0; i < node.size; ++i) {
+            if (i > 0) out += ',';
+            write_newline(out, indent, depth + 1);
+            write_node(out, node.items[i], indent, depth + 1);
+        }
+        if (node.size > 0) write_newline(out, indent, depth);
+        out += ']';
+        break;
+    case Type::Object:
+        out += '{';
+        for (uint32_t i = 0; i < node.size; ++i) {
+            if (i > 0) out += ',';
+            write_newline(out, indent, depth + 1);
+            write_string(out, node.members[i].name());
+            out += indent < 0 ? ":" : ": ";
+            write_node(out, node.members[i].value, indent, depth + 1);
+        }
+        if (node.size > 0) write_newline(out, indent, depth);
+        out += '}';
+        break;
+    }
+}
+
+} // namespace detail
+
+// ============================================================================
+// JsonWriter
+// ============================================================================
+
+// Streaming JSON writer. Containers are opened and closed explicitly, object
+// entries are a key() followed by one value; commas, indentation and string
+// escaping are handled here. Text goes straight to the target: appended to a
+// std::string, or staged in a 64 KB chunk that is drained into a Buffer or
+// written to a file descriptor (on flush() and the destructor at the latest).
+//
+// Writing a value where none is allowed (a value without a key inside an
+// object, a second top-level value, a mismatched end_*) throws
+// std::logic_error; a failed write to the descriptor throws
+// std::runtime_error.
+class JsonWriter {
+public:
+    // File descriptor target
+    struct Fd {
+        int fd;
+    };
+
+private:
+    static constexpr size_t kChunkBytes = 64 * 1024;
+
+    struct Level {
+        bool object;
+        uint32_t count;
+    };
+
+    std::string chunk_;
+    std::string& out_;
+    Buffer* buffer_ = nullptr;
+    int fd_ = -1;
+    int indent_;
+    std::vector<Level> levels_;
+    bool key_pending_ = false;
+    bool complete_ = false;
+
+    // Separator and indentation before a value (or a key, for `is_key`)
+    void before(bool is_key) {
+        if (levels_.empty()) {
+            if (complete_ || is_key) throw std::logic_error(is_key ? "JSON writer: key outside an object"
+                                                                   : "JSON writer: more than one top-level value");
+            return;
+        }
+        Level& level = levels_.back();
+        if (level.object && !is_key) {
+            if (!key_pending_) throw std::logic_error("JSON writer: object value without a key");
+            key_pending_ = false;
+            return;
+        }
+        if (is_key && (!level.object || key_pending_)) throw std::logic_error("JSON writer: misplaced key");
+        if (level.count++ > 0) out_ += ',';
+        detail::write_newline(out_, indent_, static_cast<int>(levels_.size()));
+    }
+
+    // After a complete value: a finished document, or time to drain the chunk
+    void after() {
+        if (levels_.empty()) complete_ = true;
+        if (&out_ == &chunk_ && chunk_.size() >= kChunkBytes) drain();
+    }
+
+    void open(bool object, char bracket) {
+        before(false);
+        out_ += bracket;
+        levels_.push_back({object, 0});
+    }
+
+    void close(bool object, char bracket) {
+        if (levels_.empty() || levels_.back().object != object || key_pending_) {
+            throw std::logic_error(object ? "JSON writer: end_object without an open object"
+                                          : "JSON writer: end_array without an open array");
+        }
+        bool empty = levels_.back().count == 0;
+        levels_.pop_back();
+        if (!empty) detail::write_newline(out_, indent_, static_cast<int>(levels_.size()));
+        out_ += bracket;
+        after();
+    }
+
+    // Hand the staged chunk to the Buffer or descriptor
+    void drain() {
+        if (buffer_) {
+            buffer_->append(reinterpret_cast<const uint8_t*>(chunk_.data()), chunk_.size());
+        } else if (fd_ >= 0) {
+            size_t done = 0;
+            while (done < chunk_.size()) {
+                ssize_t n = ::write(fd_, chunk_.data() + done, chunk_.size() - done);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    chunk_.clear();
+                    throw std::runtime_error("JSON writer: write failed");
+                }
+                done += static_cast<size_t>(n);
+            }
+        }
+        chunk_.clear();
+    }
+
+public:
+    // indent < 0 writes compact JSON; otherwise entries go on their own lines
+    // indented by `indent` spaces per level
+    explicit JsonWriter(std::string& out, int indent = -1) : out_(out), indent_(indent) {}
+
+    explicit JsonWriter(Buffer& out, int indent = -1) : out_(chunk_), buffer_(&out), indent_(indent) {
+        chunk_.reserve(kChunkBytes + 4096);
+    }
+
+    explicit JsonWriter(Fd target, int indent = -1) : out_(chunk_), fd_(target.fd), indent_(indent) {
+        chunk_.reserve(kChunkBytes + 4096);
+    }
+
+    ~JsonWriter() {
+        try {
+            flush();
+        } catch (...) {
+            // Destructors must not throw; call flush() explicitly to observe errors
+        }
+    }
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    JsonWriter& begin_object() {
+        open(true, '{');
+        return *this;
+    }
+
+    JsonWriter& end_object() {
+        close(true, '}');
+        return *this;
+    }
+
+    JsonWriter& begin_array() {
+        open(false, '[');
+        return *this;
+    }
+
+    JsonWriter& end_array() {
+        close(false, ']');
+        return *this;
+    }
+
+    JsonWriter& key(std::string_view name) {
+        before(true);
+        detail::write_string(out_, name);
+        out_ += indent_ < 0 ? ":" : ": ";
+        key_pending_ = true;
+        return *this;
+    }
+
+    // A key known to need no escaping (compile-time field names)
+    JsonWriter& plain_key(std::string_view name) {
+        before(true);
+        out_ += '"';
+        out_ += name;
+        out_ += indent_ < 0 ? "\":" : "\": ";
+        key_pending_ = true;
+        return *this;
+    }
+
+    JsonWriter& null() {
+        before(false);
+        out_ += "null";
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(bool b) {
+        before(false);
+        out_ += b ? "true" : "false";
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(double number) {
+        before(false);
+        detail::write_number(out_, number);
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(float number) {
+        before(false);
+        detail::write_number(out_, number);
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(int64_t number) {
+        before(false);
+        char buf[24];
+        out_.append(buf, std::to_chars(buf, buf + sizeof(buf), number).ptr);
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(uint64_t number) {
+        before(false);
+        char buf[24];
+        out_.append(buf, std::to_chars(buf, buf + sizeof(buf), number).ptr);
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(int32_t number) { return value(static_cast<int64_t>(number)); }
+
+    JsonWriter& value(std::string_view text) {
+        before(false);
+        detail::write_string(out_, text);
+        after();
+        return *this;
+    }
+
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(const mlc::String& text) { return value(std::string_view(text.as_std_string())); }
+
+    // A whole parsed or built subtree, indented to fit the current position
+    JsonWriter& value(const Node& node) {
+        before(false);
+        detail::write_node(out_, node, indent_, static_cast<int>(levels_.size()));
+        after();
+        return *this;
+    }
+
+    // A JsonValue (defined in mlc_json.hpp)
+    JsonWriter& value(const JsonValue& json);
+
+    // Nesting depth of the currently open containers
+    size_t depth() const { return levels_.size(); }
+
+    // Whether one complete top-level value has been written
+    bool complete() const { return complete_; }
+
+    // Pass staged output on to the Buffer or descriptor
+    void flush() {
+        if (&out_ == &chunk_ && !chunk_.empty()) drain();
+    }
+};
+
+} // namespace mlc::json
+
+#endif // MLC_JSON_WRITER_HPP
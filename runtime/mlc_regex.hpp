@@ -2,8 +2,15 @@
 #define AURORA_REGEX_HPP
 
 #include "mlc_string.hpp"
+#include "mlc_regex_engine.hpp"
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace mlc {
@@ -11,92 +18,341 @@ namespace mlc {
 // Forward declaration
 class Match;
 class Regex;
+class RegexSet;
 
-// Represents a single capture group in a match
+// A capture group: offsets into the subject string. Nothing is copied until
+// text() is called; view() borrows the bytes directly.
 class Capture {
 private:
-    String text_;
+    const std::string* subject_;
     size_t start_;
     size_t end_;
 
 public:
-    Capture(const String& text, size_t start, size_t end)
-        : text_(text), start_(start), end_(end) {}
+    Capture(const std::string* subject, size_t start, size_t end)
+        : subject_(subject), start_(start), end_(end) {}
 
-    const String& text() const { return text_; }
+    std::string_view view() const { return std::string_view(*subject_).substr(start_, end_ - start_); }
+    String text() const { return String(std::string(view())); }
     size_t start() const { return start_; }
     size_t end() const { return end_; }
-    size_t length() const { return text_.length(); }
+
+    // Length in characters (UTF-8), like String::length()
+    size_t length() const {
+        size_t count = 0;
+        for (char c : view()) count += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        return count;
+    }
 };
 
-// Represents a regex match with capture groups
+// A regex match: start/end offsets of the full match and of each participating
+// capture group. Like std::smatch, a Match refers to the subject string passed
+// to Regex::match and must not outlive it; matching a temporary String makes
+// the Match share ownership of a copy instead.
 class Match {
 private:
-    String full_match_;
-    std::vector<Capture> captures_;
-    size_t start_;
-    size_t end_;
+    friend class Regex;
+
+    std::shared_ptr<const std::string> owned_;
+    const std::string* subject_;
+    std::vector<size_t> offsets_;  // Pairs: full match, then participating groups
+
+    // Refill from engine slots ((groups + 1) * 2 entries, npos = unset),
+    // reusing the offsets buffer
+    void assign(const size_t* slots, size_t count) {
+        constexpr size_t unset = static_cast<size_t>(-1);
+        offsets_.clear();
+        offsets_.push_back(slots[0]);
+        offsets_.push_back(slots[1]);
+        for (size_t i = 2; i + 1 < count; i += 2) {
+            if (slots[i] != unset && slots[i + 1] != unset) {
+                offsets_.push_back(slots[i]);
+                offsets_.push_back(slots[i + 1]);
+            }
+        }
+    }
 
 public:
-    Match(const String& full, size_t start, size_t end)
-        : full_match_(full), start_(start), end_(end) {}
+    Match(const std::string& subject, const size_t* slots, size_t count) : subject_(&subject) {
+        assign(slots, count);
+    }
 
-    // Get the full matched text
-    const String& text() const { return full_match_; }
+    Match(std::shared_ptr<const std::string> subject, const size_t* slots, size_t count)
+        : owned_(std::move(subject)), subject_(owned_.get()) {
+        assign(slots, count);
+    }
+
+    // Matched text (copied on each call; view() does not copy)
+    String text() const { return get(0).text(); }
+    std::string_view view() const { return get(0).view(); }
 
     // Match position
-    size_t start() const { return start_; }
-    size_t end() const { return end_; }
+    size_t start() const { return offsets_[0]; }
+    size_t end() const { return offsets_[1]; }
 
     // Number of capture groups (excluding full match)
-    size_t capture_count() const { return captures_.size(); }
+    size_t capture_count() const { return offsets_.size() / 2 - 1; }
 
     // Get capture group by index (0 = full match)
-    const Capture& get(size_t index) const {
-        if (index == 0) {
-            static Capture full_capture(full_match_, start_, end_);
-            return full_capture;
-        }
-        if (index - 1 >= captures_.size()) {
+    Capture get(size_t index) const {
+        if (index > capture_count()) {
             throw std::out_of_range("Capture group index out of range");
         }
-        return captures_[index - 1];
+        return Capture(subject_, offsets_[index * 2], offsets_[index * 2 + 1]);
+    }
+};
+
+namespace detail {
+
+// A compiled pattern: the in-tree linear-time engine when the pattern fits its
+// ECMAScript subset, std::regex otherwise (backreferences, lookaround, other grammars)
+struct CompiledPattern {
+    std::shared_ptr<const regex_engine::Engine> engine;
+    std::shared_ptr<const std::regex> fallback;
+    bool icase = false;
+};
+
+} // namespace detail
+
+using CompiledRegex = std::shared_ptr<const detail::CompiledPattern>;
+
+namespace detail {
+
+inline std::shared_ptr<const std::regex> compile_std_regex(const std::string& pattern,
+                                                           std::regex_constants::syntax_option_type flags) {
+    try {
+        return std::make_shared<const std::regex>(pattern, flags);
+    } catch (const std::regex_error&) {
+        return nullptr;
+    }
+}
+
+// Flags the in-tree engine understands; anything else goes to std::regex
+inline bool engine_supports(std::regex_constants::syntax_option_type flags) {
+    using namespace std::regex_constants;
+    const syntax_option_type handled = ECMAScript | icase | nosubs | optimize;
+    return (flags & ~handled) == syntax_option_type{};
+}
+
+// Compile a pattern; returns nullptr if the pattern is invalid
+inline CompiledRegex compile_regex(const std::string& pattern,
+                                   std::regex_constants::syntax_option_type flags) {
+    auto compiled = std::make_shared<CompiledPattern>();
+    compiled->icase = (flags & std::regex_constants::icase) != std::regex_constants::syntax_option_type{};
+    if (engine_supports(flags)) {
+        try {
+            compiled->engine = regex_engine::Engine::create(pattern, compiled->icase);
+            return compiled;
+        } catch (const regex_engine::Unsupported&) {
+            // Needs backtracking
+        } catch (const regex_engine::Error&) {
+            // Let std::regex decide; it accepts a few extensions the engine rejects
+        }
+    }
+
+    compiled->fallback = compile_std_regex(pattern, flags);
+    if (!compiled->fallback) return nullptr;
+    return compiled;
+}
+
+// Expand an ECMAScript replacement format ($&, $1..$99, $`, $', $$)
+inline void expand_replacement(const std::string& format, const std::string& text,
+                               const std::vector<size_t>& slots, std::string& out) {
+    const size_t npos = regex_engine::Engine::npos;
+    size_t groups = slots.size() / 2;
+
+    auto append_group = [&](size_t group) {
+        size_t start = slots[group * 2];
+        size_t end = slots[group * 2 + 1];
+        if (start != npos && end != npos) out.append(text, start, end - start);
+    };
+
+    for (size_t i = 0; i < format.size(); ++i) {
+        char c = format[i];
+        if (c != '$' || i + 1 >= format.size()) {
+            out += c;
+            continue;
+        }
+
+        char next = format[i + 1];
+        if (next == '$') {
+            out += '$';
+            ++i;
+        } else if (next == '&') {
+            append_group(0);
+            ++i;
+        } else if (next == '`') {
+            out.append(text, 0, slots[0]);
+            ++i;
+        } else if (next == '\'') {
+            out.append(text, slots[1], std::string::npos);
+            ++i;
+        } else if (next >= '0' && next <= '9') {
+            size_t group = static_cast<size_t>(next - '0');
+            size_t consumed = 1;
+            if (i + 2 < format.size() && format[i + 2] >= '0' && format[i + 2] <= '9') {
+                size_t two = group * 10 + static_cast<size_t>(format[i + 2] - '0');
+                if (two < groups) {
+                    group = two;
+                    consumed = 2;
+                }
+            }
+            if (group < groups) append_group(group);
+            i += consumed;
+        } else {
+            out += c;
+        }
+    }
+}
+
+// Process-wide cache of compiled patterns, shared by every mlc::regex(str) call.
+// Compiled automata are immutable, so one instance is shared between threads.
+class RegexCache {
+private:
+    static constexpr size_t kMaxEntries = 512;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, CompiledRegex> entries_;
+
+public:
+    static RegexCache& instance() {
+        static RegexCache cache;
+        return cache;
+    }
+
+    // Invalid patterns are cached too (as nullptr) so they are not recompiled
+    CompiledRegex get(const std::string& pattern, std::regex_constants::syntax_option_type flags) {
+        std::string key = std::to_string(static_cast<unsigned>(flags));
+        key += ':';
+        key += pattern;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end()) return it->second;
+        }
+
+        // Compile outside the lock; a concurrent duplicate compile is harmless
+        CompiledRegex compiled = compile_regex(pattern, flags);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.size() >= kMaxEntries) {
+            entries_.clear();  // Bound memory for programs generating unbounded patterns
+        }
+        return entries_.emplace(std::move(key), std::move(compiled)).first->second;
     }
 
-    // Add a capture group (internal use)
-    void add_capture(const Capture& cap) {
-        captures_.push_back(cap);
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
     }
 };
 
+} // namespace detail
+
 // Main Regex class
+// Holds a shared, immutable compiled pattern: copying a Regex is O(1).
+// Matching runs on the linear-time regex_engine (lazy DFA for test(), PikeVM
+// for captures); only patterns outside its subset use std::regex.
 class Regex {
 private:
-    std::regex regex_;
+    friend class RegexSet;
+
+    CompiledRegex regex_;
     String pattern_;
     bool valid_;
 
+    static constexpr size_t npos = regex_engine::Engine::npos;
+
+    // Leftmost match at or after `start`; slots hold (group count + 1) * 2
+    // offsets into text, npos for groups that did not participate
+    bool find(const std::string& text, size_t start, std::vector<size_t>& slots,
+              bool continuous = false) const {
+        if (regex_->engine) {
+            return regex_->engine->find(text, start, slots, continuous, continuous);
+        }
+
+        std::smatch sm;
+        auto flags = start > 0 ? std::regex_constants::match_prev_avail : std::regex_constants::match_default;
+        if (continuous) flags |= std::regex_constants::match_continuous | std::regex_constants::match_not_null;
+        if (!std::regex_search(text.cbegin() + static_cast<std::ptrdiff_t>(start), text.cend(), sm,
+                               *regex_->fallback, flags)) {
+            return false;
+        }
+        slots.assign(sm.size() * 2, npos);
+        for (size_t i = 0; i < sm.size(); ++i) {
+            if (sm[i].matched) {
+                slots[i * 2] = static_cast<size_t>(sm[i].first - text.cbegin());
+                slots[i * 2 + 1] = static_cast<size_t>(sm[i].second - text.cbegin());
+            }
+        }
+        return true;
+    }
+
+    // Visit successive non-overlapping matches with std::regex_iterator
+    // semantics: after an empty match, a non-empty match at the same position
+    // is tried before moving on. The callback returns false to stop.
+    template <typename Fn>
+    void each_match(const std::string& text, Fn&& fn) const {
+        std::vector<size_t> slots;
+        if (!find(text, 0, slots)) return;
+
+        while (fn(slots)) {
+            size_t pos = slots[1];
+            if (slots[0] == slots[1]) {
+                if (find(text, pos, slots, true)) continue;
+                if (++pos > text.size()) return;
+            }
+            if (!find(text, pos, slots)) return;
+        }
+    }
+
+    String replace_impl(const String& text, const String& replacement, bool all) const {
+        const std::string& str = text.as_std_string();
+        const std::string& format = replacement.as_std_string();
+        std::string result;
+        size_t copied = 0;
+
+        each_match(str, [&](const std::vector<size_t>& slots) {
+            result.append(str, copied, slots[0] - copied);
+            detail::expand_replacement(format, str, slots, result);
+            copied = slots[1];
+            return all;
+        });
+
+        if (copied == 0 && result.empty()) return text;
+        result.append(str, copied, std::string::npos);
+        return String(result);
+    }
+
 public:
     // Constructors
     Regex() : valid_(false) {}
 
-    Regex(const String& pattern) : pattern_(pattern), valid_(true) {
-        try {
-            regex_ = std::regex(pattern.as_std_string(),
-                               std::regex_constants::ECMAScript);
-        } catch (const std::regex_error& e) {
-            valid_ = false;
-            // In production, we'd store error message
-        }
-    }
+    Regex(const String& pattern)
+        : regex_(detail::compile_regex(pattern.as_std_string(), std::regex_constants::ECMAScript))
+        , pattern_(pattern)
+        , valid_(regex_ != nullptr) {}
 
     Regex(const String& pattern, std::regex_constants::syntax_option_type flags)
-        : pattern_(pattern), valid_(true) {
-        try {
-            regex_ = std::regex(pattern.as_std_string(), flags);
-        } catch (const std::regex_error& e) {
-            valid_ = false;
-        }
+        : regex_(detail::compile_regex(pattern.as_std_string(), flags))
+        , pattern_(pattern)
+        , valid_(regex_ != nullptr) {}
+
+    Regex(const String& pattern, CompiledRegex compiled)
+        : regex_(std::move(compiled))
+        , pattern_(pattern)
+        , valid_(regex_ != nullptr) {}
+
+    // Look up (or compile and insert) the pattern in the process-wide cache
+    static Regex cached(const String& pattern,
+                        std::regex_constants::syntax_option_type flags = std::regex_constants::ECMAScript) {
+        return Regex(pattern, detail::RegexCache::instance().get(pattern.as_std_string(), flags));
     }
 
     // Copy/Move
@@ -109,95 +365,111 @@ public:
     bool is_valid() const { return valid_; }
     const String& pattern() const { return pattern_; }
 
+    // True when matching runs on the linear-time engine rather than std::regex
+    bool is_linear() const { return valid_ && regex_->engine != nullptr; }
+
     // Test if string matches the pattern
     bool test(const String& text) const {
         if (!valid_) return false;
-        return std::regex_search(text.as_std_string(), regex_);
+        if (regex_->engine) return regex_->engine->test(text.as_std_string());
+        return std::regex_search(text.as_std_string(), *regex_->fallback);
+    }
+
+    // test() on borrowed bytes, without building a String
+    bool test_view(std::string_view text) const {
+        if (!valid_) return false;
+        if (regex_->engine) return regex_->engine->test(text);
+        return std::regex_search(text.begin(), text.end(), *regex_->fallback);
+    }
+
+    // Position at or after pos where a match in text could involve the
+    // pattern's required literal (pos when there is no such literal), or
+    // npos if text[pos..] cannot match. Used by line scanners to skip lines.
+    size_t next_candidate(std::string_view text, size_t pos) const {
+        if (!valid_) return npos;
+        if (regex_->engine) return regex_->engine->next_candidate(text, pos);
+        return pos;
     }
 
-    // Find first match
+    // Find first match. The Match refers to `text` (see Match).
     std::optional<Match> match(const String& text) const {
         if (!valid_) return std::nullopt;
 
-        std::smatch sm;
-        if (std::regex_search(text.as_std_string(), sm, regex_)) {
-            Match m(String(sm[0].str()), sm.position(0), sm.position(0) + sm[0].length());
-
-            // Add capture groups (excluding full match at index 0)
-            for (size_t i = 1; i < sm.size(); i++) {
-                if (sm[i].matched) {
-                    m.add_capture(Capture(
-                        String(sm[i].str()),
-                        sm.position(i),
-                        sm.position(i) + sm[i].length()
-                    ));
-                }
-            }
+        const std::string& str = text.as_std_string();
+        std::vector<size_t> slots;
+        if (!find(str, 0, slots)) return std::nullopt;
+        return Match(str, slots.data(), slots.size());
+    }
 
-            return m;
-        }
+    // Temporary subject: the Match keeps a shared copy of it
+    std::optional<Match> match(String&& text) const {
+        if (!valid_) return std::nullopt;
 
-        return std::nullopt;
+        std::vector<size_t> slots;
+        if (!find(text.as_std_string(), 0, slots)) return std::nullopt;
+        return Match(std::make_shared<const std::string>(text.as_std_string()), slots.data(), slots.size());
     }
 
-    // Find all matches
+    // Find all matches. The Matches refer to `text` (see Match).
     std::vector<Match> match_all(const String& text) const {
         std::vector<Match> matches;
         if (!valid_) return matches;
 
         const std::string& str = text.as_std_string();
-        std::smatch sm;
-        std::string::const_iterator search_start(str.cbegin());
-
-        while (std::regex_search(search_start, str.cend(), sm, regex_)) {
-            size_t offset = search_start - str.cbegin();
-            Match m(String(sm[0].str()),
-                   offset + sm.position(0),
-                   offset + sm.position(0) + sm[0].length());
-
-            // Add capture groups
-            for (size_t i = 1; i < sm.size(); i++) {
-                if (sm[i].matched) {
-                    m.add_capture(Capture(
-                        String(sm[i].str()),
-                        offset + sm.position(i),
-                        offset + sm.position(i) + sm[i].length()
-                    ));
-                }
-            }
+        each_match(str, [&](const std::vector<size_t>& slots) {
+            matches.emplace_back(str, slots.data(), slots.size());
+            return true;
+        });
+        return matches;
+    }
 
-            matches.push_back(m);
-            search_start = sm.suffix().first;
-        }
+    // Temporary subject: all Matches share one copy of it
+    std::vector<Match> match_all(String&& text) const {
+        std::vector<Match> matches;
+        if (!valid_) return matches;
 
+        auto owned = std::make_shared<const std::string>(text.as_std_string());
+        each_match(*owned, [&](const std::vector<size_t>& slots) {
+            matches.emplace_back(owned, slots.data(), slots.size());
+            return true;
+        });
         return matches;
     }
 
-    // Replace first match
-    String replace(const String& text, const String& replacement) const {
-        if (!valid_) return text;
+    // Call fn(const Match&) for each match without building a vector. One
+    // Match and its offset buffer are reused across calls, so fn must copy
+    // whatever it keeps. fn may return bool; false stops the scan.
+    template <typename Fn>
+    void for_each_match(const String& text, Fn&& fn) const {
+        if (!valid_) return;
 
-        std::string result = std::regex_replace(
-            text.as_std_string(),
-            regex_,
-            replacement.as_std_string(),
-            std::regex_constants::format_first_only
-        );
+        const std::string& str = text.as_std_string();
+        std::optional<Match> current;
+        each_match(str, [&](const std::vector<size_t>& slots) {
+            if (current) {
+                current->assign(slots.data(), slots.size());
+            } else {
+                current.emplace(str, slots.data(), slots.size());
+            }
+            if constexpr (std::is_void_v<std::invoke_result_t<Fn&, const Match&>>) {
+                fn(static_cast<const Match&>(*current));
+                return true;
+            } else {
+                return static_cast<bool>(fn(static_cast<const Match&>(*current)));
+            }
+        });
+    }
 
-        return String(result);
+    // Replace first match ($&, $1, $`, $' and $$ are expanded)
+    String replace(const String& text, const String& replacement) const {
+        if (!valid_) return text;
+        return replace_impl(text, replacement, false);
     }
 
     // Replace all matches
     String replace_all(const String& text, const String& replacement) const {
         if (!valid_) return text;
-
-        std::string result = std::regex_replace(
-            text.as_std_string(),
-            regex_,
-            replacement.as_std_string()
-        );
-
-        return String(result);
+        return replace_impl(text, replacement, true);
     }
 
     // Split string by regex
@@ -209,13 +481,19 @@ public:
         }
 
         const std::string& str = text.as_std_string();
-        std::sregex_token_iterator iter(str.begin(), str.end(), regex_, -1);
-        std::sregex_token_iterator end;
-
-        for (; iter != end; ++iter) {
-            result.push_back(String(*iter));
+        size_t piece_start = 0;
+        bool found = false;
+        each_match(str, [&](const std::vector<size_t>& slots) {
+            result.push_back(String(str.substr(piece_start, slots[0] - piece_start)));
+            piece_start = slots[1];
+            found = true;
+            return true;
+        });
+
+        // Like std::sregex_token_iterator(-1): trailing piece only if non-empty
+        if (!found || piece_start < str.size()) {
+            result.push_back(String(str.substr(piece_start)));
         }
-
         return result;
     }
 
@@ -229,14 +507,54 @@ public:
     }
 };
 
+// Several regexes matched in a single pass over the text.
+// first_match() returns the index of the lowest-numbered member that matches
+// anywhere; multi-arm regex `match` expressions dispatch on it and then run
+// match() only on the winning arm to extract captures.
+class RegexSet {
+private:
+    std::vector<Regex> regexes_;
+    std::shared_ptr<const regex_engine::Engine> engine_;  // Null if a member needs std::regex
+
+public:
+    RegexSet(std::initializer_list<Regex> regexes) : RegexSet(std::vector<Regex>(regexes)) {}
+
+    explicit RegexSet(std::vector<Regex> regexes) : regexes_(std::move(regexes)) {
+        std::vector<regex_engine::SetPattern> patterns;
+        for (const auto& re : regexes_) {
+            if (!re.is_linear()) return;  // Members are tested one by one
+            patterns.push_back({re.pattern().as_std_string(), re.regex_->icase});
+        }
+        if (patterns.empty()) return;
+        try {
+            engine_ = regex_engine::Engine::create_set(patterns);
+        } catch (const std::exception&) {
+            engine_ = nullptr;
+        }
+    }
+
+    size_t size() const { return regexes_.size(); }
+    const Regex& operator[](size_t index) const { return regexes_.at(index); }
+
+    // Index of the lowest-numbered matching regex, or -1
+    int first_match(const String& text) const {
+        if (engine_) return engine_->first_match(text.as_std_string());
+        for (size_t i = 0; i < regexes_.size(); ++i) {
+            if (regexes_[i].test(text)) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
 // Helper function to create regex (can be used for Aurora's regex() syntax)
+// Patterns are compiled once per process and shared through the regex cache.
 inline Regex regex(const String& pattern) {
-    return Regex(pattern);
+    return Regex::cached(pattern);
 }
 
 // Case-insensitive regex
 inline Regex regex_i(const String& pattern) {
-    return Regex(pattern, std::regex_constants::ECMAScript | std::regex_constants::icase);
+    return Regex::cached(pattern, std::regex_constants::ECMAScript | std::regex_constants::icase);
 }
 
 } // namespace mlc
@@ -0,0 +1,1647 @@
+#ifndef MLC_REGEX_ENGINE_HPP
+#define MLC_REGEX_ENGINE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// In-tree regular expression engine used by mlc::Regex.
+//
+// Patterns are parsed (ECMAScript subset), compiled to a Thompson NFA program
+// and executed by one of two linear-time matchers:
+//   * a lazily built DFA answering "is there a match?" (no captures);
+//   * a PikeVM simulating the NFA with capture slots and leftmost-first
+//     (backtracking-compatible) priorities.
+// Matching is byte-oriented, like std::regex over char.
+//
+// Constructs that need backtracking (backreferences, lookaround) are reported
+// as Unsupported so the caller can fall back to std::regex.
+
+namespace mlc::regex_engine {
+
+// Pattern syntax error
+class Error : public std::runtime_error {
+public:
+    explicit Error(const std::string& msg) : std::runtime_error("regex: " + msg) {}
+};
+
+// Valid pattern that this engine cannot execute in linear time
+class Unsupported : public std::runtime_error {
+public:
+    explicit Unsupported(const std::string& msg) : std::runtime_error("regex: unsupported " + msg) {}
+};
+
+// ============================================================================
+// Byte sets
+// ============================================================================
+
+class ByteSet {
+private:
+    std::array<uint64_t, 4> bits_{};
+
+public:
+    void add(uint8_t b) { bits_[b >> 6] |= uint64_t(1) << (b & 63); }
+
+    void add_range(uint8_t lo, uint8_t hi) {
+        for (unsigned c = lo; c <= hi; ++c) add(static_cast<uint8_t>(c));
+    }
+
+    void add(const ByteSet& other) {
+        for (size_t i = 0; i < 4; ++i) bits_[i] |= other.bits_[i];
+    }
+
+    void negate() {
+        for (auto& word : bits_) word = ~word;
+    }
+
+    bool test(uint8_t b) const { return (bits_[b >> 6] >> (b & 63)) & 1; }
+
+    bool empty() const { return (bits_[0] | bits_[1] | bits_[2] | bits_[3]) == 0; }
+
+    size_t count() const {
+        size_t n = 0;
+        for (auto word : bits_) n += __builtin_popcountll(word);
+        return n;
+    }
+
+    // Add the other ASCII case of every letter in the set
+    void fold_case() {
+        for (unsigned c = 'a'; c <= 'z'; ++c) {
+            uint8_t upper = static_cast<uint8_t>(c - 'a' + 'A');
+            if (test(static_cast<uint8_t>(c)) || test(upper)) {
+                add(static_cast<uint8_t>(c));
+                add(upper);
+            }
+        }
+    }
+
+    bool operator==(const ByteSet& other) const { return bits_ == other.bits_; }
+
+    static ByteSet digits() {
+        ByteSet s;
+        s.add_range('0', '9');
+        return s;
+    }
+
+    static ByteSet word() {
+        ByteSet s;
+        s.add_range('a', 'z');
+        s.add_range('A', 'Z');
+        s.add_range('0', '9');
+        s.add('_');
+        return s;
+    }
+
+    static ByteSet space() {
+        ByteSet s;
+        for (char c : std::string_view(" \t\n\v\f\r")) s.add(static_cast<uint8_t>(c));
+        return s;
+    }
+};
+
+inline bool is_word_byte(uint8_t b) {
+    return (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || (b >= '0' && b <= '9') || b == '_';
+}
+
+// ============================================================================
+// AST
+// ============================================================================
+
+enum class AssertKind : uint8_t {
+    LineStart,      // ^
+    LineEnd,        // $
+    WordBoundary,   // \b
+    NotWordBoundary // \B
+};
+
+struct Node {
+    enum class Kind : uint8_t { Empty, Set, Concat, Alternate, Repeat, Group, Assert };
+
+    Kind kind = Kind::Empty;
+    ByteSet set;                       // Set
+    std::vector<std::unique_ptr<Node>> children;  // Concat, Alternate, Repeat/Group (1 child)
+    int min = 0;                       // Repeat
+    int max = -1;                      // Repeat (-1 = unbounded)
+    bool greedy = true;                // Repeat
+    int capture = -1;                  // Group (-1 = non-capturing)
+    AssertKind assertion = AssertKind::LineStart;
+
+    static std::unique_ptr<Node> make(Kind kind) {
+        auto node = std::make_unique<Node>();
+        node->kind = kind;
+        return node;
+    }
+
+    static std::unique_ptr<Node> byte_set(const ByteSet& set) {
+        auto node = make(Kind::Set);
+        node->set = set;
+        return node;
+    }
+};
+
+// ============================================================================
+// Parser (ECMAScript subset)
+// ============================================================================
+
+class Parser {
+private:
+    std::string_view pattern_;
+    size_t pos_ = 0;
+    bool icase_;
+    int captures_ = 0;
+
+    bool at_end() const { return pos_ >= pattern_.size(); }
+    char peek() const { return pattern_[pos_]; }
+
+    bool consume(char c) {
+        if (!at_end() && peek() == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    ByteSet literal(uint8_t b) const {
+        ByteSet s;
+        s.add(b);
+        if (icase_) s.fold_case();
+        return s;
+    }
+
+    std::unique_ptr<Node> parse_alternation() {
+        auto first = parse_concat();
+        if (at_end() || peek() != '|') return first;
+
+        auto alt = Node::make(Node::Kind::Alternate);
+        alt->children.push_back(std::move(first));
+        while (consume('|')) {
+            alt->children.push_back(parse_concat());
+        }
+        return alt;
+    }
+
+    std::unique_ptr<Node> parse_concat() {
+        auto concat = Node::make(Node::Kind::Concat);
+        while (!at_end() && peek() != '|' && peek() != ')') {
+            concat->children.push_back(parse_repeat());
+        }
+        if (concat->children.size() == 1) return std::move(concat->children.front());
+        return concat;
+    }
+
+    // Parse "{n}", "{n,}" or "{n,m}" at pos_. Returns false (pos_ unchanged)
+    // if the brace does not start a valid quantifier.
+    bool parse_braces(int& min, int& max) {
+        size_t save = pos_;
+        auto number = [&](int& out) {
+            size_t start = pos_;
+            long value = 0;
+            while (!at_end() && peek() >= '0' && peek() <= '9') {
+                value = value * 10 + (peek() - '0');
+                if (value > 100000) throw Error("repetition count too large");
+                ++pos_;
+            }
+            out = static_cast<int>(value);
+            return pos_ > start;
+        };
+
+        ++pos_;  // '{'
+        if (!number(min)) {
+            pos_ = save;
+            return false;
+        }
+        max = min;
+        if (consume(',')) {
+            max = -1;
+            if (!at_end() && peek() != '}' && !number(max)) {
+                pos_ = save;
+                return false;
+            }
+        }
+        if (!consume('}')) {
+            pos_ = save;
+            return false;
+        }
+        if (max != -1 && max < min) throw Error("numbers out of order in {} quantifier");
+        return true;
+    }
+
+    std::unique_ptr<Node> parse_repeat() {
+        auto atom = parse_atom();
+
+        while (!at_end()) {
+            int min, max;
+            char c = peek();
+            if (c == '*') {
+                min = 0; max = -1; ++pos_;
+            } else if (c == '+') {
+                min = 1; max = -1; ++pos_;
+            } else if (c == '?') {
+                min = 0; max = 1; ++pos_;
+            } else if (c == '{' && parse_braces(min, max)) {
+                // parsed
+            } else {
+                break;
+            }
+
+            if (atom->kind == Node::Kind::Assert) throw Error("nothing to repeat");
+
+            auto rep = Node::make(Node::Kind::Repeat);
+            rep->min = min;
+            rep->max = max;
+            rep->greedy = !consume('?');
+            rep->children.push_back(std::move(atom));
+            atom = std::move(rep);
+        }
+        return atom;
+    }
+
+    std::unique_ptr<Node> parse_atom() {
+        char c = peek();
+        switch (c) {
+        case '(': {
+            ++pos_;
+            int capture = -1;
+            if (consume('?')) {
+                if (consume(':')) {
+                    // non-capturing
+                } else if (!at_end() && (peek() == '=' || peek() == '!' || peek() == '<')) {
+                    throw Unsupported("lookaround assertion");
+                } else {
+                    throw Error("invalid group");
+                }
+            } else {
+                capture = ++captures_;
+            }
+            auto inner = parse_alternation();
+            if (!consume(')')) throw Error("missing )");
+            auto group = Node::make(Node::Kind::Group);
+            group->capture = capture;
+            group->children.push_back(std::move(inner));
+            return group;
+        }
+        case ')':
+            throw Error("unmatched )");
+        case '*':
+        case '+':
+        case '?':
+            throw Error("nothing to repeat");
+        case '[':
+            ++pos_;
+            return Node::byte_set(parse_class());
+        case '.': {
+            ++pos_;
+            ByteSet s;
+            s.add('\n');
+            s.add('\r');
+            s.negate();
+            return Node::byte_set(s);
+        }
+        case '^':
+            ++pos_;
+            return make_assert(AssertKind::LineStart);
+        case '$':
+            ++pos_;
+            return make_assert(AssertKind::LineEnd);
+        case '\\':
+            ++pos_;
+            return parse_escape();
+        default:
+            ++pos_;
+            return Node::byte_set(literal(static_cast<uint8_t>(c)));
+        }
+    }
+
+    static std::unique_ptr<Node> make_assert(AssertKind kind) {
+        auto node = Node::make(Node::Kind::Assert);
+        node->assertion = kind;
+        return node;
+    }
+
+    static int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    unsigned parse_hex(size_t digits) {
+        unsigned value = 0;
+        for (size_t i = 0; i < digits; ++i) {
+            if (at_end() || hex_value(peek()) < 0) throw Error("invalid hex escape");
+            value = value * 16 + static_cast<unsigned>(hex_value(peek()));
+            ++pos_;
+        }
+        return value;
+    }
+
+    // Escapes valid both inside and outside classes. Returns true and fills
+    // `set` for class escapes (\d, \w, ...) and single bytes.
+    bool parse_common_escape(char c, ByteSet& set, std::string& utf8) {
+        switch (c) {
+        case 'd': set = ByteSet::digits(); return true;
+        case 'D': set = ByteSet::digits(); set.negate(); return true;
+        case 'w': set = ByteSet::word(); return true;
+        case 'W': set = ByteSet::word(); set.negate(); return true;
+        case 's': set = ByteSet::space(); return true;
+        case 'S': set = ByteSet::space(); set.negate(); return true;
+        case 'n': set = literal('\n'); return true;
+        case 'r': set = literal('\r'); return true;
+        case 't': set = literal('\t'); return true;
+        case 'f': set = literal('\f'); return true;
+        case 'v': set = literal('\v'); return true;
+        case '0': set = literal('\0'); return true;
+        case 'c': {
+            if (at_end() || !std::isalpha(static_cast<unsigned char>(peek()))) throw Error("invalid control escape");
+            set = literal(static_cast<uint8_t>(peek() % 32));
+            ++pos_;
+            return true;
+        }
+        case 'x':
+            set = literal(static_cast<uint8_t>(parse_hex(2)));
+            return true;
+        case 'u': {
+            unsigned cp = parse_hex(4);
+            if (cp < 0x80) {
+                set = literal(static_cast<uint8_t>(cp));
+                return true;
+            }
+            // Non-ASCII code point: matched as its UTF-8 byte sequence
+            if (cp < 0x800) {
+                utf8 += static_cast<char>(0xC0 | (cp >> 6));
+            } else {
+                utf8 += static_cast<char>(0xE0 | (cp >> 12));
+                utf8 += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            }
+            utf8 += static_cast<char>(0x80 | (cp & 0x3F));
+            return false;
+        }
+        default:
+            if (std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                if (c >= '1' && c <= '9') throw Unsupported("backreference");
+                throw Error(std::string("invalid escape \\") + c);
+            }
+            set = literal(static_cast<uint8_t>(c));
+            return true;
+        }
+    }
+
+    std::unique_ptr<Node> parse_escape() {
+        if (at_end()) throw Error("trailing backslash");
+        char c = peek();
+        ++pos_;
+        if (c == 'b') return make_assert(AssertKind::WordBoundary);
+        if (c == 'B') return make_assert(AssertKind::NotWordBoundary);
+
+        ByteSet set;
+        std::string utf8;
+        if (parse_common_escape(c, set, utf8)) return Node::byte_set(set);
+
+        auto concat = Node::make(Node::Kind::Concat);
+        for (char byte : utf8) concat->children.push_back(Node::byte_set(literal(static_cast<uint8_t>(byte))));
+        return concat;
+    }
+
+    // Parse one class member; returns true if it is a single byte (usable in a range)
+    bool parse_class_atom(ByteSet& set, uint8_t& single) {
+        char c = peek();
+        ++pos_;
+        if (c != '\\') {
+            single = static_cast<uint8_t>(c);
+            set = ByteSet();
+            set.add(single);
+            return true;
+        }
+
+        if (at_end()) throw Error("trailing backslash");
+        char e = peek();
+        ++pos_;
+        if (e == 'b') {
+            single = '\b';
+            set = ByteSet();
+            set.add(single);
+            return true;
+        }
+        if (e == '-') {
+            single = '-';
+            set = ByteSet();
+            set.add(single);
+            return true;
+        }
+
+        std::string utf8;
+        bool saved_icase = icase_;
+        icase_ = false;  // Case folding is applied to the whole class
+        bool is_set = parse_common_escape(e, set, utf8);
+        icase_ = saved_icase;
+        if (!is_set) throw Unsupported("non-ASCII \\u escape in character class");
+        if (set.count() == 1) {
+            for (unsigned b = 0; b < 256; ++b) {
+                if (set.test(static_cast<uint8_t>(b))) single = static_cast<uint8_t>(b);
+            }
+            return std::string("dDwWsS").find(e) == std::string::npos;
+        }
+        return false;
+    }
+
+    ByteSet parse_class() {
+        ByteSet result;
+        bool negated = consume('^');
+
+        while (true) {
+            if (at_end()) throw Error("missing ]");
+            if (peek() == ']') {
+                ++pos_;
+                break;
+            }
+
+            ByteSet item;
+            uint8_t lo = 0;
+            bool is_single = parse_class_atom(item, lo);
+
+            if (is_single && !at_end() && peek() == '-' && pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] != ']') {
+                ++pos_;  // '-'
+                ByteSet hi_item;
+                uint8_t hi = 0;
+                if (!parse_class_atom(hi_item, hi)) throw Error("invalid range in character class");
+                if (hi < lo) throw Error("invalid range in character class");
+                result.add_range(lo, hi);
+            } else {
+                result.add(item);
+            }
+        }
+
+        if (icase_) result.fold_case();
+        if (negated) result.negate();
+        return result;
+    }
+
+public:
+    Parser(std::string_view pattern, bool icase) : pattern_(pattern), icase_(icase) {}
+
+    std::unique_ptr<Node> parse() {
+        auto root = parse_alternation();
+        if (!at_end()) throw Error("unmatched )");
+        return root;
+    }
+
+    int capture_count() const { return captures_; }
+};
+
+// ============================================================================
+// Program (Thompson NFA)
+// ============================================================================
+
+enum class Op : uint8_t {
+    Byte,    // consume one byte in sets[arg]
+    Split,   // fork: x (preferred), y
+    Jmp,     // goto x
+    Save,    // record position in slot arg
+    Assert,  // zero-width assertion
+    Match
+};
+
+struct Inst {
+    Op op;
+    AssertKind assertion = AssertKind::LineStart;
+    int x = 0;
+    int y = 0;
+    int arg = 0;
+};
+
+// Rough frequency rank of a byte in text (higher = more common), used to pick
+// the byte a literal search hands to memchr
+inline int byte_rank(uint8_t b) {
+    if (b == ' ') return 255;
+    if (b >= 'a' && b <= 'z') return std::strchr("etaoinsrhldcu", b) ? 240 : 200;
+    if (b >= '0' && b <= '9') return 190;
+    if (b >= 'A' && b <= 'Z') return 150;
+    if (b == '=' || b == ':' || b == '/' || b == '-' || b == '.' || b == ',' || b == '_') return 140;
+    if (b < 0x20 || b >= 0x80) return 20;
+    return 80;
+}
+
+// Byte string searched with memchr on its rarest byte plus memcmp
+class Literal {
+private:
+    std::string bytes_;
+    size_t rare_ = 0;  // Index of the byte memchr looks for
+
+public:
+    Literal() = default;
+
+    explicit Literal(std::string bytes) : bytes_(std::move(bytes)) {
+        for (size_t i = 1; i < bytes_.size(); ++i) {
+            if (byte_rank(static_cast<uint8_t>(bytes_[i])) < byte_rank(static_cast<uint8_t>(bytes_[rare_]))) {
+                rare_ = i;
+            }
+        }
+    }
+
+    bool empty() const { return bytes_.empty(); }
+    size_t size() const { return bytes_.size(); }
+    const std::string& bytes() const { return bytes_; }
+
+    // First occurrence at or after pos, or std::string_view::npos
+    size_t find(std::string_view text, size_t pos) const {
+        const size_t n = bytes_.size();
+        if (n == 0) return pos <= text.size() ? pos : std::string_view::npos;
+        const char rare = bytes_[rare_];
+        size_t scan = pos + rare_;
+        while (scan + n - rare_ <= text.size()) {
+            const void* hit = std::memchr(text.data() + scan, rare, text.size() - scan - (n - rare_ - 1));
+            if (!hit) break;
+            size_t at = static_cast<size_t>(static_cast<const char*>(hit) - text.data()) - rare_;
+            if (std::memcmp(text.data() + at, bytes_.data(), n) == 0) return at;
+            scan = at + rare_ + 1;
+        }
+        return std::string_view::npos;
+    }
+};
+
+struct Program {
+    std::vector<Inst> insts;
+    std::vector<ByteSet> sets;
+    int start = 0;
+    int capture_count = 0;       // excluding group 0
+    bool has_word_boundary = false;
+    bool anchored_start = false; // pattern begins with ^
+
+    // Bytes that can begin a match; only meaningful when has_first_bytes
+    // (false if the pattern can match the empty string)
+    ByteSet first_bytes;
+    bool has_first_bytes = false;
+
+    // Literal prefilters (see analyze_literals): every match begins with
+    // `prefix` and contains `required`; `literal` means the whole pattern is
+    // the byte string `required` with no captures or assertions.
+    Literal prefix;
+    Literal required;
+    bool literal = false;
+
+    size_t slot_count() const { return static_cast<size_t>(capture_count + 1) * 2; }
+
+    // First position >= pos where a match could begin, or text.size()
+    size_t skip_to_candidate(std::string_view text, size_t pos) const {
+        if (prefix.size() >= 2) {
+            size_t at = prefix.find(text, pos);
+            return at == std::string_view::npos ? text.size() : at;
+        }
+        if (first_bytes.count() == 1) {
+            uint8_t only = 0;
+            while (!first_bytes.test(only)) ++only;
+            const void* hit = pos < text.size() ? std::memchr(text.data() + pos, only, text.size() - pos) : nullptr;
+            return hit ? static_cast<size_t>(static_cast<const char*>(hit) - text.data()) : text.size();
+        }
+        while (pos < text.size() && !first_bytes.test(static_cast<uint8_t>(text[pos]))) ++pos;
+        return pos;
+    }
+};
+
+class Compiler {
+private:
+    static constexpr size_t kMaxInsts = 200000;
+
+    Program& prog_;
+
+    int emit(Inst inst) {
+        if (prog_.insts.size() >= kMaxInsts) throw Unsupported("pattern size (too many repetitions)");
+        prog_.insts.push_back(inst);
+        return static_cast<int>(prog_.insts.size() - 1);
+    }
+
+    int set_index(const ByteSet& set) {
+        for (size_t i = 0; i < prog_.sets.size(); ++i) {
+            if (prog_.sets[i] == set) return static_cast<int>(i);
+        }
+        prog_.sets.push_back(set);
+        return static_cast<int>(prog_.sets.size() - 1);
+    }
+
+    void compile(const Node& node) {
+        switch (node.kind) {
+        case Node::Kind::Empty:
+            break;
+        case Node::Kind::Set:
+            emit({Op::Byte, AssertKind::LineStart, 0, 0, set_index(node.set)});
+            break;
+        case Node::Kind::Concat:
+            for (const auto& child : node.children) compile(*child);
+            break;
+        case Node::Kind::Alternate: {
+            // split L1, next; L1: a; jmp end; next: split L2, ... ; last
+            std::vector<int> jumps;
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                if (i + 1 < node.children.size()) {
+                    int split = emit({Op::Split});
+                    prog_.insts[split].x = split + 1;
+                    compile(*node.children[i]);
+                    jumps.push_back(emit({Op::Jmp}));
+                    prog_.insts[split].y = static_cast<int>(prog_.insts.size());
+                } else {
+                    compile(*node.children[i]);
+                }
+            }
+            for (int j : jumps) prog_.insts[j].x = static_cast<int>(prog_.insts.size());
+            break;
+        }
+        case Node::Kind::Group:
+            if (node.capture >= 0) emit({Op::Save, AssertKind::LineStart, 0, 0, node.capture * 2});
+            compile(*node.children.front());
+            if (node.capture >= 0) emit({Op::Save, AssertKind::LineStart, 0, 0, node.capture * 2 + 1});
+            break;
+        case Node::Kind::Assert:
+            if (node.assertion == AssertKind::WordBoundary || node.assertion == AssertKind::NotWordBoundary) {
+                prog_.has_word_boundary = true;
+            }
+            emit({Op::Assert, node.assertion});
+            break;
+        case Node::Kind::Repeat:
+            compile_repeat(node);
+            break;
+        }
+    }
+
+    void compile_optional(const Node& child, bool greedy) {
+        int split = emit({Op::Split});
+        compile(child);
+        int after = static_cast<int>(prog_.insts.size());
+        prog_.insts[split].x = greedy ? split + 1 : after;
+        prog_.insts[split].y = greedy ? after : split + 1;
+    }
+
+    void compile_star(const Node& child, bool greedy) {
+        int split = emit({Op::Split});
+        compile(child);
+        emit({Op::Jmp, AssertKind::LineStart, split});
+        int after = static_cast<int>(prog_.insts.size());
+        prog_.insts[split].x = greedy ? split + 1 : after;
+        prog_.insts[split].y = greedy ? after : split + 1;
+    }
+
+    void compile_repeat(const Node& node) {
+        const Node& child = *node.children.front();
+
+        if (node.min == 0 && node.max == -1) {
+            compile_star(child, node.greedy);
+            return;
+        }
+        if (node.min == 1 && node.max == -1) {
+            int start = static_cast<int>(prog_.insts.size());
+            compile(child);
+            int split = emit({Op::Split});
+            int after = split + 1;
+            prog_.insts[split].x = node.greedy ? start : after;
+            prog_.insts[split].y = node.greedy ? after : start;
+            return;
+        }
+
+        for (int i = 0; i < node.min; ++i) compile(child);
+        if (node.max == -1) {
+            compile_star(child, node.greedy);
+        } else {
+            for (int i = node.min; i < node.max; ++i) compile_optional(child, node.greedy);
+        }
+    }
+
+public:
+    explicit Compiler(Program& prog) : prog_(prog) {}
+
+    void compile_root(const Node& root, int arm = 0) {
+        prog_.start = static_cast<int>(prog_.insts.size());
+        emit({Op::Save, AssertKind::LineStart, 0, 0, 0});
+        compile(root);
+        emit({Op::Save, AssertKind::LineStart, 0, 0, 1});
+        emit({Op::Match, AssertKind::LineStart, 0, 0, arm});
+    }
+
+    // Alternation of several patterns; each ends in a Match tagged with its index
+    void compile_set(const std::vector<std::unique_ptr<Node>>& roots) {
+        std::vector<int> splits;
+        std::vector<int> starts;
+        for (size_t i = 0; i + 1 < roots.size(); ++i) splits.push_back(emit({Op::Split}));
+        for (size_t i = 0; i < roots.size(); ++i) {
+            compile_root(*roots[i], static_cast<int>(i));
+            starts.push_back(prog_.start);
+        }
+        for (size_t i = 0; i < splits.size(); ++i) {
+            prog_.insts[splits[i]].x = starts[i];
+            prog_.insts[splits[i]].y = i + 1 < splits.size() ? splits[i + 1] : starts[i + 1];
+        }
+        prog_.start = roots.size() > 1 ? splits.front() : starts.front();
+    }
+};
+
+inline bool starts_anchored(const Node& node) {
+    switch (node.kind) {
+    case Node::Kind::Assert:
+        return node.assertion == AssertKind::LineStart;
+    case Node::Kind::Concat:
+        return !node.children.empty() && starts_anchored(*node.children.front());
+    case Node::Kind::Group:
+        return starts_anchored(*node.children.front());
+    case Node::Kind::Alternate:
+        for (const auto& child : node.children) {
+            if (!starts_anchored(*child)) return false;
+        }
+        return !node.children.empty();
+    default:
+        return false;
+    }
+}
+
+// Union of the byte sets reachable from start without consuming input.
+// Assertions only restrict matches, so following them keeps a safe superset.
+inline void compute_first_bytes(Program& prog) {
+    std::vector<bool> seen(prog.insts.size(), false);
+    std::vector<int> stack{prog.start};
+    ByteSet first;
+
+    while (!stack.empty()) {
+        int pc = stack.back();
+        stack.pop_back();
+        if (seen[pc]) continue;
+        seen[pc] = true;
+
+        const Inst& inst = prog.insts[pc];
+        switch (inst.op) {
+        case Op::Jmp:
+            stack.push_back(inst.x);
+            break;
+        case Op::Split:
+            stack.push_back(inst.x);
+            stack.push_back(inst.y);
+            break;
+        case Op::Save:
+        case Op::Assert:
+            stack.push_back(pc + 1);
+            break;
+        case Op::Byte:
+            first.add(prog.sets[inst.arg]);
+            break;
+        case Op::Match:
+            return;  // Nullable pattern: every position is a candidate
+        }
+    }
+
+    prog.first_bytes = first;
+    prog.has_first_bytes = true;
+}
+
+// Byte strings every match of a node must begin with, end with and contain.
+// `exact` means the node matches exactly `prefix` (== suffix == required).
+struct LiteralInfo {
+    bool exact = false;
+    std::string prefix;
+    std::string suffix;
+    std::string required;
+
+    static constexpr size_t kMaxLength = 256;
+
+    static LiteralInfo exactly(std::string bytes) {
+        LiteralInfo info;
+        info.exact = true;
+        info.prefix = bytes;
+        info.suffix = bytes;
+        info.required = std::move(bytes);
+        return info;
+    }
+
+    void keep_longest(const std::string& candidate) {
+        if (candidate.size() > required.size()) required = candidate;
+    }
+};
+
+inline LiteralInfo analyze_literals(const Node& node) {
+    switch (node.kind) {
+    case Node::Kind::Empty:
+    case Node::Kind::Assert:
+        return LiteralInfo::exactly("");
+    case Node::Kind::Set: {
+        if (node.set.count() != 1) return {};
+        uint8_t only = 0;
+        while (!node.set.test(only)) ++only;
+        return LiteralInfo::exactly(std::string(1, static_cast<char>(only)));
+    }
+    case Node::Kind::Group:
+        return analyze_literals(*node.children.front());
+    case Node::Kind::Concat: {
+        LiteralInfo acc = LiteralInfo::exactly("");
+        for (const auto& child : node.children) {
+            LiteralInfo next = analyze_literals(*child);
+            if (acc.exact && next.exact && acc.prefix.size() + next.prefix.size() <= LiteralInfo::kMaxLength) {
+                acc = LiteralInfo::exactly(acc.prefix + next.prefix);
+                continue;
+            }
+            LiteralInfo joined;
+            joined.prefix = acc.exact ? acc.prefix + next.prefix : acc.prefix;
+            joined.suffix = next.exact ? acc.suffix + next.prefix : next.suffix;
+            joined.required = acc.required;
+            joined.keep_longest(next.required);
+            joined.keep_longest(acc.suffix + next.prefix);  // Adjacent, so contiguous
+            joined.keep_longest(joined.prefix);
+            joined.keep_longest(joined.suffix);
+            acc = std::move(joined);
+        }
+        return acc;
+    }
+    case Node::Kind::Repeat: {
+        if (node.min == 0) return {};
+        LiteralInfo child = analyze_literals(*node.children.front());
+        if (child.exact && child.prefix.size() * static_cast<size_t>(node.min) <= LiteralInfo::kMaxLength) {
+            std::string repeated;
+            for (int i = 0; i < node.min; ++i) repeated += child.prefix;
+            if (node.max == node.min) return LiteralInfo::exactly(repeated);
+            LiteralInfo info;
+            info.prefix = repeated;
+            info.suffix = repeated;
+            info.required = std::move(repeated);
+            return info;
+        }
+        child.exact = false;
+        return child;
+    }
+    case Node::Kind::Alternate: {
+        LiteralInfo info;
+        bool first = true;
+        bool same = true;
+        for (const auto& child : node.children) {
+            LiteralInfo branch = analyze_literals(*child);
+            if (first) {
+                info = std::move(branch);
+                first = false;
+                continue;
+            }
+            same = same && info.exact && branch.exact && info.prefix == branch.prefix;
+            size_t p = 0;
+            while (p < info.prefix.size() && p < branch.prefix.size() && info.prefix[p] == branch.prefix[p]) ++p;
+            info.prefix.resize(p);
+            size_t s = 0;
+            while (s < info.suffix.size() && s < branch.suffix.size() &&
+                   info.suffix[info.suffix.size() - 1 - s] == branch.suffix[branch.suffix.size() - 1 - s]) {
+                ++s;
+            }
+            info.suffix.erase(0, info.suffix.size() - s);
+        }
+        if (same && info.exact) return info;
+        info.exact = false;
+        info.required.clear();
+        info.keep_longest(info.prefix);
+        info.keep_longest(info.suffix);
+        return info;
+    }
+    }
+    return {};
+}
+
+// Fill the program's literal prefilters from the pattern's AST
+inline void compute_literals(Program& prog, const Node& root) {
+    LiteralInfo info = analyze_literals(root);
+    prog.prefix = Literal(info.prefix);
+    prog.required = Literal(info.required);
+
+    bool has_assert = false;
+    for (const auto& inst : prog.insts) has_assert = has_assert || inst.op == Op::Assert;
+    prog.literal = info.exact && !info.required.empty() && prog.capture_count == 0 && !has_assert;
+}
+
+// A pattern and its case-insensitivity flag, as a member of a regex set
+struct SetPattern {
+    std::string_view pattern;
+    bool icase;
+};
+
+// Compile several patterns into one program whose Match instructions carry
+// the pattern index. Captures are not tracked. Throws Error or Unsupported.
+inline std::shared_ptr<const Program> compile_set(const std::vector<SetPattern>& patterns) {
+    if (patterns.empty()) throw Error("empty regex set");
+
+    std::vector<std::unique_ptr<Node>> roots;
+    bool anchored = true;
+    for (const auto& member : patterns) {
+        roots.push_back(Parser(member.pattern, member.icase).parse());
+        anchored = anchored && starts_anchored(*roots.back());
+    }
+
+    auto prog = std::make_shared<Program>();
+    prog->anchored_start = anchored;
+    Compiler(*prog).compile_set(roots);
+    compute_first_bytes(*prog);
+    return prog;
+}
+
+// Parse and compile a pattern. Throws Error or Unsupported.
+inline std::shared_ptr<const Program> compile(std::string_view pattern, bool icase) {
+    Parser parser(pattern, icase);
+    auto root = parser.parse();
+
+    auto prog = std::make_shared<Program>();
+    prog->capture_count = parser.capture_count();
+    prog->anchored_start = starts_anchored(*root);
+    Compiler(*prog).compile_root(*root);
+    compute_first_bytes(*prog);
+    compute_literals(*prog, *root);
+    return prog;
+}
+
+// ============================================================================
+// Sparse set of instruction indices (O(1) insert/contains/clear)
+// ============================================================================
+
+class SparseSet {
+private:
+    std::vector<int> dense_;
+    std::vector<int> sparse_;
+    size_t size_ = 0;
+
+public:
+    void resize(size_t capacity) {
+        dense_.assign(capacity, 0);
+        sparse_.assign(capacity, 0);
+        size_ = 0;
+    }
+
+    bool contains(int value) const {
+        int i = sparse_[value];
+        return static_cast<size_t>(i) < size_ && dense_[i] == value;
+    }
+
+    void insert(int value) {
+        sparse_[value] = static_cast<int>(size_);
+        dense_[size_++] = value;
+    }
+
+    void clear() { size_ = 0; }
+    size_t size() const { return size_; }
+    int operator[](size_t i) const { return dense_[i]; }
+};
+
+inline bool assertion_holds(AssertKind kind, std::string_view text, size_t pos) {
+    switch (kind) {
+    case AssertKind::LineStart:
+        return pos == 0;
+    case AssertKind::LineEnd:
+        return pos == text.size();
+    case AssertKind::WordBoundary:
+    case AssertKind::NotWordBoundary: {
+        bool before = pos > 0 && is_word_byte(static_cast<uint8_t>(text[pos - 1]));
+        bool after = pos < text.size() && is_word_byte(static_cast<uint8_t>(text[pos]));
+        return (before != after) == (kind == AssertKind::WordBoundary);
+    }
+    }
+    return false;
+}
+
+// ============================================================================
+// PikeVM - NFA simulation with captures, leftmost-first semantics
+// ============================================================================
+
+class PikeVM {
+private:
+    struct ThreadList {
+        SparseSet set;
+        std::vector<size_t> slots;  // slot_count entries per instruction
+    };
+
+    struct Frame {
+        int pc;
+        int restore_slot;  // >= 0: restore slots[restore_slot] = value
+        size_t value;
+    };
+
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    const Program* prog_ = nullptr;
+    size_t nslots_ = 0;
+    ThreadList lists_[2];
+    std::vector<Frame> stack_;
+    std::vector<size_t> scratch_;
+
+    void add_thread(ThreadList& list, int pc0, std::string_view text, size_t pos) {
+        stack_.push_back({pc0, -1, 0});
+        while (!stack_.empty()) {
+            Frame frame = stack_.back();
+            stack_.pop_back();
+
+            if (frame.restore_slot >= 0) {
+                scratch_[frame.restore_slot] = frame.value;
+                continue;
+            }
+
+            int pc = frame.pc;
+            if (list.set.contains(pc)) continue;
+            list.set.insert(pc);
+
+            const Inst& inst = prog_->insts[pc];
+            switch (inst.op) {
+            case Op::Jmp:
+                stack_.push_back({inst.x, -1, 0});
+                break;
+            case Op::Split:
+                stack_.push_back({inst.y, -1, 0});
+                stack_.push_back({inst.x, -1, 0});
+                break;
+            case Op::Save:
+                if (static_cast<size_t>(inst.arg) < nslots_) {
+                    stack_.push_back({0, inst.arg, scratch_[inst.arg]});
+                    scratch_[inst.arg] = pos;
+                }
+                stack_.push_back({pc + 1, -1, 0});
+                break;
+            case Op::Assert:
+                if (assertion_holds(inst.assertion, text, pos)) stack_.push_back({pc + 1, -1, 0});
+                break;
+            case Op::Byte:
+            case Op::Match:
+                std::copy(scratch_.begin(), scratch_.end(), list.slots.begin() + static_cast<size_t>(pc) * nslots_);
+                break;
+            }
+        }
+    }
+
+public:
+    void reset(const Program& prog, size_t nslots) {
+        if (prog_ != &prog || nslots_ != nslots) {
+            prog_ = &prog;
+            nslots_ = nslots;
+            for (auto& list : lists_) {
+                list.set.resize(prog.insts.size());
+                list.slots.assign(prog.insts.size() * nslots, kNone);
+            }
+            scratch_.assign(nslots, kNone);
+        }
+    }
+
+    // Search text[start..] for the leftmost-first match. On success fills
+    // slots (nslots entries, kNone for unset groups) and returns true.
+    // With `earliest`, returns as soon as any match is known to exist; with
+    // `not_empty`, empty matches are skipped.
+    bool search(const Program& prog, std::string_view text, size_t start, bool anchored,
+                std::vector<size_t>& slots, size_t nslots, bool earliest = false, bool not_empty = false) {
+        reset(prog, nslots);
+        ThreadList* clist = &lists_[0];
+        ThreadList* nlist = &lists_[1];
+        clist->set.clear();
+        nlist->set.clear();
+
+        bool matched = false;
+        anchored = anchored || prog.anchored_start;
+
+        bool skip = !anchored && prog.has_first_bytes;
+
+        for (size_t pos = start;; ++pos) {
+            if (skip && !matched && clist->set.size() == 0) {
+                pos = prog.skip_to_candidate(text, pos);
+                if (pos >= text.size()) break;
+            }
+            if (!matched && (!anchored || pos == start)) {
+                std::fill(scratch_.begin(), scratch_.end(), kNone);
+                add_thread(*clist, prog.start, text, pos);
+            }
+            if (clist->set.size() == 0) break;
+
+            uint8_t byte = pos < text.size() ? static_cast<uint8_t>(text[pos]) : 0;
+            for (size_t i = 0; i < clist->set.size(); ++i) {
+                int pc = clist->set[i];
+                const Inst& inst = prog.insts[pc];
+                const size_t* thread_slots = clist->slots.data() + static_cast<size_t>(pc) * nslots_;
+
+                if (inst.op == Op::Match) {
+                    if (not_empty && thread_slots[1] == thread_slots[0]) continue;
+                    std::copy(thread_slots, thread_slots + nslots_, slots.begin());
+                    matched = true;
+                    if (earliest) return true;
+                    break;  // Lower-priority threads are cut off
+                }
+                if (inst.op == Op::Byte && pos < text.size() && prog.sets[inst.arg].test(byte)) {
+                    std::copy(thread_slots, thread_slots + nslots_, scratch_.begin());
+                    add_thread(*nlist, pc + 1, text, pos + 1);
+                }
+            }
+
+            std::swap(clist, nlist);
+            nlist->set.clear();
+            if (pos >= text.size()) break;
+        }
+        return matched;
+    }
+
+    // Lowest-numbered arm of a set program matching anywhere in text, or -1.
+    // All threads run to completion: arm order, not thread priority, decides.
+    int search_set(const Program& prog, std::string_view text) {
+        reset(prog, 0);
+        ThreadList* clist = &lists_[0];
+        ThreadList* nlist = &lists_[1];
+        clist->set.clear();
+        nlist->set.clear();
+
+        int best = -1;
+        for (size_t pos = 0;; ++pos) {
+            if (!prog.anchored_start || pos == 0) add_thread(*clist, prog.start, text, pos);
+
+            uint8_t byte = pos < text.size() ? static_cast<uint8_t>(text[pos]) : 0;
+            for (size_t i = 0; i < clist->set.size(); ++i) {
+                int pc = clist->set[i];
+                const Inst& inst = prog.insts[pc];
+                if (inst.op == Op::Match) {
+                    if (best < 0 || inst.arg < best) best = inst.arg;
+                } else if (inst.op == Op::Byte && pos < text.size() && prog.sets[inst.arg].test(byte)) {
+                    add_thread(*nlist, pc + 1, text, pos + 1);
+                }
+            }
+            if (best == 0) break;
+
+            std::swap(clist, nlist);
+            nlist->set.clear();
+            if (pos >= text.size() || (prog.anchored_start && clist->set.size() == 0)) break;
+        }
+        return best;
+    }
+};
+
+// ============================================================================
+// Bounded backtracker - depth-first NFA walk with a (pc, position) visited
+// bitmap, so each pair is explored at most once. Same results as the PikeVM
+// but much cheaper on short inputs; used when the bitmap stays small.
+// ============================================================================
+
+class BoundedBacktracker {
+private:
+    struct Job {
+        int pc;
+        int restore_slot;  // >= 0: restore slots_[restore_slot] = pos
+        size_t pos;
+    };
+
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    std::vector<uint64_t> visited_;
+    std::vector<Job> jobs_;
+    std::vector<size_t> slots_;
+    size_t base_ = 0;    // text position of visited_ column 0
+    size_t width_ = 0;   // positions per instruction row
+
+    bool visit(int pc, size_t pos) {
+        size_t bit = static_cast<size_t>(pc) * width_ + (pos - base_);
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        uint64_t& word = visited_[bit >> 6];
+        if (word & mask) return false;
+        word |= mask;
+        return true;
+    }
+
+    bool run(const Program& prog, std::string_view text, size_t start, bool not_empty) {
+        jobs_.push_back({prog.start, -1, start});
+        while (!jobs_.empty()) {
+            Job job = jobs_.back();
+            jobs_.pop_back();
+            if (job.restore_slot >= 0) {
+                slots_[job.restore_slot] = job.pos;
+                continue;
+            }
+
+            int pc = job.pc;
+            size_t pos = job.pos;
+            while (visit(pc, pos)) {
+                const Inst& inst = prog.insts[pc];
+                bool advance = true;
+                switch (inst.op) {
+                case Op::Byte:
+                    if (pos < text.size() && prog.sets[inst.arg].test(static_cast<uint8_t>(text[pos]))) {
+                        ++pos;
+                    } else {
+                        advance = false;
+                    }
+                    break;
+                case Op::Split:
+                    jobs_.push_back({inst.y, -1, pos});
+                    pc = inst.x - 1;
+                    break;
+                case Op::Jmp:
+                    pc = inst.x - 1;
+                    break;
+                case Op::Save:
+                    if (static_cast<size_t>(inst.arg) < slots_.size()) {
+                        jobs_.push_back({0, inst.arg, slots_[inst.arg]});
+                        slots_[inst.arg] = pos;
+                    }
+                    break;
+                case Op::Assert:
+                    advance = assertion_holds(inst.assertion, text, pos);
+                    break;
+                case Op::Match:
+                    if (not_empty && pos == start) {
+                        advance = false;
+                        break;
+                    }
+                    jobs_.clear();
+                    return true;
+                }
+                if (!advance) break;
+                ++pc;
+            }
+        }
+        return false;
+    }
+
+public:
+    static constexpr size_t kMaxVisitedBits = 256 * 1024;
+
+    static bool fits(const Program& prog, size_t haystack) {
+        return (haystack + 1) * prog.insts.size() <= kMaxVisitedBits;
+    }
+
+    // Same contract as PikeVM::search (without `earliest`)
+    bool search(const Program& prog, std::string_view text, size_t start, bool anchored,
+                std::vector<size_t>& slots, bool not_empty = false) {
+        base_ = start;
+        width_ = text.size() - start + 1;
+        visited_.assign((width_ * prog.insts.size() + 63) / 64, 0);
+        anchored = anchored || prog.anchored_start;
+        bool skip = !anchored && prog.has_first_bytes;
+
+        for (size_t pos = start; pos <= text.size(); ++pos) {
+            if (skip) {
+                pos = prog.skip_to_candidate(text, pos);
+                if (pos >= text.size()) break;
+            }
+            slots_.assign(slots.size(), kNone);
+            if (run(prog, text, pos, not_empty)) {
+                std::copy(slots_.begin(), slots_.end(), slots.begin());
+                return true;
+            }
+            if (anchored) break;
+        }
+        return false;
+    }
+};
+
+// ============================================================================
+// Lazy DFA - answers "does the text contain a match?" without captures
+// ============================================================================
+
+class LazyDFA {
+private:
+    static constexpr int kUnknown = -1;
+    static constexpr size_t kMaxStates = 4096;
+
+    struct State {
+        std::vector<int> pcs;   // Byte, Match and pending $ instructions
+        int match_arm = -1;     // Lowest arm whose Match is in pcs, -1 if none
+        int eof_arm = -2;       // Lowest arm matching via pending $ at end of input; -2 unknown
+    };
+
+    const Program* prog_ = nullptr;
+    std::vector<State> states_;
+    std::vector<int32_t> trans_;  // states_.size() * 256
+    std::unordered_map<std::string, int> index_;
+    SparseSet seen_;
+    std::vector<int> stack_;
+    std::vector<int> unanchored_start_;  // closure of start at pos > 0
+    int start_state_ = kUnknown;
+
+    // Epsilon closure; $ asserts are kept as pending, ^ holds only at_start
+    void closure(std::vector<int>& out, int pc0, bool at_start, bool at_end) {
+        stack_.push_back(pc0);
+        while (!stack_.empty()) {
+            int pc = stack_.back();
+            stack_.pop_back();
+            if (seen_.contains(pc)) continue;
+            seen_.insert(pc);
+
+            const Inst& inst = prog_->insts[pc];
+            switch (inst.op) {
+            case Op::Jmp:
+                stack_.push_back(inst.x);
+                break;
+            case Op::Split:
+                stack_.push_back(inst.y);
+                stack_.push_back(inst.x);
+                break;
+            case Op::Save:
+                stack_.push_back(pc + 1);
+                break;
+            case Op::Assert:
+                if (inst.assertion == AssertKind::LineStart) {
+                    if (at_start) stack_.push_back(pc + 1);
+                } else if (inst.assertion == AssertKind::LineEnd) {
+                    if (at_end) {
+                        stack_.push_back(pc + 1);
+                    } else {
+                        out.push_back(pc);
+                    }
+                }
+                break;
+            case Op::Byte:
+            case Op::Match:
+                out.push_back(pc);
+                break;
+            }
+        }
+    }
+
+    int intern(std::vector<int>& pcs) {
+        std::sort(pcs.begin(), pcs.end());
+        pcs.erase(std::unique(pcs.begin(), pcs.end()), pcs.end());
+
+        std::string key(reinterpret_cast<const char*>(pcs.data()), pcs.size() * sizeof(int));
+        auto it = index_.find(key);
+        if (it != index_.end()) return it->second;
+
+        if (states_.size() >= kMaxStates) return kUnknown;
+
+        State state;
+        state.pcs = pcs;
+        state.match_arm = lowest_arm(pcs);
+        states_.push_back(std::move(state));
+        trans_.resize(states_.size() * 256, kUnknown);
+        int id = static_cast<int>(states_.size() - 1);
+        index_.emplace(std::move(key), id);
+        return id;
+    }
+
+    std::vector<int> step_pcs(const std::vector<int>& pcs, uint8_t byte, bool unanchored) {
+        std::vector<int> next;
+        seen_.clear();
+        for (int pc : pcs) {
+            const Inst& inst = prog_->insts[pc];
+            if (inst.op == Op::Byte && prog_->sets[inst.arg].test(byte)) {
+                closure(next, pc + 1, false, false);
+            }
+        }
+        if (unanchored) {
+            for (int pc : unanchored_start_) {
+                if (!seen_.contains(pc)) {
+                    seen_.insert(pc);
+                    next.push_back(pc);
+                }
+            }
+        }
+        return next;
+    }
+
+    int lowest_arm(const std::vector<int>& pcs) const {
+        int arm = -1;
+        for (int pc : pcs) {
+            const Inst& inst = prog_->insts[pc];
+            if (inst.op == Op::Match && (arm < 0 || inst.arg < arm)) arm = inst.arg;
+        }
+        return arm;
+    }
+
+    int eof_arm(State& state) {
+        if (state.eof_arm == -2) {
+            std::vector<int> out;
+            seen_.clear();
+            for (int pc : state.pcs) {
+                const Inst& inst = prog_->insts[pc];
+                if (inst.op == Op::Assert && inst.assertion == AssertKind::LineEnd) {
+                    closure(out, pc + 1, false, true);
+                }
+            }
+            state.eof_arm = lowest_arm(out);
+        }
+        return state.eof_arm;
+    }
+
+    static int better(int best, int arm) {
+        return arm >= 0 && (best < 0 || arm < best) ? arm : best;
+    }
+
+    // Scan text and return the lowest matching arm (-1 none, kThrashed if the
+    // cache thrashed). With first_only the scan stops at the first match of any arm.
+    int scan(const Program& prog, std::string_view text, bool first_only) {
+        if (prog_ != &prog) init(prog);
+
+        bool unanchored = !prog.anchored_start;
+        if (text.empty()) {
+            // Both ^ and $ hold; not worth a cached state
+            std::vector<int> pcs;
+            seen_.clear();
+            closure(pcs, prog.start, true, true);
+            return lowest_arm(pcs);
+        }
+        if (start_state_ == kUnknown) {
+            std::vector<int> pcs;
+            seen_.clear();
+            closure(pcs, prog.start, true, false);
+            start_state_ = intern(pcs);
+            if (start_state_ == kUnknown) return kThrashed;
+        }
+
+        int s = start_state_;
+        int best = states_[s].match_arm;
+        if (best == 0 || (first_only && best >= 0)) return best;
+
+        size_t flushes = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            uint8_t byte = static_cast<uint8_t>(text[i]);
+            int32_t next = trans_[static_cast<size_t>(s) * 256 + byte];
+            if (next == kUnknown) {
+                std::vector<int> pcs = step_pcs(states_[s].pcs, byte, unanchored);
+                next = intern(pcs);
+                if (next == kUnknown) {
+                    // Cache full: start over, keeping only the current set
+                    if (++flushes > 8) return kThrashed;
+                    flush();
+                    next = intern(pcs);
+                } else {
+                    trans_[static_cast<size_t>(s) * 256 + byte] = next;
+                }
+            }
+            s = next;
+            best = better(best, states_[s].match_arm);
+            if (best == 0 || (first_only && best >= 0)) return best;
+            if (states_[s].pcs.empty()) return best;  // Dead (anchored pattern failed)
+        }
+        return better(best, eof_arm(states_[s]));
+    }
+
+    void flush() {
+        states_.clear();
+        trans_.clear();
+        index_.clear();
+        start_state_ = kUnknown;
+    }
+
+    void init(const Program& prog) {
+        prog_ = &prog;
+        flush();
+        seen_.resize(prog.insts.size());
+        unanchored_start_.clear();
+        if (!prog.anchored_start) {
+            seen_.clear();
+            closure(unanchored_start_, prog.start, false, false);
+        }
+    }
+
+public:
+    static constexpr int kThrashed = -2;
+
+    // Returns 1 if text contains a match, 0 if not, -1 if the cache thrashed
+    // (caller should fall back to the PikeVM).
+    int search(const Program& prog, std::string_view text) {
+        int arm = scan(prog, text, true);
+        if (arm == kThrashed) return -1;
+        return arm >= 0 ? 1 : 0;
+    }
+
+    // Lowest-numbered arm of a set program matching anywhere in text,
+    // -1 if none, kThrashed if the cache thrashed
+    int search_set(const Program& prog, std::string_view text) {
+        return scan(prog, text, false);
+    }
+
+};
+
+// ============================================================================
+// Engine - compiled program plus a pool of per-search scratch space
+// ============================================================================
+
+struct Scratch {
+    PikeVM pike;
+    BoundedBacktracker backtrack;
+    LazyDFA dfa;
+    std::vector<size_t> slots;
+};
+
+class Engine {
+private:
+    std::shared_ptr<const Program> prog_;
+    mutable std::mutex pool_mutex_;
+    mutable std::vector<std::unique_ptr<Scratch>> pool_;
+
+    class ScratchGuard {
+    private:
+        const Engine& engine_;
+        std::unique_ptr<Scratch> scratch_;
+
+    public:
+        explicit ScratchGuard(const Engine& engine) : engine_(engine) {
+            std::lock_guard<std::mutex> lock(engine_.pool_mutex_);
+            if (!engine_.pool_.empty()) {
+                scratch_ = std::move(engine_.pool_.back());
+                engine_.pool_.pop_back();
+            }
+            if (!scratch_) scratch_ = std::make_unique<Scratch>();
+        }
+
+        ~ScratchGuard() {
+            std::lock_guard<std::mutex> lock(engine_.pool_mutex_);
+            engine_.pool_.push_back(std::move(scratch_));
+        }
+
+        Scratch& operator*() { return *scratch_; }
+        Scratch* operator->() { return scratch_.get(); }
+    };
+
+    // Prefilter: npos if no match can exist in text[start..], else a position
+    // to continue from (the first occurrence of the required literal for
+    // unanchored patterns). A ^-anchored pattern only needs its prefix at
+    // `start`, which is cheaper to check than searching for the literal.
+    size_t locate_required(std::string_view text, size_t start) const {
+        const Program& prog = *prog_;
+        if (prog.anchored_start) {
+            if (start != 0) return std::string_view::npos;
+            const std::string& prefix = prog.prefix.bytes();
+            if (!prefix.empty()) {
+                bool ok = text.size() >= prefix.size() && std::memcmp(text.data(), prefix.data(), prefix.size()) == 0;
+                return ok ? 0 : std::string_view::npos;
+            }
+        }
+        return prog.required.find(text, start);
+    }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit Engine(std::shared_ptr<const Program> prog) : prog_(std::move(prog)) {}
+
+    static std::shared_ptr<const Engine> create(std::string_view pattern, bool icase) {
+        return std::make_shared<const Engine>(compile(pattern, icase));
+    }
+
+    static std::shared_ptr<const Engine> create_set(const std::vector<SetPattern>& patterns) {
+        return std::make_shared<const Engine>(compile_set(patterns));
+    }
+
+    const Program& program() const { return *prog_; }
+    int capture_count() const { return prog_->capture_count; }
+
+    // Is there a match anywhere in text?
+    bool test(std::string_view text) const {
+        // Most texts lack the pattern's required literal: reject them with a
+        // memchr-driven search before touching the automata
+        if (!prog_->required.empty()) {
+            size_t at = locate_required(text, 0);
+            if (at == std::string_view::npos || prog_->literal) return at != std::string_view::npos;
+        }
+        ScratchGuard scratch(*this);
+        if (!prog_->has_word_boundary) {
+            int result = scratch->dfa.search(*prog_, text);
+            if (result >= 0) return result == 1;
+        }
+        scratch->slots.assign(prog_->slot_count(), npos);
+        return scratch->pike.search(*prog_, text, 0, false, scratch->slots, scratch->slots.size(), true);
+    }
+
+    // Next occurrence of the required literal at or after pos (pos itself when
+    // the pattern has none), or npos when text[pos..] cannot hold a match.
+    // Lets callers scanning many short records skip the ones that cannot match.
+    size_t next_candidate(std::string_view text, size_t pos) const {
+        if (prog_->required.empty()) return pos;
+        size_t at = prog_->required.find(text, pos);
+        return at == std::string_view::npos ? npos : at;
+    }
+
+    // For engines built with create_set: index of the lowest-numbered pattern
+    // matching anywhere in text (one pass over the text), or -1
+    int first_match(std::string_view text) const {
+        ScratchGuard scratch(*this);
+        if (!prog_->has_word_boundary) {
+            int arm = scratch->dfa.search_set(*prog_, text);
+            if (arm != LazyDFA::kThrashed) return arm;
+        }
+        return scratch->pike.search_set(*prog_, text);
+    }
+
+    // Leftmost-first match starting the search at `start`. Fills `slots` with
+    // (capture_count + 1) * 2 positions (npos for groups that did not participate).
+    // `anchored` requires the match to begin at `start`; `not_empty` rejects
+    // empty matches (used to step past an empty match like std::regex_iterator).
+    bool find(std::string_view text, size_t start, std::vector<size_t>& slots,
+              bool anchored = false, bool not_empty = false) const {
+        if (!prog_->required.empty()) {
+            size_t at = locate_required(text, start);
+            if (at == std::string_view::npos) return false;
+            if (prog_->literal) {
+                if (anchored && at != start) return false;
+                slots.assign(2, at);
+                slots[1] = at + prog_->required.size();
+                return true;
+            }
+        }
+        ScratchGuard scratch(*this);
+        if (start == 0 && !prog_->has_word_boundary && scratch->dfa.search(*prog_, text) == 0) {
+            return false;
+        }
+        slots.assign(prog_->slot_count(), npos);
+        if (BoundedBacktracker::fits(*prog_, text.size() - start)) {
+            return scratch->backtrack.search(*prog_, text, start, anchored, slots, not_empty);
+        }
+        return scratch->pike.search(*prog_, text, start, anchored, slots, slots.size(), false, not_empty);
+    }
+};
+
+} // namespace mlc::regex_engine
+
+#endif // MLC_REGEX_ENGINE_HPP
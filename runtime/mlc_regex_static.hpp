@@ -0,0 +1,324 @@
+#ifndef MLC_REGEX_STATIC_HPP
+#define MLC_REGEX_STATIC_HPP
+
+#include "mlc_regex.hpp"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Compile-time regex matchers (CTRE-style).
+//
+// The MLC compiler translates eligible regex literals into a type built from
+// the templates below, e.g. /user=(\d+)/ becomes
+//   mlc::ct::Regex<mlc::ct::Seq<mlc::ct::Lit<117,115,101,114,61>,
+//                  mlc::ct::Group<1, mlc::ct::Repeat<1, mlc::ct::kInf, mlc::ct::Class<mlc::ct::Range<48,57>>>>>, 1>
+// so the C++ compiler sees the whole matcher and can inline it: no pattern
+// parsing or automaton tables at runtime.
+//
+// Matching is continuation-passing backtracking over the pattern structure.
+// Repetitions are possessive; the compiler only emits a static matcher when
+// that is equivalent to ordinary backtracking (the repeated item cannot
+// start what follows it), and uses the runtime engine for everything else.
+
+namespace mlc::ct {
+
+inline constexpr size_t kInf = static_cast<size_t>(-1);
+
+// ============================================================================
+// Byte classes
+// ============================================================================
+
+template <unsigned char C>
+struct Ch {
+    static constexpr bool test(unsigned char c) { return c == C; }
+};
+
+template <unsigned char Lo, unsigned char Hi>
+struct Range {
+    static constexpr bool test(unsigned char c) { return c >= Lo && c <= Hi; }
+};
+
+template <typename... Items>
+struct Set {
+    static constexpr bool test(unsigned char c) { return (Items::test(c) || ...); }
+};
+
+template <typename... Items>
+struct NotSet {
+    static constexpr bool test(unsigned char c) { return !(Items::test(c) || ...); }
+};
+
+// ============================================================================
+// Match state
+// ============================================================================
+
+template <size_t Groups>
+struct Context {
+    const char* text;
+    size_t size;
+    std::array<size_t, (Groups + 1) * 2> slots;
+
+    unsigned char at(size_t pos) const { return static_cast<unsigned char>(text[pos]); }
+
+    bool is_word(size_t pos) const {
+        unsigned char c = at(pos);
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+};
+
+// ============================================================================
+// Pattern nodes
+// Each node provides
+//   template <typename Ctx, typename Cont> static bool match(Ctx&, size_t pos, Cont&& k)
+// which matches the node at pos and calls k(end) for each way it can match,
+// stopping at the first k that returns true.
+// ============================================================================
+
+// One byte from a class
+template <typename Cls>
+struct Class {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        return pos < ctx.size && Cls::test(ctx.at(pos)) && k(pos + 1);
+    }
+};
+
+// Literal byte string
+template <unsigned char... Cs>
+struct Lit {
+    static constexpr unsigned char chars[] = {Cs...};
+    static constexpr size_t length = sizeof...(Cs);
+
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        return ctx.size - pos >= length && std::memcmp(ctx.text + pos, chars, length) == 0 && k(pos + length);
+    }
+};
+
+template <typename... Nodes>
+struct Seq;
+
+template <>
+struct Seq<> {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx&, size_t pos, Cont&& k) {
+        return k(pos);
+    }
+};
+
+template <typename Head, typename... Tail>
+struct Seq<Head, Tail...> {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        return Head::match(ctx, pos, [&](size_t next) { return Seq<Tail...>::match(ctx, next, k); });
+    }
+};
+
+// Ordered alternation: earlier alternatives are preferred
+template <typename... Nodes>
+struct Alt {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        return (Nodes::match(ctx, pos, k) || ...);
+    }
+};
+
+// Possessive repetition between Min and Max times (Max = kInf for unbounded)
+template <size_t Min, size_t Max, typename Node>
+struct Repeat {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        size_t count = 0;
+        while (count < Max) {
+            size_t next = pos;
+            if (!Node::match(ctx, pos, [&](size_t end) {
+                    next = end;
+                    return true;
+                }) || next == pos) {
+                break;
+            }
+            pos = next;
+            ++count;
+        }
+        return count >= Min && k(pos);
+    }
+};
+
+// Tight loop for the common case of a repeated byte class
+template <size_t Min, size_t Max, typename Cls>
+struct Repeat<Min, Max, Class<Cls>> {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        size_t limit = Max == kInf || ctx.size - pos < Max ? ctx.size : pos + Max;
+        size_t end = pos;
+        while (end < limit && Cls::test(ctx.at(end))) ++end;
+        return end - pos >= Min && k(end);
+    }
+};
+
+// Capture group N (N >= 1)
+template <size_t N, typename Node>
+struct Group {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        return Node::match(ctx, pos, [&](size_t end) {
+            size_t old_start = ctx.slots[N * 2];
+            size_t old_end = ctx.slots[N * 2 + 1];
+            ctx.slots[N * 2] = pos;
+            ctx.slots[N * 2 + 1] = end;
+            if (k(end)) return true;
+            ctx.slots[N * 2] = old_start;
+            ctx.slots[N * 2 + 1] = old_end;
+            return false;
+        });
+    }
+};
+
+struct LineStart {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx&, size_t pos, Cont&& k) {
+        return pos == 0 && k(pos);
+    }
+};
+
+struct LineEnd {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        return pos == ctx.size && k(pos);
+    }
+};
+
+template <bool Expected>
+struct WordBoundaryIs {
+    template <typename Ctx, typename Cont>
+    static bool match(Ctx& ctx, size_t pos, Cont&& k) {
+        bool before = pos > 0 && ctx.is_word(pos - 1);
+        bool after = pos < ctx.size && ctx.is_word(pos);
+        return (before != after) == Expected && k(pos);
+    }
+};
+
+using WordBoundary = WordBoundaryIs<true>;
+using NotWordBoundary = WordBoundaryIs<false>;
+
+// ============================================================================
+// Static analysis: bytes that can start a match (for skipping start positions)
+// ============================================================================
+
+template <typename Node>
+struct First {
+    static constexpr bool known = false;
+    static constexpr bool test(unsigned char) { return true; }
+};
+
+template <typename Cls>
+struct First<Class<Cls>> {
+    static constexpr bool known = true;
+    static constexpr bool test(unsigned char c) { return Cls::test(c); }
+};
+
+template <unsigned char C, unsigned char... Cs>
+struct First<Lit<C, Cs...>> {
+    static constexpr bool known = true;
+    static constexpr bool test(unsigned char c) { return c == C; }
+};
+
+template <typename Head, typename... Tail>
+struct First<Seq<Head, Tail...>> : First<Head> {};
+
+template <size_t N, typename Node>
+struct First<Group<N, Node>> : First<Node> {};
+
+template <size_t Max, typename Node>
+struct First<Repeat<0, Max, Node>> {
+    static constexpr bool known = false;
+    static constexpr bool test(unsigned char) { return true; }
+};
+
+template <size_t Min, size_t Max, typename Node>
+struct First<Repeat<Min, Max, Node>> : First<Node> {};
+
+template <typename... Nodes>
+struct First<Alt<Nodes...>> {
+    static constexpr bool known = (First<Nodes>::known && ...);
+    static constexpr bool test(unsigned char c) { return (First<Nodes>::test(c) || ...); }
+};
+
+template <typename Node>
+struct Anchored {
+    static constexpr bool value = false;
+};
+
+template <>
+struct Anchored<LineStart> {
+    static constexpr bool value = true;
+};
+
+template <typename Head, typename... Tail>
+struct Anchored<Seq<Head, Tail...>> : Anchored<Head> {};
+
+template <size_t N, typename Node>
+struct Anchored<Group<N, Node>> : Anchored<Node> {};
+
+// ============================================================================
+// Regex - compile-time pattern with the mlc::Regex query surface
+// ============================================================================
+
+template <typename Pattern, size_t Groups>
+class Regex {
+private:
+    using Ctx = Context<Groups>;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Leftmost match at or after start; fills ctx.slots
+    static bool find(Ctx& ctx, size_t start) {
+        for (size_t pos = start; pos <= ctx.size; ++pos) {
+            if constexpr (First<Pattern>::known) {
+                while (pos < ctx.size && !First<Pattern>::test(ctx.at(pos))) ++pos;
+                if (pos == ctx.size) return false;
+            }
+            ctx.slots.fill(npos);
+            if (Pattern::match(ctx, pos, [&](size_t end) {
+                    ctx.slots[0] = pos;
+                    ctx.slots[1] = end;
+                    return true;
+                })) {
+                return true;
+            }
+            if constexpr (Anchored<Pattern>::value) break;
+        }
+        return false;
+    }
+
+    static Ctx context(const std::string& text) { return Ctx{text.data(), text.size(), {}}; }
+
+public:
+    constexpr Regex() = default;
+
+    static constexpr size_t group_count() { return Groups; }
+
+    bool test(const String& text) const {
+        Ctx ctx = context(text.as_std_string());
+        return find(ctx, 0);
+    }
+
+    std::optional<Match> match(const String& text) const {
+        const std::string& str = text.as_std_string();
+        Ctx ctx = context(str);
+        if (!find(ctx, 0)) return std::nullopt;
+        return Match(str, ctx.slots.data(), ctx.slots.size());
+    }
+
+    std::optional<Match> match(String&& text) const {
+        Ctx ctx = context(text.as_std_string());
+        if (!find(ctx, 0)) return std::nullopt;
+        return Match(std::make_shared<const std::string>(text.as_std_string()), ctx.slots.data(), ctx.slots.size());
+    }
+};
+
+} // namespace mlc::ct
+
+#endif // MLC_REGEX_STATIC_HPP
@@ -33,6 +33,7 @@ public:
     String(const char* str) : data_(str) {}
     String(const std::string& str) : data_(str) {}
     String(std::string&& str) : data_(std::move(str)) {}
+    explicit String(std::string_view str) : data_(str) {}
 
     // Copy/Move
     String(const String&) = default;
@@ -53,6 +53,58 @@ class AuroraCLITest < Minitest::Test
     end
   end
 
+  def test_program_iterates_stdin_lines
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "lines.mlc")
+      File.write(source, <<~AUR)
+        import { stdin_lines } from "IO"
+
+        fn main() -> i32 = do
+          let header = read_line();
+          for line in stdin_lines() do
+            println(header + ":" + line)
+          end;
+          0
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "n\nfirst\n\nlast")
+
+      assert(status.success?, "Expected execution success, stderr: #{stderr}")
+      assert_equal "n:first\nn:\nn:last\n", stdout
+    end
+  end
+
+  def test_program_uses_stdin_lines_as_array
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "lines_array.mlc")
+      File.write(source, <<~AUR)
+        import { stdin_lines } from "IO"
+
+        fn count_lines(xs: str[]) -> i32 = xs.length()
+
+        fn main() -> i32 = do
+          let all = stdin_lines();
+          println(to_string(all.length()));
+          println(to_string(count_lines(all)));
+          for line in all.map(x => x + "!") do
+            println(line)
+          end;
+          0
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "a\n\nb")
+
+      assert(status.success?, "Expected execution success, stderr: #{stderr}")
+      assert_equal "3\n3\na!\n!\nb!\n", stdout
+    end
+  end
+
   def test_emit_cpp
     source = <<~AUR
       fn main() -> i32 = 0
@@ -187,6 +239,528 @@ class AuroraCLITest < Minitest::Test
     end
   end
 
+  def test_regex_match_arms
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "classify.mlc")
+      File.write(source, <<~AUR)
+        fn classify(line: str) -> i32 =
+          match line
+            | /^ERROR (\\w+) code=\\d{3}$/ => 1
+            | /warn|notice/i => 2
+            | _ => 0
+
+        fn main() -> i32 = do
+          let a = classify(read_line())
+          let b = classify(read_line())
+          let c = classify(read_line())
+          a * 100 + b * 10 + c
+        end
+      AUR
+
+      input = "ERROR disk code=500\nWARN slow\nERROR disk code=5000\n"
+      [[], ["--static-regex"]].each do |flags|
+        _stdout, stderr, status = Open3.capture3(CLI, *flags, source, stdin_data: input)
+
+        assert_equal 120, status.exitstatus, "Unexpected exit code #{flags.inspect}, stderr: #{stderr}"
+      end
+    end
+  end
+
+  def test_regex_scan_file
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      log = File.join(dir, "app.log")
+      File.write(log, "INFO a\nERROR 1\nWARN\nERROR x\nERROR 22")
+
+      source = File.join(dir, "scan.mlc")
+      File.write(source, <<~AUR)
+        import { regex_scan_file, regex_scan_offsets } from "File"
+
+        fn main() -> i32 = do
+          let path = read_line()
+          let lines = regex_scan_file(path, /ERROR \\d+/, 2)
+          let offsets = regex_scan_offsets(path, /ERROR/, 0)
+          lines.length() * 10 + offsets.length()
+        end
+      AUR
+
+      _stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "#{log}\n")
+
+      assert_equal 23, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+    end
+  end
+
+  def test_file_lines_strips_crlf
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      data = File.join(dir, "data.txt")
+      File.write(data, "ab\r\ncde\n\nf")
+
+      source = File.join(dir, "lines.mlc")
+      File.write(source, <<~AUR)
+        import { lines } from "File"
+
+        fn main() -> i32 = do
+          let path = read_line();
+          let mut total = 0;
+          let mut count = 0;
+          for line in lines(path) do
+            total = total + line.length();
+            count = count + 1
+          end;
+          total * 10 + count
+        end
+      AUR
+
+      _stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "#{data}\n")
+
+      assert_equal 64, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+    end
+  end
+
+  def test_file_lines_used_as_array
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      data = File.join(dir, "data.txt")
+      File.write(data, "ab\r\ncde\n\nf")
+
+      source = File.join(dir, "lines_array.mlc")
+      File.write(source, <<~AUR)
+        import { lines } from "File"
+
+        fn count_lines(xs: str[]) -> i32 = xs.length()
+
+        fn main() -> i32 = do
+          let all = lines(read_line());
+          println(to_string(all.length()));
+          println(to_string(count_lines(all)));
+          for line in all.map(x => "[" + x + "]") do
+            println(line)
+          end;
+          0
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "#{data}\n")
+
+      assert(status.success?, "Expected execution success, stderr: #{stderr}")
+      assert_equal "4\n4\n[ab]\n[cde]\n[]\n[f]\n", stdout
+    end
+  end
+
+  def test_file_chunks_and_records
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      data = File.join(dir, "data.txt")
+      File.write(data, "alpha;beta;;gamma-delta;x")
+
+      source = File.join(dir, "records.mlc")
+      File.write(source, <<~AUR)
+        import { chunks, records } from "File"
+
+        fn main() -> i32 = do
+          let path = read_line();
+          let mut pieces = 0;
+          for chunk in chunks(path, 4) do
+            pieces = pieces + 1
+          end;
+          let mut longest = 0;
+          for record in records(path, ";") do
+            longest = if record.length() > longest then record.length() else longest
+          end;
+          pieces * 10 + longest
+        end
+      AUR
+
+      _stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "#{data}\n")
+
+      assert_equal 81, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+    end
+  end
+
+  def test_file_chunks_and_records_used_as_arrays
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      data = File.join(dir, "data.txt")
+      File.write(data, "alpha;beta;;gamma-delta;x")
+
+      source = File.join(dir, "records_array.mlc")
+      File.write(source, <<~AUR)
+        import { chunks, records } from "File"
+
+        fn count_items(xs: str[]) -> i32 = xs.length()
+
+        fn main() -> i32 = do
+          let path = read_line();
+          let pieces = chunks(path, 4);
+          println(to_string(count_items(pieces)) + " " + pieces[6]);
+          let fields = records(path, ";");
+          println(to_string(fields.length()));
+          for field in fields.map(x => "<" + x + ">") do
+            println(field)
+          end;
+          0
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "#{data}\n")
+
+      assert(status.success?, "Expected execution success, stderr: #{stderr}")
+      assert_equal "7 x\n5\n<alpha>\n<beta>\n<>\n<gamma-delta>\n<x>\n", stdout
+    end
+  end
+
+  def test_read_many_keeps_path_order
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      paths = %w[a b c].each_with_index.map do |name, i|
+        File.join(dir, name).tap { |path| File.write(path, name * (i + 1)) }
+      end
+
+      source = File.join(dir, "many.mlc")
+      File.write(source, <<~AUR)
+        import { read_many } from "File"
+
+        fn main() -> i32 = do
+          let texts = read_many(args());
+          for text in texts do
+            println(text)
+          end;
+          texts.length()
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, "--", paths[0], File.join(dir, "missing"), paths[1], paths[2])
+
+      assert_equal 4, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "a\n\nbb\nccc\n", stdout
+    end
+  end
+
+  def test_append_log_writes_lines_in_order
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      log_path = File.join(dir, "audit.log")
+      File.write(log_path, "existing\n")
+
+      source = File.join(dir, "log.mlc")
+      File.write(source, <<~AUR)
+        import { AppendLog, open_log, log_is_open, log_line, commit_line, sync_log, close_log, read_lines } from "File"
+
+        fn main() -> i32 = do
+          let log = open_log(args()[0]);
+          if log_is_open(log) then do
+            log_line(log, "queued");
+            commit_line(log, "committed");
+            log_line(log, "synced");
+            sync_log(log);
+            close_log(log)
+          end else false;
+          read_lines(args()[0]).length()
+        end
+      AUR
+
+      _stdout, stderr, status = Open3.capture3(CLI, source, "--", log_path)
+
+      assert_equal 4, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "existing\nqueued\ncommitted\nsynced\n", File.read(log_path)
+    end
+  end
+
+  def test_file_handle_reads_lines_and_writes_at_offsets
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      input = File.join(dir, "in.txt")
+      output = File.join(dir, "out.txt")
+      File.write(input, "alpha\n\nbeta")
+
+      source = File.join(dir, "handle.mlc")
+      File.write(source, <<~AUR)
+        import { File, file_handle, file_open_read, file_open_write, file_read_line, file_eof, file_write_line, file_read_at, file_write_at, file_advise, file_set_direct, file_set_buffer_size, file_size, file_flush, close_file } from "File"
+
+        fn main() -> i32 = do
+          let input = file_handle(args()[0]);
+          file_open_read(input);
+          file_advise(input, "sequential");
+          let mut line = file_read_line(input);
+          println(file_read_at(input, 7, 4));
+          while line != "" || !file_eof(input) do
+            println("[" + line + "]");
+            line = file_read_line(input)
+          end;
+          close_file(input);
+
+          let output = file_handle(args()[1]);
+          file_set_direct(output, true);
+          file_set_buffer_size(output, 8192);
+          file_open_write(output);
+          file_write_line(output, "hello");
+          file_write_at(output, 0, "J");
+          file_write_line(output, "world");
+          file_flush(output);
+          println(to_string(file_size(output)));
+          close_file(output);
+          5
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, "--", input, output)
+
+      assert_equal 5, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "beta\n[alpha]\n[]\n[beta]\n12\n", stdout
+      assert_equal "Jello\nworld\n", File.read(output)
+    end
+  end
+
+  def test_copy_concat_and_write_bytes_to_stdout
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      src = File.join(dir, "a.txt")
+      copied = File.join(dir, "b.txt")
+      joined = File.join(dir, "c.txt")
+      File.write(src, "abc\n")
+
+      source = File.join(dir, "copy.mlc")
+      File.write(source, <<~AUR)
+        import { CopyStats, copy, concat, write_bytes_to_fd } from "File"
+
+        fn main() -> i32 = do
+          let first = copy(args()[0], args()[1]);
+          let both = concat([args()[0], args()[1]], args()[2]);
+          println("before");
+          let sent = write_bytes_to_fd(args()[2], 1);
+          println("after " + to_string(first.bytes + both.bytes + sent.bytes));
+          if first.ok && both.ok && sent.ok then 7 else 1
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, "--", src, copied, joined)
+
+      assert_equal 7, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "before\nabc\nabc\nafter 20\n", stdout
+      assert_equal "abc\n", File.read(copied)
+    end
+  end
+
+  def test_walk_finds_files_by_glob
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      root = File.join(dir, "tree")
+      FileUtils.mkdir_p(File.join(root, "sub", "deep"))
+      %w[a.mlc sub/b.mlc sub/deep/c.txt x.txt].each { |name| File.write(File.join(root, name), "") }
+
+      source = File.join(dir, "walk.mlc")
+      File.write(source, <<~AUR)
+        import { walk, walk_each } from "File"
+
+        fn main() -> i32 = do
+          for path in walk(args()[0], "*.mlc") do
+            println(path)
+          end;
+          walk_each(args()[0], "sub/**/*.txt", (path: str) => println("each " + path))
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source, "--", root)
+
+      assert_equal 1, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "#{root}/a.mlc\n#{root}/sub/b.mlc\neach #{root}/sub/deep/c.txt\n", stdout
+    end
+  end
+
+  def test_fused_map_filter_chains
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "pipeline.mlc")
+      File.write(source, <<~AUR)
+        fn shout(text: str) -> str[] =
+          text.split(",").map(w => w.upper()).filter(w => w.length() > 1)
+
+        fn main() -> i32 = do
+          for w in "a,bb,ccc".split(",").filter(w => w.length() > 1).map(w => w + "!") do
+            println(w)
+          end
+          let loud = shout("ab,c,de")
+          let total = [1, 2, 3, 4].map(x => x * 10).filter(x => x > 10).sum()
+          println(to_string(loud.length()) + " " + to_string(total))
+          " a  b c ".split(" ").map(w => w.trim()).filter(w => !w.is_empty()).length()
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source)
+
+      assert_equal 3, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "bb!\nccc!\n2 90\n", stdout
+    end
+  end
+
+  def test_chains_with_effects_keep_eager_order
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "effects.mlc")
+      File.write(source, <<~AUR)
+        fn m(x: i32) -> i32 = do
+          println("map" + to_string(x))
+          x
+        end
+
+        fn f(x: i32) -> bool = do
+          println("filter" + to_string(x))
+          x > 1
+        end
+
+        fn main() -> i32 = do
+          let n = [1, 2, 3].map(x => m(x)).filter(x => f(x)).length()
+          for y in [4, 5].map(x => m(x)) do
+            println("loop" + to_string(y))
+          end
+          n
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source)
+
+      assert_equal 2, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "map1\nmap2\nmap3\nfilter1\nfilter2\nfilter3\nmap4\nmap5\nloop4\nloop5\n", stdout
+    end
+  end
+
+  def test_json_lazy_access
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "json.mlc")
+      File.write(source, <<~AUR)
+        import { parse_json, json_has_key, json_array_length, JsonValue } from "Json"
+
+        fn main() -> i32 = do
+          let doc = parse_json(read_line())
+          let items = parse_json(read_line())
+          let truncated = parse_json(read_line())
+          let user = if json_has_key(doc, "user") then 10 else 0
+          let missing = if json_has_key(doc, "name") then 100 else 0
+          let cut = if json_has_key(truncated, "a") then 50 else 0
+          user + missing + cut + json_array_length(items)
+        end
+      AUR
+
+      input = "{\"name\\u0000\": 1, \"tags\": [\"}\"], \"user\": {\"id\": 7}}\n[1, {\"a\": [2, 3]}, \"]\"]\n" \
+              "{\"a\": 1, \"b\": [1, 2\n"
+      cpp, stderr, _status = Open3.capture3(CLI, "--emit-cpp", source)
+      refute_includes cpp, "mlc::json::json_lazy(", "Expected the DOM by default, stderr: #{stderr}"
+      cpp, stderr, _status = Open3.capture3(CLI, "--lazy-json", "--emit-cpp", source)
+      assert_includes cpp, "mlc::json::json_lazy(", "Expected lazy cursors, stderr: #{stderr}"
+
+      [[], ["--lazy-json"]].each do |flags|
+        _stdout, stderr, status = Open3.capture3(CLI, *flags, source, stdin_data: input)
+
+        assert_equal 13, status.exitstatus, "Unexpected exit code with #{flags.inspect}, stderr: #{stderr}"
+      end
+    end
+  end
+
+  def test_ndjson_read
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      records = File.join(dir, "events.jsonl")
+      File.write(records, "{\"user\": 1}\n\n[1, 2]\r\n{oops}\n{\"user\": {\"x\": \"}\"}}")
+
+      source = File.join(dir, "ndjson.mlc")
+      File.write(source, <<~AUR)
+        import { ndjson_read, ndjson_open, ndjson_next_batch, ndjson_errors, ndjson_close, json_has_key, NdjsonReader, JsonValue } from "Json"
+
+        fn main() -> i32 = do
+          let path = read_line()
+          let records = ndjson_read(path)
+          let reader = ndjson_open(path, 2)
+          let mut total = 0
+          let mut batch = ndjson_next_batch(reader)
+          while batch.length() > 0 do
+            total = total + batch.length()
+            batch = ndjson_next_batch(reader)
+          end
+          let errors = ndjson_errors(reader)
+          ndjson_close(reader)
+          let users = records.filter((r: JsonValue) => json_has_key(r, "user")).length()
+          users * 100 + records.length() * 10 + total - errors
+        end
+      AUR
+
+      _stdout, stderr, status = Open3.capture3(CLI, source, stdin_data: "#{records}\n")
+
+      assert_equal 243, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+    end
+  end
+
+  def test_derive_json_round_trip
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "codec.mlc")
+      File.write(source, <<~AUR)
+        type Point = { x: i32, y: f32, label: str, tags: i32[] } derive Json
+        type Shape = Circle(f32) | Rect { w: f32, h: f32 } | Empty derive Json
+
+        fn main() -> i32 = do
+          let p = Point { x: 3, y: 1.5, label: "a\\"b", tags: [1, 2] }
+          println(point_to_json(p))
+          let q = point_from_json("{\\"tags\\": [7], \\"x\\": 40, \\"extra\\": [1, {}], \\"y\\": 2, \\"label\\": \\"z\\"}", p)
+          let missing = point_from_json("{\\"x\\": 1}", p)
+          let again = point_from_json(point_to_json(q), p)
+          println(shape_to_json(Circle(2.5)))
+          q.x + missing.x + again.x
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source)
+
+      assert_equal 83, status.exitstatus, "Unexpected exit code, stderr: #{stderr}"
+      assert_equal "{\"x\":3,\"y\":1.5,\"label\":\"a\\\"b\",\"tags\":[1,2]}\n{\"Circle\":2.5}\n", stdout
+    end
+  end
+
+  def test_buffered_output_is_flushed_at_exit
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      source = File.join(dir, "print.mlc")
+      File.write(source, <<~AUR)
+        import { print_many, flush } from "IO"
+
+        fn main() -> i32 = do
+          print("a")
+          println("b")
+          print_many(["x", "y"])
+          flush()
+          eprintln("to stderr")
+          println("last")
+          0
+        end
+      AUR
+
+      stdout, stderr, status = Open3.capture3(CLI, source)
+
+      assert status.success?, "Unexpected failure, stderr: #{stderr}"
+      assert_equal "ab\nx\ny\nlast\n", stdout
+      assert_includes stderr, "to stderr\n"
+    end
+  end
+
   private
 
   def skip_unless_compiler_available
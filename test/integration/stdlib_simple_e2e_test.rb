@@ -161,6 +161,46 @@ class StdlibSimpleE2ETest < Minitest::Test
     end
   end
 
+  # Compress stdlib E2E tests
+
+  def test_compress_roundtrip
+    skip_unless_compiler_available
+
+    run_aurora(<<~AUR) do |stdout, stderr, status|
+      import { compress, decompress } from "Compress"
+
+      fn main() -> i32 = do
+        let text = "abcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabc"
+        let packed = compress(text)
+        if decompress(packed) == text && packed.length() < text.length() then 0 else 1
+      end
+    AUR
+      assert_equal 0, status.exitstatus
+    end
+  end
+
+  def test_compress_file_roundtrip
+    skip_unless_compiler_available
+
+    Dir.mktmpdir do |dir|
+      path = File.join(dir, "data.lz4")
+
+      run_aurora(<<~AUR) do |stdout, stderr, status|
+        import { write_compressed, read_compressed } from "Compress"
+
+        fn main() -> i32 = do
+          let ok = write_compressed("#{path}", "line one\nline two\n")
+          println(read_compressed("#{path}"))
+          0
+        end
+      AUR
+        assert_equal 0, status.exitstatus
+        assert_equal "line one\nline two\n\n", stdout
+        assert_equal [0x04, 0x22, 0x4D, 0x18], File.binread(path).bytes.first(4)
+      end
+    end
+  end
+
   private
 
   def skip_unless_compiler_available
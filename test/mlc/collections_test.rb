@@ -12,8 +12,9 @@ class AuroraCollectionsTest < Minitest::Test
 
     cpp = MLC.to_cpp(aurora_source)
 
-    assert_includes cpp, "mlc::collections::map"
-    assert_includes cpp, "mlc::collections::filter"
+    assert_includes cpp, "mlc::collections::lazy(lines).map("
+    assert_includes cpp, ".filter("
+    assert_includes cpp, ".collect()"
   end
 
   def test_fold_lowering
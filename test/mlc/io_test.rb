@@ -26,4 +26,51 @@ class AuroraIOTest < Minitest::Test
     assert_includes cpp, "mlc::io::read_line"
     assert_includes cpp, "mlc::io::args"
   end
+
+  def test_print_many_and_flush_lowering
+    aurora_source = <<~AUR
+      import { print_many, flush } from "IO"
+
+      fn report(lines: str[]) -> void = do
+        print_many(lines)
+        flush()
+      end
+    AUR
+
+    cpp = MLC.to_cpp(aurora_source)
+
+    assert_includes cpp, "mlc::io::print_many(lines)"
+    assert_includes cpp, "mlc::io::flush()"
+  end
+
+  def test_stdin_lines_lowering
+    aurora_source = <<~AUR
+      import { stdin_lines } from "IO"
+
+      fn count_lines() -> i32 = do
+        let mut n = 0;
+        for line in stdin_lines() do
+          n = n + line.length()
+        end;
+        n
+      end
+    AUR
+
+    cpp = MLC.to_cpp(aurora_source)
+
+    assert_includes cpp, "std::string_view line_view : mlc::io::stdin_lines()"
+    assert_includes cpp, "const mlc::String line(line_view);"
+  end
+
+  def test_stdin_lines_collected_outside_for_loop
+    aurora_source = <<~AUR
+      import { stdin_lines } from "IO"
+
+      fn count_lines() -> i32 = stdin_lines().length()
+    AUR
+
+    cpp = MLC.to_cpp(aurora_source)
+
+    assert_includes cpp, "std::vector<mlc::String>(mlc::io::stdin_lines()).size()"
+  end
 end
@@ -0,0 +1,64 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+class JsonCodecTest < Minitest::Test
+  def test_derive_clause_is_parsed
+    ast = MLC.parse(<<~AUR)
+      type Point = { x: i32, y: i32 } derive Json
+      type Plain = { x: i32 }
+    AUR
+
+    assert_equal ["Json"], ast.declarations[0].derives
+    assert_equal [], ast.declarations[1].derives
+  end
+
+  def test_record_gets_codec_and_functions
+    source = <<~AUR
+      type HttpRequest = { method: str, retries: i32, ratio: f32 } derive Json
+
+      fn roundtrip(req: HttpRequest) -> HttpRequest =
+        http_request_from_json(http_request_to_json(req), req)
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "mlc::json::RecordCodec<HttpRequest, mlc::json::Field<\"method\", &HttpRequest::method>, " \
+                         "mlc::json::Field<\"retries\", &HttpRequest::retries>, mlc::json::Field<\"ratio\", &HttpRequest::ratio>> " \
+                         "mlc_json_codec(const HttpRequest*);"
+    assert_includes cpp, "inline mlc::String http_request_to_json(const HttpRequest& value)"
+    assert_includes cpp, "inline HttpRequest http_request_from_json(const mlc::String& text, const HttpRequest& fallback)"
+    assert_includes cpp, "http_request_from_json(http_request_to_json(req), req)"
+  end
+
+  def test_sum_type_is_externally_tagged
+    source = <<~AUR
+      type Shape = Circle(f32) | Rect { w: f32, h: f32 } | Empty derive Json
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "mlc::json::TupleCodec<Circle, &Circle::field0> mlc_json_codec(const Circle*);"
+    assert_includes cpp, "mlc::json::RecordCodec<Rect, mlc::json::Field<\"w\", &Rect::w>, mlc::json::Field<\"h\", &Rect::h>> " \
+                         "mlc_json_codec(const Rect*);"
+    assert_includes cpp, "mlc::json::VariantCodec<Shape, mlc::json::Alternative<\"Circle\", Circle>, " \
+                         "mlc::json::Alternative<\"Rect\", Rect>, mlc::json::Alternative<\"Empty\", Empty>> mlc_json_codec(const Shape*);"
+    assert_includes cpp, "inline Shape shape_from_json(const mlc::String& text, const Shape& fallback)"
+  end
+
+  def test_unknown_derive_is_rejected
+    error = assert_raises MLC::CompileError do
+      MLC.to_cpp("type Point = { x: i32 } derive Yaml")
+    end
+
+    assert_match(/Unknown derive 'Yaml' on type 'Point'/, error.message)
+  end
+
+  def test_generic_type_cannot_derive_json
+    error = assert_raises MLC::CompileError do
+      MLC.to_cpp("type Box<T> = { value: T } derive Json")
+    end
+
+    assert_match(/derive Json is not supported on generic type 'Box'/, error.message)
+  end
+end
@@ -0,0 +1,57 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+class JsonLazyTest < Minitest::Test
+  LAZY = MLC::Backend::RuntimePolicy.new.with(json_strategy: :lazy)
+
+  def test_accessor_only_document_uses_lazy_cursor
+    source = <<~AUR
+      import { parse_json, json_get, json_has_key, JsonValue } from "Json"
+
+      fn has_user(text: str) -> bool = do
+        let doc = parse_json(text)
+        json_has_key(doc, "user")
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source, runtime_policy: LAZY)
+
+    assert_includes cpp, "const mlc::json::LazyValue doc = mlc::json::json_lazy(text);"
+    assert_includes cpp, "mlc::json::json_has_key(doc, mlc::String(\"user\"))"
+    refute_includes cpp, "parse_json"
+    refute_match(/constexpr bool has_user/, cpp)
+  end
+
+  def test_other_uses_keep_the_dom
+    source = <<~AUR
+      import { parse_json, json_has_key, stringify_json, JsonValue } from "Json"
+
+      fn dump(text: str) -> str = do
+        let doc = parse_json(text)
+        if json_has_key(doc, "user") then stringify_json(doc) else ""
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source, runtime_policy: LAZY)
+
+    assert_includes cpp, "const mlc::json::JsonValue doc = mlc::json::parse_json(text);"
+    refute_includes cpp, "json_lazy"
+  end
+
+  def test_dom_is_the_default
+    source = <<~AUR
+      import { parse_json, json_has_key, JsonValue } from "Json"
+
+      fn has_user(text: str) -> bool = do
+        let doc = parse_json(text)
+        json_has_key(doc, "user")
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "mlc::json::parse_json(text)"
+    refute_includes cpp, "json_lazy"
+  end
+end
@@ -0,0 +1,61 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+class JsonLinearUpdateTest < Minitest::Test
+  def test_self_update_in_loop_moves_the_array
+    source = <<~AUR
+      import { parse_json, json_array_push, json_number, JsonValue } from "Json"
+
+      fn build(n: i32) -> JsonValue = do
+        let mut arr = parse_json("[]")
+        let mut i = 0
+        while i < n do
+          arr = json_array_push(arr, json_number(to_f32(i)))
+          i = i + 1
+        end
+        arr
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "arr = mlc::json::json_array_push(std::move(arr), "
+  end
+
+  def test_last_use_of_binding_is_moved
+    source = <<~AUR
+      import { parse_json, json_set, json_number, JsonValue } from "Json"
+
+      fn tag(obj: JsonValue) -> JsonValue = json_set(obj, "tag", json_number(1.0))
+
+      fn pair(text: str) -> JsonValue = do
+        let one = json_set(parse_json(text), "a", json_number(1.0))
+        json_set(one, "b", json_number(2.0))
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "mlc::json::json_set(std::move(obj), mlc::String(\"tag\")"
+    assert_includes cpp, "mlc::json::json_set(std::move(one), mlc::String(\"b\")"
+    refute_includes cpp, "const mlc::json::JsonValue one"
+  end
+
+  def test_shared_value_is_not_moved
+    source = <<~AUR
+      import { parse_json, json_set, json_number, JsonValue } from "Json"
+
+      fn keep(text: str) -> JsonValue = do
+        let base = parse_json(text)
+        let changed = json_set(base, "a", json_number(1.0))
+        if json_set(base, "b", json_number(2.0)) == changed then base else changed
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    refute_includes cpp, "std::move(base)"
+    assert_includes cpp, "const mlc::json::JsonValue base"
+  end
+end
@@ -0,0 +1,108 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+class PipelineFusionTest < Minitest::Test
+  def test_chain_with_terminal_runs_as_one_pass
+    source = <<~AUR
+      fn score(xs: i32[]) -> i32 =
+        xs.map(x => x * 3).filter(x => x % 2 == 0).fold(0, (acc, x) => acc + x)
+
+      fn total(xs: i32[]) -> i32 =
+        xs.filter(x => x > 2).map(x => x * 10).sum()
+
+      fn matches(xs: i32[]) -> i32 =
+        xs.filter(x => x > 4).length()
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_match(/mlc::collections::lazy\(xs\)\.map\(.*\)\.filter\(.*\)\.fold\(0, /, cpp)
+    assert_match(/mlc::collections::lazy\(xs\)\.filter\(.*\)\.map\(.*\)\.sum\(\)/, cpp)
+    assert_match(/mlc::collections::lazy\(xs\)\.filter\(.*\)\.count\(\)/, cpp)
+    refute_includes cpp, "mlc::collections::map("
+    refute_includes cpp, "mlc::collections::filter("
+  end
+
+  def test_escaping_chain_is_collected_once
+    source = <<~AUR
+      fn evens(xs: i32[]) -> i32[] =
+        xs.map(x => x + 1).filter(x => x % 2 == 0)
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_match(/mlc::collections::lazy\(xs\)\.map\(.*\)\.filter\(.*\)\.collect\(\)/, cpp)
+  end
+
+  def test_for_loop_pulls_from_the_pipeline
+    source = <<~AUR
+      fn main() -> i32 = do
+        let xs = [1, 2, 3]
+        for y in xs.map(x => x * 100) do
+          println(to_string(y))
+        end
+        0
+      end
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_match(/for \(int y : mlc::collections::lazy\(xs\)\.map\(.*\)\) \{/, cpp)
+    refute_includes cpp, "collect()"
+  end
+
+  def test_single_operations_stay_eager
+    source = <<~AUR
+      fn doubled(xs: i32[]) -> i32[] = xs.map(x => x * 2)
+
+      fn total(xs: i32[]) -> i32 = xs.sum()
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "mlc::collections::map(xs, "
+    assert_includes cpp, "mlc::collections::sum(xs)"
+    refute_includes cpp, "lazy("
+  end
+
+  def test_stages_with_effects_stay_eager
+    source = <<~AUR
+      fn shown(x: i32) -> i32 = do
+        println(to_string(x))
+        x
+      end
+
+      fn via_helper(x: i32) -> bool = shown(x) > 1
+
+      fn printed(xs: i32[]) -> i32 =
+        xs.map(x => shown(x)).filter(x => x > 1).length()
+
+      fn indirect(xs: i32[]) -> i32 =
+        xs.map(x => x + 1).filter(x => via_helper(x)).length()
+
+      fn logged_total(xs: i32[]) -> i32 =
+        xs.map(x => x * 2).filter(x => x > 1).fold(0, (acc, x) => acc + shown(x))
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_match(/int printed\(.*\) noexcept\{return mlc::collections::filter\(mlc::collections::map\(xs, /, cpp)
+    assert_match(/int indirect\(.*\) noexcept\{return mlc::collections::filter\(mlc::collections::map\(xs, /, cpp)
+    # Only the terminal has effects, and it runs last either way
+    assert_match(/int logged_total\(.*\) noexcept\{return mlc::collections::lazy\(xs\)/, cpp)
+  end
+
+  def test_eager_strategy_disables_fusion
+    source = <<~AUR
+      fn score(xs: i32[]) -> i32 =
+        xs.map(x => x * 3).filter(x => x % 2 == 0).fold(0, (acc, x) => acc + x)
+    AUR
+
+    policy = MLC::Backend::RuntimePolicy.new.with(pipeline_strategy: :eager)
+    cpp = MLC.to_cpp(source, runtime_policy: policy)
+
+    assert_includes cpp, "mlc::collections::fold(mlc::collections::filter(mlc::collections::map(xs, "
+    refute_includes cpp, "lazy("
+  end
+end
@@ -0,0 +1,126 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+class RegexMatchTest < Minitest::Test
+  def test_regex_arms_are_hoisted_to_static_locals
+    source = <<~AUR
+      fn classify(line: str) -> i32 =
+        match line
+          | /^ERROR/ => 1
+          | /warn/i => 2
+          | _ => 0
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, 'static const mlc::Regex mlc_re_0 = mlc::regex(mlc::String("^ERROR"));'
+    assert_includes cpp, 'static const mlc::Regex mlc_re_1 = mlc::regex_i(mlc::String("warn"));'
+  end
+
+  def test_multiple_regex_arms_dispatch_through_regex_set
+    source = <<~AUR
+      fn classify(line: str) -> i32 =
+        match line
+          | /^ERROR/ => 1
+          | /warn/i => 2
+          | _ => 0
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "static const mlc::RegexSet mlc_re_set{mlc_re_0, mlc_re_1};"
+    assert_includes cpp, "switch (mlc_re_set.first_match(line))"
+    assert_includes cpp, "case 0: return 1;"
+    assert_includes cpp, "case 1: return 2;"
+    refute_includes cpp, ".test(line)"
+  end
+
+  def test_single_regex_arm_keeps_direct_test
+    source = <<~AUR
+      fn is_error(line: str) -> i32 =
+        match line
+          | /^ERROR/ => 1
+          | _ => 0
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    refute_includes cpp, "mlc::RegexSet"
+    assert_includes cpp, "mlc_re_0.test(line)"
+  end
+
+  def test_regex_set_extracts_captures_only_for_winning_arm
+    source = <<~AUR
+      fn user(line: str) -> str =
+        match line
+          | /^ERROR/ => "error"
+          | /user=(\\w+)/ as [name] => name
+          | _ => ""
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "case 1: if (auto match_opt = mlc_re_1.match(line))"
+    assert_operator cpp.index("switch (mlc_re_set.first_match(line))"), :<, cpp.index("mlc_re_1.match(line)")
+    assert_equal 1, cpp.scan(".match(line)").size
+  end
+
+  def test_regex_declarations_precede_arm_tests
+    source = <<~AUR
+      fn classify(line: str) -> i32 =
+        match line
+          | /a/ => 1
+          | /b/ => 2
+          | _ => 0
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_operator cpp.index("mlc_re_1 = "), :<, cpp.index("mlc_re_set{")
+    assert_operator cpp.index("mlc_re_set{"), :<, cpp.index("switch (")
+  end
+
+  def test_capture_arms_use_hoisted_regex
+    source = <<~AUR
+      fn user(line: str) -> str =
+        match line
+          | /user=(\\w+)/ as [name] => name
+          | _ => ""
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, "static const mlc::Regex mlc_re_0"
+    assert_includes cpp, "mlc_re_0.match(line)"
+    refute_match(/mlc::regex\(mlc::String\([^;]*\)\)\.match/, cpp)
+  end
+
+  def test_regex_literal_expression_is_static
+    source = <<~AUR
+      fn pattern() -> regex = /a+b/
+    AUR
+
+    cpp = MLC.to_cpp(source)
+
+    assert_includes cpp, 'static const mlc::Regex re = mlc::regex(mlc::String("a+b")); return re;'
+  end
+
+  def test_static_strategy_emits_compile_time_matchers
+    source = <<~AUR
+      fn classify(line: str) -> i32 =
+        match line
+          | /^ERROR/ => 1
+          | /user=(\\d+)/ as [_, id] => 2
+          | _ => 0
+    AUR
+
+    policy = MLC::Backend::RuntimePolicy.new.with(regex_strategy: :static)
+    cpp = MLC.to_cpp(source, runtime_policy: policy)
+
+    assert_includes cpp, "static constexpr mlc::ct::Regex<"
+    assert_includes cpp, "mlc_re_0{};"
+    refute_includes cpp, "mlc::RegexSet"
+    refute_includes cpp, "mlc::regex("
+  end
+end
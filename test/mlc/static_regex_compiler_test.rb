@@ -0,0 +1,47 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+require_relative "../../lib/mlc/backend/static_regex_compiler"
+
+class StaticRegexCompilerTest < Minitest::Test
+  def compile(pattern, flags = "")
+    MLC::Backend::StaticRegexCompiler.compile(pattern, flags)
+  end
+
+  def test_literal_pattern_becomes_lit
+    result = compile("abc")
+
+    assert_equal "mlc::ct::Regex<mlc::ct::Lit<97,98,99>, 0>", result.type
+    assert_equal 0, result.groups
+  end
+
+  def test_capture_group_and_class_repeat
+    result = compile("user=(\\d+)")
+
+    assert_equal 1, result.groups
+    assert_includes result.type, "mlc::ct::Lit<117,115,101,114,61>"
+    assert_includes result.type, "mlc::ct::Group<1, mlc::ct::Repeat<1, mlc::ct::kInf,"
+    assert_includes result.type, "mlc::ct::Range<48,57>"
+  end
+
+  def test_case_insensitive_flag_folds_letters
+    result = compile("a", "i")
+
+    assert_includes result.type, "mlc::ct::Ch<65>"
+    assert_includes result.type, "mlc::ct::Ch<97>"
+  end
+
+  def test_repeat_that_can_start_its_follower_is_rejected
+    # Possessive [a-c]+ would eat the final 'a' that the pattern still needs
+    assert_nil compile("a*a")
+    assert_nil compile("[a-c]+a")
+    refute_nil compile("[a-c]+x")
+  end
+
+  def test_unsupported_constructs_are_rejected
+    assert_nil compile("a+?")
+    assert_nil compile("(a)\\1")
+    assert_nil compile("a(?=b)")
+    assert_nil compile("(a|b)*")
+  end
+end
@@ -0,0 +1,49 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+class StdlibCompressTest < Minitest::Test
+  def test_compress_module_is_discovered
+    scanner = MLC::StdlibScanner.new
+
+    assert scanner.module_exists?("Compress")
+    assert_equal "mlc::compress::compress", scanner.cpp_function_name("compress")
+    assert_equal "mlc::compress::read_compressed", scanner.cpp_function_name("read_compressed")
+  end
+
+  def test_compress_functions_lower_to_runtime
+    source = <<~AURORA
+      import { compress, decompress } from "Compress"
+
+      fn roundtrip(data: str) -> str =
+        decompress(compress(data))
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::compress::decompress(mlc::compress::compress(data))"
+  end
+
+  def test_compressed_file_functions
+    source = <<~AURORA
+      import { write_compressed, read_compressed, compress_file, decompress_file } from "Compress"
+
+      fn save(path: str, content: str) -> bool =
+        write_compressed(path, content)
+
+      fn load(path: str) -> str =
+        read_compressed(path)
+
+      fn pack(src: str, dst: str) -> bool =
+        compress_file(src, dst)
+
+      fn unpack(src: str, dst: str) -> bool =
+        decompress_file(src, dst)
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::compress::write_compressed(path, content)"
+    assert_includes cpp, "mlc::compress::read_compressed(path)"
+    assert_includes cpp, "mlc::compress::compress_file(src, dst)"
+    assert_includes cpp, "mlc::compress::decompress_file(src, dst)"
+  end
+end
@@ -197,4 +197,189 @@ class StdlibFileTest < Minitest::Test
     assert_includes cpp, "safe_read_to_string"
     assert_includes cpp, "safe_write_string"
   end
+
+  def test_regex_scan_functions
+    source = <<~AURORA
+      import { regex_scan_file, regex_scan_offsets } from "File"
+
+      fn errors(path: str) -> str[] =
+        regex_scan_file(path, /ERROR \\d+/, 0)
+
+      fn error_offsets(path: str) -> i64[] =
+        regex_scan_offsets(path, /ERROR/, 4)
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "std::vector<mlc::String> errors(mlc::String path)"
+    assert_includes cpp, "mlc::file::regex_scan_file(path, "
+    assert_includes cpp, "std::vector<int64_t> error_offsets(mlc::String path)"
+    assert_includes cpp, "mlc::file::regex_scan_offsets(path, "
+  end
+
+  def test_lines_iterates_lazily
+    source = <<~AURORA
+      import { lines } from "File"
+
+      fn longest(path: str) -> i32 = do
+        let mut best = 0;
+        for line in lines(path) do
+          best = if line.length() > best then line.length() else best
+        end;
+        best
+      end
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "std::string_view line_view : mlc::file::lines(path))"
+    assert_includes cpp, "const mlc::String line(line_view);"
+  end
+
+  def test_lines_collected_when_used_as_array
+    source = <<~AURORA
+      import { lines } from "File"
+
+      fn count_lines(path: str) -> i32 = lines(path).length()
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "std::vector<mlc::String>(mlc::file::lines(path)).size()"
+  end
+
+  def test_chunks_and_records_stream
+    source = <<~AURORA
+      import { chunks, records } from "File"
+
+      fn total_size(path: str) -> i32 = do
+        let mut size = 0;
+        for chunk in chunks(path, 65536) do
+          size = size + chunk.length()
+        end;
+        size
+      end
+
+      fn count_records(path: str) -> i32 = do
+        let mut n = 0;
+        for record in records(path, ";") do
+          n = n + 1
+        end;
+        n
+      end
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "std::string_view chunk_view : mlc::file::chunks(path, 65536))"
+    assert_includes cpp, "std::string_view record_view : mlc::file::records(path, mlc::String(\";\")))"
+  end
+
+  def test_chunks_and_records_collected_when_used_as_array
+    source = <<~AURORA
+      import { chunks, records } from "File"
+
+      fn count_chunks(path: str) -> i32 = chunks(path, 4).length()
+      fn all_records(path: str) -> str[] = records(path, ";")
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "std::vector<mlc::String>(mlc::file::chunks(path, 4)).size()"
+    assert_includes cpp, "std::vector<mlc::String>(mlc::file::records(path, mlc::String(\";\")))"
+  end
+
+  def test_read_many_and_read_each
+    source = <<~AURORA
+      import { read_many, read_each } from "File"
+
+      fn sizes(paths: str[]) -> str[] =
+        read_many(paths)
+
+      fn show(paths: str[]) -> void =
+        read_each(paths, (path: str, text: str) => println(path + ": " + text))
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::file::read_many(paths)"
+    assert_includes cpp, "mlc::file::read_each(paths, "
+  end
+
+  def test_append_log_is_an_opaque_handle
+    source = <<~AURORA
+      import { AppendLog, open_log, log_line, commit_line, close_log } from "File"
+
+      fn audit(path: str, event: str) -> bool = do
+        let log = open_log(path);
+        log_line(log, event);
+        commit_line(log, event);
+        close_log(log)
+      end
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::file::AppendLog* log = mlc::file::open_log(path)"
+    assert_includes cpp, "mlc::file::log_line(log, event)"
+    assert_includes cpp, "mlc::file::commit_line(log, event)"
+    assert_includes cpp, "mlc::file::close_log(log)"
+  end
+
+  def test_file_is_an_opaque_handle
+    source = <<~AURORA
+      import { File, file_handle, file_set_direct, file_set_buffer_size, file_open_write, file_preallocate, file_write_at, file_read_at, file_advise, close_file } from "File"
+
+      fn patch(path: str) -> str = do
+        let file = file_handle(path);
+        file_set_direct(file, true);
+        file_set_buffer_size(file, 8192);
+        file_open_write(file);
+        file_preallocate(file, 4096);
+        file_advise(file, "dontneed");
+        file_write_at(file, 0, "x");
+        let head = file_read_at(file, 0, 1);
+        close_file(file);
+        head
+      end
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::file::File* file = mlc::file::file_handle(path)"
+    assert_includes cpp, "mlc::file::file_set_direct(file, true)"
+    assert_includes cpp, "mlc::file::file_set_buffer_size(file, 8192)"
+    assert_includes cpp, "mlc::file::file_preallocate(file, 4096)"
+    assert_includes cpp, "mlc::file::file_write_at(file, 0, "
+    assert_includes cpp, "mlc::file::file_read_at(file, 0, 1)"
+    assert_includes cpp, "mlc::file::close_file(file)"
+  end
+
+  def test_copy_functions_return_copy_stats
+    source = <<~AURORA
+      import { CopyStats, copy, concat, write_bytes_to_fd } from "File"
+
+      fn backup(src: str, dst: str) -> bool =
+        copy(src, dst).ok
+
+      fn join(parts: str[], dst: str) -> i64 =
+        concat(parts, dst).bytes
+
+      fn show(path: str) -> str =
+        write_bytes_to_fd(path, 1).method
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::file::copy(src, dst).ok"
+    assert_includes cpp, "mlc::file::concat(parts, dst).bytes"
+    assert_includes cpp, "mlc::file::write_bytes_to_fd(path, 1).method"
+  end
+
+  def test_walk_and_walk_each
+    source = <<~AURORA
+      import { walk, walk_each } from "File"
+
+      fn sources(root: str) -> str[] =
+        walk(root, "src/**/*.mlc")
+
+      fn show(root: str) -> i32 =
+        walk_each(root, "*.log", (path: str) => println(path))
+    AURORA
+
+    cpp = MLC.to_cpp(source)
+    assert_includes cpp, "mlc::file::walk(root, mlc::String(\"src/**/*.mlc\"))"
+    assert_includes cpp, "mlc::file::walk_each(root, mlc::String(\"*.log\"), "
+  end
 end
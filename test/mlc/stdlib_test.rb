@@ -31,7 +31,7 @@ class AuroraStdlibTest < Minitest::Test
     
     assert_includes cpp, "map"
     assert_includes cpp, "filter"
-    assert_includes cpp, "size"  # Aurora uses .size() instead of .length()
+    assert_includes cpp, "count()"  # length() ends the fused map/filter pipeline
   end
 
   def test_string_operations
@@ -0,0 +1,122 @@
+// An audit log written from many threads: file::append_line per event (an
+// open, write and close each, nothing synced) versus AppendLog, which keeps
+// the descriptor open and writes and fdatasyncs once per batch. Then durable
+// events, where each thread waits until its event is on disk: one write and
+// fdatasync per event under a mutex versus AppendLog's group commit. Every
+// log is checked for its line count afterwards.
+
+#include "../../../runtime/mlc_file_log.hpp"
+#include "bench_util.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int kThreads = 16;
+
+template <typename Fn>
+void on_threads(int per_thread, Fn&& fn) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i) fn(t, i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+}
+
+std::string event(int thread, int i) {
+    return "2025-10-14T12:00:00Z audit user=" + std::to_string(thread) + " action=update record=" +
+           std::to_string(i) + " status=ok";
+}
+
+size_t count_lines(const std::string& path) {
+    std::string content = mlc::file::read_to_string(mlc::String(path)).as_std_string();
+    size_t lines = 0;
+    for (char c : content) lines += c == '\n';
+    return lines;
+}
+
+void print_stats(const mlc::file::AppendLogStats& stats) {
+    std::printf("  %-36s %9.1f records, max %llu, mean sync %.0f us, max %.0f us\n", "batches of",
+                stats.mean_batch_records(), static_cast<unsigned long long>(stats.max_batch_records),
+                stats.mean_sync_us(), stats.max_sync_ns / 1e3);
+}
+
+} // namespace
+
+int main() {
+    const std::string path = "/tmp/mlc_append_log_benchmark.log";
+    std::atomic<int> failures{0};
+    auto check = [&](const char* label, size_t expected) {
+        size_t lines = count_lines(path);
+        if (lines != expected) {
+            std::printf("%s: %zu lines, expected %zu\n", label, lines, expected);
+            ++failures;
+        }
+        std::remove(path.c_str());
+    };
+
+    const int events = 10000;
+    const double bytes = static_cast<double>(event(0, 0).size() + 1) * events * kThreads;
+    std::printf("%d threads x %d events\n", kThreads, events);
+
+    std::remove(path.c_str());
+    double append_line_s = bench::best_of(1, [&] {
+        on_threads(events, [&](int t, int i) { mlc::file::append_line(mlc::String(path), mlc::String(event(t, i))); });
+    });
+    bench::report("file::append_line, not synced", bytes, append_line_s);
+    check("append_line", static_cast<size_t>(events) * kThreads);
+
+    mlc::file::AppendLogStats stats;
+    double log_s = bench::best_of(1, [&] {
+        mlc::file::AppendLog log(path);
+        on_threads(events, [&](int t, int i) { log.append_line(event(t, i)); });
+        log.close();
+        stats = log.stats();
+    });
+    bench::report("AppendLog, fdatasync per batch", bytes, log_s);
+    bench::report_speedup("speedup", append_line_s, log_s);
+    print_stats(stats);
+    check("AppendLog", static_cast<size_t>(events) * kThreads);
+
+    const int durable = 200;
+    const double durable_bytes = static_cast<double>(event(0, 0).size() + 1) * durable * kThreads;
+    std::printf("%d threads x %d durable events\n", kThreads, durable);
+
+    double per_event_s = bench::best_of(1, [&] {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        std::mutex mutex;
+        on_threads(durable, [&](int t, int i) {
+            std::string line = event(t, i) + '\n';
+            std::lock_guard<std::mutex> lock(mutex);
+            if (::write(fd, line.data(), line.size()) != static_cast<ssize_t>(line.size())) ++failures;
+            ::fdatasync(fd);
+        });
+        ::close(fd);
+    });
+    bench::report("write + fdatasync per event", durable_bytes, per_event_s);
+    check("per event", static_cast<size_t>(durable) * kThreads);
+
+    double group_s = bench::best_of(1, [&] {
+        mlc::file::AppendLog log(path);
+        on_threads(durable, [&](int t, int i) {
+            if (!log.append_line(event(t, i), true)) ++failures;
+        });
+        log.close();
+        stats = log.stats();
+    });
+    bench::report("AppendLog, waiting for each", durable_bytes, group_s);
+    bench::report_speedup("speedup", per_event_s, group_s);
+    print_stats(stats);
+    check("group commit", static_cast<size_t>(durable) * kThreads);
+
+    return failures == 0 ? 0 : 1;
+}
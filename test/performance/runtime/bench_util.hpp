@@ -0,0 +1,91 @@
+#ifndef MLC_BENCH_UTIL_HPP
+#define MLC_BENCH_UTIL_HPP
+
+// Shared helpers for the runtime throughput benchmarks.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace bench {
+
+// Run fn `iterations` times and return the best wall-clock time in seconds
+template <typename Fn>
+double best_of(int iterations, Fn&& fn) {
+    double best = 1e100;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+inline void report(const char* label, double bytes, double seconds) {
+    std::printf("  %-36s %9.1f MB/s  (%.3f s)\n", label, bytes / seconds / 1e6, seconds);
+}
+
+inline void report_speedup(const char* label, double baseline_seconds, double seconds) {
+    std::printf("  %-36s %9.2fx\n", label, baseline_seconds / seconds);
+}
+
+// Synthetic application log: timestamps, levels, key=value pairs
+inline std::string make_log(size_t target_bytes, uint32_t seed = 42) {
+    static const char* levels[] = {"INFO ", "DEBUG ", "WARN ", "ERROR "};
+    static const char* paths[] = {"/api/users", "/api/orders", "/health", "/api/items/search"};
+    std::mt19937 rng(seed);
+    auto draw = [&rng](unsigned n) { return static_cast<unsigned>(rng() % n); };
+    std::string out;
+    out.reserve(target_bytes + 256);
+    char line[256];
+    while (out.size() < target_bytes) {
+        uint32_t r = rng();
+        int len = std::snprintf(line, sizeof(line),
+            "2025-10-%02u 12:%02u:%02u.%03u %shttp method=GET path=%s user_id=%u status=%u latency_ms=%u\n",
+            1 + r % 28, (r >> 5) % 60, (r >> 11) % 60, (r >> 17) % 1000,
+            levels[(r >> 3) % 4 == 3 && (r >> 20) % 8 != 0 ? 0 : (r >> 3) % 4],
+            paths[(r >> 7) % 4], draw(100000), (r >> 23) % 8 == 0 ? 500u : 200u, draw(2000));
+        out.append(line, static_cast<size_t>(len));
+    }
+    return out;
+}
+
+// Synthetic API response: a JSON array of user/order records with nested
+// objects, arrays, escapes and mixed number formats
+inline std::string make_json_payload(size_t target_bytes, uint32_t seed = 42) {
+    static const char* names[] = {"Alice", "Bob", "Carol", "Dmitri", "Eve \\\"E\\\"", "Fran\\u00e7ois"};
+    static const char* tags[] = {"\"new\"", "\"vip\"", "\"beta\"", "\"churn-risk\"", "\"eu\""};
+    std::mt19937 rng(seed);
+    // mt19937 yields unsigned long on LP64; %u wants unsigned
+    auto draw = [&rng](unsigned n) { return static_cast<unsigned>(rng() % n); };
+    std::string out;
+    out.reserve(target_bytes + 1024);
+    out += "[";
+    char record[768];
+    bool first = true;
+    while (out.size() < target_bytes) {
+        uint32_t r = rng();
+        int len = std::snprintf(record, sizeof(record),
+            "%s\n  {\"id\": %u, \"name\": \"%s\", \"email\": \"user%u@example.com\", \"active\": %s, "
+            "\"balance\": %u.%02u, \"score\": %.6e, \"tags\": [%s, %s], "
+            "\"address\": {\"city\": \"City %u\", \"zip\": \"%05u\", \"geo\": [%.5f, %.5f]}, "
+            "\"orders\": [{\"sku\": \"SKU-%u\", \"qty\": %u, \"price\": %u.%02u}, "
+            "{\"sku\": \"SKU-%u\", \"qty\": %u, \"price\": %u.%02u}], \"manager\": null}",
+            first ? "" : ",", draw(10000000), names[r % 6], draw(100000), (r >> 3) % 2 ? "true" : "false",
+            draw(100000), draw(100), draw(1000000) / 7.0, tags[(r >> 4) % 5], tags[(r >> 7) % 5],
+            draw(1000), draw(100000), draw(180000) / 1000.0 - 90, draw(360000) / 1000.0 - 180,
+            draw(100000), 1 + draw(9), draw(1000), draw(100),
+            draw(100000), 1 + draw(9), draw(1000), draw(100));
+        out.append(record, static_cast<size_t>(len));
+        first = false;
+    }
+    out += "\n]\n";
+    return out;
+}
+
+} // namespace bench
+
+#endif // MLC_BENCH_UTIL_HPP
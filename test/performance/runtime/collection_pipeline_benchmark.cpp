@@ -0,0 +1,79 @@
+// map/filter/fold chains as the compiler lowered them before fusion, one
+// mlc::collections call per step with a vector in between, against the
+// fused mlc::collections::lazy pipeline it emits now. Lambdas take their
+// parameters by value, as lowered lambdas do. Both must agree.
+
+#include "../../../runtime/mlc_collections.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main() {
+    namespace col = mlc::collections;
+    int failures = 0;
+
+    // xs.map(x => x * 3).filter(x => x % 2 == 0).map(x => x + 1).sum()
+    std::vector<int> xs(20'000'000);
+    for (size_t i = 0; i < xs.size(); ++i) xs[i] = static_cast<int>(i % 64);  // keeps the i32 sum from overflowing
+    const double int_bytes = static_cast<double>(xs.size() * sizeof(int));
+    auto triple = [](int x) { return x * 3; };
+    auto even = [](int x) { return x % 2 == 0; };
+    auto inc = [](int x) { return x + 1; };
+
+    std::printf("i32[] of %zu elements, map/filter/map/sum:\n", xs.size());
+    int eager = 0;
+    double eager_s = bench::best_of(3, [&] { eager = col::sum(col::map(col::filter(col::map(xs, triple), even), inc)); });
+    bench::report("nested map/filter calls", int_bytes, eager_s);
+
+    int fused = 0;
+    double fused_s = bench::best_of(3, [&] { fused = col::lazy(xs).map(triple).filter(even).map(inc).sum(); });
+    bench::report("lazy pipeline", int_bytes, fused_s);
+    bench::report_speedup("speedup", eager_s, fused_s);
+    if (fused != eager) {
+        std::printf("sum differs: %d vs %d\n", fused, eager);
+        ++failures;
+    }
+
+    // lines.map(l => l.trim()).filter(l => l.contains("ERROR")).fold(0, (n, l) => n + l.byte_size())
+    const std::string log = bench::make_log(64 * 1024 * 1024);
+    const std::vector<mlc::String> lines = mlc::String(log).split(mlc::String("\n"));
+    const double log_bytes = static_cast<double>(log.size());
+    auto trim = [](mlc::String line) { return line.trim(); };
+    auto error = [](mlc::String line) { return line.contains(mlc::String("ERROR")); };
+    auto add_size = [](int64_t total, mlc::String line) { return total + static_cast<int64_t>(line.byte_size()); };
+
+    std::printf("str[] of %zu log lines, map/filter/fold:\n", lines.size());
+    int64_t eager_bytes = 0;
+    eager_s = bench::best_of(3, [&] {
+        eager_bytes = col::fold(col::filter(col::map(lines, trim), error), int64_t{0}, add_size);
+    });
+    bench::report("nested map/filter calls", log_bytes, eager_s);
+
+    int64_t fused_bytes = 0;
+    fused_s = bench::best_of(3, [&] { fused_bytes = col::lazy(lines).map(trim).filter(error).fold(int64_t{0}, add_size); });
+    bench::report("lazy pipeline", log_bytes, fused_s);
+    bench::report_speedup("speedup", eager_s, fused_s);
+    if (fused_bytes != eager_bytes) {
+        std::printf("fold differs: %lld vs %lld\n", static_cast<long long>(fused_bytes),
+                    static_cast<long long>(eager_bytes));
+        ++failures;
+    }
+
+    // An escaping chain still builds one vector instead of two
+    std::vector<mlc::String> eager_kept;
+    eager_s = bench::best_of(3, [&] { eager_kept = col::filter(col::map(lines, trim), error); });
+    bench::report("nested calls, result kept", log_bytes, eager_s);
+
+    std::vector<mlc::String> fused_kept;
+    fused_s = bench::best_of(3, [&] { fused_kept = col::lazy(lines).map(trim).filter(error).collect(); });
+    bench::report("lazy pipeline + collect", log_bytes, fused_s);
+    bench::report_speedup("speedup", eager_s, fused_s);
+    if (fused_kept != eager_kept) {
+        std::printf("collected lines differ\n");
+        ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
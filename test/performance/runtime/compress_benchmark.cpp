@@ -0,0 +1,67 @@
+// LZ4 block and frame throughput (runtime/mlc_compress.hpp)
+
+#include "../../../runtime/mlc_compress.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+using namespace mlc::compress;
+
+namespace {
+
+void bench_block(const char* name, const std::string& data) {
+    std::vector<uint8_t> compressed(compress_bound(data.size()));
+    std::vector<uint8_t> restored(data.size());
+    const auto* src = reinterpret_cast<const uint8_t*>(data.data());
+
+    size_t compressed_size = 0;
+    double compress_s = bench::best_of(5, [&] {
+        compressed_size = compress_block(src, data.size(), compressed.data(), compressed.size());
+    });
+    double decompress_s = bench::best_of(5, [&] {
+        decompress_block(compressed.data(), compressed_size, restored.data(), restored.size());
+    });
+
+    if (std::memcmp(restored.data(), src, data.size()) != 0) {
+        std::fprintf(stderr, "roundtrip mismatch for %s\n", name);
+        std::exit(1);
+    }
+
+    std::printf("%s: %zu -> %zu bytes (ratio %.2f)\n", name, data.size(), compressed_size,
+                static_cast<double>(data.size()) / compressed_size);
+    bench::report("block compress", data.size(), compress_s);
+    bench::report("block decompress", data.size(), decompress_s);
+}
+
+void bench_file(const std::string& data) {
+    {
+        std::ofstream out("plain.log", std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    double compress_s = bench::best_of(3, [] { compress_file("plain.log", "plain.log.lz4"); });
+    double decompress_s = bench::best_of(3, [] { decompress_file("plain.log.lz4", "restored.log"); });
+
+    std::printf("frame files:\n");
+    bench::report("compress_file", data.size(), compress_s);
+    bench::report("decompress_file", data.size(), decompress_s);
+}
+
+} // namespace
+
+int main() {
+    const size_t size = 64 * 1024 * 1024;
+
+    std::string log = bench::make_log(size);
+    bench_block("log text", log);
+
+    std::string random(size, '\0');
+    std::mt19937 rng(7);
+    for (auto& c : random) c = static_cast<char>(rng());
+    bench_block("random bytes", random);
+
+    bench_file(log);
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Copying files the way MLC programs did before file::copy existed,
+// read_to_string then write_string, against copy, concat and
+// write_bytes_to_fd, which leave the bytes in the kernel. Sources are in the
+// page cache; every result is compared with the source.
+
+#include "../../../runtime/mlc_file_copy.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Runs fn(write end of a pipe) while a thread counts what comes out
+size_t through_pipe(const std::function<void(int)>& fn) {
+    int fds[2];
+    if (::pipe(fds) != 0) std::exit(1);
+    size_t total = 0;
+    std::thread reader([&] {
+        std::vector<char> chunk(1 << 20);
+        ssize_t n;
+        while ((n = ::read(fds[0], chunk.data(), chunk.size())) > 0) total += static_cast<size_t>(n);
+    });
+    fn(fds[1]);
+    ::close(fds[1]);
+    reader.join();
+    ::close(fds[0]);
+    return total;
+}
+
+} // namespace
+
+int main() {
+    const std::string log = bench::make_log(256 * 1024 * 1024);
+    const std::string dir = "/tmp/mlc_file_copy_benchmark";
+    const mlc::String src(dir + "/src.log");
+    const mlc::String dst(dir + "/dst.log");
+    ::mkdir(dir.c_str(), 0755);
+    mlc::file::write_string(src, mlc::String(log));
+    const double bytes = static_cast<double>(log.size());
+    int failures = 0;
+    auto check = [&](const char* label, const std::string& expected) {
+        if (mlc::file::read_to_string(dst).as_std_string() != expected) {
+            std::printf("%s: copy differs from the source\n", label);
+            ++failures;
+        }
+        std::remove(dst.as_std_string().c_str());
+    };
+
+    double old_copy_s = bench::best_of(3, [&] { mlc::file::write_string(dst, mlc::file::read_to_string(src)); });
+    bench::report("read_to_string + write_string", bytes, old_copy_s);
+    check("read + write", log);
+
+    mlc::file::CopyStats stats;
+    double copy_s = bench::best_of(3, [&] { stats = mlc::file::copy(src, dst); });
+    bench::report("file::copy", bytes, copy_s);
+    bench::report_speedup("speedup", old_copy_s, copy_s);
+    std::printf("  %-36s %s, %.0f MB/s reported\n", "method", stats.method.as_std_string().c_str(), stats.mb_per_s);
+    if (!stats.ok || stats.bytes != static_cast<int64_t>(log.size())) ++failures;
+    check("copy", log);
+
+    // Eight parts of 32 MB joined back together
+    std::vector<mlc::String> parts;
+    const size_t part_size = log.size() / 8;
+    for (size_t i = 0; i < 8; ++i) {
+        parts.emplace_back(dir + "/part" + std::to_string(i));
+        const size_t size = i == 7 ? log.size() - part_size * 7 : part_size;
+        mlc::file::write_string(parts.back(), mlc::String(log.substr(part_size * i, size)));
+    }
+    double old_concat_s = bench::best_of(3, [&] {
+        std::string joined;
+        for (const auto& part : parts) joined += mlc::file::read_to_string(part).as_std_string();
+        mlc::file::write_string(dst, mlc::String(joined));
+    });
+    bench::report("read_to_string x8 + write_string", bytes, old_concat_s);
+    check("read + write parts", log);
+
+    double concat_s = bench::best_of(3, [&] { stats = mlc::file::concat(parts, dst); });
+    bench::report("file::concat", bytes, concat_s);
+    bench::report_speedup("speedup", old_concat_s, concat_s);
+    if (!stats.ok) ++failures;
+    check("concat", log);
+
+    size_t piped = 0;
+    double old_pipe_s = bench::best_of(3, [&] {
+        piped = through_pipe([&](int fd) {
+            const std::string content = mlc::file::read_to_string(src).as_std_string();
+            mlc::file::detail::write_all_fd(fd, content.data(), content.size());
+        });
+    });
+    bench::report("read_to_string + write(2) to a pipe", bytes, old_pipe_s);
+    if (piped != log.size()) ++failures;
+
+    double pipe_s = bench::best_of(3, [&] {
+        piped = through_pipe([&](int fd) { stats = mlc::file::write_bytes_to_fd(src, fd); });
+    });
+    bench::report("write_bytes_to_fd to a pipe", bytes, pipe_s);
+    bench::report_speedup("speedup", old_pipe_s, pipe_s);
+    std::printf("  %-36s %s\n", "method", stats.method.as_std_string().c_str());
+    if (piped != log.size() || !stats.ok) ++failures;
+
+    for (const auto& part : parts) std::remove(part.as_std_string().c_str());
+    std::remove(src.as_std_string().c_str());
+    ::rmdir(dir.c_str());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// file::File on a descriptor versus the std::fstream version it replaced
+// (reproduced here call for call): writing a log line by line, reading it
+// back line by line and whole, and random 4 KB reads (seekg + read versus
+// read_at). Results are checked against what was written. Writes land in
+// the page cache, so the kernel's share of the write numbers is large.
+
+#include "../../../runtime/mlc_file.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+int main() {
+    const std::string log = bench::make_log(128 * 1024 * 1024);
+    std::vector<mlc::String> lines;
+    for (size_t pos = 0; pos < log.size();) {
+        size_t nl = log.find('\n', pos);
+        if (nl == std::string::npos) nl = log.size();
+        lines.emplace_back(log.substr(pos, nl - pos));
+        pos = nl + 1;
+    }
+    std::string expected;
+    expected.reserve(log.size() + 1);
+    for (const auto& line : lines) {
+        expected += line.as_std_string();
+        expected += '\n';
+    }
+    const double bytes = static_cast<double>(expected.size());
+    const std::string path = "/tmp/mlc_file_handle_benchmark.log";
+    std::printf("%zu lines, %.1f MB\n", lines.size(), bytes / 1e6);
+
+    double fstream_write_s = bench::best_of(5, [&] {
+        std::fstream out(path, std::ios::out | std::ios::trunc);
+        for (const auto& line : lines) {
+            out << line.as_std_string() << '\n';
+            if (!out.good()) std::exit(1);
+        }
+    });
+    bench::report("std::fstream << line", bytes, fstream_write_s);
+    double write_s = bench::best_of(5, [&] {
+        mlc::file::File out(path);
+        out.open_write();
+        for (const auto& line : lines) {
+            if (!out.write_line(line)) std::exit(1);
+        }
+    });
+    bench::report("File::write_line", bytes, write_s);
+    bench::report_speedup("speedup", fstream_write_s, write_s);
+
+    // The same writes into /dev/null leave only the user-space cost
+    double fstream_null_s = bench::best_of(5, [&] {
+        std::fstream out("/dev/null", std::ios::out | std::ios::trunc);
+        for (const auto& line : lines) out << line.as_std_string() << '\n';
+    });
+    bench::report("std::fstream << line, /dev/null", bytes, fstream_null_s);
+    double null_s = bench::best_of(5, [&] {
+        mlc::file::File out("/dev/null");
+        out.open_write();
+        for (const auto& line : lines) out.write_line(line);
+    });
+    bench::report("File::write_line, /dev/null", bytes, null_s);
+    bench::report_speedup("speedup", fstream_null_s, null_s);
+
+    size_t total = 0;
+    double getline_s = bench::best_of(3, [&] {
+        std::fstream in(path, std::ios::in);
+        total = 0;
+        for (;;) {
+            std::string line;
+            if (!std::getline(in, line)) break;
+            std::optional<mlc::String> value = mlc::String(line);
+            total += value->as_std_string().size() + 1;
+        }
+    });
+    bench::report("std::getline(fstream)", bytes, getline_s);
+    double read_line_s = bench::best_of(3, [&] {
+        mlc::file::File in(path);
+        in.open_read();
+        total = 0;
+        while (auto line = in.read_line()) total += line->as_std_string().size() + 1;
+    });
+    bench::report("File::read_line", bytes, read_line_s);
+    bench::report_speedup("speedup", getline_s, read_line_s);
+    if (total != expected.size()) return 1;
+
+    std::string whole;
+    double seek_read_s = bench::best_of(3, [&] {
+        std::fstream in(path, std::ios::in);
+        in.seekg(0, std::ios::end);
+        whole.assign(static_cast<size_t>(in.tellg()), '\0');
+        in.seekg(0, std::ios::beg);
+        in.read(whole.data(), static_cast<std::streamsize>(whole.size()));
+        whole = std::optional<mlc::String>(mlc::String(whole))->as_std_string();
+    });
+    bench::report("fstream seekg/tellg/read", bytes, seek_read_s);
+    double read_all_s = bench::best_of(3, [&] {
+        mlc::file::File in(path);
+        in.open_read();
+        whole = in.read_all()->as_std_string();
+    });
+    bench::report("File::read_all", bytes, read_all_s);
+    bench::report_speedup("speedup", seek_read_s, read_all_s);
+    if (whole != expected) return 1;
+
+    constexpr int kReads = 200000;
+    constexpr size_t kBlock = 4096;
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> offsets(kReads);
+    for (auto& offset : offsets) offset = rng() % (expected.size() - kBlock);
+    double seek_s = bench::best_of(3, [&] {
+        std::fstream in(path, std::ios::in | std::ios::binary);
+        std::string block(kBlock, '\0');
+        total = 0;
+        for (uint64_t offset : offsets) {
+            in.seekg(static_cast<std::streamoff>(offset));
+            in.read(block.data(), kBlock);
+            total += static_cast<size_t>(block[0]);
+        }
+    });
+    bench::report("fstream seekg + read, 4 KB", kReads * double(kBlock), seek_s);
+    const size_t random_total = total;
+    double read_at_s = bench::best_of(3, [&] {
+        mlc::file::File in(path);
+        in.open_read();
+        in.advise(mlc::file::Advice::Random);
+        total = 0;
+        for (uint64_t offset : offsets) total += static_cast<size_t>(in.read_at(offset, kBlock)->as_std_string()[0]);
+    });
+    bench::report("File::read_at, 4 KB", kReads * double(kBlock), read_at_s);
+    bench::report_speedup("speedup", seek_s, read_at_s);
+
+    ::unlink(path.c_str());
+    return total == random_total ? 0 : 1;
+}
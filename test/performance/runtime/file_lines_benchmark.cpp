@@ -0,0 +1,55 @@
+// Going through a large log line by line: read_lines (getline into a vector
+// of Strings, so the file is held twice) versus file::lines, which scans the
+// mapped file in place and yields views. The chunked fallback is measured by
+// reading the same bytes from a FIFO.
+
+#include "../../../runtime/mlc_file.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+int main() {
+    const std::string log = bench::make_log(200 * 1024 * 1024);
+    const double bytes = static_cast<double>(log.size());
+    const std::string path = "/tmp/mlc_file_lines_benchmark.log";
+    const std::string fifo = "/tmp/mlc_file_lines_benchmark.fifo";
+    if (!mlc::file::write_string(mlc::String(path), mlc::String(log))) return 1;
+    std::printf("input: %.1f MB\n", bytes / 1e6);
+
+    size_t total = 0;
+    double read_lines_s = bench::best_of(3, [&] {
+        total = 0;
+        for (const auto& line : mlc::file::read_lines(mlc::String(path))) total += line.as_std_string().size() + 1;
+    });
+    bench::report("read_lines", bytes, read_lines_s);
+    const size_t expected = total;
+
+    double lines_s = bench::best_of(3, [&] {
+        total = 0;
+        for (std::string_view line : mlc::file::lines(mlc::String(path))) total += line.size() + 1;
+    });
+    bench::report("file::lines (mapped)", bytes, lines_s);
+    bench::report_speedup("speedup", read_lines_s, lines_s);
+
+    ::unlink(fifo.c_str());
+    if (::mkfifo(fifo.c_str(), 0600) != 0) return 1;
+    double fifo_s = bench::best_of(3, [&] {
+        std::thread writer([&] { mlc::file::write_string(mlc::String(fifo), mlc::String(log)); });
+        total = 0;
+        for (std::string_view line : mlc::file::lines(mlc::String(fifo))) total += line.size() + 1;
+        writer.join();
+    });
+    bench::report("file::lines (FIFO, chunked)", bytes, fifo_s);
+
+    ::unlink(fifo.c_str());
+    ::unlink(path.c_str());
+    if (total != expected) {
+        std::fprintf(stderr, "line totals differ: %zu vs %zu\n", total, expected);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Streaming a large log with per-byte work on each piece (a checksum stands
+// in for parsing): read_to_string, which holds the whole file, versus
+// file::Reader with and without the prefetch thread, and read_lines versus
+// file::Records for line records. The file sits in the page cache, where a
+// read is only a copy; the prefetch thread pays off when reads wait on a
+// disk or a pipe writer.
+
+#include "../../../runtime/mlc_file_reader.hpp"
+#include "bench_util.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+uint64_t checksum(std::string_view data, uint64_t hash = 1469598103934665603ull) {
+    for (unsigned char c : data) hash = (hash ^ c) * 1099511628211ull;
+    return hash;
+}
+
+} // namespace
+
+int main() {
+    const std::string log = bench::make_log(256 * 1024 * 1024);
+    const double bytes = static_cast<double>(log.size());
+    const std::string path = "/tmp/mlc_file_reader_benchmark.log";
+    if (!mlc::file::write_string(mlc::String(path), mlc::String(log))) return 1;
+    std::printf("input: %.1f MB\n", bytes / 1e6);
+
+    uint64_t expected = 0, hash = 0;
+    double whole_s = bench::best_of(3, [&] { expected = checksum(mlc::file::read_to_string(mlc::String(path)).as_std_string()); });
+    bench::report("read_to_string (whole file in memory)", bytes, whole_s);
+
+    double sync_s = bench::best_of(3, [&] {
+        hash = 1469598103934665603ull;
+        for (std::string_view chunk : mlc::file::Reader(path, mlc::file::Reader::kDefaultChunk, false)) hash = checksum(chunk, hash);
+    });
+    bench::report("Reader, 1 MB chunks, no prefetch", bytes, sync_s);
+    bench::report_speedup("speedup", whole_s, sync_s);
+    if (hash != expected) {
+        std::fprintf(stderr, "checksums differ\n");
+        return 1;
+    }
+
+    double prefetch_s = bench::best_of(3, [&] {
+        hash = 1469598103934665603ull;
+        for (std::string_view chunk : mlc::file::Reader(path)) hash = checksum(chunk, hash);
+    });
+    bench::report("Reader, 1 MB chunks, prefetch thread", bytes, prefetch_s);
+    bench::report_speedup("speedup", whole_s, prefetch_s);
+    if (hash != expected) {
+        std::fprintf(stderr, "checksums differ\n");
+        return 1;
+    }
+
+    size_t count = 0;
+    double lines_s = bench::best_of(3, [&] {
+        count = 0;
+        for (const auto& line : mlc::file::read_lines(mlc::String(path))) count += line.as_std_string().size() + 1;
+    });
+    bench::report("read_lines", bytes, lines_s);
+    const size_t line_bytes = count;
+
+    double records_s = bench::best_of(3, [&] {
+        count = 0;
+        for (std::string_view record : mlc::file::Records(path)) count += record.size() + 1;
+    });
+    bench::report("Records('\\n')", bytes, records_s);
+    bench::report_speedup("speedup", lines_s, records_s);
+
+    ::unlink(path.c_str());
+    return count == line_bytes ? 0 : 1;
+}
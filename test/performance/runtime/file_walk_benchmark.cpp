@@ -0,0 +1,105 @@
+// Listing a tree of 100k small files the way jobs did before file::walk,
+// by running find and reading its output, and with a single-threaded
+// std::filesystem::recursive_directory_iterator, against file::walk on one
+// thread and on every core. All four must find the same files.
+
+#include "../../../runtime/mlc_file_walk.hpp"
+#include "bench_util.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kTop = 20;
+constexpr int kDirs = 25;
+constexpr int kFiles = 200;
+
+void report_files(const char* label, size_t files, double seconds) {
+    std::printf("  %-36s %9.0f files/s  (%.3f s)\n", label, files / seconds, seconds);
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+    const std::string root = "/tmp/mlc_file_walk_benchmark";
+    fs::remove_all(root);
+    size_t expected = 0;
+    for (int top = 0; top < kTop; ++top) {
+        for (int dir = 0; dir < kDirs; ++dir) {
+            const std::string path = root + "/t" + std::to_string(top) + "/d" + std::to_string(dir);
+            fs::create_directories(path);
+            for (int file = 0; file < kFiles; ++file) {
+                const bool log = file % 4 != 0;
+                std::FILE* out = std::fopen((path + "/f" + std::to_string(file) + (log ? ".log" : ".tmp")).c_str(), "w");
+                std::fputs("x\n", out);
+                std::fclose(out);
+                expected += log;
+            }
+        }
+    }
+    std::printf("%d files in %d directories, %zu match *.log, %u threads\n", kTop * kDirs * kFiles, kTop * kDirs,
+                expected, std::thread::hardware_concurrency());
+    int failures = 0;
+    auto check = [&](const char* label, size_t found) {
+        if (found != expected) {
+            std::printf("%s: found %zu files, expected %zu\n", label, found, expected);
+            ++failures;
+        }
+    };
+
+    size_t found = 0;
+    double find_s = bench::best_of(3, [&] {
+        found = 0;
+        std::FILE* pipe = ::popen(("find " + root + " -type f -name '*.log'").c_str(), "r");
+        char line[4096];
+        std::vector<std::string> paths;
+        while (std::fgets(line, sizeof(line), pipe)) paths.emplace_back(line);
+        ::pclose(pipe);
+        found = paths.size();
+    });
+    report_files("popen(find -name '*.log')", found, find_s);
+    check("find", found);
+
+    double fs_s = bench::best_of(3, [&] {
+        std::vector<std::string> paths;
+        for (const auto& entry : fs::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".log") paths.push_back(entry.path().string());
+        }
+        found = paths.size();
+    });
+    report_files("recursive_directory_iterator", found, fs_s);
+    check("recursive_directory_iterator", found);
+
+    mlc::file::WalkOptions one;
+    one.threads = 1;
+    double walk_one_s = bench::best_of(3, [&] { found = mlc::file::walk(root, "*.log", one).size(); });
+    report_files("file::walk, 1 thread", found, walk_one_s);
+    bench::report_speedup("speedup over find", find_s, walk_one_s);
+    check("walk, 1 thread", found);
+
+    double walk_s = bench::best_of(3, [&] { found = mlc::file::walk(root, "*.log").size(); });
+    report_files("file::walk, every core", found, walk_s);
+    bench::report_speedup("speedup over find", find_s, walk_s);
+    bench::report_speedup("speedup over the iterator", fs_s, walk_s);
+    check("walk", found);
+
+    std::atomic<size_t> bytes{0};
+    double each_s = bench::best_of(3, [&] {
+        bytes = 0;
+        found = static_cast<size_t>(mlc::file::walk_each(root, "*.log", [&](const mlc::String& path) {
+            bytes += mlc::file::read_to_string(path).byte_size();
+        }));
+    });
+    report_files("walk_each + read_to_string", found, each_s);
+    check("walk_each", found);
+    if (bytes != expected * 2) ++failures;
+
+    fs::remove_all(root);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// Parsing a large API payload: nlohmann::json (the previous runtime backend)
+// versus the arena-backed mlc::json DOM, the structural-index stage on each
+// available kernel, and the DOM parser with and without that index.
+
+#include "../../../runtime/json.hpp"
+#include "../../../runtime/mlc_json.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Sum of all "qty" fields, so each parser's tree is actually walked
+double sum_qty(const nlohmann::json& records) {
+    double total = 0;
+    for (const auto& record : records) {
+        for (const auto& order : record["orders"]) total += order["qty"].get<double>();
+    }
+    return total;
+}
+
+double sum_qty(const mlc::json::JsonValue& records) {
+    double total = 0;
+    const mlc::json::Node& root = records.node();
+    for (uint32_t i = 0; i < root.size; ++i) {
+        const mlc::json::Node* orders = mlc::json::find_member(root.items[i], "orders");
+        for (uint32_t j = 0; j < orders->size; ++j) total += mlc::json::find_member(orders->items[j], "qty")->number;
+    }
+    return total;
+}
+
+// Records dominated by long string fields (bodies of ~2 KB prose)
+std::string make_articles(size_t target_bytes) {
+    std::mt19937 rng(7);
+    std::string out = "[";
+    while (out.size() < target_bytes) {
+        if (out.size() > 1) out += ",\n";
+        out += "{\"id\": " + std::to_string(rng() % 1000000) + ", \"title\": \"Release notes\", \"body\": \"";
+        for (int word = 0; word < 300; ++word) {
+            for (uint32_t i = 0, n = 2 + rng() % 8; i < n; ++i) out += static_cast<char>('a' + rng() % 26);
+            out += word % 40 == 39 ? ".\\n" : " ";
+        }
+        out += "\"}";
+    }
+    out += "]";
+    return out;
+}
+
+} // namespace
+
+int main() {
+    const mlc::String payload(bench::make_json_payload(100 * 1024 * 1024));
+    double bytes = static_cast<double>(payload.as_std_string().size());
+    std::printf("payload: %.1f MB\n", bytes / 1e6);
+
+    double expected = 0;
+    double nlohmann_s = bench::best_of(2, [&] {
+        nlohmann::json doc = nlohmann::json::parse(payload.as_std_string());
+        expected = sum_qty(doc);
+    });
+    bench::report("nlohmann::json::parse", bytes, nlohmann_s);
+
+    double total = 0;
+    double dom_s = bench::best_of(3, [&] {
+        mlc::json::JsonValue doc = mlc::json::parse_json(payload);
+        total = sum_qty(doc);
+    });
+    if (total != expected) {
+        std::fprintf(stderr, "qty mismatch: %f vs %f\n", total, expected);
+        return 1;
+    }
+    bench::report("mlc::json::parse_json", bytes, dom_s);
+    bench::report_speedup("speedup", nlohmann_s, dom_s);
+
+    const char* kernel_names[] = {"scalar", "sse2", "avx2"};
+    for (auto kernel : {mlc::json::simd::Kernel::Scalar, mlc::json::simd::Kernel::Sse2, mlc::json::simd::Kernel::Avx2}) {
+        if (!mlc::json::simd::kernel_supported(kernel)) continue;
+        std::vector<uint32_t> index;
+        double index_s = bench::best_of(3, [&] { mlc::json::simd::build_structural_index(payload.as_std_string(), index, kernel); });
+        char label[64];
+        std::snprintf(label, sizeof(label), "structural index (%s)", kernel_names[static_cast<int>(kernel)]);
+        bench::report(label, bytes, index_s);
+    }
+
+    // Direct scanning versus the two-stage path (which falls back to scanning
+    // for dense documents like this one), both parsing in place
+    auto compare_stages = [&](const char* name, const std::string& text) {
+        auto parse_in_place = [&](bool indexed) {
+            return bench::best_of(3, [&] {
+                mlc::json::Document doc;
+                doc.arena().reserve(text.size() / 2);
+                mlc::json::simd::StructuralIndexer indexer(text);
+                mlc::json::Parser parser(doc, text, indexed ? &indexer : nullptr);
+                if (!parser.parse()) std::exit(1);
+            });
+        };
+        double text_bytes = static_cast<double>(text.size());
+        double scan_s = parse_in_place(false);
+        double two_stage_s = parse_in_place(true);
+        std::printf("%s:\n", name);
+        bench::report("DOM parser, direct scan", text_bytes, scan_s);
+        bench::report("DOM parser, two-stage", text_bytes, two_stage_s);
+        bench::report_speedup("two-stage speedup", scan_s, two_stage_s);
+    };
+    compare_stages("API payload", payload.as_std_string());
+    compare_stages("text-heavy payload", make_articles(64 * 1024 * 1024));
+
+    double roundtrip_s = bench::best_of(3, [&] {
+        total = static_cast<double>(mlc::json::stringify_json(mlc::json::parse_json(payload)).as_std_string().size());
+    });
+    bench::report("parse_json + stringify_json", bytes, roundtrip_s);
+    return 0;
+}
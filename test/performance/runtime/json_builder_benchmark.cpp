@@ -0,0 +1,68 @@
+// Building a JSON array and object one entry at a time: json_array_push /
+// json_set on a shared value (a new version per call), on a moved value
+// (updated in place, as generated code does for a last use), and JsonBuilder.
+
+#include "../../../runtime/mlc_json.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+int main() {
+    const int small = 20000;
+    const int large = 2000000;
+    std::vector<mlc::String> keys;
+    for (int i = 0; i < large; ++i) keys.emplace_back("key" + std::to_string(i));
+
+    auto report = [](const char* label, int entries, double seconds) {
+        std::printf("  %-36s %9.2f M entries/s  (%.3f s)\n", label, entries / seconds / 1e6, seconds);
+    };
+    auto check = [](const mlc::json::JsonValue& value, int expected) {
+        if (value.size() != static_cast<size_t>(expected)) {
+            std::fprintf(stderr, "size mismatch: %zu vs %d\n", value.size(), expected);
+            std::exit(1);
+        }
+    };
+
+    std::printf("array of %d numbers:\n", small);
+    double shared_s = bench::best_of(3, [&] {
+        mlc::json::JsonValue arr = mlc::json::json_array({});
+        for (int i = 0; i < small; ++i) {
+            mlc::json::JsonValue previous = arr;
+            arr = mlc::json::json_array_push(previous, mlc::json::JsonValue(static_cast<double>(i)));
+        }
+        check(arr, small);
+    });
+    double moved_s = bench::best_of(3, [&] {
+        mlc::json::JsonValue arr = mlc::json::json_array({});
+        for (int i = 0; i < small; ++i) arr = mlc::json::json_array_push(std::move(arr), mlc::json::JsonValue(static_cast<double>(i)));
+        check(arr, small);
+    });
+    report("json_array_push, shared", small, shared_s);
+    report("json_array_push, moved", small, moved_s);
+    bench::report_speedup("in-place speedup", shared_s, moved_s);
+
+    std::printf("%d entries, in place:\n", large);
+    double push_s = bench::best_of(3, [&] {
+        mlc::json::JsonValue arr = mlc::json::json_array({});
+        for (int i = 0; i < large; ++i) arr = mlc::json::json_array_push(std::move(arr), mlc::json::JsonValue(static_cast<double>(i)));
+        check(arr, large);
+    });
+    double builder_s = bench::best_of(3, [&] {
+        auto builder = mlc::json::JsonBuilder::array();
+        for (int i = 0; i < large; ++i) builder.push(mlc::json::JsonValue(static_cast<double>(i)));
+        check(builder.build(), large);
+    });
+    double set_s = bench::best_of(3, [&] {
+        mlc::json::JsonValue obj = mlc::json::json_object();
+        for (int i = 0; i < large; ++i) obj = mlc::json::json_set(std::move(obj), keys[i], mlc::json::JsonValue(static_cast<double>(i)));
+        check(obj, large);
+    });
+    report("json_array_push, moved", large, push_s);
+    report("JsonBuilder::push", large, builder_s);
+    report("json_set, moved", large, set_s);
+    return 0;
+}
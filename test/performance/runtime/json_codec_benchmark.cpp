@@ -0,0 +1,134 @@
+// Decoding a JSON API payload into typed records: parse_json and a walk
+// over the DOM with get()/as_*() (what hand-written MLC decoding does)
+// versus the derived codec, which reads the text straight into the structs
+// and dispatches field names through a perfect hash. Encoding the records
+// back is compared with stringify_json on the DOM.
+
+#include "../../../runtime/mlc_json_codec.hpp"
+#include "bench_util.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct Address {
+    mlc::String city;
+    mlc::String zip;
+    std::vector<double> geo;
+};
+
+struct Order {
+    mlc::String sku;
+    int32_t qty;
+    double price;
+};
+
+struct User {
+    int64_t id;
+    mlc::String name;
+    mlc::String email;
+    bool active;
+    double balance;
+    double score;
+    std::vector<mlc::String> tags;
+    Address address;
+    std::vector<Order> orders;
+    mlc::json::JsonValue manager;
+};
+
+// What `derive Json` emits for these types (at namespace scope, as generated
+// code is: the hooks are only declared, so they must not have internal linkage)
+mlc::json::RecordCodec<Address, mlc::json::Field<"city", &Address::city>, mlc::json::Field<"zip", &Address::zip>,
+                       mlc::json::Field<"geo", &Address::geo>>
+mlc_json_codec(const Address*);
+mlc::json::RecordCodec<Order, mlc::json::Field<"sku", &Order::sku>, mlc::json::Field<"qty", &Order::qty>,
+                       mlc::json::Field<"price", &Order::price>>
+mlc_json_codec(const Order*);
+mlc::json::RecordCodec<User, mlc::json::Field<"id", &User::id>, mlc::json::Field<"name", &User::name>,
+                       mlc::json::Field<"email", &User::email>, mlc::json::Field<"active", &User::active>,
+                       mlc::json::Field<"balance", &User::balance>, mlc::json::Field<"score", &User::score>,
+                       mlc::json::Field<"tags", &User::tags>, mlc::json::Field<"address", &User::address>,
+                       mlc::json::Field<"orders", &User::orders>, mlc::json::Field<"manager", &User::manager>>
+mlc_json_codec(const User*);
+
+namespace {
+
+mlc::String field_string(const mlc::json::JsonValue& obj, const char* key) {
+    return obj.get(key)->as_string().value_or(mlc::String());
+}
+
+double field_number(const mlc::json::JsonValue& obj, const char* key) {
+    return obj.get(key)->as_number().value_or(0);
+}
+
+std::vector<mlc::json::JsonValue> items(const mlc::json::JsonValue& array) {
+    return array.as_array().value_or(std::vector<mlc::json::JsonValue>());
+}
+
+// Decoding by hand over the DOM
+std::vector<User> users_from_dom(const mlc::json::JsonValue& doc) {
+    std::vector<User> users;
+    for (const auto& item : items(doc)) {
+        User& user = users.emplace_back();
+        user.id = static_cast<int64_t>(field_number(item, "id"));
+        user.name = field_string(item, "name");
+        user.email = field_string(item, "email");
+        user.active = item.get("active")->as_bool().value_or(false);
+        user.balance = field_number(item, "balance");
+        user.score = field_number(item, "score");
+        for (const auto& tag : items(*item.get("tags"))) user.tags.push_back(tag.as_string().value_or(mlc::String()));
+        auto address = *item.get("address");
+        user.address.city = field_string(address, "city");
+        user.address.zip = field_string(address, "zip");
+        for (const auto& x : items(*address.get("geo"))) user.address.geo.push_back(x.as_number().value_or(0));
+        for (const auto& entry : items(*item.get("orders"))) {
+            user.orders.push_back({field_string(entry, "sku"), static_cast<int32_t>(field_number(entry, "qty")),
+                                   field_number(entry, "price")});
+        }
+        user.manager = *item.get("manager");
+    }
+    return users;
+}
+
+double checksum(const std::vector<User>& users) {
+    double sum = 0;
+    for (const auto& user : users) {
+        sum += static_cast<double>(user.id) + user.balance + static_cast<double>(user.tags.size() + user.name.length());
+        for (const auto& order : user.orders) sum += order.qty * order.price;
+    }
+    return sum;
+}
+
+} // namespace
+
+int main() {
+    const std::string payload = bench::make_json_payload(50 * 1024 * 1024);
+    const mlc::String text(payload);
+    const double bytes = static_cast<double>(payload.size());
+    std::printf("payload: %.1f MB\n", bytes / 1e6);
+
+    std::vector<User> by_hand, typed;
+    double dom_s = bench::best_of(3, [&] { by_hand = users_from_dom(mlc::json::parse_json(text)); });
+    bench::report("parse_json + get()/as_*()", bytes, dom_s);
+    double codec_s = bench::best_of(3, [&] {
+        typed.clear();
+        if (!mlc::json::decode(payload, typed)) std::exit(1);
+    });
+    bench::report("derived codec decode", bytes, codec_s);
+    bench::report_speedup("speedup", dom_s, codec_s);
+
+    if (by_hand.size() != typed.size() || checksum(by_hand) != checksum(typed)) {
+        std::fprintf(stderr, "decoded records differ: %zu vs %zu\n", by_hand.size(), typed.size());
+        return 1;
+    }
+
+    const mlc::json::JsonValue doc = mlc::json::parse_json(text);
+    size_t out_size = 0;
+    double stringify_s = bench::best_of(3, [&] { out_size = mlc::json::stringify_json(doc).as_std_string().size(); });
+    bench::report("stringify_json (DOM)", static_cast<double>(out_size), stringify_s);
+    double encode_s = bench::best_of(3, [&] { out_size = mlc::json::encode(typed).as_std_string().size(); });
+    bench::report("derived codec encode", static_cast<double>(out_size), encode_s);
+    bench::report_speedup("speedup", stringify_s, encode_s);
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Reading three fields from a 50 KB JSON response: parse_json + json_get
+// (full DOM) versus json_lazy cursors, which check the document's strings
+// and brackets once and skip everything else.
+
+#include "../../../runtime/mlc_json_lazy.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <string>
+
+int main() {
+    const mlc::String response("{\"request_id\": \"req-8f3a\", \"items\": " + bench::make_json_payload(50 * 1024) +
+                               ", \"status\": {\"code\": 200, \"message\": \"ok\"}}");
+    const int iterations = 4000;
+    double bytes = static_cast<double>(response.as_std_string().size()) * iterations;
+    std::printf("document: %.1f KB x %d\n", static_cast<double>(response.as_std_string().size()) / 1024, iterations);
+
+    double dom_sum = 0;
+    double dom_s = bench::best_of(3, [&] {
+        dom_sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            mlc::json::JsonValue doc = mlc::json::parse_json(response);
+            dom_sum += doc.get("status")->get("code")->as_number().value_or(0);
+            dom_sum += doc.get("items")->at(0)->get("id")->as_number().value_or(0);
+            dom_sum += doc.get("request_id")->string_view()->size();
+        }
+    });
+    bench::report("parse_json + json_get", bytes, dom_s);
+
+    double lazy_sum = 0;
+    double lazy_s = bench::best_of(3, [&] {
+        lazy_sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            mlc::json::LazyValue doc = mlc::json::json_lazy(response);
+            lazy_sum += doc.get("status").get("code").as_number().value_or(0);
+            lazy_sum += doc.get("items").at(0).get("id").as_number().value_or(0);
+            lazy_sum += doc.get("request_id").as_string().value_or(mlc::String("")).as_std_string().size();
+        }
+    });
+    if (lazy_sum != dom_sum) {
+        std::fprintf(stderr, "field mismatch: %f vs %f\n", lazy_sum, dom_sum);
+        return 1;
+    }
+    bench::report("json_lazy", bytes, lazy_s);
+    bench::report_speedup("speedup", dom_s, lazy_s);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Serializing JSON: nlohmann::json::dump (the previous stringify_json
+// backend) versus mlc::json::stringify_json on a parsed API payload, the
+// escape scan on each kernel, and JsonWriter streaming records to a file
+// descriptor versus building a tree first.
+
+#include "../../../runtime/json.hpp"
+#include "../../../runtime/mlc_json.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+int main() {
+    const std::string payload = bench::make_json_payload(50 * 1024 * 1024);
+    const nlohmann::ordered_json tree = nlohmann::ordered_json::parse(payload);
+    const mlc::json::JsonValue doc = mlc::json::parse_json(mlc::String(payload));
+    size_t out_size = 0;
+    std::printf("payload: %.1f MB\n", static_cast<double>(payload.size()) / 1e6);
+
+    double nlohmann_s = bench::best_of(3, [&] { out_size = tree.dump().size(); });
+    double bytes = static_cast<double>(out_size);
+    bench::report("nlohmann::json::dump", bytes, nlohmann_s);
+    double mlc_s = bench::best_of(3, [&] { out_size = mlc::json::stringify_json(doc).as_std_string().size(); });
+    bench::report("stringify_json", static_cast<double>(out_size), mlc_s);
+    bench::report_speedup("speedup", nlohmann_s, mlc_s);
+
+    double nlohmann_pretty_s = bench::best_of(3, [&] { out_size = tree.dump(2).size(); });
+    bench::report("nlohmann::json::dump(2)", static_cast<double>(out_size), nlohmann_pretty_s);
+    double mlc_pretty_s = bench::best_of(3, [&] { out_size = mlc::json::stringify_json_pretty(doc, 2).as_std_string().size(); });
+    bench::report("stringify_json_pretty(2)", static_cast<double>(out_size), mlc_pretty_s);
+    bench::report_speedup("speedup", nlohmann_pretty_s, mlc_pretty_s);
+
+    // Long prose with occasional quotes and newlines
+    std::mt19937 rng(7);
+    std::string prose;
+    while (prose.size() < 64 * 1024 * 1024) {
+        for (uint32_t i = 0, n = 2 + rng() % 8; i < n; ++i) prose += static_cast<char>('a' + rng() % 26);
+        prose += rng() % 200 == 0 ? '\n' : rng() % 300 == 0 ? '"' : ' ';
+    }
+    auto count_escapes = [&](size_t (*find)(const char*, size_t)) {
+        size_t count = 0;
+        for (size_t i = 0; i < prose.size(); ++count) i += find(prose.data() + i, prose.size() - i) + 1;
+        return count;
+    };
+    size_t scalar_count = 0, simd_count = 0;
+    double scalar_s = bench::best_of(3, [&] { scalar_count = count_escapes(mlc::json::simd::find_escape_scalar); });
+    double simd_s = bench::best_of(3, [&] { simd_count = count_escapes(mlc::json::simd::find_escape); });
+    if (scalar_count != simd_count) {
+        std::fprintf(stderr, "escape count mismatch: %zu vs %zu\n", scalar_count, simd_count);
+        return 1;
+    }
+    bench::report("escape scan (scalar)", static_cast<double>(prose.size()), scalar_s);
+    bench::report("escape scan (best kernel)", static_cast<double>(prose.size()), simd_s);
+
+    // One million records, streamed versus built as a tree and dumped
+    const int records = 1000000;
+    int null_fd = ::open("/dev/null", O_WRONLY);
+    double tree_s = bench::best_of(3, [&] {
+        nlohmann::ordered_json all = nlohmann::ordered_json::array();
+        for (int i = 0; i < records; ++i) {
+            all.push_back({{"id", i}, {"name", "user-" + std::to_string(i)}, {"score", i * 0.25}, {"tags", {"a", "b"}}});
+        }
+        std::string text = all.dump();
+        out_size = text.size();
+        if (::write(null_fd, text.data(), text.size()) < 0) std::exit(1);
+    });
+    bench::report("nlohmann tree + dump", static_cast<double>(out_size), tree_s);
+    double stream_s = bench::best_of(3, [&] {
+        mlc::json::JsonWriter writer(mlc::json::JsonWriter::Fd{null_fd});
+        writer.begin_array();
+        for (int i = 0; i < records; ++i) {
+            writer.begin_object().key("id").value(i).key("name").value("user-" + std::to_string(i));
+            writer.key("score").value(i * 0.25).key("tags").begin_array().value("a").value("b").end_array();
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.flush();
+    });
+    bench::report("JsonWriter to fd", static_cast<double>(out_size), stream_s);
+    bench::report_speedup("speedup", tree_s, stream_s);
+    ::close(null_fd);
+    return 0;
+}
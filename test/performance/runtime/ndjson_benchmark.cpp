@@ -0,0 +1,91 @@
+// Reading a large JSON Lines log: read_lines + parse_json per line on one
+// core versus NdjsonReader (mmap, ~1 MB chunks parsed on worker threads,
+// one arena per chunk) at increasing thread counts.
+
+#include "../../../runtime/mlc_json_ndjson.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// One API event per line
+std::string make_events(size_t target_bytes) {
+    static const char* methods[] = {"GET", "POST", "PUT", "DELETE"};
+    static const char* paths[] = {"/api/users", "/api/orders", "/health", "/api/items/search"};
+    std::mt19937 rng(42);
+    std::string out;
+    while (out.size() < target_bytes) {
+        out += "{\"ts\": " + std::to_string(1700000000 + rng() % 1000000) + ", \"method\": \"" + methods[rng() % 4] +
+               "\", \"path\": \"" + paths[rng() % 4] + "\", \"status\": " + std::to_string(rng() % 10 == 0 ? 500 : 200) +
+               ", \"latency_ms\": " + std::to_string(rng() % 2000) + ", \"user\": {\"id\": " +
+               std::to_string(rng() % 100000) + ", \"tags\": [\"beta\", \"eu\"]}}\n";
+    }
+    return out;
+}
+
+// Records with status 500, so every record is actually looked at
+size_t count_errors(const std::vector<mlc::json::JsonValue>& records) {
+    size_t errors = 0;
+    for (const auto& record : records) {
+        auto status = record.get("status");
+        errors += status && status->as_number().value_or(0) == 500;
+    }
+    return errors;
+}
+
+} // namespace
+
+int main() {
+    const mlc::String path("ndjson_input.jsonl");
+    std::string events = make_events(128 * 1024 * 1024);
+    {
+        std::ofstream out(path.as_std_string(), std::ios::binary);
+        out << events;
+    }
+    double bytes = static_cast<double>(events.size());
+    events.clear();
+    events.shrink_to_fit();
+    std::printf("%.1f MB, %u hardware threads\n", bytes / 1e6, std::thread::hardware_concurrency());
+
+    size_t expected = 0;
+    double baseline_s = bench::best_of(2, [&] {
+        std::vector<mlc::json::JsonValue> records;
+        for (const auto& line : mlc::file::read_lines(path)) records.push_back(mlc::json::parse_json(line));
+        expected = count_errors(records);
+    });
+    bench::report("read_lines + parse_json", bytes, baseline_s);
+
+    unsigned hw = std::thread::hardware_concurrency();
+    std::vector<int> thread_counts = {1, 2, 4};
+    if (hw > 4) thread_counts.push_back(static_cast<int>(hw));
+
+    for (int threads : thread_counts) {
+        size_t errors = 0;
+        double read_s = bench::best_of(3, [&] { errors = count_errors(mlc::json::ndjson_read(path, threads)); });
+        double batch_s = bench::best_of(3, [&] {
+            errors = 0;
+            mlc::json::NdjsonReader reader(path.as_std_string(), threads);
+            while (!reader.done()) errors += count_errors(reader.next_batch());
+        });
+        if (errors != expected) {
+            std::fprintf(stderr, "record mismatch with %d threads: %zu vs %zu\n", threads, errors, expected);
+            return 1;
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "ndjson_read, %d thread%s", threads, threads == 1 ? "" : "s");
+        bench::report(label, bytes, read_s);
+        std::snprintf(label, sizeof(label), "next_batch loop, %d thread%s", threads, threads == 1 ? "" : "s");
+        bench::report(label, bytes, batch_s);
+        bench::report_speedup("speedup", baseline_s, batch_s);
+    }
+
+    std::remove(path.as_std_string().c_str());
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Printing many short lines into a pipe, as in `mlc prog.mlc | grep ...`:
+// the previous println (std::cout, flushed after every call, so one write
+// per line) versus the buffered println and print_many. fd 1 is pointed at
+// a pipe drained by a reader thread while each variant runs.
+
+#include "../../../runtime/mlc_io.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int kLines = 2000000;
+
+// Runs fn with stdout redirected into a pipe; returns the bytes that came out
+double to_pipe(const std::function<void()>& fn) {
+    std::fflush(stdout);
+    int fds[2];
+    if (::pipe(fds) != 0) std::exit(1);
+    int saved = ::dup(STDOUT_FILENO);
+    ::dup2(fds[1], STDOUT_FILENO);
+    ::close(fds[1]);
+
+    size_t total = 0;
+    std::thread reader([&] {
+        std::vector<char> chunk(1 << 20);
+        ssize_t n;
+        while ((n = ::read(fds[0], chunk.data(), chunk.size())) > 0) total += static_cast<size_t>(n);
+    });
+    fn();
+    ::dup2(saved, STDOUT_FILENO);
+    ::close(saved);
+    reader.join();
+    ::close(fds[0]);
+    return static_cast<double>(total);
+}
+
+} // namespace
+
+int main() {
+    std::vector<mlc::String> lines;
+    lines.reserve(kLines);
+    for (int i = 0; i < kLines; ++i) lines.emplace_back("event " + std::to_string(i) + " status=ok latency_ms=12");
+
+    double bytes = 0;
+    double flushed_s = bench::best_of(1, [&] {
+        bytes = to_pipe([&] {
+            for (const auto& line : lines) std::cout << line.as_std_string() << '\n' << std::flush;
+        });
+    });
+    bench::report("std::cout, flush per line", bytes, flushed_s);
+
+    // The pipe is not a terminal, so stdout is block-buffered
+    double println_s = bench::best_of(3, [&] {
+        bytes = to_pipe([&] {
+            for (const auto& line : lines) mlc::io::println(line);
+            mlc::io::flush();
+        });
+    });
+    bench::report("buffered println", bytes, println_s);
+    bench::report_speedup("speedup", flushed_s, println_s);
+
+    double many_s = bench::best_of(3, [&] {
+        bytes = to_pipe([&] {
+            mlc::io::print_many(lines);
+            mlc::io::flush();
+        });
+    });
+    bench::report("print_many", bytes, many_s);
+    bench::report_speedup("speedup", flushed_s, many_s);
+
+    mlc::io::set_flush_policy(1, mlc::io::FlushPolicy::Line);
+    double line_s = bench::best_of(1, [&] {
+        bytes = to_pipe([&] {
+            for (const auto& line : lines) mlc::io::println(line);
+        });
+    });
+    bench::report("println, line-buffered (terminal)", bytes, line_s);
+    return 0;
+}
@@ -0,0 +1,235 @@
+// Regex throughput: in-tree linear-time engine (runtime/mlc_regex_engine.hpp)
+// versus std::regex on log-scanning patterns, one line at a time, plus the
+// compile-time matchers from runtime/mlc_regex_static.hpp.
+
+#include "../../../runtime/mlc_regex.hpp"
+#include "../../../runtime/mlc_regex_static.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        lines.emplace_back(text, start, end - start);
+        start = end + 1;
+    }
+    return lines;
+}
+
+void bench_pattern(const char* pattern, const std::vector<std::string>& lines, double bytes) {
+    std::regex std_re(pattern);
+    mlc::Regex re{mlc::String(pattern)};
+    std::vector<mlc::String> texts(lines.begin(), lines.end());
+
+    size_t std_hits = 0, hits = 0;
+    double std_test_s = bench::best_of(2, [&] {
+        std_hits = 0;
+        for (const auto& line : lines) std_hits += std::regex_search(line, std_re);
+    });
+    double test_s = bench::best_of(3, [&] {
+        hits = 0;
+        for (const auto& line : texts) hits += re.test(line);
+    });
+
+    size_t std_captures = 0, captures = 0;
+    double std_match_s = bench::best_of(2, [&] {
+        std::smatch sm;
+        std_captures = 0;
+        for (const auto& line : lines) {
+            if (std::regex_search(line, sm, std_re)) std_captures += static_cast<size_t>(sm.length(0));
+        }
+    });
+    double match_s = bench::best_of(3, [&] {
+        captures = 0;
+        for (const auto& line : texts) {
+            if (auto m = re.match(line)) captures += m->end() - m->start();
+        }
+    });
+
+    if (hits != std_hits || captures != std_captures) {
+        std::fprintf(stderr, "result mismatch for /%s/: %zu/%zu vs %zu/%zu\n", pattern, hits, captures, std_hits,
+                     std_captures);
+        std::exit(1);
+    }
+
+    std::printf("/%s/ (%zu of %zu lines match):\n", pattern, hits, lines.size());
+    bench::report("std::regex test", bytes, std_test_s);
+    bench::report("mlc::Regex test (lazy DFA)", bytes, test_s);
+    bench::report_speedup("test speedup", std_test_s, test_s);
+    bench::report("std::regex match", bytes, std_match_s);
+    bench::report("mlc::Regex match (PikeVM)", bytes, match_s);
+    bench::report_speedup("match speedup", std_match_s, match_s);
+}
+
+// match_all / replace_all over the whole log as one string. Patterns with a
+// literal prefix or required substring are prefiltered with memchr.
+void bench_scan(const char* pattern, const std::string& log) {
+    std::regex std_re(pattern);
+    mlc::Regex re{mlc::String(pattern)};
+    mlc::String text(log);
+    double bytes = static_cast<double>(log.size());
+
+    size_t std_count = 0, count = 0;
+    double std_all_s = bench::best_of(2, [&] {
+        std_count = static_cast<size_t>(std::distance(std::sregex_iterator(log.begin(), log.end(), std_re),
+                                                      std::sregex_iterator()));
+    });
+    double all_s = bench::best_of(3, [&] { count = re.match_all(text).size(); });
+    size_t each_count = 0;
+    double each_s = bench::best_of(3, [&] {
+        each_count = 0;
+        re.for_each_match(text, [&](const mlc::Match& m) { each_count += m.capture_count() + 1; });
+    });
+
+    std::string std_replaced;
+    mlc::String replaced;
+    double std_replace_s = bench::best_of(2, [&] { std_replaced = std::regex_replace(log, std_re, "<$&>"); });
+    double replace_s = bench::best_of(3, [&] { replaced = re.replace_all(text, mlc::String("<$&>")); });
+
+    if (count != std_count || each_count < count || replaced.as_std_string() != std_replaced) {
+        std::fprintf(stderr, "scan mismatch for /%s/: %zu vs %zu\n", pattern, count, std_count);
+        std::exit(1);
+    }
+
+    std::printf("/%s/ over the whole log (%zu matches):\n", pattern, count);
+    bench::report("std::sregex_iterator", bytes, std_all_s);
+    bench::report("mlc::Regex match_all", bytes, all_s);
+    bench::report_speedup("match_all speedup", std_all_s, all_s);
+    bench::report("mlc::Regex for_each_match", bytes, each_s);
+    bench::report_speedup("for_each_match speedup", std_all_s, each_s);
+    bench::report("std::regex_replace", bytes, std_replace_s);
+    bench::report("mlc::Regex replace_all", bytes, replace_s);
+    bench::report_speedup("replace_all speedup", std_replace_s, replace_s);
+}
+
+// A multi-arm `match` over log lines: one RegexSet pass versus testing each
+// arm in turn (the lowering before RegexSet)
+void bench_set(const std::vector<std::string>& lines, double bytes) {
+    std::vector<mlc::Regex> arms = {
+        mlc::regex(mlc::String("status=5\\d\\d")),
+        mlc::regex(mlc::String("latency_ms=1\\d{3}")),
+        mlc::regex(mlc::String("path=/api/items/search")),
+        mlc::regex(mlc::String("^2025-10-0[1-7] ")),
+        mlc::regex_i(mlc::String("debug")),
+    };
+    mlc::RegexSet set(arms);
+    std::vector<mlc::String> texts(lines.begin(), lines.end());
+
+    size_t sequential_sum = 0, set_sum = 0;
+    double sequential_s = bench::best_of(3, [&] {
+        sequential_sum = 0;
+        for (const auto& line : texts) {
+            for (size_t i = 0; i < arms.size(); ++i) {
+                if (arms[i].test(line)) {
+                    sequential_sum += i + 1;
+                    break;
+                }
+            }
+        }
+    });
+    double set_s = bench::best_of(3, [&] {
+        set_sum = 0;
+        for (const auto& line : texts) set_sum += static_cast<size_t>(set.first_match(line) + 1);
+    });
+
+    if (sequential_sum != set_sum) {
+        std::fprintf(stderr, "regex set mismatch: %zu vs %zu\n", sequential_sum, set_sum);
+        std::exit(1);
+    }
+
+    std::printf("%zu-arm match:\n", arms.size());
+    bench::report("sequential Regex::test", bytes, sequential_s);
+    bench::report("RegexSet::first_match", bytes, set_s);
+    bench::report_speedup("set speedup", sequential_s, set_s);
+}
+
+// Compile-time matcher (what `mlc --static-regex` emits) versus the runtime engine
+template <typename Static>
+void bench_static(const char* pattern, const std::vector<std::string>& lines, double bytes) {
+    mlc::Regex re{mlc::String(pattern)};
+    constexpr Static ct_re{};
+    std::vector<mlc::String> texts(lines.begin(), lines.end());
+
+    size_t hits = 0, ct_hits = 0;
+    double test_s = bench::best_of(3, [&] {
+        hits = 0;
+        for (const auto& line : texts) hits += re.test(line);
+    });
+    double ct_test_s = bench::best_of(3, [&] {
+        ct_hits = 0;
+        for (const auto& line : texts) ct_hits += ct_re.test(line);
+    });
+
+    size_t captures = 0, ct_captures = 0;
+    double match_s = bench::best_of(3, [&] {
+        captures = 0;
+        for (const auto& line : texts) {
+            if (auto m = re.match(line)) captures += m->end() - m->start() + m->capture_count();
+        }
+    });
+    double ct_match_s = bench::best_of(3, [&] {
+        ct_captures = 0;
+        for (const auto& line : texts) {
+            if (auto m = ct_re.match(line)) ct_captures += m->end() - m->start() + m->capture_count();
+        }
+    });
+
+    if (hits != ct_hits || captures != ct_captures) {
+        std::fprintf(stderr, "static mismatch for /%s/: %zu/%zu vs %zu/%zu\n", pattern, ct_hits, ct_captures, hits,
+                     captures);
+        std::exit(1);
+    }
+
+    std::printf("/%s/ static:\n", pattern);
+    bench::report("mlc::Regex test", bytes, test_s);
+    bench::report("mlc::ct::Regex test", bytes, ct_test_s);
+    bench::report_speedup("test speedup", test_s, ct_test_s);
+    bench::report("mlc::Regex match", bytes, match_s);
+    bench::report("mlc::ct::Regex match", bytes, ct_match_s);
+    bench::report_speedup("match speedup", match_s, ct_match_s);
+}
+
+using Digit = mlc::ct::Class<mlc::ct::Range<'0', '9'>>;
+using Digits = mlc::ct::Repeat<1, mlc::ct::kInf, Digit>;
+
+// /status=5\d\d/
+using StaticStatus = mlc::ct::Regex<mlc::ct::Seq<mlc::ct::Lit<'s', 't', 'a', 't', 'u', 's', '=', '5'>, Digit, Digit>, 0>;
+
+// /user_id=(\d+) status=(\d+)/
+using StaticUserStatus =
+    mlc::ct::Regex<mlc::ct::Seq<mlc::ct::Lit<'u', 's', 'e', 'r', '_', 'i', 'd', '='>, mlc::ct::Group<1, Digits>,
+                                mlc::ct::Lit<' ', 's', 't', 'a', 't', 'u', 's', '='>, mlc::ct::Group<2, Digits>>,
+                   2>;
+
+} // namespace
+
+int main() {
+    std::string log = bench::make_log(8 * 1024 * 1024);
+    std::vector<std::string> lines = split_lines(log);
+    double bytes = static_cast<double>(log.size());
+
+    const char* patterns[] = {
+        "ERROR",
+        "status=5\\d\\d",
+        "user_id=(\\d+) status=(\\d+)",
+        "path=(/api/[a-z]+)(/[a-z]+)?",
+        "^2025-10-(\\d{2}) (\\d{2}):(\\d{2})",
+        "(WARN|ERROR) .*latency_ms=\\d{4}",
+    };
+    for (const char* pattern : patterns) bench_pattern(pattern, lines, bytes);
+    bench_scan("user_id=(\\d+)", log);
+    bench_scan("latency_ms=1\\d{3}", log);
+    bench_set(lines, bytes);
+    bench_static<StaticStatus>("status=5\\d\\d", lines, bytes);
+    bench_static<StaticUserStatus>("user_id=(\\d+) status=(\\d+)", lines, bytes);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Grepping a large log file: read_lines + Regex::test on one core versus
+// file::regex_scan_file (mmap, line-aligned chunks, worker threads).
+
+#include "../../../runtime/mlc_file_scan.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void bench_scan(const char* pattern, const mlc::String& path, double bytes) {
+    mlc::Regex re{mlc::String(pattern)};
+
+    size_t baseline_hits = 0;
+    double baseline_s = bench::best_of(2, [&] {
+        baseline_hits = 0;
+        for (const auto& line : mlc::file::read_lines(path)) baseline_hits += re.test(line);
+    });
+
+    std::printf("/%s/ (%zu matching lines):\n", pattern, baseline_hits);
+    bench::report("read_lines + Regex::test", bytes, baseline_s);
+
+    unsigned hw = std::thread::hardware_concurrency();
+    std::vector<int> thread_counts = {1, 2, 4};
+    if (hw > 4) thread_counts.push_back(static_cast<int>(hw));
+
+    for (int threads : thread_counts) {
+        size_t hits = 0;
+        double scan_s = bench::best_of(3, [&] { hits = mlc::file::regex_scan_file(path, re, threads).size(); });
+        if (hits != baseline_hits) {
+            std::fprintf(stderr, "scan mismatch for /%s/ with %d threads: %zu vs %zu\n", pattern, threads, hits,
+                         baseline_hits);
+            std::exit(1);
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "regex_scan_file, %d thread%s", threads, threads == 1 ? "" : "s");
+        bench::report(label, bytes, scan_s);
+        bench::report_speedup("speedup", baseline_s, scan_s);
+    }
+}
+
+} // namespace
+
+int main() {
+    const mlc::String path("scan_input.log");
+    std::string log = bench::make_log(128 * 1024 * 1024);
+    {
+        std::ofstream out(path.as_std_string(), std::ios::binary);
+        out << log;
+    }
+    double bytes = static_cast<double>(log.size());
+    log.clear();
+    log.shrink_to_fit();
+
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    bench_scan("ERROR .*status=5\\d\\d", path, bytes);
+    bench_scan("latency_ms=19\\d\\d", path, bytes);
+    bench_scan("(WARN|ERROR) .*latency_ms=\\d{4}", path, bytes);
+
+    std::remove(path.as_std_string().c_str());
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Reading a large log from stdin, as in `cat app.log | mlc prog.mlc`: the
+// previous read_line (std::getline on std::cin with stdio sync on) and
+// read_all (std::cin.rdbuf() into an ostringstream) versus the read(2)
+// refill buffer behind read_line, stdin_lines and read_all. fd 0 is pointed
+// at a temporary file, or at a pipe fed by a writer thread, for each variant.
+
+#include "../../../runtime/mlc_io.hpp"
+#include "bench_util.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// Runs fn with stdin reading the file from the start
+void from_file(const char* path, const std::function<void()>& fn) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) std::exit(1);
+    ::dup2(fd, STDIN_FILENO);
+    ::close(fd);
+    std::clearerr(stdin);
+    std::cin.clear();
+    fn();
+}
+
+// Runs fn with stdin reading a pipe that a thread fills with data
+void from_pipe(const std::string& data, const std::function<void()>& fn) {
+    int fds[2];
+    if (::pipe(fds) != 0) std::exit(1);
+    ::dup2(fds[0], STDIN_FILENO);
+    ::close(fds[0]);
+    std::thread writer([&] {
+        const char* p = data.data();
+        size_t left = data.size();
+        while (left > 0) {
+            ssize_t n = ::write(fds[1], p, left);
+            if (n <= 0) break;
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        ::close(fds[1]);
+    });
+    std::clearerr(stdin);
+    std::cin.clear();
+    fn();
+    writer.join();
+}
+
+} // namespace
+
+int main() {
+    const std::string log = bench::make_log(100 * 1024 * 1024);
+    const double bytes = static_cast<double>(log.size());
+    char path[] = "/tmp/mlc_stdin_benchmark_XXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd < 0 || ::write(fd, log.data(), log.size()) != static_cast<ssize_t>(log.size())) return 1;
+    ::close(fd);
+    std::printf("input: %.1f MB\n", bytes / 1e6);
+
+    size_t total = 0;
+    double getline_s = bench::best_of(1, [&] {
+        from_file(path, [&] {
+            total = 0;
+            std::string line;
+            while (std::getline(std::cin, line)) total += line.size() + 1;
+        });
+    });
+    bench::report("std::getline(std::cin)", bytes, getline_s);
+    const size_t expected = total;
+
+    double read_line_s = bench::best_of(3, [&] {
+        from_file(path, [&] {
+            total = 0;
+            // read_line cannot tell an empty line from the end of input
+            for (size_t seen = 0; seen < log.size(); seen = total) total += mlc::io::read_line().as_std_string().size() + 1;
+        });
+    });
+    bench::report("read_line", bytes, read_line_s);
+    bench::report_speedup("speedup", getline_s, read_line_s);
+
+    double lines_s = bench::best_of(3, [&] {
+        from_file(path, [&] {
+            total = 0;
+            for (std::string_view line : mlc::io::stdin_lines()) total += line.size() + 1;
+        });
+    });
+    bench::report("stdin_lines (views)", bytes, lines_s);
+    bench::report_speedup("speedup", getline_s, lines_s);
+    if (total != expected) {
+        std::fprintf(stderr, "line totals differ: %zu vs %zu\n", total, expected);
+        return 1;
+    }
+
+    double lines_pipe_s = bench::best_of(3, [&] {
+        from_pipe(log, [&] {
+            total = 0;
+            for (std::string_view line : mlc::io::stdin_lines()) total += line.size() + 1;
+        });
+    });
+    bench::report("stdin_lines from a pipe", bytes, lines_pipe_s);
+
+    double rdbuf_s = bench::best_of(1, [&] {
+        from_file(path, [&] {
+            std::ostringstream oss;
+            oss << std::cin.rdbuf();
+            total = oss.str().size();
+        });
+    });
+    bench::report("std::cin.rdbuf() into ostringstream", bytes, rdbuf_s);
+
+    double all_s = bench::best_of(3, [&] {
+        from_file(path, [&] { total = mlc::io::read_all().as_std_string().size(); });
+    });
+    bench::report("read_all, regular file", bytes, all_s);
+    bench::report_speedup("speedup", rdbuf_s, all_s);
+
+    double all_pipe_s = bench::best_of(3, [&] {
+        from_pipe(log, [&] { total = mlc::io::read_all().as_std_string().size(); });
+    });
+    bench::report("read_all from a pipe", bytes, all_pipe_s);
+
+    ::unlink(path);
+    return total == log.size() ? 0 : 1;
+}
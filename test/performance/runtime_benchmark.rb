@@ -0,0 +1,52 @@
+# frozen_string_literal: true
+
+require "benchmark"
+require "open3"
+require "tmpdir"
+require_relative "../test_helper"
+
+# Builds and runs the C++ runtime throughput benchmarks in test/performance/runtime.
+# Each *_benchmark.cpp is a standalone program that prints its own report.
+#
+#   ruby -Itest test/performance/runtime_benchmark.rb
+#   ruby -Itest test/performance/runtime_benchmark.rb -n /compress/
+class RuntimeBenchmark < Minitest::Test
+  RUNTIME_DIR = File.expand_path("../../runtime", __dir__)
+  BENCH_DIR = File.expand_path("runtime", __dir__)
+  RUNTIME_SOURCES = %w[mlc_string.cpp mlc_io.cpp].map { |f| File.join(RUNTIME_DIR, f) }.freeze
+
+  Dir.glob(File.join(BENCH_DIR, "*_benchmark.cpp")).sort.each do |bench|
+    name = File.basename(bench, "_benchmark.cpp")
+
+    define_method("test_#{name}_benchmark") do
+      skip_unless_compiler_available
+      run_benchmark(bench)
+    end
+  end
+
+  private
+
+  def run_benchmark(source)
+    Dir.mktmpdir("mlc-bench") do |dir|
+      binary = File.join(dir, File.basename(source, ".cpp"))
+      compiler = ENV.fetch("CXX", "g++")
+      compile_cmd = [compiler, "-std=c++20", "-O2", "-pthread", "-I", RUNTIME_DIR, source, *RUNTIME_SOURCES, "-o", binary]
+
+      _stdout, stderr, status = Open3.capture3(*compile_cmd)
+      assert status.success?, "Benchmark failed to compile:\n#{stderr}"
+
+      puts "\n=== #{File.basename(source)} ==="
+      elapsed = Benchmark.realtime do
+        stdout, stderr, status = Open3.capture3(binary, chdir: dir)
+        puts stdout
+        assert status.success?, "Benchmark failed:\n#{stderr}"
+      end
+      puts "Total: #{elapsed.round(2)}s"
+    end
+  end
+
+  def skip_unless_compiler_available
+    compiler = ENV.fetch("CXX", "g++")
+    skip "C++ compiler (#{compiler}) not available" unless system("#{compiler} --version > /dev/null 2>&1")
+  end
+end
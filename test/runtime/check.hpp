@@ -0,0 +1,51 @@
+#ifndef MLC_RUNTIME_CHECK_HPP
+#define MLC_RUNTIME_CHECK_HPP
+
+// Shared helpers for the runtime tests. Each *_test.cpp is a standalone
+// program; a failed check prints where and why and the program exits with
+// check::result().
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+namespace check {
+
+inline int failures = 0;
+
+inline void fail(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+    ++failures;
+}
+
+template <typename T>
+std::string show(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+inline int result() {
+    if (failures > 0) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace check
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) check::fail(__FILE__, __LINE__, "CHECK(" #cond ")"); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                       \
+    do {                                                                                                 \
+        const auto& check_actual_ = (actual);                                                            \
+        const auto& check_expected_ = (expected);                                                        \
+        if (!(check_actual_ == check_expected_)) {                                                       \
+            check::fail(__FILE__, __LINE__,                                                              \
+                        #actual " == " #expected ": got " + check::show(check_actual_) + ", expected " + \
+                            check::show(check_expected_));                                               \
+        }                                                                                                \
+    } while (0)
+
+#endif // MLC_RUNTIME_CHECK_HPP
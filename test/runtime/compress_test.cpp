@@ -0,0 +1,99 @@
+// Size-prefixed LZ4 blocks: compress/decompress must round-trip, and a
+// corrupted size prefix must be rejected before anything is allocated for it.
+
+#include "../../runtime/mlc_compress.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace compress = mlc::compress;
+
+namespace {
+
+std::vector<uint8_t> bytes_of(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// The message decompress_prefixed throws for `block`, or "" if it succeeds
+std::string rejection(const std::vector<uint8_t>& block) {
+    try {
+        compress::detail::decompress_prefixed(block.data(), block.size());
+        return "";
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+}
+
+void set_prefix(std::vector<uint8_t>& block, uint32_t size) {
+    compress::detail::write_le32(block.data(), size);
+}
+
+void test_round_trips() {
+    std::mt19937 rng(7);
+    std::string random(100000, '\0');
+    for (char& c : random) c = static_cast<char>(rng());
+    std::string text;
+    while (text.size() < 200000) text += "2025-10-18 12:00:00 INFO http path=/api/users status=200\n";
+
+    const std::string inputs[] = {"", "a", "abcdefghijklm", std::string(1 << 20, '\0'), random, text};
+    for (const std::string& input : inputs) {
+        const auto block = compress::detail::compress_prefixed(reinterpret_cast<const uint8_t*>(input.data()),
+                                                               input.size());
+        CHECK(compress::detail::decompress_prefixed(block.data(), block.size()) == bytes_of(input));
+
+        const mlc::String packed = compress::compress(mlc::String(input));
+        CHECK(compress::decompress(packed).as_std_string() == input);
+
+        const mlc::Bytes bytes(bytes_of(input));
+        const mlc::Bytes unpacked = compress::decompress(compress::compress(bytes));
+        CHECK_EQ(unpacked.size(), input.size());
+        CHECK(std::equal(unpacked.as_ptr(), unpacked.as_ptr() + unpacked.size(),
+                         reinterpret_cast<const uint8_t*>(input.data())));
+    }
+
+    // Highly compressible input stays within the expansion bound
+    const std::string zeros(16 << 20, '\0');
+    const auto block = compress::detail::compress_prefixed(reinterpret_cast<const uint8_t*>(zeros.data()),
+                                                           zeros.size());
+    CHECK(zeros.size() <= (block.size() - 4) * compress::detail::MAX_EXPANSION);
+    CHECK_EQ(rejection(block), std::string(""));
+}
+
+void test_corrupted_size_prefix() {
+    const std::string input = "hello hello hello hello hello hello";
+    const auto good = compress::detail::compress_prefixed(reinterpret_cast<const uint8_t*>(input.data()),
+                                                          input.size());
+
+    // A prefix the block could never expand to is refused up front
+    auto huge = good;
+    set_prefix(huge, 0xFFFFFFFFu);
+    CHECK_EQ(rejection(huge), std::string("LZ4: size prefix larger than the block can hold"));
+    const std::vector<uint8_t> tiny = {0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+    CHECK_EQ(rejection(tiny), std::string("LZ4: size prefix larger than the block can hold"));
+
+    // Plausible but wrong prefixes fail while decoding
+    auto larger = good;
+    set_prefix(larger, static_cast<uint32_t>(input.size() + 1));
+    CHECK(!rejection(larger).empty());
+    auto smaller = good;
+    set_prefix(smaller, static_cast<uint32_t>(input.size() - 1));
+    CHECK(!rejection(smaller).empty());
+
+    CHECK_EQ(rejection({1, 2, 3}), std::string("LZ4: missing size prefix"));
+
+    // The String overload reports corruption as ""
+    CHECK(compress::decompress(mlc::String(std::string(huge.begin(), huge.end()))).as_std_string().empty());
+    CHECK(compress::decompress(mlc::String("\xff\xff\xff\xff")).as_std_string().empty());
+}
+
+} // namespace
+
+int main() {
+    test_round_trips();
+    test_corrupted_size_prefix();
+    return check::result();
+}
@@ -0,0 +1,75 @@
+// file::copy and file::concat: the bytes arrive in order, and a destination
+// that is also a source (under any name) is refused before it is truncated,
+// rather than copied into itself while it grows. Runs in a scratch directory.
+
+#include "../../runtime/mlc_file_copy.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace file = mlc::file;
+
+namespace {
+
+void put(const std::string& path, const std::string& data) {
+    CHECK(file::write_string(mlc::String(path), mlc::String(data)));
+}
+
+std::string contents(const std::string& path) {
+    return file::read_to_string(mlc::String(path)).as_std_string();
+}
+
+void test_copy_and_concat() {
+    put("a.txt", "alpha\n");
+    put("b.txt", std::string(300000, 'b'));
+
+    const auto copied = file::copy(mlc::String("a.txt"), mlc::String("copy.txt"));
+    CHECK(copied.ok);
+    CHECK_EQ(copied.bytes, int64_t{6});
+    CHECK_EQ(contents("copy.txt"), std::string("alpha\n"));
+
+    put("joined.txt", "old contents that are longer than the result");
+    const auto joined = file::concat({mlc::String("a.txt"), mlc::String("b.txt"), mlc::String("a.txt")},
+                                     mlc::String("joined.txt"));
+    CHECK(joined.ok);
+    CHECK_EQ(joined.bytes, int64_t{300012});
+    CHECK(contents("joined.txt") == "alpha\n" + std::string(300000, 'b') + "alpha\n");
+
+    // A missing source stops the concatenation
+    CHECK(!file::concat({mlc::String("a.txt"), mlc::String("missing.txt")}, mlc::String("joined.txt")).ok);
+}
+
+void test_destination_among_sources() {
+    put("a.txt", "alpha\n");
+    put("out.txt", "kept\n");
+    CHECK_EQ(::symlink("out.txt", "link.txt"), 0);
+
+    const std::vector<std::vector<mlc::String>> sources = {
+        {mlc::String("a.txt"), mlc::String("out.txt")},
+        {mlc::String("out.txt")},
+        {mlc::String("a.txt"), mlc::String("./out.txt")},
+        {mlc::String("link.txt"), mlc::String("a.txt")},
+    };
+    for (const auto& srcs : sources) {
+        const auto stats = file::concat(srcs, mlc::String("out.txt"));
+        CHECK(!stats.ok);
+        CHECK_EQ(stats.bytes, int64_t{0});
+        CHECK_EQ(contents("out.txt"), std::string("kept\n"));
+    }
+
+    CHECK(!file::copy(mlc::String("out.txt"), mlc::String("link.txt")).ok);
+    CHECK_EQ(contents("out.txt"), std::string("kept\n"));
+}
+
+} // namespace
+
+int main() {
+    // A regression copies a file into itself forever
+    ::alarm(30);
+    test_copy_and_concat();
+    test_destination_among_sources();
+    return check::result();
+}
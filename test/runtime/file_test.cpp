@@ -0,0 +1,234 @@
+// file::File on POSIX descriptors: the write buffer and O_DIRECT tail must
+// leave exactly what was written, read_line must split lines the way
+// std::getline does across refills, and positional reads and writes must
+// not disturb the sequential position. Runs in a scratch directory.
+
+#include "../../runtime/mlc_file.hpp"
+#include "check.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace file = mlc::file;
+
+namespace {
+
+std::string contents(const std::string& path) {
+    file::File f(path);
+    if (!f.open_read()) return "<unreadable>";
+    return f.read_all().value_or(mlc::String("<failed>")).as_std_string();
+}
+
+void put(const std::string& path, const std::string& data) {
+    file::File f(path);
+    CHECK(f.open_write());
+    CHECK(f.write(mlc::String(data)));
+}
+
+std::vector<std::string> read_all_lines(const std::string& path, bool& eof_after_last) {
+    file::File f(path);
+    std::vector<std::string> lines;
+    CHECK(f.open_read());
+    while (auto line = f.read_line()) {
+        lines.push_back(line->as_std_string());
+        eof_after_last = f.eof();
+    }
+    CHECK(f.eof());
+    CHECK(!f.read_line());
+    return lines;
+}
+
+void test_buffered_write_reads_back() {
+    const std::string big(100 * 1024, 'x');
+    const std::vector<std::string> pieces = {"short", "", std::string(10, 'a'), big, "end"};
+    std::string expected;
+    for (const auto& piece : pieces) expected += piece + "\n";
+    expected += "no newline";
+
+    for (size_t buffer_size : {size_t{0}, size_t{1}, size_t{7}, size_t{4096}, file::File::kDefaultBufferSize}) {
+        file::File f("buffered.txt");
+        f.set_buffer_size(buffer_size);
+        CHECK_EQ(f.buffer_size(), buffer_size);
+        CHECK(f.open_write());
+        for (const auto& piece : pieces) CHECK(f.write_line(mlc::String(piece)));
+        CHECK(f.write(mlc::String("no newline")));
+        f.flush();
+        CHECK_EQ(f.size(), static_cast<int64_t>(expected.size()));
+        f.close();
+        CHECK(contents("buffered.txt") == expected);
+    }
+
+    // Appending after a buffered write
+    {
+        file::File f("buffered.txt");
+        f.set_buffer_size(3);
+        CHECK(f.open_append());
+        CHECK(f.write(mlc::String("+more")));
+    }
+    CHECK(contents("buffered.txt") == expected + "+more");
+}
+
+void test_direct_write_with_unaligned_tail() {
+    constexpr size_t kBlock = 4096;
+    for (size_t total : {3 * kBlock + 123, 2 * kBlock, size_t{10}}) {
+        std::string expected;
+        for (size_t i = 0; expected.size() < total; ++i) expected += static_cast<char>('a' + i % 26);
+
+        file::File f("direct.bin");
+        f.set_buffer_size(5000);
+        f.set_direct(true);
+        CHECK(f.open_write());
+        // Filesystems without O_DIRECT fall back to ordinary writes
+        if (f.is_direct()) CHECK_EQ(f.buffer_size() % kBlock, size_t{0});
+        for (size_t at = 0; at < total; at += 1000) CHECK(f.write(mlc::String(expected.substr(at, 1000))));
+        f.flush();
+        CHECK_EQ(f.size(), static_cast<int64_t>(total));
+        if (total % kBlock != 0) CHECK(!f.is_direct());
+
+        // Writes after the tail still land at the end
+        CHECK(f.write(mlc::String("!")));
+        f.close();
+        CHECK(contents("direct.bin") == expected + "!");
+    }
+
+    // Direct mode needs a write buffer
+    file::File f("direct.bin");
+    f.set_buffer_size(0);
+    f.set_direct(true);
+    CHECK(f.open_write());
+    CHECK(!f.is_direct());
+}
+
+void test_read_line_across_refills() {
+    const size_t kBuffer = file::File::kDefaultBufferSize;
+    const std::vector<std::string> lines = {
+        std::string(kBuffer - 6, 'a'),  // Newline lands just before the first refill
+        "crosses",                      // Starts in the first buffer, ends in the next
+        std::string(kBuffer - 9, 'b'),  // Newline is the last byte of a buffer
+        "",
+        std::string(3 * kBuffer, 'c'),  // Longer than the buffer
+        "last",
+    };
+
+    // Final line without a newline: eof as soon as it is read
+    std::string text;
+    for (size_t i = 0; i < lines.size(); ++i) text += lines[i] + (i + 1 < lines.size() ? "\n" : "");
+    put("lines.txt", text);
+    bool eof_after_last = false;
+    CHECK(read_all_lines("lines.txt", eof_after_last) == lines);
+    CHECK(eof_after_last);
+
+    // Final newline: the last line leaves eof unset, like std::getline
+    put("lines.txt", text + "\n");
+    eof_after_last = true;
+    CHECK(read_all_lines("lines.txt", eof_after_last) == lines);
+    CHECK(!eof_after_last);
+
+    put("lines.txt", "");
+    CHECK(read_all_lines("lines.txt", eof_after_last).empty());
+
+    put("lines.txt", "\n\n");
+    CHECK(read_all_lines("lines.txt", eof_after_last) == std::vector<std::string>({"", ""}));
+
+    file::File f("lines.txt");
+    CHECK(f.open_read());
+    CHECK(f.read_lines() == std::vector<mlc::String>({mlc::String(""), mlc::String("")}));
+    CHECK(f.eof());
+}
+
+void test_positional_io_keeps_position() {
+    put("positional.txt", "line1\nline2\nline3\n");
+    {
+        file::File f("positional.txt");
+        CHECK(f.open_read());
+        CHECK(f.read_line() == mlc::String("line1"));
+        CHECK(f.read_at(12, 5) == mlc::String("line3"));
+        CHECK(f.read_at(0, 100) == mlc::String("line1\nline2\nline3\n"));
+        CHECK(f.read_at(100, 5) == mlc::String(""));
+        CHECK(f.read_line() == mlc::String("line2"));
+        CHECK(f.read_line() == mlc::String("line3"));
+        CHECK(!f.read_line());
+    }
+    {
+        file::File f("positional.txt");
+        f.set_buffer_size(64);
+        CHECK(f.open_write());
+        CHECK(f.write(mlc::String("AAAA\n")));  // Still buffered
+        CHECK(f.write_at(0, "BB"));
+        CHECK(f.write(mlc::String("CCCC")));
+        CHECK(f.write_at(12, "Z"));
+        CHECK(f.write(mlc::String("D")));
+    }
+    CHECK(contents("positional.txt") == std::string("BBAA\nCCCCD") + std::string(2, '\0') + "Z");
+}
+
+void test_positional_io_in_direct_mode() {
+    constexpr size_t kBlock = 4096;
+    const std::string block(kBlock, 'a');
+
+    // After whole blocks, when flush leaves nothing to switch O_DIRECT off
+    {
+        file::File f("direct.bin");
+        f.set_direct(true);
+        CHECK(f.open_write());
+        CHECK(f.write(mlc::String(block)));
+        f.flush();
+        CHECK(f.write_at(3, "xyz"));
+        CHECK(!f.is_direct());
+        CHECK(f.write(mlc::String("tail")));
+    }
+    CHECK(contents("direct.bin") == block.substr(0, 3) + "xyz" + block.substr(6) + "tail");
+
+    // Before anything is written
+    {
+        file::File f("direct.bin");
+        f.set_direct(true);
+        CHECK(f.open_write());
+        CHECK(f.write_at(1, "b"));
+        CHECK(f.write(mlc::String(block + "c")));  // From position 0, over the "b"
+    }
+    CHECK(contents("direct.bin") == block + "c");
+}
+
+void test_mlc_handles() {
+    put("handles.txt", "one\n\ntwo");
+    file::File* f = file::file_handle(mlc::String("handles.txt"));
+    CHECK(file::file_open_read(f));
+#ifdef MLC_FILE_HAS_MMAP
+    CHECK(file::file_advise(f, mlc::String("sequential")));
+#endif
+    CHECK(!file::file_advise(f, mlc::String("sideways")));
+    std::vector<std::string> lines;
+    for (;;) {
+        auto line = file::file_read_line(f);
+        if (line.as_std_string().empty() && file::file_eof(f)) break;
+        lines.push_back(line.as_std_string());
+    }
+    CHECK(lines == std::vector<std::string>({"one", "", "two"}));
+    CHECK(file::file_read_at(f, 5, 3) == mlc::String("two"));
+    CHECK(file::file_read_at(f, -1, 3) == mlc::String(""));
+    CHECK_EQ(file::file_size(f), int64_t{8});
+    file::close_file(f);
+
+    f = file::file_handle(mlc::String("handles.txt"));
+    file::file_set_buffer_size(f, 16);
+    CHECK(file::file_open_write(f));
+    CHECK(file::file_write_line(f, mlc::String("xyz")));
+    CHECK(file::file_write_at(f, 0, mlc::String("X")));
+    CHECK(!file::file_write_at(f, -1, mlc::String("X")));
+    file::close_file(f);
+    CHECK(contents("handles.txt") == "Xyz\n");
+}
+
+} // namespace
+
+int main() {
+    test_buffered_write_reads_back();
+    test_direct_write_with_unaligned_tail();
+    test_read_line_across_refills();
+    test_positional_io_keeps_position();
+    test_positional_io_in_direct_mode();
+    test_mlc_handles();
+    return check::result();
+}
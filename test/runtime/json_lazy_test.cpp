@@ -0,0 +1,112 @@
+// json_lazy cursors against parse_json: every lookup the compiler may turn
+// into a cursor (json_get, json_has_key, json_array_get, json_array_length)
+// must give the DOM's answer, for malformed documents as well.
+
+#include "../../runtime/mlc_json_lazy.hpp"
+#include "check.hpp"
+
+#include <optional>
+#include <string>
+
+namespace json = mlc::json;
+
+namespace {
+
+std::optional<double> dom_number(const std::string& text, const char* key) {
+    auto value = json::json_get(json::parse_json(mlc::String(text)), mlc::String(key));
+    return value ? value->as_number() : std::nullopt;
+}
+
+std::optional<double> lazy_number(const std::string& text, const char* key) {
+    auto value = json::json_get(json::json_lazy(mlc::String(text)), mlc::String(key));
+    return value ? value->as_number() : std::nullopt;
+}
+
+bool dom_has(const std::string& text, const char* key) {
+    return json::json_has_key(json::parse_json(mlc::String(text)), mlc::String(key));
+}
+
+bool lazy_has(const std::string& text, const char* key) {
+    return json::json_has_key(json::json_lazy(mlc::String(text)), mlc::String(key));
+}
+
+// Both readings of `text` agree on `key`; returns the lazy one
+bool has_key(const std::string& text, const char* key) {
+    CHECK_EQ(lazy_has(text, key), dom_has(text, key));
+    return lazy_has(text, key);
+}
+
+double number(const std::string& text, const char* key) {
+    CHECK(lazy_number(text, key) == dom_number(text, key));
+    return lazy_number(text, key).value_or(-1);
+}
+
+void test_valid_documents() {
+    const std::string doc = R"({"s": "}]\"[{", "n": 1.5, "nested": {"a": [1, {"b": 2}], "key": 3}, "last": 4})";
+    CHECK(has_key(doc, "s"));
+    CHECK_EQ(number(doc, "n"), 1.5);
+    CHECK_EQ(number(doc, "last"), 4.0);
+    CHECK(!has_key(doc, "missing"));
+
+    auto nested = json::json_lazy(mlc::String(doc)).get("nested");
+    CHECK_EQ(nested.get("key").as_number().value_or(-1), 3.0);
+    CHECK_EQ(nested.get("a").at(1).get("b").as_number().value_or(-1), 2.0);
+    CHECK_EQ(json::json_array_length(nested.get("a")), 2);
+    CHECK(!json::json_array_get(nested.get("a"), 2));
+
+    // Containers spanning several 64-byte blocks
+    std::string wide = R"({"pad": [)";
+    for (int i = 0; i < 100; ++i) wide += R"({"x": "]]]}}}", "y": [[], {}]},)";
+    wide += R"(0], "after": 7})";
+    CHECK_EQ(number(wide, "after"), 7.0);
+    CHECK_EQ(json::json_array_length(json::json_lazy(mlc::String(wide)).get("pad")), 101);
+}
+
+void test_malformed_documents_are_null() {
+    const char* malformed[] = {
+        R"({"a": 1, "b": [1, 2)",         // Truncated
+        R"({"a": 1, "b": [1, 2})",        // Mismatched bracket
+        R"({"a": 1}})",                   // Extra closing bracket
+        R"({"a": 1} {"b": 2})",           // Two values
+        R"({"a": 1, "b": "open})",        // Unterminated string
+        "{\"a\": 1, \"b\": \"\x01\"}",    // Control character in a skipped string
+        "{\"a\": 1, \"b\": \"\xff\"}",    // Invalid UTF-8 in a skipped string
+        "",
+        "   ",
+    };
+    for (const char* text : malformed) {
+        if (has_key(text, "a")) std::fprintf(stderr, "  in %s\n", text);
+        CHECK_EQ(number(text, "a"), -1.0);
+    }
+
+    // Deeper than Parser::kMaxDepth
+    const std::string deep = R"({"a": 1, "b": )" + std::string(json::Parser::kMaxDepth + 1, '[') +
+                             std::string(json::Parser::kMaxDepth + 1, ']') + "}";
+    CHECK(!has_key(deep, "a"));
+    const std::string allowed = R"({"a": 1, "b": )" + std::string(json::Parser::kMaxDepth - 1, '[') +
+                                std::string(json::Parser::kMaxDepth - 1, ']') + "}";
+    CHECK(has_key(allowed, "a"));
+
+    auto array = json::json_lazy(mlc::String("[1, 2, [3"));
+    CHECK_EQ(json::json_array_length(array), 0);
+    CHECK(!json::json_array_get(array, 0));
+}
+
+void test_last_duplicate_key_wins() {
+    CHECK_EQ(number(R"({"a": 1, "b": 2, "a": 3})", "a"), 3.0);
+    CHECK_EQ(number(R"({"a": {"x": 1}, "a": 5})", "a"), 5.0);
+    CHECK_EQ(number(R"({"a": 5, "a": {"x": 1}})", "a"), -1.0);  // An object is not a number
+
+    auto doc = json::json_lazy(mlc::String(R"({"o": {"k": 1, "k": 2}, "o": {"k": 3, "k": 4}})"));
+    CHECK_EQ(doc.get("o").get("k").as_number().value_or(-1), 4.0);
+    CHECK_EQ(doc.get("o").size(), size_t{2});
+}
+
+} // namespace
+
+int main() {
+    test_valid_documents();
+    test_malformed_documents_are_null();
+    test_last_duplicate_key_wins();
+    return check::result();
+}
@@ -0,0 +1,197 @@
+// Stage one of the JSON parser: every classifier kernel the CPU supports
+// (scalar, SSE2, AVX2) must produce the same structural index as a
+// byte-at-a-time walk of the input, including for strings that cross
+// 64-byte blocks, runs of backslashes before a quote and multi-byte UTF-8.
+
+#include "../../runtime/mlc_json_simd.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace simd = mlc::json::simd;
+
+namespace {
+
+struct Index {
+    std::vector<uint32_t> entries;
+    std::string error;
+    size_t error_offset = 0;
+};
+
+std::vector<simd::Kernel> kernels() {
+    std::vector<simd::Kernel> out;
+    for (auto kernel : {simd::Kernel::Scalar, simd::Kernel::Sse2, simd::Kernel::Avx2}) {
+        if (simd::kernel_supported(kernel)) out.push_back(kernel);
+    }
+    return out;
+}
+
+Index build(const std::string& text, simd::Kernel kernel) {
+    Index index;
+    const auto result = simd::build_structural_index(text, index.entries, kernel);
+    index.error = result.error ? result.error : "";
+    index.error_offset = result.error ? result.error_offset : 0;
+    return index;
+}
+
+// One 64-byte block per window, so every carry crosses a window as well
+Index build_windowed(const std::string& text, simd::Kernel kernel) {
+    Index index;
+    simd::StructuralIndexer indexer(text, kernel, 1);
+    while (indexer.next()) index.entries.insert(index.entries.end(), indexer.entries(), indexer.entries() + indexer.size());
+    index.error = indexer.error() ? indexer.error() : "";
+    index.error_offset = indexer.error() ? indexer.error_offset() : 0;
+    return index;
+}
+
+// Byte-at-a-time stage one for well-formed input (backslashes only inside strings)
+std::vector<uint32_t> reference_index(const std::string& text) {
+    std::vector<uint32_t> out;
+    bool in_string = false, escape = false, has_escape = false, in_bare = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        const uint32_t at = static_cast<uint32_t>(i);
+        if (in_string) {
+            if (escape) {
+                escape = false;
+            } else if (c == '\\') {
+                escape = has_escape = true;
+            } else if (c == '"') {
+                out.push_back(at | (has_escape ? simd::kEscapedString : 0));
+                in_string = false;
+            }
+            continue;
+        }
+        if (c == '"') {
+            out.push_back(at);
+            in_string = true;
+            has_escape = in_bare = false;
+        } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') {
+            out.push_back(at);
+            in_bare = false;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            in_bare = false;
+        } else {
+            if (!in_bare) out.push_back(at);
+            in_bare = true;
+        }
+    }
+    out.push_back(static_cast<uint32_t>(text.size()));
+    return out;
+}
+
+bool same(const Index& a, const Index& b) {
+    if (a.error != b.error || a.error_offset != b.error_offset) return false;
+    return !a.error.empty() || a.entries == b.entries;
+}
+
+// Every kernel, whole and windowed, agrees with the reference
+void check_valid(const std::string& text) {
+    const std::vector<uint32_t> expected = reference_index(text);
+    for (auto kernel : kernels()) {
+        const Index whole = build(text, kernel);
+        const Index windowed = build_windowed(text, kernel);
+        const bool ok = whole.error.empty() && whole.entries == expected && same(whole, windowed);
+        if (!ok) std::fprintf(stderr, "  kernel %d on %zu bytes: %s\n", static_cast<int>(kernel), text.size(), text.c_str());
+        CHECK(ok);
+    }
+}
+
+// Every kernel reports `error` at `offset`
+void check_error(const std::string& text, const char* error, size_t offset) {
+    for (auto kernel : kernels()) {
+        for (const Index& index : {build(text, kernel), build_windowed(text, kernel)}) {
+            CHECK_EQ(index.error, std::string(error));
+            CHECK_EQ(index.error_offset, offset);
+        }
+    }
+}
+
+void test_strings_across_blocks() {
+    const std::string interior = "x{]:, [}";
+    for (size_t pad = 0; pad < 72; ++pad) {
+        for (size_t length : {0, 1, 2, 30, 61, 62, 63, 64, 65, 66, 127, 128, 129, 200}) {
+            std::string body;
+            for (size_t i = 0; i < length; ++i) body += interior[i % interior.size()];
+            check_valid("[" + std::string(pad, ' ') + "\"" + body + "\", 12, true]");
+            check_valid("{\"" + std::string(pad, 'k') + "\":\"" + body + "\"}");
+        }
+    }
+    // Many short strings, so quotes land on every bit of a block
+    std::string many = "[";
+    for (int i = 0; i < 200; ++i) many += "\"" + std::string(i % 7, 's') + "\",";
+    check_valid(many + "0]");
+}
+
+void test_backslash_runs_before_quotes() {
+    for (size_t run = 0; run < 140; ++run) {
+        const std::string slashes(run, '\\');
+        for (size_t pad : {0, 1, 30, 59, 60, 61, 62, 63, 64, 65, 127}) {
+            const std::string filler(pad, 'a');
+            // An odd run escapes the quote and the string goes on
+            const std::string before_quote = filler + slashes + "\"" + (run % 2 ? "tail\"" : "");
+            check_valid("{\"k\": \"" + before_quote + ", \"z\": [1]}");
+            // An odd run escapes an ordinary character instead
+            check_valid("[\"" + filler + slashes + (run % 2 ? "n" : "") + "\", \"" + filler + "\"]");
+        }
+    }
+    // Escaped quotes and backslashes packed together across a block boundary
+    std::string packed = "[\"";
+    for (int i = 0; i < 60; ++i) packed += "\\\"\\\\";
+    check_valid(packed + "\", 1]");
+}
+
+void test_utf8_across_blocks() {
+    const std::string characters[] = {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf"};
+    for (const std::string& ch : characters) {
+        for (size_t pad = 50; pad < 72; ++pad) {
+            const std::string filler(pad, 'a');
+            check_valid("[\"" + filler + ch + ch + ch + "\", \"" + ch + "\", \"" + filler + "\"]");
+            check_valid("{\"" + filler + ch + "\": \"" + ch + "\\n" + ch + "\"}");
+        }
+    }
+
+    // Malformed sequences are reported at their first byte by every kernel
+    for (size_t pad = 58; pad < 70; ++pad) {
+        const std::string prefix = "[\"" + std::string(pad, 'a');
+        check_error(prefix + "\xe2\x82\"]", "invalid UTF-8", prefix.size());         // Truncated
+        check_error(prefix + "\xc0\xaf\"]", "invalid UTF-8", prefix.size());         // Overlong
+        check_error(prefix + "\xed\xa0\x80\"]", "invalid UTF-8", prefix.size());     // Surrogate
+        check_error(prefix + "\x01\"]", "control character in string", prefix.size());
+    }
+    check_error("[\"" + std::string(100, 'a'), "unterminated string", 102);
+}
+
+// Random bytes from a JSON-heavy alphabet: the kernels agree with each
+// other on the index or on the error, valid or not
+void test_kernels_agree_on_random_input() {
+    const std::string alphabet[] = {"{", "}", "[", "]", ":", ",", "\"", "\"", "\\", "\\", " ", "\n", "a",
+                                    "1", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xff", "\x01"};
+    std::mt19937 rng(11);
+    const std::vector<simd::Kernel> supported = kernels();
+    for (int round = 0; round < 3000; ++round) {
+        std::string text;
+        const size_t pieces = rng() % 300;
+        for (size_t i = 0; i < pieces; ++i) text += alphabet[rng() % std::size(alphabet)];
+        const Index expected = build(text, simd::Kernel::Scalar);
+        for (auto kernel : supported) {
+            CHECK(same(build(text, kernel), expected));
+            CHECK(same(build_windowed(text, kernel), expected));
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    test_strings_across_blocks();
+    test_backslash_runs_before_quotes();
+    test_utf8_across_blocks();
+    test_kernels_agree_on_random_input();
+    return check::result();
+}
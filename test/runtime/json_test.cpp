@@ -0,0 +1,154 @@
+// parse_json and stringify_json: parsing and writing back must give the
+// compact form of the input (nesting, duplicate keys, escapes, \u surrogate
+// pairs, numbers at the edges of double), and anything that is not JSON must
+// parse to null.
+
+#include "../../runtime/mlc_json.hpp"
+#include "check.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace json = mlc::json;
+
+namespace {
+
+std::string stringify(const json::JsonValue& value) {
+    return json::stringify_json(value).as_std_string();
+}
+
+// Parses `text`, checks that writing it gives `expected` and that parsing
+// that again writes the same text
+void round_trip(const std::string& text, const std::string& expected) {
+    const json::JsonValue value = json::parse_json(mlc::String(text));
+    CHECK(!value.is_null() || expected == "null");
+    const std::string written = stringify(value);
+    CHECK_EQ(written, expected);
+    CHECK_EQ(stringify(json::parse_json(mlc::String(written))), written);
+}
+
+double parse_number(const std::string& text) {
+    return json::parse_json(mlc::String(text)).as_number().value_or(NAN);
+}
+
+bool same_bits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void test_nesting_round_trips() {
+    round_trip(R"({"a":[1,[2,[3,{}]],{"b":{"c":[]}}],"d":null,"e":true,"f":false})",
+               R"({"a":[1,[2,[3,{}]],{"b":{"c":[]}}],"d":null,"e":true,"f":false})");
+    round_trip(" {\n\t\"a\" : [ 1 , 2 ] ,\r\n \"b\" : { } } ", R"({"a":[1,2],"b":{}})");
+    round_trip("[[[[[[[[[[]]]]]]]]]]", "[[[[[[[[[[]]]]]]]]]]");
+    round_trip(R"({"":{"":""}})", R"({"":{"":""}})");
+    round_trip("null", "null");
+    round_trip(" true ", "true");
+
+    // Member order is kept, and the parsed values are reachable
+    const json::JsonValue doc = json::parse_json(mlc::String(R"({"z": 1, "a": {"k": [10, "x"]}})"));
+    const std::string first_key = json::json_keys(doc).at(0).as_std_string();
+    CHECK_EQ(first_key, std::string("z"));
+    const json::JsonValue k = *doc.get("a")->get("k");
+    CHECK_EQ(k.at(0)->as_number().value_or(-1), 10.0);
+    CHECK(k.at(1)->as_string() == mlc::String("x"));
+}
+
+void test_duplicate_keys_collapse() {
+    // The last value, at the first key's position
+    round_trip(R"({"a":1,"b":3,"a":2})", R"({"a":2,"b":3})");
+    round_trip(R"({"a":1,"a":2,"a":{"x":1,"x":[]}})", R"({"a":{"x":[]}})");
+
+    const json::JsonValue doc = json::parse_json(mlc::String(R"({"a":1,"b":3,"a":2})"));
+    CHECK_EQ(json::json_keys(doc).size(), size_t{2});
+    CHECK_EQ(doc.get("a")->as_number().value_or(-1), 2.0);
+    const std::string set = stringify(json::json_set(doc, mlc::String("a"), json::JsonValue(5.0)));
+    CHECK_EQ(set, std::string(R"({"a":5,"b":3})"));
+
+    // Past the linear-lookup size, where the object has a hash index
+    std::string text = "{", expected = "{";
+    for (int i = 0; i < 40; ++i) {
+        text += "\"k" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+        expected += "\"k" + std::to_string(i) + "\":" + std::to_string(i % 5 == 0 ? i + 100 : i) + ",";
+    }
+    for (int i = 0; i < 40; i += 5) text += "\"k" + std::to_string(i) + "\":" + std::to_string(i + 100) + ",";
+    text.back() = '}';
+    expected.back() = '}';
+    round_trip(text, expected);
+    const json::JsonValue large = json::parse_json(mlc::String(text));
+    CHECK_EQ(json::json_keys(large).size(), size_t{40});
+    CHECK_EQ(large.get("k35")->as_number().value_or(-1), 135.0);
+
+    // Objects built from pairs collapse the same way
+    const json::JsonValue built = json::JsonValue::object({{mlc::String("x"), json::JsonValue(1.0)},
+                                                           {mlc::String("y"), json::JsonValue(2.0)},
+                                                           {mlc::String("x"), json::JsonValue(3.0)}});
+    CHECK_EQ(stringify(built), std::string(R"({"x":3,"y":2})"));
+}
+
+void test_escapes_round_trip() {
+    round_trip(R"("\"\\\/\b\f\n\r\t")", R"("\"\\/\b\f\n\r\t")");
+    round_trip(R"("\u0000\u0001\u001f")", R"("\u0000\u0001\u001f")");
+    round_trip(R"("\u00e9\u20AC")", "\"\xc3\xa9\xe2\x82\xac\"");
+    round_trip("\"\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"", "\"\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"");
+
+    // Surrogate pairs decode to one 4-byte character
+    const auto smile = json::parse_json(mlc::String(R"("\ud83d\ude00")")).as_string();
+    CHECK(smile && smile->as_std_string() == "\xf0\x9f\x98\x80");
+    round_trip(R"(["\uD83D\uDE00", "a\ud834\udd1eb"])", "[\"\xf0\x9f\x98\x80\",\"a\xf0\x9d\x84\x9e" "b\"]");
+
+    // A key with escapes
+    round_trip(R"({"tab\there\u0041": 1})", R"({"tab\thereA":1})");
+}
+
+void test_number_edges_round_trip() {
+    round_trip("[0,-0,0.1,2.5,100,-1.0,1E2,-1.25e+3]", "[0,-0,0.1,2.5,100,-1,100,-1250]");
+    round_trip("[1e300,1.5e-300,1e-7,1e21]", "[1e+300,1.5e-300,1e-07,1e+21]");
+    round_trip("[5e-324,1.7976931348623157e308]", "[5e-324,1.7976931348623157e+308]");
+    round_trip("123456789012345678", "123456789012345680");  // Nearest double
+
+    // Writing and parsing again gives back the same double, sign of zero included
+    const char* numbers[] = {"0.1", "-0", "1e300", "5e-324", "2.2250738585072014e-308",
+                             "1.7976931348623157e308", "0.30000000000000004", "9007199254740993", "-123.456e-78"};
+    for (const char* text : numbers) {
+        const double parsed = parse_number(text);
+        CHECK(std::isfinite(parsed));
+        const double again = parse_number(stringify(json::JsonValue(parsed)));
+        if (!same_bits(parsed, again)) std::fprintf(stderr, "  for %s\n", text);
+        CHECK(same_bits(parsed, again));
+    }
+    CHECK(std::signbit(parse_number("-0")));
+    CHECK_EQ(parse_number("9007199254740993"), 9007199254740992.0);  // Ties to even
+}
+
+void test_malformed_is_null() {
+    const char* malformed[] = {
+        "", " ", "[", "]", "{", "}", "[1,]", "[,1]", "[1 2]", R"({"a":1,})", R"({"a"})", R"({"a":})",
+        "{1:2}", "{'a':1}", R"({"a" 1})", "01", "-01", "1.", ".5", "1e", "1e+", "-", "+1", "0x10", "NaN",
+        "Infinity", "-Infinity", "tru", "nul", "True", "[] x", "{} {}", "1 2", R"("\x")", R"("\u12")",
+        R"("\u12g4")", R"("\ud83d")", R"("\ude00")", R"("\ud83dx")", R"("\ud83dA")", "\"a\x01\"",
+        "\"tab\there\"", "\"\xff\"", "\"\xc3\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"", R"("open)", R"(["a)",
+    };
+    for (const char* text : malformed) {
+        const json::JsonValue value = json::parse_json(mlc::String(text));
+        if (!value.is_null()) std::fprintf(stderr, "  parsed: %s\n", text);
+        CHECK(value.is_null());
+        CHECK_EQ(stringify(value), std::string("null"));
+    }
+
+    // Deeper than Parser::kMaxDepth
+    const size_t depth = json::Parser::kMaxDepth + 1;
+    CHECK(json::parse_json(mlc::String(std::string(depth, '[') + std::string(depth, ']'))).is_null());
+    CHECK(json::parse_json(mlc::String(std::string(depth - 1, '[') + std::string(depth - 1, ']'))).is_array());
+}
+
+} // namespace
+
+int main() {
+    test_nesting_round_trips();
+    test_duplicate_keys_collapse();
+    test_escapes_round_trip();
+    test_number_edges_round_trip();
+    test_malformed_is_null();
+    return check::result();
+}
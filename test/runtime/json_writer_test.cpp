@@ -0,0 +1,190 @@
+// JsonWriter: string escaping (checked against a byte-at-a-time escaper at
+// every offset the vectorised scan can land on), pretty-printed layout of
+// nested and empty containers, shortest round-trip numbers, and NaN and
+// infinities written as null.
+
+#include "../../runtime/mlc_json.hpp"
+#include "check.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace json = mlc::json;
+
+namespace {
+
+// Byte-at-a-time reference for detail::write_string
+std::string reference_string(const std::string& text) {
+    static const char hex[] = "0123456789abcdef";
+    std::string out = "\"";
+    for (unsigned char c : text) {
+        if (c == '"') out += "\\\"";
+        else if (c == '\\') out += "\\\\";
+        else if (c == '\b') out += "\\b";
+        else if (c == '\f') out += "\\f";
+        else if (c == '\n') out += "\\n";
+        else if (c == '\r') out += "\\r";
+        else if (c == '\t') out += "\\t";
+        else if (c < 0x20) out += std::string("\\u00") + hex[c >> 4] + hex[c & 0xF];
+        else out += static_cast<char>(c);
+    }
+    return out + "\"";
+}
+
+std::string written(const std::string& text) {
+    std::string out;
+    json::JsonWriter(out).value(text);
+    return out;
+}
+
+template <typename Number>
+std::string number(Number value) {
+    std::string out;
+    json::JsonWriter(out).value(value);
+    return out;
+}
+
+void test_string_escaping() {
+    CHECK_EQ(written("plain / text"), std::string("\"plain / text\""));
+    CHECK_EQ(written("say \"hi\" \\ bye"), std::string(R"("say \"hi\" \\ bye")"));
+    CHECK_EQ(written("\b\f\n\r\t"), std::string(R"("\b\f\n\r\t")"));
+    CHECK_EQ(written(std::string("\0\x01\x1f", 3)), std::string(R"("\u0000\u0001\u001f")"));
+    CHECK_EQ(written("\x7f \xc3\xa9 \xf0\x9f\x98\x80"), std::string("\"\x7f \xc3\xa9 \xf0\x9f\x98\x80\""));
+
+    // Every byte that needs escaping, at every offset around the 16- and
+    // 32-byte steps of find_escape
+    for (int c = 0; c < 0x80; ++c) {
+        for (size_t offset = 0; offset < 70; ++offset) {
+            std::string text = std::string(offset, 'a') + static_cast<char>(c) + std::string(40, 'b');
+            CHECK_EQ(written(text), reference_string(text));
+        }
+    }
+    // Long runs of escapes and mixed content
+    std::string mixed;
+    for (int i = 0; i < 500; ++i) mixed += static_cast<char>(i % 3 == 0 ? i % 0x20 : i % 2 ? '"' : 'x');
+    CHECK_EQ(written(mixed), reference_string(mixed));
+
+    // Keys escape the same way; plain_key is for names known not to need it
+    std::string out;
+    json::JsonWriter(out).begin_object().key("a\"b\n").value(1).plain_key("id").value(2).end_object();
+    CHECK_EQ(out, std::string(R"({"a\"b\n":1,"id":2})"));
+}
+
+void test_pretty_nested_empty_containers() {
+    std::string out;
+    json::JsonWriter writer(out, 2);
+    writer.begin_object()
+        .key("a").begin_array().end_array()
+        .key("b").begin_object().end_object()
+        .key("c").begin_array()
+            .begin_array().end_array()
+            .begin_object().end_object()
+            .begin_array().begin_object().end_object().end_array()
+        .end_array()
+        .end_object();
+    CHECK_EQ(out, std::string("{\n"
+                              "  \"a\": [],\n"
+                              "  \"b\": {},\n"
+                              "  \"c\": [\n"
+                              "    [],\n"
+                              "    {},\n"
+                              "    [\n"
+                              "      {}\n"
+                              "    ]\n"
+                              "  ]\n"
+                              "}"));
+
+    // A parsed subtree is indented to fit where it is written
+    const json::JsonValue doc = json::parse_json(mlc::String(R"({"x": [], "y": {"z": [{}]}})"));
+    out.clear();
+    json::JsonWriter(out, 2).begin_array().value(doc).end_array();
+    CHECK_EQ(out, std::string("[\n"
+                              "  {\n"
+                              "    \"x\": [],\n"
+                              "    \"y\": {\n"
+                              "      \"z\": [\n"
+                              "        {}\n"
+                              "      ]\n"
+                              "    }\n"
+                              "  }\n"
+                              "]"));
+    const std::string pretty = json::stringify_json_pretty(doc, 2).as_std_string();
+    CHECK_EQ(pretty, std::string("{\n"
+                                 "  \"x\": [],\n"
+                                 "  \"y\": {\n"
+                                 "    \"z\": [\n"
+                                 "      {}\n"
+                                 "    ]\n"
+                                 "  }\n"
+                                 "}"));
+
+    // Indent 0 still breaks lines; a top-level empty container stays on one
+    out.clear();
+    json::JsonWriter(out, 0).begin_array().value(1).begin_object().end_object().end_array();
+    CHECK_EQ(out, std::string("[\n1,\n{}\n]"));
+    out.clear();
+    json::JsonWriter(out, 4).begin_object().end_object();
+    CHECK_EQ(out, std::string("{}"));
+}
+
+void test_shortest_round_trip_numbers() {
+    CHECK_EQ(number(0.1), std::string("0.1"));
+    CHECK_EQ(number(0.1f), std::string("0.1"));
+    CHECK_EQ(number(0.1 + 0.2), std::string("0.30000000000000004"));
+    CHECK_EQ(number(1e300), std::string("1e+300"));
+    CHECK_EQ(number(1.0 / 3), std::string("0.3333333333333333"));
+    CHECK_EQ(number(5e-324), std::string("5e-324"));
+    CHECK_EQ(number(std::numeric_limits<double>::max()), std::string("1.7976931348623157e+308"));
+    CHECK_EQ(number(-0.0), std::string("-0"));
+    CHECK_EQ(number(100.0), std::string("100"));
+    CHECK_EQ(number(-42.0f), std::string("-42"));
+    CHECK_EQ(number(9007199254740992.0), std::string("9007199254740992"));
+    CHECK_EQ(number(1e21), std::string("1e+21"));
+    CHECK_EQ(number(std::numeric_limits<int64_t>::min()), std::string("-9223372036854775808"));
+    CHECK_EQ(number(std::numeric_limits<uint64_t>::max()), std::string("18446744073709551615"));
+
+    // Reading the text back gives the same double
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 20000; ++i) {
+        const uint64_t bits = rng();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) continue;
+        const std::string text = number(value);
+        const double back = std::strtod(text.c_str(), nullptr);
+        if (std::memcmp(&back, &value, sizeof(value)) != 0) std::fprintf(stderr, "  %s\n", text.c_str());
+        CHECK(std::memcmp(&back, &value, sizeof(value)) == 0);
+    }
+}
+
+void test_non_finite_numbers_are_null() {
+    CHECK_EQ(number(std::nan("")), std::string("null"));
+    CHECK_EQ(number(INFINITY), std::string("null"));
+    CHECK_EQ(number(-INFINITY), std::string("null"));
+    CHECK_EQ(number(std::numeric_limits<float>::quiet_NaN()), std::string("null"));
+
+    std::string out;
+    json::JsonWriter(out).begin_object().key("nan").value(NAN).key("inf").value(HUGE_VAL).key("ok").value(1.5).end_object();
+    CHECK_EQ(out, std::string(R"({"nan":null,"inf":null,"ok":1.5})"));
+
+    // The same through stringify_json, and the result parses
+    const json::JsonValue values(std::vector<json::JsonValue>{json::JsonValue(NAN), json::JsonValue(-INFINITY)});
+    const std::string text = json::stringify_json(values).as_std_string();
+    CHECK_EQ(text, std::string("[null,null]"));
+    CHECK(json::parse_json(mlc::String(text)).is_array());
+}
+
+} // namespace
+
+int main() {
+    test_string_escaping();
+    test_pretty_nested_empty_containers();
+    test_shortest_round_trip_numbers();
+    test_non_finite_numbers_are_null();
+    return check::result();
+}
@@ -0,0 +1,46 @@
+# frozen_string_literal: true
+
+require "open3"
+require "tmpdir"
+require_relative "../test_helper"
+
+# Builds and runs the C++ runtime tests in this directory. Each *_test.cpp is
+# a standalone program that exits non-zero when a check fails (check.hpp).
+#
+#   ruby -Itest test/runtime/runtime_test.rb
+#   ruby -Itest test/runtime/runtime_test.rb -n /json/
+class RuntimeTest < Minitest::Test
+  RUNTIME_DIR = File.expand_path("../../runtime", __dir__)
+  RUNTIME_SOURCES = %w[mlc_string.cpp mlc_io.cpp].map { |f| File.join(RUNTIME_DIR, f) }.freeze
+
+  Dir.glob(File.join(__dir__, "*_test.cpp")).sort.each do |source|
+    name = File.basename(source, "_test.cpp")
+
+    define_method("test_#{name}") do
+      skip_unless_compiler_available
+      run_program(source)
+    end
+  end
+
+  private
+
+  def run_program(source)
+    Dir.mktmpdir("mlc-runtime-test") do |dir|
+      binary = File.join(dir, File.basename(source, ".cpp"))
+      compiler = ENV.fetch("CXX", "g++")
+      compile_cmd = [compiler, "-std=c++20", "-O1", "-pthread", "-Wall", "-Wextra", "-Werror",
+                     "-I", RUNTIME_DIR, source, *RUNTIME_SOURCES, "-o", binary]
+
+      _stdout, stderr, status = Open3.capture3(*compile_cmd)
+      assert status.success?, "#{File.basename(source)} failed to compile:\n#{stderr}"
+
+      _stdout, stderr, status = Open3.capture3(binary, chdir: dir)
+      assert status.success?, "#{File.basename(source)} failed:\n#{stderr}"
+    end
+  end
+
+  def skip_unless_compiler_available
+    compiler = ENV.fetch("CXX", "g++")
+    skip "C++ compiler (#{compiler}) not available" unless system("#{compiler} --version > /dev/null 2>&1")
+  end
+end